@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <string_view>
 
@@ -77,8 +78,11 @@ namespace cmdutils {
 
     inline void printProgress(std::string_view message, std::size_t progress, std::size_t total)
     {
-        std::cout << "\r" << message << std::fixed << std::setprecision(2)
-            << (double(progress) / double(total)) * 100.00  << "%" << std::flush;
+        // Percentage is formatted in own stream, so the format state of std::cout
+        // which is shared by concurrent jobs is not changed
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2) << (double(progress) / double(total)) * 100.00;
+        std::cout << "\r" << message << ss.str() << "%" << std::flush;
     }
 
     template<typename ...Args>
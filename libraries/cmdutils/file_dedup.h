@@ -0,0 +1,288 @@
+#ifndef CMDUTILS_FILE_DEDUP_H
+#define CMDUTILS_FILE_DEDUP_H
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <libim/utils/hash.h>
+
+/**
+ * Header file provides content-hash deduplication of files written by extraction commands.
+ */
+
+namespace cmdutils {
+
+    /**
+     * Registry of files produced by the running command, keyed by the hash of the file content source.
+     * When file with the same content key was already produced, it is copied or hard linked
+     * to the new output path instead of being encoded and written again.
+     *
+     * Produced files can be recorded to manifest file and the manifest can be loaded
+     * by the next run to skip files which already exist in the output tree.
+     *
+     * @note Content key is 64-bit non-cryptographic hash (see libim::utils::Hasher64).
+     *       The key should include everything that affects the output file, e.g.: source data, output format and encoder options.
+     * @note The class is thread safe.
+     */
+    class FileDedup final
+    {
+    public:
+        enum class Mode
+        {
+            Copy,    // Duplicate file is copied
+            Hardlink // Duplicate file is hard linked, or copied if hard link can't be created
+        };
+
+        explicit FileDedup(Mode mode = Mode::Copy) :
+            mode_(mode)
+        {}
+
+        FileDedup(const FileDedup&) = delete;
+        FileDedup& operator=(const FileDedup&) = delete;
+
+        /**
+         * Produces file at outPath which content is identified by key.
+         * If file with the same key was already produced, the file is copied or hard linked to outPath,
+         * or nothing is done if outPath is the produced file. Otherwise write(outPath) is called.
+         * When file with the same key is being written by another thread, the call waits for it to finish.
+         *
+         * @param key     - content key of file.
+         * @param outPath - output file path.
+         * @param write   - function which writes file to path passed as argument.
+         * @return true if file was written by write function, false if it was deduplicated.
+         * @throw any exception thrown by write or std::filesystem::filesystem_error if file can't be copied.
+         */
+        template<typename WriteF>
+        bool produce(uint64_t key, const std::filesystem::path& outPath, WriteF&& write)
+        {
+            namespace fs = std::filesystem;
+            const auto pathKey = normalizePath(outPath);
+
+            std::promise<void> promise;
+            std::optional<Entry> src;
+            bool hasContent = false; // outPath was already produced with the same content
+            {
+                std::scoped_lock lock(mutex_);
+                if (auto it = entries_.find(key); it != entries_.end()) {
+                    src = it->second;
+                }
+
+                if (auto it = owners_.find(pathKey); it != owners_.end())
+                {
+                    hasContent = it->second == key;
+                    // Other content produced at outPath is overwritten
+                    auto eit = entries_.find(it->second);
+                    if (!hasContent && eit != entries_.end() && eit->second.pathKey == pathKey) {
+                        entries_.erase(eit);
+                    }
+                }
+                owners_[pathKey] = key;
+
+                if (!src) {
+                    entries_[key] = Entry{ pathKey, outPath, promise.get_future().share() };
+                }
+            }
+
+            if (src)
+            {
+                bool srcValid = true;
+                try {
+                    src->ready.get();
+                }
+                catch (...) {
+                    srcValid = false;
+                }
+
+                std::error_code ec;
+                if (srcValid && (hasContent || src->pathKey == pathKey) && fs::exists(outPath, ec))
+                {
+                    numDeduplicated_++;
+                    return false;
+                }
+
+                if (srcValid && src->pathKey != pathKey && fs::exists(src->path, ec))
+                {
+                    linkOrCopy(src->path, outPath);
+                    numDeduplicated_++;
+                    return false;
+                }
+
+                // Source file is gone, write the file
+                removeFile(outPath);
+                write(outPath);
+                return true;
+            }
+
+            try
+            {
+                removeFile(outPath); // break any hard link to the previous content
+                write(outPath);
+                promise.set_value();
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+                std::scoped_lock lock(mutex_);
+                if (auto it = entries_.find(key); it != entries_.end() && it->second.pathKey == pathKey) {
+                    entries_.erase(it);
+                }
+                owners_.erase(pathKey);
+                throw;
+            }
+            return true;
+        }
+
+        /** Returns number of files which were deduplicated. */
+        std::size_t numDeduplicated() const
+        {
+            return numDeduplicated_;
+        }
+
+        /**
+         * Loads manifest file written by saveManifest.
+         * Listed files which still exist with the recorded size are registered as produced files.
+         * If manifest file doesn't exist nothing is loaded.
+         *
+         * @param path - path to manifest file.
+         */
+        void loadManifest(const std::filesystem::path& path)
+        {
+            namespace fs = std::filesystem;
+            std::ifstream ifs(path);
+            if (!ifs) {
+                return;
+            }
+
+            const auto baseDir = path.parent_path();
+            std::scoped_lock lock(mutex_);
+            std::string line;
+            while (std::getline(ifs, line))
+            {
+                if (line.empty() || line.front() == '#') {
+                    continue;
+                }
+
+                std::istringstream ss(line);
+                std::string hash;
+                uintmax_t size = 0;
+                if (!(ss >> hash >> size) || hash.size() != 16) {
+                    continue;
+                }
+
+                std::string relPath;
+                std::getline(ss >> std::ws, relPath);
+                const auto filePath = baseDir / fs::path(relPath);
+
+                std::error_code ec;
+                if (relPath.empty() || fs::file_size(filePath, ec) != size || ec) {
+                    continue;
+                }
+
+                uint64_t key = 0;
+                try {
+                    key = std::stoull(hash, nullptr, 16);
+                }
+                catch (const std::exception&) {
+                    continue;
+                }
+
+                const auto pathKey = normalizePath(filePath);
+                owners_[pathKey] = key;
+                if (entries_.find(key) == entries_.end())
+                {
+                    std::promise<void> ready;
+                    ready.set_value();
+                    entries_[key] = Entry{ pathKey, filePath, ready.get_future().share() };
+                }
+            }
+        }
+
+        /**
+         * Writes manifest of produced files.
+         * Each line lists content key, file size and file path relative to the manifest folder.
+         *
+         * @param path - path to manifest file.
+         * @throw std::runtime_error if manifest file can't be written.
+         */
+        void saveManifest(const std::filesystem::path& path) const
+        {
+            namespace fs = std::filesystem;
+            std::scoped_lock lock(mutex_);
+            std::ofstream ofs(path, std::ios::trunc);
+            if (!ofs) {
+                throw std::runtime_error("Failed to write manifest file '" + path.string() + "'");
+            }
+
+            ofs << "# <content-hash> <file-size> <file-path>\n";
+            const auto baseDir = fs::absolute(path).parent_path().lexically_normal();
+            for (const auto& [pathKey, key] : owners_)
+            {
+                std::error_code ec;
+                const auto size = fs::file_size(pathKey, ec);
+                if (ec) {
+                    continue;
+                }
+                ofs << libim::utils::hashToString(key) << ' ' << size << ' '
+                    << fs::path(pathKey).lexically_relative(baseDir).generic_string() << '\n';
+            }
+
+            if (!ofs) {
+                throw std::runtime_error("Failed to write manifest file '" + path.string() + "'");
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            std::string pathKey;
+            std::filesystem::path path;
+            std::shared_future<void> ready;
+        };
+
+        static std::string normalizePath(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            auto p = std::filesystem::absolute(path, ec);
+            return (ec ? path : p).lexically_normal().generic_string();
+        }
+
+        static void removeFile(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+
+        void linkOrCopy(const std::filesystem::path& src, const std::filesystem::path& dest) const
+        {
+            namespace fs = std::filesystem;
+            removeFile(dest);
+            if (mode_ == Mode::Hardlink)
+            {
+                std::error_code ec;
+                fs::create_hard_link(src, dest, ec);
+                if (!ec) {
+                    return;
+                }
+            }
+            fs::copy_file(src, dest, fs::copy_options::overwrite_existing);
+        }
+
+    private:
+        Mode mode_;
+        mutable std::mutex mutex_;
+        std::unordered_map<uint64_t, Entry> entries_;      // content key => first produced file
+        std::unordered_map<std::string, uint64_t> owners_; // produced file path => content key
+        std::atomic_size_t numDeduplicated_ = 0;
+    };
+}
+#endif // CMDUTILS_FILE_DEDUP_H
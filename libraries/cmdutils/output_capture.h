@@ -0,0 +1,166 @@
+#ifndef CMDUTILS_OUTPUT_CAPTURE_H
+#define CMDUTILS_OUTPUT_CAPTURE_H
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Header file provides capturing of console output per thread,
+ * used to print output of concurrently executed jobs without interleaving.
+ */
+
+namespace cmdutils {
+
+    /**
+     * Captured console output.
+     * Output written to std::cout and std::cerr is stored in order of writing,
+     * so it can be replayed to the same streams later.
+     */
+    class CapturedOutput final
+    {
+    public:
+        enum class Stream
+        {
+            Out,
+            Err
+        };
+
+        /** Appends text written to stream. */
+        void append(Stream stream, const char* s, std::size_t n)
+        {
+            if (chunks_.empty() || chunks_.back().first != stream) {
+                chunks_.emplace_back(stream, std::string());
+            }
+            chunks_.back().second.append(s, n);
+        }
+
+        bool empty() const
+        {
+            return chunks_.empty();
+        }
+
+        /** Writes captured output to std::cout and std::cerr in order it was captured. */
+        void print() const
+        {
+            for (const auto& [stream, text] : chunks_)
+            {
+                auto& os = stream == Stream::Err ? std::cerr : std::cout;
+                os << text << std::flush;
+            }
+        }
+
+    private:
+        std::vector<std::pair<Stream, std::string>> chunks_;
+    };
+
+    namespace detail {
+        /**
+         * Stream buffer which appends output of the thread with active capture to the capture buffer
+         * and writes output of other threads to the target stream buffer.
+         */
+        class ThreadOutputBuf final : public std::streambuf
+        {
+        public:
+            static inline thread_local CapturedOutput* tCapture = nullptr;
+
+            ThreadOutputBuf(std::streambuf* target, CapturedOutput::Stream stream) :
+                target_(target),
+                stream_(stream)
+            {}
+
+        protected:
+            int_type overflow(int_type c) override
+            {
+                if (traits_type::eq_int_type(c, traits_type::eof())) {
+                    return traits_type::not_eof(c);
+                }
+
+                const char ch = traits_type::to_char_type(c);
+                return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+            }
+
+            std::streamsize xsputn(const char* s, std::streamsize n) override
+            {
+                if (tCapture)
+                {
+                    tCapture->append(stream_, s, static_cast<std::size_t>(n));
+                    return n;
+                }
+
+                std::scoped_lock lock(mutex_);
+                return target_->sputn(s, n);
+            }
+
+            int sync() override
+            {
+                if (tCapture) {
+                    return 0;
+                }
+
+                std::scoped_lock lock(mutex_);
+                return target_->pubsync();
+            }
+
+        private:
+            std::streambuf* target_;
+            CapturedOutput::Stream stream_;
+            std::mutex mutex_;
+        };
+
+        /** Redirects std::cout and std::cerr through ThreadOutputBuf. Installed once per program. */
+        inline void installThreadOutputBufs()
+        {
+            static std::once_flag once;
+            std::call_once(once, []{
+                std::cout.flush();
+                std::cerr.flush();
+                static ThreadOutputBuf coutBuf(std::cout.rdbuf(), CapturedOutput::Stream::Out);
+                static ThreadOutputBuf cerrBuf(std::cerr.rdbuf(), CapturedOutput::Stream::Err);
+                std::cout.rdbuf(&coutBuf);
+                std::cerr.rdbuf(&cerrBuf);
+            });
+        }
+    }
+
+    /**
+     * Captures std::cout and std::cerr output of the calling thread
+     * for the lifetime of the object. Output of other threads is not captured.
+     *
+     * @note Only the stream buffers are per thread, the format state (flags, width, precision, fill)
+     *       of std::cout and std::cerr is shared by all threads. Code running under capture
+     *       concurrently with other threads must not change the stream format state,
+     *       values should be formatted into own stream instead e.g. std::ostringstream.
+     * @note The object must be destroyed on the thread it was created on.
+     */
+    class OutputCapture final
+    {
+    public:
+        OutputCapture()
+        {
+            detail::installThreadOutputBufs();
+            prev_ = std::exchange(detail::ThreadOutputBuf::tCapture, &output_);
+        }
+
+        OutputCapture(const OutputCapture&) = delete;
+        OutputCapture& operator=(const OutputCapture&) = delete;
+
+        ~OutputCapture()
+        {
+            detail::ThreadOutputBuf::tCapture = prev_;
+        }
+
+        /** Returns captured output and clears the capture buffer. */
+        [[nodiscard]] CapturedOutput take()
+        {
+            return std::exchange(output_, CapturedOutput());
+        }
+
+    private:
+        CapturedOutput output_;
+        CapturedOutput* prev_ = nullptr;
+    };
+}
+#endif // CMDUTILS_OUTPUT_CAPTURE_H
@@ -0,0 +1,85 @@
+#ifndef CMDUTILS_TRACE_H
+#define CMDUTILS_TRACE_H
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+#include "cmdutils.h"
+#include "options.h"
+
+#include <libim/io/filestream.h>
+#include <libim/trace/trace.h>
+
+/**
+ * Header file provides support for the --trace program option
+ * which writes Chrome trace-event JSON file of the program execution.
+ *
+ * Heap allocations are counted in trace spans when the program links
+ * replaced global allocation functions from trace_alloc.cpp (libcmd_trace_alloc object library).
+ */
+
+namespace cmdutils {
+    constexpr inline std::string_view kOptTrace          = "--trace";
+    constexpr inline std::string_view kDefaultTraceFile  = "trace.json";
+
+    inline void printTraceOption()
+    {
+        printOption(kOptTrace, "", "Write Chrome trace JSON file, e.g.: --trace=out.json");
+    }
+
+    /**
+     * Starts tracing when --trace option is provided
+     * and traces program execution until the session is destroyed.
+     * On destruction the trace is written to file.
+     */
+    class TraceSession final
+    {
+    public:
+        /**
+         * @param args - program arguments
+         * @param name - name of the root trace span, must be string literal
+         */
+        TraceSession(const CmdArgs& args, const char* name)
+        {
+            if (args.hasArg(kOptTrace))
+            {
+                filePath_ = args.arg(kOptTrace);
+                if (filePath_.empty()) {
+                    filePath_ = kDefaultTraceFile;
+                }
+
+                libim::trace::start();
+                span_.emplace("program", name);
+            }
+        }
+
+        TraceSession(const TraceSession&) = delete;
+        TraceSession& operator=(const TraceSession&) = delete;
+
+        ~TraceSession()
+        {
+            if (filePath_.empty()) {
+                return;
+            }
+
+            span_.reset();
+            libim::trace::stop();
+            try
+            {
+                libim::OutputFileStream ofs(filePath_, /*truncate=*/true);
+                libim::trace::writeChromeTrace(ofs);
+                std::cout << "Trace written to " << filePath_ << std::endl;
+            }
+            catch (const std::exception& e) {
+                printError("Failed to write trace file %: %", filePath_, e.what());
+            }
+        }
+
+    private:
+        std::filesystem::path filePath_;
+        std::optional<libim::trace::Span> span_;
+    };
+}
+
+#endif // CMDUTILS_TRACE_H
@@ -0,0 +1,39 @@
+#include <cstdlib>
+#include <new>
+
+#include <libim/trace/trace.h>
+
+/* Replaced global allocation functions which count allocations for trace spans */
+void* operator new(std::size_t size)
+{
+    libim::trace::countAllocation();
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
@@ -1,6 +1,7 @@
 #ifndef LIBIM_ANIMATION_H
 #define LIBIM_ANIMATION_H
 #include "../asset.h"
+#include "flat_keyframes.h"
 #include "key_node.h"
 #include "key_marker.h"
 
@@ -8,12 +9,22 @@
 #include <libim/content/text/text_resource_writer.h>
 #include <libim/types/flags.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <string>
 #include <vector>
 #include <utility>
 
 namespace libim::content::asset {
+
+    /** Keyframe node representation populated when loading animation. */
+    enum class KeyframeLayout
+    {
+        Nodes, // Keyframes are stored as list of KeyNode, see Animation::nodes()
+        Flat   // Keyframes are stored as FlatKeyframes, see Animation::flatKeyframes(). Nodes are not populated.
+    };
+
     class Animation final : public Asset
     {
     public:
@@ -134,6 +145,46 @@ namespace libim::content::asset {
             return nodes_;
         }
 
+        void setFlatKeyframes(FlatKeyframes keyframes)
+        {
+            flatKeyframes_ = std::move(keyframes);
+        }
+
+        /**
+         * Returns flat keyframes which can be sampled with FlatKeyframes::sample.
+         * Flat keyframes are populated when animation is loaded with KeyframeLayout::Flat or by calling flatten().
+         */
+        const FlatKeyframes& flatKeyframes() const
+        {
+            return flatKeyframes_;
+        }
+
+        /** Builds flat keyframes from nodes. */
+        void flatten()
+        {
+            flatKeyframes_ = FlatKeyframes(nodes_);
+        }
+
+        /**
+         * Returns animation frame at time.
+         * @param seconds - time in seconds.
+         * @param loop    - if true, frame wraps around the number of animation frames,
+         *                  otherwise frame is clamped to the last frame.
+         */
+        float frameAt(float seconds, bool loop = true) const
+        {
+            if (fps_ <= 0.0f || frames_ == 0 || seconds <= 0.0f) {
+                return 0.0f;
+            }
+
+            const float frame  = seconds * fps_;
+            const float length = static_cast<float>(frames_);
+            if (loop) {
+                return std::fmod(frame, length);
+            }
+            return std::min(frame, length - 1.0f);
+        }
+
         void setType(Flags<Type> type)
         {
             type_ = type;
@@ -153,17 +204,20 @@ namespace libim::content::asset {
 
         std::vector<KeyMarker> markers_;
         std::vector<KeyNode> nodes_;
+        FlatKeyframes flatKeyframes_;
     };
 
     /**
      * Loads Animation from KEY text format from TextResourceReader
-     * @param rr - text resource reader to read Animation from
+     * @param rr     - text resource reader to read Animation from
+     * @param layout - (optional) keyframe node representation to populate. By default KeyframeLayout::Nodes.
     */
-    Animation keyLoad(text::TextResourceReader& rr);
-    Animation keyLoad(text::TextResourceReader&& rr);
+    Animation keyLoad(text::TextResourceReader& rr, KeyframeLayout layout = KeyframeLayout::Nodes);
+    Animation keyLoad(text::TextResourceReader&& rr, KeyframeLayout layout = KeyframeLayout::Nodes);
 
     /**
-     * Writes Animation to TextResourceWriter as KEY text format
+     * Writes Animation to TextResourceWriter as KEY text format.
+     * If animation has no nodes, flat keyframes are written.
      * @param anim - Animation to write
      * @param rw   - text resource writer to write anim to
      * @param headerComments - (optional) additional header comments to write to KEY file
@@ -0,0 +1,170 @@
+#ifndef LIBIM_FLAT_KEYFRAMES_H
+#define LIBIM_FLAT_KEYFRAMES_H
+#include "key_node.h"
+#include "key_node_entry.h"
+
+#include <libim/math/rotator.h>
+#include <libim/math/vector3.h>
+#include <libim/types/flags.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace libim::content::asset {
+
+    /**
+     * Compact keyframe storage of animation nodes (joints).
+     * Entries of all nodes are stored in contiguous per-field arrays (frame, flags, position, rotation and deltas),
+     * and each node references its range of entries by offset.
+     *
+     * The storage is built by adding nodes in order and appending entries to the last added node.
+     */
+    class FlatKeyframes final
+    {
+    public:
+        using Flag = KeyNodeEntry::Flag;
+
+        FlatKeyframes() = default;
+
+        /** Constructs flat keyframes from list of key nodes. */
+        explicit FlatKeyframes(const std::vector<KeyNode>& nodes);
+
+        void reserve(std::size_t numNodes, std::size_t numEntries);
+        void clear();
+
+        /**
+         * Adds new node. Subsequently added entries belong to this node.
+         * @param num      - node number (joint index).
+         * @param meshName - name of the mesh node.
+         */
+        void addNode(uint32_t num, std::string meshName);
+
+        /**
+         * Appends entry to the last added node.
+         * @throw std::logic_error if no node was added.
+         */
+        void addEntry(const KeyNodeEntry& entry);
+
+        bool isEmpty() const
+        {
+            return nodeNums_.empty();
+        }
+
+        std::size_t numNodes() const
+        {
+            return nodeNums_.size();
+        }
+
+        std::size_t numEntries() const
+        {
+            return frames_.size();
+        }
+
+        std::size_t numEntries(std::size_t node) const
+        {
+            return offsets_.at(node + 1) - offsets_.at(node);
+        }
+
+        uint32_t nodeNum(std::size_t node) const
+        {
+            return nodeNums_.at(node);
+        }
+
+        const std::string& meshName(std::size_t node) const
+        {
+            return meshNames_.at(node);
+        }
+
+        std::span<const float> frames(std::size_t node) const
+        {
+            return range(frames_, node);
+        }
+
+        std::span<const Flags<Flag>> flags(std::size_t node) const
+        {
+            return range(flags_, node);
+        }
+
+        std::span<const Vector3f> positions(std::size_t node) const
+        {
+            return range(positions_, node);
+        }
+
+        std::span<const FRotator> rotations(std::size_t node) const
+        {
+            return range(rotations_, node);
+        }
+
+        std::span<const Vector3f> dpositions(std::size_t node) const
+        {
+            return range(dpositions_, node);
+        }
+
+        std::span<const FRotator> drotations(std::size_t node) const
+        {
+            return range(drotations_, node);
+        }
+
+        /** Returns entry at index idx of node. */
+        KeyNodeEntry entry(std::size_t node, std::size_t idx) const;
+
+        /** Converts flat keyframes back to list of key nodes. */
+        std::vector<KeyNode> toNodes() const;
+
+        /**
+         * Samples position and rotation of all nodes at given animation frames.
+         * Node pose at frame f is evaluated from the last node entry with entry frame <= f (or the first entry)
+         * as: position + dpos * (f - entry frame) and rotation + drot * (f - entry frame),
+         * where the delta is applied only when entry has PositionChange or RotationChange flag set,
+         * and is clamped to 0 for frames before the first entry.
+         * Nodes with no entries are sampled as zero position and rotation.
+         *
+         * Output is frame-major: pose of node n at frames[i] is written at index i * numNodes() + n.
+         * Sampling is fastest when frames are sorted in ascending order.
+         *
+         * @param frames       - animation frames (not seconds) to sample. See Animation::frameAt.
+         * @param outPositions - output node positions. Size must be at least frames.size() * numNodes().
+         * @param outRotations - output node rotations. Size must be at least frames.size() * numNodes().
+         * @throw std::invalid_argument if output spans are too small.
+         */
+        void sample(std::span<const float> frames, std::span<Vector3f> outPositions, std::span<FRotator> outRotations) const;
+
+        /**
+         * Samples position and rotation of all nodes at single frame.
+         * @see sample
+         */
+        void sample(float frame, std::span<Vector3f> outPositions, std::span<FRotator> outRotations) const
+        {
+            sample(std::span<const float>(&frame, 1), outPositions, outRotations);
+        }
+
+        friend bool operator == (const FlatKeyframes& fk1, const FlatKeyframes& fk2);
+
+    private:
+        KeyNodeEntry entryAt(std::size_t idx) const;
+
+        template<typename T>
+        std::span<const T> range(const std::vector<T>& v, std::size_t node) const
+        {
+            const auto first = offsets_.at(node);
+            return std::span<const T>(v.data() + first, offsets_.at(node + 1) - first);
+        }
+
+    private:
+        std::vector<uint32_t> nodeNums_;
+        std::vector<std::string> meshNames_;
+        std::vector<uint32_t> offsets_ = { 0 }; // Node entries start offsets, last element is end of last node
+
+        std::vector<float> frames_;
+        std::vector<Flags<Flag>> flags_;
+        std::vector<Vector3f> positions_;
+        std::vector<FRotator> rotations_;
+        std::vector<Vector3f> dpositions_;
+        std::vector<FRotator> drotations_;
+    };
+
+    bool operator == (const FlatKeyframes& fk1, const FlatKeyframes& fk2);
+}
+#endif // LIBIM_FLAT_KEYFRAMES_H
@@ -1,5 +1,6 @@
 #include "../animation.h"
 #include <libim/content/text/impl/text_resource_literals.h>
+#include <libim/trace/trace.h>
 
 #include <string_view>
 #include <utility>
@@ -36,6 +37,18 @@ void parseMarkers(TextResourceReader& rr, Animation& anim)
     anim.setMarkers(std::move(markers));
 }
 
+void parseKeyNodeEntry(TextResourceReader& rr, std::size_t /*rowIdx*/, KeyNodeEntry& entry)
+{
+    entry.frame = rr.getNumber<decltype(entry.frame)>();
+    entry.flags = rr.readFlags<decltype(entry.flags)>();
+
+    entry.position = rr.readVector<Vector3f>();
+    entry.rot      = rr.readVector<FRotator>();
+
+    entry.dpos  = rr.readVector<Vector3f>();
+    entry.drot  = rr.readVector<FRotator>();
+}
+
 void parseKeyframes(TextResourceReader& rr, Animation& anim)
 {
     auto nodes = rr.readList<std::vector<KeyNode>, false>(kResName_Nodes,
@@ -44,25 +57,37 @@ void parseKeyframes(TextResourceReader& rr, Animation& anim)
         node.num      = rr.readKey<decltype(node.num)>(kResName_Node);
         node.meshName = rr.readKey<std::string>(kResName_MeshName);
 
-        node.entries = rr.readList<std::vector<KeyNodeEntry>>(kResName_Entries,
-        [](TextResourceReader& rr, auto /*rowIdx*/, auto& entry)
-        {
-            entry.frame = rr.getNumber<decltype(entry.frame)>();
-            entry.flags = rr.readFlags<decltype(entry.flags)>();
-
-            entry.position = rr.readVector<Vector3f>();
-            entry.rot      = rr.readVector<FRotator>();
-
-            entry.dpos  = rr.readVector<Vector3f>();
-            entry.drot  = rr.readVector<FRotator>();
-        });
+        node.entries = rr.readList<std::vector<KeyNodeEntry>>(kResName_Entries, parseKeyNodeEntry);
     });
 
     anim.setNodes(std::move(nodes));
 }
 
-Animation libim::content::asset::keyLoad(text::TextResourceReader& rr)
+void parseFlatKeyframes(TextResourceReader& rr, Animation& anim)
 {
+    FlatKeyframes keyframes;
+    auto addEntry = [&](auto& /*entries*/, KeyNodeEntry&& entry) {
+        keyframes.addEntry(entry);
+    };
+
+    // Nodes and entries are added directly to flat keyframes, parsed lists stay empty
+    rr.readList<std::vector<KeyNode>, false>(kResName_Nodes,
+    [&](TextResourceReader& rr, auto /*rowIdx*/, auto& node)
+    {
+        node.num      = rr.readKey<decltype(node.num)>(kResName_Node);
+        node.meshName = rr.readKey<std::string>(kResName_MeshName);
+        keyframes.addNode(node.num, std::move(node.meshName));
+
+        rr.readList<std::vector<KeyNodeEntry>>(kResName_Entries, parseKeyNodeEntry, addEntry);
+    },
+    [](auto& /*nodes*/, KeyNode&& /*node*/) {});
+
+    anim.setFlatKeyframes(std::move(keyframes));
+}
+
+Animation libim::content::asset::keyLoad(text::TextResourceReader& rr, KeyframeLayout layout)
+{
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "keyLoad", rr, rr.istream().name());
     Animation anim;
     rr.assertSection(kResName_Header);
     parseHeader(rr, anim);
@@ -79,12 +104,17 @@ Animation libim::content::asset::keyLoad(text::TextResourceReader& rr)
         throw SyntaxError("Expected section: KEYFRAME NODES"sv, rr.currentToken().location());
     }
 
-    parseKeyframes(rr, anim);
+    if (layout == KeyframeLayout::Flat) {
+        parseFlatKeyframes(rr, anim);
+    }
+    else {
+        parseKeyframes(rr, anim);
+    }
     anim.setName(getFilename(rr.istream().name()));
     return anim;
 }
 
-Animation libim::content::asset::keyLoad(text::TextResourceReader&& rr)
+Animation libim::content::asset::keyLoad(text::TextResourceReader&& rr, KeyframeLayout layout)
 {
-    return keyLoad(rr);
+    return keyLoad(rr, layout);
 }
@@ -1,5 +1,6 @@
 #include "../animation.h"
 #include <libim/content/text/impl/text_resource_literals.h>
+#include <libim/trace/trace.h>
 
 #include <utility>
 
@@ -48,11 +49,11 @@ void writeMarkers(TextResourceWriter& rw, const Animation& anim)
       .writeEol();
 }
 
-void writeKeyframes(TextResourceWriter& rw, const Animation& anim)
+void writeKeyframes(TextResourceWriter& rw, const std::vector<KeyNode>& nodes)
 {
     rw.writeSection(kResName_KfNodes)
       .writeEol()
-      .writeList(kResName_Nodes, anim.nodes(),
+      .writeList(kResName_Nodes, nodes,
       [](TextResourceWriter& rw, auto /*idx*/, const KeyNode& node)
       {
 
@@ -95,9 +96,15 @@ void writeKeyframes(TextResourceWriter& rw, const Animation& anim)
 
 void libim::content::asset::keyWrite(const Animation& anim, text::TextResourceWriter& rw, const std::vector<std::string>& headerComments)
 {
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "keyWrite", rw, anim.name());
     writeHeader(rw, anim, headerComments);
     writeMarkers(rw, anim);
-    writeKeyframes(rw, anim);
+    if (anim.nodes().empty() && !anim.flatKeyframes().isEmpty()) {
+        writeKeyframes(rw, anim.flatKeyframes().toNodes());
+    }
+    else {
+        writeKeyframes(rw, anim.nodes());
+    }
 }
 
 void libim::content::asset::keyWrite(const Animation& anim, text::TextResourceWriter&& rw, const std::vector<std::string>& headerComments)
@@ -0,0 +1,192 @@
+#include "../flat_keyframes.h"
+#include <libim/types/safe_cast.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+
+FlatKeyframes::FlatKeyframes(const std::vector<KeyNode>& nodes)
+{
+    std::size_t numEntries = 0;
+    for (const auto& node : nodes) {
+        numEntries += node.entries.size();
+    }
+
+    reserve(nodes.size(), numEntries);
+    for (const auto& node : nodes)
+    {
+        addNode(node.num, node.meshName);
+        for (const auto& entry : node.entries) {
+            addEntry(entry);
+        }
+    }
+}
+
+void FlatKeyframes::reserve(std::size_t numNodes, std::size_t numEntries)
+{
+    nodeNums_.reserve(numNodes);
+    meshNames_.reserve(numNodes);
+    offsets_.reserve(numNodes + 1);
+
+    frames_.reserve(numEntries);
+    flags_.reserve(numEntries);
+    positions_.reserve(numEntries);
+    rotations_.reserve(numEntries);
+    dpositions_.reserve(numEntries);
+    drotations_.reserve(numEntries);
+}
+
+void FlatKeyframes::clear()
+{
+    nodeNums_.clear();
+    meshNames_.clear();
+    offsets_.assign(1, 0);
+
+    frames_.clear();
+    flags_.clear();
+    positions_.clear();
+    rotations_.clear();
+    dpositions_.clear();
+    drotations_.clear();
+}
+
+void FlatKeyframes::addNode(uint32_t num, std::string meshName)
+{
+    nodeNums_.push_back(num);
+    meshNames_.push_back(std::move(meshName));
+    offsets_.push_back(offsets_.back());
+}
+
+void FlatKeyframes::addEntry(const KeyNodeEntry& entry)
+{
+    if (nodeNums_.empty()) {
+        throw std::logic_error("FlatKeyframes::addEntry: no node was added");
+    }
+
+    frames_.push_back(entry.frame);
+    flags_.push_back(entry.flags);
+    positions_.push_back(entry.position);
+    rotations_.push_back(entry.rot);
+    dpositions_.push_back(entry.dpos);
+    drotations_.push_back(entry.drot);
+    offsets_.back() = safe_cast<uint32_t>(frames_.size());
+}
+
+KeyNodeEntry FlatKeyframes::entryAt(std::size_t idx) const
+{
+    KeyNodeEntry entry;
+    entry.frame    = frames_[idx];
+    entry.flags    = flags_[idx];
+    entry.position = positions_[idx];
+    entry.rot      = rotations_[idx];
+    entry.dpos     = dpositions_[idx];
+    entry.drot     = drotations_[idx];
+    return entry;
+}
+
+KeyNodeEntry FlatKeyframes::entry(std::size_t node, std::size_t idx) const
+{
+    if (idx >= numEntries(node)) {
+        throw std::out_of_range("FlatKeyframes::entry: entry index out of range");
+    }
+    return entryAt(offsets_[node] + idx);
+}
+
+std::vector<KeyNode> FlatKeyframes::toNodes() const
+{
+    std::vector<KeyNode> nodes(numNodes());
+    for (std::size_t n = 0; n < nodes.size(); n++)
+    {
+        auto& node    = nodes[n];
+        node.num      = nodeNums_[n];
+        node.meshName = meshNames_[n];
+        node.entries.reserve(numEntries(n));
+        for (auto i = offsets_[n]; i < offsets_[n + 1]; i++) {
+            node.entries.push_back(entryAt(i));
+        }
+    }
+    return nodes;
+}
+
+void FlatKeyframes::sample(std::span<const float> frames, std::span<Vector3f> outPositions, std::span<FRotator> outRotations) const
+{
+    const std::size_t nNodes = numNodes();
+    const std::size_t outSize = frames.size() * nNodes;
+    if (outPositions.size() < outSize || outRotations.size() < outSize) {
+        throw std::invalid_argument("FlatKeyframes::sample: output buffer is too small");
+    }
+
+    for (std::size_t node = 0; node < nNodes; node++)
+    {
+        const auto first = offsets_[node];
+        const auto last  = offsets_[node + 1];
+        if (first == last)
+        {
+            for (std::size_t i = 0; i < frames.size(); i++)
+            {
+                outPositions[i * nNodes + node] = Vector3f(0.0f, 0.0f, 0.0f);
+                outRotations[i * nNodes + node] = FRotator(0.0f, 0.0f, 0.0f);
+            }
+            continue;
+        }
+
+        const float* pBegin = frames_.data() + first;
+        const float* pEnd   = frames_.data() + last;
+
+        // Entry search continues from the previous entry while frames are ascending
+        std::size_t idx = 0;
+        float prevFrame = frames.empty() ? 0.0f : frames[0];
+        for (std::size_t i = 0; i < frames.size(); i++)
+        {
+            const float frame = frames[i];
+            if (frame < prevFrame) {
+                idx = 0;
+            }
+            prevFrame = frame;
+
+            const auto it = std::upper_bound(pBegin + idx, pEnd, frame);
+            idx = it == pBegin ? 0 : std::size_t(it - pBegin) - 1;
+
+            const std::size_t e = first + idx;
+            const float delta   = std::max(frame - frames_[e], 0.0f);
+
+            auto& pos = outPositions[i * nNodes + node];
+            auto& rot = outRotations[i * nNodes + node];
+            pos = positions_[e];
+            rot = rotations_[e];
+            if (flags_[e] & Flag::PositionChange)
+            {
+                const auto& dpos = dpositions_[e];
+                for (std::size_t c = 0; c < pos.size(); c++) {
+                    pos[c] += dpos[c] * delta;
+                }
+            }
+            if (flags_[e] & Flag::RotationChange)
+            {
+                const auto& drot = drotations_[e];
+                for (std::size_t c = 0; c < rot.size(); c++) {
+                    rot[c] += drot[c] * delta;
+                }
+            }
+        }
+    }
+}
+
+bool libim::content::asset::operator == (const FlatKeyframes& fk1, const FlatKeyframes& fk2)
+{
+    if (fk1.nodeNums_ != fk2.nodeNums_ || fk1.meshNames_ != fk2.meshNames_ || fk1.offsets_ != fk2.offsets_) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < fk1.numEntries(); i++)
+    {
+        if (!(fk1.entryAt(i) == fk2.entryAt(i))) {
+            return false;
+        }
+    }
+    return true;
+}
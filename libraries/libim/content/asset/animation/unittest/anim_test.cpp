@@ -1,6 +1,10 @@
 #include "anim_test.h"
 #include <libim/common.h>
 
+#include <span>
+#include <stdexcept>
+#include <vector>
+
 using namespace libim;
 using namespace libim::content::text;
 using namespace libim::content::asset;
@@ -48,6 +52,34 @@ void test_anim_file(const std::filesystem::path& filePath)
         assert(anim.joints()  == anim2.joints());
         assert(anim.markers() == anim2.markers());
         assert(anim.nodes()   == anim2.nodes());
+
+        // Load animation with flat keyframes
+        Animation animFlat;
+        {
+            InputFileStream fs(filePath);
+            animFlat = keyLoad(TextResourceReader(fs), KeyframeLayout::Flat);
+        }
+
+        assert(animFlat.nodes().empty());
+        assert(animFlat.markers() == anim.markers());
+        assert(animFlat.flatKeyframes().numNodes() == anim.nodes().size());
+        assert(animFlat.flatKeyframes().toNodes() == anim.nodes());
+        assert(animFlat.flatKeyframes() == FlatKeyframes(anim.nodes()));
+
+        // Write animation with flat keyframes
+        {
+            OutputFileStream ofs(testFile, /*truncate=*/true);
+            keyWrite(animFlat, TextResourceWriter(ofs));
+        }
+
+        {
+            InputFileStream fs(testFile);
+            anim2 = keyLoad(TextResourceReader(fs));
+
+            fs.close();
+            removeFile(testFile);
+        }
+        assert(anim.nodes() == anim2.nodes());
     }
     catch(const std::exception& e)
     {
@@ -57,6 +89,69 @@ void test_anim_file(const std::filesystem::path& filePath)
 }
 
 
+void test_anim_sample()
+{
+    // Test case 1: Sample nodes at sorted frames
+    FlatKeyframes keyframes;
+    keyframes.addNode(0, "node0");
+    keyframes.addEntry({ 0.0f,  KeyNodeEntry::PositionChange, Vector3f(0.0f, 0.0f, 0.0f), FRotator(0.0f, 0.0f, 0.0f), Vector3f(1.0f, 2.0f, 0.0f), FRotator(0.0f, 0.0f, 0.0f) });
+    keyframes.addEntry({ 10.0f, KeyNodeEntry::RotationChange, Vector3f(5.0f, 5.0f, 5.0f), FRotator(0.0f, 0.0f, 0.0f), Vector3f(1.0f, 1.0f, 1.0f), FRotator(0.0f, 9.0f, 0.0f) });
+    keyframes.addNode(1, "node1");
+    keyframes.addNode(2, "node2");
+    keyframes.addEntry({ 4.0f,  KeyNodeEntry::PositionChange, Vector3f(1.0f, 1.0f, 1.0f), FRotator(1.0f, 1.0f, 1.0f), Vector3f(1.0f, 0.0f, 0.0f), FRotator(0.0f, 0.0f, 0.0f) });
+
+    assert(keyframes.numNodes() == 3);
+    assert(keyframes.numEntries() == 3);
+    assert(keyframes.numEntries(0) == 2 && keyframes.numEntries(1) == 0 && keyframes.numEntries(2) == 1);
+
+    const std::vector<float> frames = { 0.0f, 2.5f, 10.0f, 12.0f };
+    std::vector<Vector3f> pos(frames.size() * keyframes.numNodes());
+    std::vector<FRotator> rot(pos.size());
+    keyframes.sample(frames, pos, rot);
+
+    assert(pos[0 * 3 + 0] == Vector3f(0.0f, 0.0f, 0.0f));
+    assert(pos[1 * 3 + 0] == Vector3f(2.5f, 5.0f, 0.0f));
+    assert(pos[2 * 3 + 0] == Vector3f(5.0f, 5.0f, 5.0f));
+    assert(pos[3 * 3 + 0] == Vector3f(5.0f, 5.0f, 5.0f));
+    assert(rot[3 * 3 + 0] == FRotator(0.0f, 18.0f, 0.0f));
+
+    // Node with no entries
+    assert(pos[2 * 3 + 1] == Vector3f(0.0f, 0.0f, 0.0f));
+    assert(rot[2 * 3 + 1] == FRotator(0.0f, 0.0f, 0.0f));
+
+    // Frame before the first entry
+    assert(pos[1 * 3 + 2] == Vector3f(1.0f, 1.0f, 1.0f));
+    assert(pos[3 * 3 + 2] == Vector3f(9.0f, 1.0f, 1.0f));
+
+    // Test case 2: Sample nodes at unsorted frames
+    const std::vector<float> uframes = { 12.0f, 2.5f, 0.0f };
+    std::vector<Vector3f> upos(uframes.size() * keyframes.numNodes());
+    std::vector<FRotator> urot(upos.size());
+    keyframes.sample(uframes, upos, urot);
+    assert(upos[0 * 3 + 0] == pos[3 * 3 + 0]);
+    assert(upos[1 * 3 + 0] == pos[1 * 3 + 0]);
+    assert(upos[2 * 3 + 0] == pos[0 * 3 + 0]);
+    assert(urot[0 * 3 + 0] == rot[3 * 3 + 0]);
+
+    // Test case 3: Too small output buffer
+    [[maybe_unused]] bool thrown = false;
+    try {
+        keyframes.sample(frames, std::span(pos).first(3), rot);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Test case 4: Animation time to frame
+    Animation anim;
+    anim.setFps(15.0f);
+    anim.setFrames(30);
+    assert(cmpf(anim.frameAt(1.0f), 15.0f));
+    assert(cmpf(anim.frameAt(2.5f), 7.5f));
+    assert(cmpf(anim.frameAt(2.5f, /*loop=*/false), 29.0f));
+}
+
 void libim::unit_test::run_animation_tests(const std::filesystem::path& tvRootPath )
 {
     using namespace libim;
@@ -70,4 +165,5 @@ void libim::unit_test::run_animation_tests(const std::filesystem::path& tvRootPa
 
     test_anim_file(tvFile1);
     test_anim_file(tvFile2);
+    test_anim_sample();
 }
@@ -12,7 +12,9 @@
 #include "mat_ser_helpers.h"
 #include "../../material.h"
 #include "../../colorformat.h"
+#include <libim/io/schema.h>
 #include <libim/io/stream.h>
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
 
 
@@ -30,21 +32,14 @@ Material libim::content::asset::matLoad(InputStream&& istream)
 
 Material libim::content::asset::matLoad(const InputStream& istream)
 {
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "matLoad", istream, istream.name());
     /* Read header */
-    auto header = istream.read<MatHeader>();
-
-    if (header.type != MAT_TEXTURE_TYPE) {
-        throw StreamError("MAT file contains no textures");
-    }
+    auto header = readStruct<MatHeader>(istream);
 
     if (header.recordCount != header.celCount) {
         throw StreamError("Cannot read older version of MAT file");
     }
 
-    if (header.recordCount <= 0) {
-        throw StreamError("MAT file record count <= 0");
-    }
-
     if (header.colorInfo.mode < ColorMode::RGB ||
        header.colorInfo.mode > ColorMode::RGBA) {
         throw StreamError("Can't read MAT file from stream, invalid color mode");
@@ -59,7 +54,7 @@ Material libim::content::asset::matLoad(const InputStream& istream)
     }
 
     /* Read Material records */
-    auto records = istream.read<std::vector<MatRecordHeader>>(
+    auto records = readStructs<MatRecordHeader>(istream,
         static_cast<std::size_t>(header.recordCount)
     );
 
@@ -68,7 +63,7 @@ Material libim::content::asset::matLoad(const InputStream& istream)
     const auto celCount = safe_cast<std::size_t>(header.celCount);
     for (std::size_t i = 0; i < celCount; i++)
     {
-        auto texHeader = istream.read<MatTextureHeader>();
+        auto texHeader = readStruct<MatTextureHeader>(istream);
         auto tex = istream.read<Texture, uint32_t, uint32_t, uint32_t, const ColorFormat&>(
             safe_cast<uint32_t>(texHeader.width),
             safe_cast<uint32_t>(texHeader.height),
@@ -90,6 +85,7 @@ bool libim::content::asset::matWrite(const Material& mat, OutputStream&& ostream
 
 bool libim::content::asset::matWrite(const Material& mat, OutputStream& ostream)
 {
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "matWrite", ostream, mat.name());
     if (mat.cells().empty()) {
         return false;
     }
@@ -105,17 +101,16 @@ bool libim::content::asset::matWrite(const Material& mat, OutputStream& ostream)
     header.celCount     = celCount;
     header.colorInfo    = mat.format();
 
-    ostream.write(header);
+    writeStruct(ostream, header);
 
     /* Write record headers to file */
-    MatRecordHeader record {};
-    record.recordType = 8;
-    record.texIdx = 0;
-    while (celCount --> 0)
+    std::vector<MatRecordHeader> records(safe_cast<std::size_t>(celCount));
+    for (std::size_t i = 0; i < records.size(); i++)
     {
-        ostream.write(record);
-        record.texIdx++;
+        records[i].recordType = 8;
+        records[i].texIdx     = safe_cast<int32_t>(i);
     }
+    writeStructs<MatRecordHeader>(ostream, records);
 
     /* Write textures to stream */
     MatTextureHeader texHeader {};
@@ -126,7 +121,7 @@ bool libim::content::asset::matWrite(const Material& mat, OutputStream& ostream)
         texHeader.height    = safe_cast<int32_t>(tex.height());
         texHeader.mipLevels = safe_cast<int32_t>(tex.mipLevels());
 
-        ostream.write(texHeader);
+        writeStruct(ostream, texHeader);
         ostream.write(tex.pixdata());
     }
 
@@ -1,95 +1,85 @@
 #ifndef LIBIM_MATERIAL_SER_HELPERS_H
 #define LIBIM_MATERIAL_SER_HELPERS_H
 #include <cstdint>
-#include <memory>
-#include <utility>
-
+#include <limits>
+#include <tuple>
 
 #include "mat_structs.h"
-#include "../../material.h"
 #include "../../colorformat.h"
-#include <libim/io/stream.h>
+#include <libim/io/schema.h>
 
-/* Defines stream io overloads to serialize mat structs from stream */
+/* Defines binary schema of mat structs */
 
 namespace libim {
-    using namespace libim;
     using namespace libim::content::asset;
 
-
-    // Mat header
-    template<> inline MatHeader Stream::read<MatHeader>() const
+    template<>
+    struct StructSchema<ColorFormat>
     {
-        MatHeader matHeader;
-        auto nRead = this->readsome(reinterpret_cast<byte_t*>(&matHeader), sizeof(MatHeader));
-        if(nRead != sizeof(MatHeader)) {
-            throw StreamError("Error reading MatHeader from stream!");
-        }
-
-        /* Verify file signature */
-        if(matHeader.magic != MAT_FILE_SIG) {
-            throw StreamError("Unknown MAT file");
-        }
-
-        /* Verify file version */
-        if(matHeader.version != MAT_VERSION) {
-            throw StreamError(std::string("Wrong MAT file version: ") + std::to_string(matHeader.version));
-        }
-
-        return matHeader;
-    }
-
-    template<> inline Stream& Stream::write(const MatHeader& matHeader)
+        static constexpr std::string_view name = "ColorFormat";
+        static constexpr auto fields = std::make_tuple(
+            schemaField<&ColorFormat::mode>("mode"),
+            schemaField<&ColorFormat::bpp>("bpp"),
+            schemaField<&ColorFormat::redBPP>("redBPP"),
+            schemaField<&ColorFormat::greenBPP>("greenBPP"),
+            schemaField<&ColorFormat::blueBPP>("blueBPP"),
+            schemaField<&ColorFormat::redShl>("redShl"),
+            schemaField<&ColorFormat::greenShl>("greenShl"),
+            schemaField<&ColorFormat::blueShl>("blueShl"),
+            schemaField<&ColorFormat::redShr>("redShr"),
+            schemaField<&ColorFormat::greenShr>("greenShr"),
+            schemaField<&ColorFormat::blueShr>("blueShr"),
+            schemaField<&ColorFormat::alphaBPP>("alphaBPP"),
+            schemaField<&ColorFormat::alphaShl>("alphaShl"),
+            schemaField<&ColorFormat::alphaShr>("alphaShr")
+        );
+    };
+
+    template<>
+    struct StructSchema<MatHeader>
     {
-        auto nWritten = this->write(reinterpret_cast<const byte_t*>(&matHeader), sizeof(MatHeader));
-        if(nWritten != sizeof(MatHeader)) {
-            throw StreamError("Error writing MatHeader to stream");
-        }
-
-        return *this;
-    }
-
-    // Mat record header
-    template<> inline MatRecordHeader Stream::read<MatRecordHeader>() const
+        static constexpr std::string_view name = "MatHeader";
+        static constexpr auto fields = std::make_tuple(
+            schemaField<&MatHeader::magic>("magic", MAT_FILE_SIG),
+            schemaField<&MatHeader::version>("version", static_cast<int>(MAT_VERSION)),
+            schemaField<&MatHeader::type>("type", MAT_TEXTURE_TYPE),
+            schemaField<&MatHeader::recordCount>("recordCount", 1, std::numeric_limits<int32_t>::max()),
+            schemaField<&MatHeader::celCount>("celCount", 1, std::numeric_limits<int32_t>::max()),
+            schemaField<&MatHeader::colorInfo>("colorInfo")
+        );
+    };
+
+    template<>
+    struct StructSchema<MatRecordHeader>
     {
-        MatRecordHeader matRecord;
-        auto nRead = this->readsome(reinterpret_cast<byte_t*>(&matRecord), sizeof(MatRecordHeader));
-        if(nRead != sizeof(MatRecordHeader)) {
-            throw StreamError("Error reading MatRecordHeader from stream");
-        }
-
-        return matRecord;
-    }
-
-    template<> inline Stream& Stream::write(const MatRecordHeader& matRecord)
-    {
-        auto nWritten = this->write(reinterpret_cast<const byte_t*>(&matRecord), sizeof(MatRecordHeader));
-        if(nWritten != sizeof(MatRecordHeader)) {
-            throw StreamError("Error writing MatRecordHeader to stream");
-        }
-
-        return *this;
-    }
-
-    // Mat texture header
-    template<> inline MatTextureHeader Stream::read<MatTextureHeader>() const
-    {
-        MatTextureHeader texHeader;
-        auto nRead = this->readsome(reinterpret_cast<byte_t*>(&texHeader), sizeof(MatTextureHeader));
-        if(nRead != sizeof(MatTextureHeader)) {
-            throw StreamError("Error reading MatTextureHeader from stream");
-        }
-        return texHeader;
-    }
-
-    template<> inline Stream& Stream::write(const MatTextureHeader& texHeader)
+        static constexpr std::string_view name = "MatRecordHeader";
+        static constexpr auto fields = std::make_tuple(
+            schemaField<&MatRecordHeader::recordType>("recordType"),
+            schemaField<&MatRecordHeader::transparentColor>("transparentColor"),
+            schemaField<&MatRecordHeader::Unknown1>("Unknown1"),
+            schemaField<&MatRecordHeader::Unknown2>("Unknown2"),
+            schemaField<&MatRecordHeader::Unknown3>("Unknown3"),
+            schemaField<&MatRecordHeader::Unknown4>("Unknown4"),
+            schemaField<&MatRecordHeader::Unknown5>("Unknown5"),
+            schemaField<&MatRecordHeader::Unknown6>("Unknown6"),
+            schemaField<&MatRecordHeader::Unknown7>("Unknown7"),
+            schemaField<&MatRecordHeader::texIdx>("texIdx")
+        );
+    };
+
+    template<>
+    struct StructSchema<MatTextureHeader>
     {
-        auto nWritten = this->write(reinterpret_cast<const byte_t*>(&texHeader), sizeof(MatTextureHeader));
-        if(nWritten != sizeof(MatTextureHeader)) {
-            throw StreamError("Error writing MatTextureHeader to stream");
-        }
-        return *this;
-    }
+        static constexpr std::string_view name = "MatTextureHeader";
+        static constexpr auto fields = std::make_tuple(
+            schemaField<&MatTextureHeader::width>("width", 0, std::numeric_limits<int32_t>::max()),
+            schemaField<&MatTextureHeader::height>("height", 0, std::numeric_limits<int32_t>::max()),
+            schemaField<&MatTextureHeader::transparentBool>("transparentBool"),
+            schemaField<&MatTextureHeader::Unknown1>("Unknown1"),
+            schemaField<&MatTextureHeader::Unknown2>("Unknown2"),
+            schemaField<&MatTextureHeader::mipLevels>("mipLevels", 0, std::numeric_limits<int32_t>::max())
+        );
+    };
 }
 
 #endif // LIBIM_MATERIAL_SER_HELPERS_H
@@ -4,13 +4,19 @@
 #include "bmp.h"
 
 #include <libim/math/math.h>
+#include <libim/trace/trace.h>
+#include <libim/utils/parallel.h>
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include <png.h>
 #include <zlib.h>
@@ -46,6 +52,7 @@ void pixdataFlipOverY(uint32_t bpp, uint32_t width, uint32_t height, Pixdata& pi
 
 Texture libim::content::asset::pngLoad(const InputStream& istream)
 {
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "pngLoad", istream, istream.name());
     /* Read PNG file signature */
     auto pngsig = istream.read<std::array<png_byte, 8>>();
     if (!png_check_sig(pngsig.data(), pngsig.size())) {
@@ -148,8 +155,247 @@ Texture libim::content::asset::pngLoad(const InputStream& istream)
     return Texture(width, height, 1, cf, std::move(ptrPixdata));
 }
 
+static constexpr std::array<byte_t, 8> kPngSignature = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+static int pngFilterMask(PngWriteOptions::Filter filter)
+{
+    switch (filter)
+    {
+        case PngWriteOptions::Filter::None:    return PNG_FILTER_NONE;
+        case PngWriteOptions::Filter::Sub:     return PNG_FILTER_SUB;
+        case PngWriteOptions::Filter::Up:      return PNG_FILTER_UP;
+        case PngWriteOptions::Filter::Average: return PNG_FILTER_AVG;
+        case PngWriteOptions::Filter::Paeth:   return PNG_FILTER_PAETH;
+        default:                               return PNG_ALL_FILTERS;
+    }
+}
+
+static void pngWriteU32(OutputStream& ostream, uint32_t v)
+{
+    const std::array<byte_t, 4> be = { byte_t(v >> 24), byte_t(v >> 16), byte_t(v >> 8), byte_t(v) };
+    if (ostream.write(be.data(), be.size()) != be.size()) {
+        throw StreamError("Error writing texture as PNG file format to stream");
+    }
+}
+
+// Writes PNG chunk: length, type, data and CRC of type and data
+static void pngWriteChunk(OutputStream& ostream, std::string_view type, const byte_t* data, std::size_t size)
+{
+    if (size > 0x7FFFFFFF) {
+        throw StreamError("PNG chunk data too big");
+    }
+
+    pngWriteU32(ostream, static_cast<uint32_t>(size));
+    auto crc = crc32(0L, reinterpret_cast<const Bytef*>(type.data()), static_cast<uInt>(type.size()));
+    if (ostream.write(reinterpret_cast<const byte_t*>(type.data()), type.size()) != type.size()) {
+        throw StreamError("Error writing texture as PNG file format to stream");
+    }
+
+    if (size > 0)
+    {
+        crc = crc32(crc, data, static_cast<uInt>(size));
+        if (ostream.write(data, size) != size) {
+            throw StreamError("Error writing texture as PNG file format to stream");
+        }
+    }
+    pngWriteU32(ostream, static_cast<uint32_t>(crc));
+}
+
+static inline byte_t pngPaethPredictor(int a, int b, int c)
+{
+    const int p  = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return byte_t(a);
+    if (pb <= pc) return byte_t(b);
+    return byte_t(c);
+}
+
+// Filters image row with PNG filter type (0 = None, 1 = Sub, 2 = Up, 3 = Average, 4 = Paeth) and writes filter type byte followed by filtered row to pOut.
+// pPrev is nullptr for the first row.
+static void pngFilterRow(int type, const byte_t* pRow, const byte_t* pPrev, std::size_t rowLen, std::size_t bpp, byte_t* pOut)
+{
+    *pOut++ = byte_t(type);
+    for (std::size_t x = 0; x < rowLen; x++)
+    {
+        const int a = x >= bpp ? pRow[x - bpp] : 0;
+        const int b = pPrev ? pPrev[x] : 0;
+        const int c = pPrev && x >= bpp ? pPrev[x - bpp] : 0;
+        switch (type)
+        {
+            case 0:  pOut[x] = pRow[x]; break;
+            case 1:  pOut[x] = byte_t(pRow[x] - a); break;
+            case 2:  pOut[x] = byte_t(pRow[x] - b); break;
+            case 3:  pOut[x] = byte_t(pRow[x] - ((a + b) >> 1)); break;
+            default: pOut[x] = byte_t(pRow[x] - pngPaethPredictor(a, b, c)); break;
+        }
+    }
+}
+
+// Filters image row with the filter type which produces the minimum sum of absolute differences (libpng heuristic).
+static void pngFilterRowAdaptive(const byte_t* pRow, const byte_t* pPrev, std::size_t rowLen, std::size_t bpp, byte_t* pOut, std::vector<byte_t>& tmp)
+{
+    tmp.resize(rowLen + 1);
+    uint64_t minSum = std::numeric_limits<uint64_t>::max();
+    for (int type = 0; type <= 4; type++)
+    {
+        pngFilterRow(type, pRow, pPrev, rowLen, bpp, tmp.data());
+        uint64_t sum = 0;
+        for (std::size_t x = 1; x <= rowLen; x++) {
+            sum += static_cast<uint64_t>(tmp[x] < 128 ? tmp[x] : 256 - tmp[x]);
+        }
+
+        if (sum < minSum)
+        {
+            minSum = sum;
+            std::copy(tmp.begin(), tmp.end(), pOut);
+        }
+    }
+}
+
+// Writes texture in PNG format with rows filtered and compressed in parallel chunks.
+// Each chunk is compressed as a raw deflate block sequence with the previous 32 KiB of data
+// as dictionary and concatenated into single zlib stream.
+static void pngWriteParallel(OutputStream& ostream, const TextureView& tex, const PngWriteOptions& options, std::size_t maxThreads)
+{
+    const auto ci       = tex.format();
+    const auto destCi   = ci.mode == ColorMode::RGB ? RGB24be : RGBA32be;
+    const bool convert  = !(ci == destCi);
+    const auto bpp      = std::size_t(bbs(destCi.bpp));
+    const auto width    = std::size_t(tex.width());
+    const auto height   = std::size_t(tex.height());
+    const auto rowLen   = width * bpp;
+    const auto rowLenSrc = width * bbs(ci.bpp);
+    const auto filtRowLen = rowLen + 1; // filter type byte + row
+
+    const auto rowsPerChunk = std::max<std::size_t>(1, options.parallelChunkSize / filtRowLen);
+    const auto numChunks    = (height + rowsPerChunk - 1) / rowsPerChunk;
+    const int  level        = options.compressionLevel < 0 ? Z_DEFAULT_COMPRESSION : std::min(options.compressionLevel, Z_BEST_COMPRESSION);
+
+    auto getRow = [&](std::size_t r, std::vector<byte_t>& buf) -> const byte_t* {
+        const byte_t* pRow = &(*tex.begin()) + r * tex.stride();
+        if (!convert) {
+            return pRow;
+        }
+        buf.resize(rowLen);
+        convertPixdataRow(pRow, uint32_t(rowLenSrc), ci, buf.data(), uint32_t(rowLen), destCi);
+        return buf.data();
+    };
+
+    /* Filter rows */
+    std::vector<byte_t> filtered(filtRowLen * height);
+    utils::parallelFor(numChunks, [&](std::size_t i) {
+        std::vector<byte_t> rowBuf, prevBuf, tmp;
+        const auto first = i * rowsPerChunk;
+        const auto last  = std::min(height, first + rowsPerChunk);
+        const byte_t* pPrev = first > 0 ? getRow(first - 1, prevBuf) : nullptr;
+        for (auto r = first; r < last; r++)
+        {
+            const byte_t* pRow = getRow(r, rowBuf);
+            byte_t* pOut = filtered.data() + r * filtRowLen;
+            if (options.filter == PngWriteOptions::Filter::Adaptive) {
+                pngFilterRowAdaptive(pRow, pPrev, rowLen, bpp, pOut, tmp);
+            }
+            else {
+                pngFilterRow(static_cast<int>(options.filter), pRow, pPrev, rowLen, bpp, pOut);
+            }
+
+            if (convert) {
+                std::swap(rowBuf, prevBuf);
+                pPrev = prevBuf.data();
+            }
+            else {
+                pPrev = pRow;
+            }
+        }
+    }, maxThreads);
+
+    /* Compress chunks */
+    struct Chunk
+    {
+        ByteArray data;
+        uLong adler;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> chunks(numChunks);
+    utils::parallelFor(numChunks, [&](std::size_t i) {
+        const auto offset  = i * rowsPerChunk * filtRowLen;
+        const auto size    = std::min(filtered.size(), offset + rowsPerChunk * filtRowLen) - offset;
+        const bool isLast  = i + 1 == numChunks;
+        const auto pData   = filtered.data() + offset;
+
+        z_stream zs {};
+        if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw StreamError("Error initializing PNG deflate stream");
+        }
+        AT_SCOPE_EXIT([&zs]() {
+            deflateEnd(&zs);
+        });
+
+        if (offset > 0)
+        {
+            const auto dictSize = std::min<std::size_t>(offset, 32768);
+            deflateSetDictionary(&zs, pData - dictSize, static_cast<uInt>(dictSize));
+        }
+
+        auto& chunk = chunks[i];
+        chunk.size  = size;
+        chunk.adler = adler32(1L, pData, static_cast<uInt>(size));
+        chunk.data.resize(deflateBound(&zs, static_cast<uLong>(size)) + 16); // + sync flush marker
+        zs.next_in   = pData;
+        zs.avail_in  = static_cast<uInt>(size);
+        zs.next_out  = chunk.data.data();
+        zs.avail_out = static_cast<uInt>(chunk.data.size());
+
+        const auto ret = deflate(&zs, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+        if ((isLast && ret != Z_STREAM_END) || (!isLast && (ret != Z_OK || zs.avail_in != 0))) {
+            throw StreamError("Error compressing PNG pixel data");
+        }
+        chunk.data.resize(zs.total_out);
+    }, maxThreads);
+
+    /* Write PNG */
+    if (ostream.write(kPngSignature.data(), kPngSignature.size()) != kPngSignature.size()) {
+        throw StreamError("Error writing texture as PNG file format to stream");
+    }
+
+    std::array<byte_t, 13> ihdr {};
+    for (std::size_t b = 0; b < 4; b++)
+    {
+        ihdr[b]     = byte_t(width  >> (24 - b * 8));
+        ihdr[4 + b] = byte_t(height >> (24 - b * 8));
+    }
+    ihdr[8] = 8; // bits per channel
+    ihdr[9] = ci.mode == ColorMode::RGB ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGBA;
+    pngWriteChunk(ostream, "IHDR", ihdr.data(), ihdr.size());
+
+    // Wrap deflate data into zlib stream: header + data + adler32 checksum of uncompressed data
+    uLong adler = 1L;
+    for (const auto& c : chunks) {
+        adler = adler32_combine(adler, c.adler, static_cast<z_off_t>(c.size));
+    }
+
+    const byte_t flevel = level == 0 || level == 1 ? 0x01 : level > 1 && level < 6 ? 0x5E : level > 6 ? 0xDA : 0x9C;
+    chunks.front().data.insert(chunks.front().data.begin(), { 0x78, flevel });
+    chunks.back().data.insert(chunks.back().data.end(), { byte_t(adler >> 24), byte_t(adler >> 16), byte_t(adler >> 8), byte_t(adler) });
+
+    for (const auto& c : chunks) {
+        pngWriteChunk(ostream, "IDAT", c.data.data(), c.data.size());
+    }
+    pngWriteChunk(ostream, "IEND", nullptr, 0);
+    ostream.flush();
+}
+
 void libim::content::asset::pngWrite(OutputStream& ostream, const TextureView& tex)
 {
+    pngWrite(ostream, tex, PngWriteOptions{});
+}
+
+void libim::content::asset::pngWrite(OutputStream& ostream, const TextureView& tex, const PngWriteOptions& options)
+{
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "pngWrite", ostream, ostream.name());
     // Note: PNG file format stores pixel channels in big-endian RGB8 ot RGBA8 format.
     //       Texture which has color depth less then 24 BPP (e.g.16bit) is converted
     //       to RGB24be or RGBA24be color format to unpack color channels to 1 byte per channel.
@@ -172,7 +418,14 @@ void libim::content::asset::pngWrite(OutputStream& ostream, const TextureView& t
         auto destCi     = ci.mode == ColorMode::RGB ? RGB24be : RGBA32be;
         auto ptrPixData = convertPixdata(tex.begin(), tex.end(), tex.width(), tex.height(), ci, destCi);
         auto convTex    = Texture(tex.width(), tex.height(), 1, destCi, std::move(ptrPixData));
-        return pngWrite(ostream, convTex);
+        return pngWrite(ostream, convTex, options);
+    }
+
+    /* Compress large image in parallel */
+    const auto maxThreads = options.maxThreads == 0 ? utils::hardwareConcurrency() : options.maxThreads;
+    const auto imageSize  = std::size_t(tex.width()) * bbs(ci.bpp) * tex.height();
+    if (maxThreads > 1 && imageSize >= options.parallelMinSize && imageSize > options.parallelChunkSize) {
+        return pngWriteParallel(ostream, tex, options, maxThreads);
     }
 
     png_structp pngPtr = png_create_write_struct(png_get_libpng_ver(nullptr), nullptr, nullptr, nullptr);
@@ -227,6 +480,10 @@ void libim::content::asset::pngWrite(OutputStream& ostream, const TextureView& t
         PNG_FILTER_TYPE_BASE
     );
 
+    /* Set compression speed/size trade-off */
+    png_set_compression_level(pngPtr, options.compressionLevel < 0 ? Z_DEFAULT_COMPRESSION : std::min(options.compressionLevel, Z_BEST_COMPRESSION));
+    png_set_filter(pngPtr, PNG_FILTER_TYPE_BASE, pngFilterMask(options.filter));
+
     /* Write info */
     png_write_info(pngPtr, infoPtr);
 
@@ -327,6 +584,7 @@ void bmpReadImageInfo(const InputStream& istream, int32_t& width, int32_t& heigh
 
 Texture libim::content::asset::bmpLoad(const InputStream& istream)
 {
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "bmpLoad", istream, istream.name());
     /* Read header */
     BitmapFileHeader header{};
     if (istream.read(reinterpret_cast<byte_t*>(&header), sizeof(header)) != sizeof(header)) {
@@ -398,6 +656,7 @@ void bmpWriteInfoHeader(OutputStream& ostream, uint32_t width, int32_t height, c
 
 void libim::content::asset::bmpWrite(OutputStream& ostream, const TextureView& texView)
 {
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "bmpWrite", ostream, ostream.name());
     if (texView.isEmpty()) {
         throw std::invalid_argument("Can't write empty texture as BMP file format to stream");
     }
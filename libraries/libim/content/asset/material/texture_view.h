@@ -106,6 +106,15 @@ namespace libim::content::asset{
             return maxLevels == mipLevels_;
         }
 
+        /**
+         * Returns pointer to Pixdata of top mipmap texture at LOD idx 0.
+         * The pointed data is size() bytes long. The pointer must not be dereferenced if view is empty.
+         */
+        const byte_t* data() const
+        {
+            return std::to_address(itFirst_);
+        }
+
         /**
          * Returns Pixdata start iterator of top mipmap texture at LOD idx 0.
          * To get Pixdata start iterator for any other LOD mipmap call function mipmap.
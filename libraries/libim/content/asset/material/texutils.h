@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <iterator>
 #include <tuple>
 #include <type_traits>
@@ -24,6 +25,46 @@ namespace libim::content::asset {
      */
     Texture pngLoad(const InputStream& istream);
 
+    /** PNG encoder options which trade encoding speed for file size. */
+    struct PngWriteOptions
+    {
+        /** PNG row filter. Adaptive selects the best filter for each row (libpng default heuristic). */
+        enum class Filter
+        {
+            None     = 0,
+            Sub      = 1,
+            Up       = 2,
+            Average  = 3,
+            Paeth    = 4,
+            Adaptive = 5
+        };
+
+        int compressionLevel          = -1;               // zlib compression level 0 - 9, -1 = zlib default (6).
+        Filter filter                 = Filter::Adaptive;
+        std::size_t maxThreads        = 1;                // Max number of threads to compress image with. 0 = hardware concurrency, 1 = no parallel compression.
+        std::size_t parallelMinSize   = 1024 * 1024;      // Min image pixel data size in bytes to compress image in parallel.
+        std::size_t parallelChunkSize = 256 * 1024;       // Size of image pixel data in bytes compressed per thread.
+
+        /** Returns options with zlib compression level and the filter suited for the level. */
+        static constexpr PngWriteOptions withLevel(int level)
+        {
+            PngWriteOptions opt;
+            opt.compressionLevel = level;
+            opt.filter = level >= 0 && level <= 1 ? Filter::Up : Filter::Adaptive;
+            return opt;
+        }
+
+        /** Returns options for fast encoding: zlib level 1 and Up filter. */
+        static constexpr PngWriteOptions fast() {
+            return withLevel(1);
+        }
+
+        /** Returns options for the fastest encoding: uncompressed deflate (store) and Up filter. */
+        static constexpr PngWriteOptions store() {
+            return withLevel(0);
+        }
+    };
+
     /**
      * Writes Texture to stream as PNG (Portable Network Graphics) file format.
      *
@@ -32,6 +73,18 @@ namespace libim::content::asset {
      */
     void pngWrite(OutputStream& ostream, const TextureView& tex);
 
+    /**
+     * Writes Texture to stream as PNG (Portable Network Graphics) file format.
+     * When image pixel data is bigger than options.parallelMinSize, the pixel data
+     * is split into chunks which are filtered and compressed in parallel on options.maxThreads threads.
+     *
+     * @param ostream - reference to output stream.
+     * @param tex     - const reference to TextureView object to write to stream.
+     * @param options - const reference to encoder options.
+     * @throw StreamError if tex is empty or tex can't be written to stream.
+     */
+    void pngWrite(OutputStream& ostream, const TextureView& tex, const PngWriteOptions& options);
+
     /**
      * Writes Texture to stream as PNG (Portable Network Graphics) file format.
      *
@@ -43,6 +96,18 @@ namespace libim::content::asset {
         pngWrite(ostream, tex);
     }
 
+    /**
+     * Writes Texture to stream as PNG (Portable Network Graphics) file format.
+     *
+     * @param ostream - r-value reference to output stream.
+     * @param tex     - const reference to TextureView object to write to stream.
+     * @param options - const reference to encoder options.
+     * @throw StreamError if tex is empty or tex can't be written to stream.
+     */
+    inline void pngWrite(OutputStream&& ostream, const TextureView& tex, const PngWriteOptions& options) {
+        pngWrite(ostream, tex, options);
+    }
+
     /**
      * Loads Texture from BMP (Bitmap) file format stream.
      *
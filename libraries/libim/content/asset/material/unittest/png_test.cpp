@@ -0,0 +1,93 @@
+#include "png_test.h"
+#include "../texture.h"
+#include "../texture_view.h"
+#include "../texutils.h"
+
+#include <libim/io/binarystream.h>
+
+#include <assert.h>
+#include <cstdint>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+static Texture makeTexture(uint32_t width, uint32_t height, const ColorFormat& cf)
+{
+    auto pixdata = makePixdataPtr(calcStride(width, cf) * height);
+    for (std::size_t i = 0; i < pixdata->size(); i++) {
+        pixdata->at(i) = static_cast<byte_t>((i * 7 + i / 13) & 0xFF);
+    }
+    return Texture(width, height, 1, cf, std::move(pixdata));
+}
+
+static void assertPngRoundtrip(const Texture& tex, const PngWriteOptions& options)
+{
+    ByteArray data;
+    OutputBinaryStream ostream(data);
+    pngWrite(ostream, tex, options);
+
+    InputBinaryStream istream(data);
+    auto ptex = pngLoad(istream);
+    const auto cf = tex.format().mode == ColorMode::RGB ? RGB24be : RGBA32be;
+    assert(ptex.width() == tex.width());
+    assert(ptex.height() == tex.height());
+    assert(ptex.format() == cf);
+
+    auto expected = convertPixdata(tex.pixdata(), tex.width(), tex.height(), tex.format(), cf);
+    assert(*ptex.pixdata() == *expected);
+}
+
+void libim::unit_test::run_png_tests()
+{
+// Test case 1: Image is encoded with every filter and compression level
+    {
+        const auto tex = makeTexture(37, 23, RGBA32be);
+        for (auto filter : { PngWriteOptions::Filter::None, PngWriteOptions::Filter::Sub,
+                             PngWriteOptions::Filter::Up, PngWriteOptions::Filter::Average,
+                             PngWriteOptions::Filter::Paeth, PngWriteOptions::Filter::Adaptive })
+        {
+            for (int level : { -1, 0, 1, 9 })
+            {
+                PngWriteOptions opt;
+                opt.compressionLevel = level;
+                opt.filter           = filter;
+                opt.maxThreads       = 1;
+                assertPngRoundtrip(tex, opt);
+            }
+        }
+
+        assertPngRoundtrip(tex, PngWriteOptions::fast());
+        assertPngRoundtrip(tex, PngWriteOptions::store());
+    }
+
+// Test case 2: Image is compressed in parallel chunks
+    {
+        for (const auto& cf : { RGB24be, RGBA32be, RGB24, ARGB32 })
+        {
+            const auto tex = makeTexture(61, 97, cf);
+            for (auto filter : { PngWriteOptions::Filter::Up, PngWriteOptions::Filter::Paeth, PngWriteOptions::Filter::Adaptive })
+            {
+                for (int level : { -1, 0, 1, 9 })
+                {
+                    PngWriteOptions opt;
+                    opt.compressionLevel  = level;
+                    opt.filter            = filter;
+                    opt.maxThreads        = 4;
+                    opt.parallelMinSize   = 0;
+                    opt.parallelChunkSize = 1000;
+                    assertPngRoundtrip(tex, opt);
+                }
+            }
+        }
+    }
+
+// Test case 3: 16 bit image is converted and image with single chunk is written
+    {
+        PngWriteOptions opt;
+        opt.maxThreads      = 4;
+        opt.parallelMinSize = 0;
+        assertPngRoundtrip(makeTexture(16, 16, RGB565), opt);
+        assertPngRoundtrip(makeTexture(16, 16, ARGB1555), opt);
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef LIBIM_PNG_TEST_H
+#define LIBIM_PNG_TEST_H
+
+namespace libim::unit_test {
+    void run_png_tests();
+}
+
+#endif // LIBIM_PNG_TEST_H
@@ -2,6 +2,7 @@
 #define LIBIM_FACE_H
 
 #include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <vector>
 #include <tuple>
@@ -43,6 +44,13 @@ namespace libim::content::asset {
             std::optional<std::size_t> uvIdx;  // index in UV list
         };
 
+        Face() = default;
+
+        /** Constructs face which allocates vertex list from memory resource mr. */
+        explicit Face(std::pmr::memory_resource* mr) :
+            vertices(mr)
+        {}
+
         Flags<Flag> flags;
         GeoMode geoMode;
         LightMode lightMode;
@@ -50,7 +58,7 @@ namespace libim::content::asset {
         std::size_t matCelIdx = 0; // material texture to use (material mipmap idx)
         LinearColor extraLight;    // face additional light color
         Vector3f normal;
-        std::vector<VertexIdx> vertices;
+        std::pmr::vector<VertexIdx> vertices;
     };
 
 
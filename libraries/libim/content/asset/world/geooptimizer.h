@@ -0,0 +1,64 @@
+#ifndef LIBIM_GEOOPTIMIZER_H
+#define LIBIM_GEOOPTIMIZER_H
+#include <cstddef>
+#include <span>
+
+#include "georesource.h"
+#include "sector.h"
+
+namespace libim::content::asset {
+
+    /** Options of world geometry optimization. */
+    struct GeoOptimizeOptions final
+    {
+        float vertexEpsilon = 1e-5f; // Max distance of welded vertices along each axis. 0 = weld only equal vertices.
+        float uvEpsilon     = 1e-4f; // Max distance of welded texture vertices along each axis. 0 = weld only equal texture vertices.
+        std::size_t maxThreads = 0;  // Max number of threads to remap indices. 0 = all hardware threads.
+    };
+
+    /** Result of world geometry optimization. */
+    struct GeoOptimizeStats final
+    {
+        std::size_t numVertices       = 0; // number of vertices before optimization
+        std::size_t numWeldedVertices = 0; // number of vertices welded with equal vertex
+        std::size_t numUnusedVertices = 0; // number of removed vertices not referenced by any surface or sector
+        std::size_t numTexVertices       = 0;
+        std::size_t numWeldedTexVertices = 0;
+        std::size_t numUnusedTexVertices = 0;
+        std::size_t numCollapsedSurfVertices = 0; // number of removed surface vertices equal to the previous surface vertex after welding
+        std::size_t numDegenerateSurfaces    = 0; // number of surfaces left with less than 3 vertices after welding
+
+        std::size_t numRemovedVertices() const
+        {
+            return numWeldedVertices + numUnusedVertices;
+        }
+
+        std::size_t numRemovedTexVertices() const
+        {
+            return numWeldedTexVertices + numUnusedTexVertices;
+        }
+    };
+
+    /**
+     * Optimizes world geometry by welding equal vertices and texture vertices and
+     * removing vertices and texture vertices which are not referenced by any surface or sector.
+     *
+     * Vertices are welded by spatial hashing with grid cell size of 2 * epsilon.
+     * Each vertex is welded with the first preceding vertex within epsilon along each axis,
+     * welded vertices are not merged transitively. The order of the remaining vertices is preserved.
+     * Surface and sector vertex indices are remapped in parallel,
+     * duplicated sector vertex indices are removed.
+     * Consecutive surface vertices welded into the same vertex, including the last and the first vertex,
+     * are collapsed into the first one, together with their vertex intensities.
+     * Surfaces left with less than 3 vertices are not removed, they are counted in GeoOptimizeStats::numDegenerateSurfaces.
+     *
+     * @param geo     - world georesource.
+     * @param sectors - world sectors.
+     * @param options - optimization options.
+     * @return GeoOptimizeStats
+     * @throw std::invalid_argument if any surface or sector references vertex or texture vertex out of range
+     *        or epsilon is negative.
+     */
+    GeoOptimizeStats optimizeGeometry(Georesource& geo, std::span<Sector> sectors, const GeoOptimizeOptions& options = {});
+}
+#endif // LIBIM_GEOOPTIMIZER_H
@@ -0,0 +1,325 @@
+#include "../geooptimizer.h"
+
+#include <libim/trace/trace.h>
+#include <libim/utils/hash.h>
+#include <libim/utils/parallel.h>
+#include <libim/utils/utils.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::asset;
+using namespace libim::utils;
+
+static constexpr std::size_t kNoIdx          = std::numeric_limits<std::size_t>::max();
+static constexpr double      kMaxGridCell    = 4611686018427387904.0; // 2^62
+static constexpr std::size_t kRemapChunkSize = 1024; // number of surfaces or sectors remapped by single job
+
+namespace {
+    template<std::size_t N>
+    using GridCell = std::array<int64_t, N>;
+
+    template<std::size_t N>
+    struct GridCellHash
+    {
+        std::size_t operator()(const GridCell<N>& c) const noexcept
+        {
+            return static_cast<std::size_t>(hash64(c.data(), sizeof(c)));
+        }
+    };
+}
+
+/**
+ * Returns grid cell of point or std::nullopt if point can't be welded,
+ * i.e. point is not finite or it's too far from the origin.
+ * Grid cell size is 2 * epsilon, so points within epsilon can only be in the same cell or
+ * in the neighbour cell on the side of cell half the point is in. The side is returned in dirs.
+ * When epsilon is 0, the cell is the bit pattern of the point coordinates.
+ */
+template<typename VecT, std::size_t N = VecT::size()>
+static std::optional<GridCell<N>> gridCell(const VecT& p, float epsilon, GridCell<N>& dirs)
+{
+    GridCell<N> c;
+    for (std::size_t i = 0; i < N; i++)
+    {
+        const float v = p.at(i);
+        if (!std::isfinite(v)) {
+            return std::nullopt;
+        }
+
+        if (epsilon == 0.0f)
+        {
+            c[i]    = std::bit_cast<int32_t>(v + 0.0f); // -0 + 0 = +0
+            dirs[i] = 0;
+        }
+        else
+        {
+            const double q = double(v) / (2.0 * double(epsilon));
+            const double f = std::floor(q);
+            if (std::abs(f) > kMaxGridCell) {
+                return std::nullopt;
+            }
+            c[i]    = static_cast<int64_t>(f);
+            dirs[i] = q - f < 0.5 ? -1 : 1;
+        }
+    }
+    return c;
+}
+
+template<typename VecT>
+static bool isWithin(const VecT& a, const VecT& b, float epsilon)
+{
+    for (std::size_t i = 0; i < VecT::size(); i++)
+    {
+        if (!(std::abs(a.at(i) - b.at(i)) <= epsilon)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Welds points which are within epsilon along each axis.
+ * Point is welded with the first preceding point which is within epsilon and was not welded itself.
+ * Points are hashed into grid of 2 * epsilon sized cells, so only the points in 2^N neighbour cells are compared.
+ *
+ * @return list of indices of points each point is welded with, or its own index when point was not welded.
+ */
+template<typename VecT, std::size_t N = VecT::size()>
+static std::vector<std::size_t> weldPoints(const std::vector<VecT>& points, float epsilon)
+{
+    const std::size_t numNeighbours = epsilon == 0.0f ? 1 : std::size_t(1) << N;
+
+    std::vector<std::size_t> welds(points.size());
+    std::vector<std::size_t> next(points.size(), kNoIdx); // next not welded point in the same cell
+    std::unordered_map<GridCell<N>, std::size_t, GridCellHash<N>> cells; // cell -> first not welded point in cell
+    cells.reserve(points.size());
+
+    for (std::size_t i = 0; i < points.size(); i++)
+    {
+        welds[i] = i;
+        GridCell<N> dirs;
+        const auto cell = gridCell(points[i], epsilon, dirs);
+        if (!cell) {
+            continue;
+        }
+
+        for (std::size_t n = 0; n < numNeighbours; n++)
+        {
+            auto ncell = *cell;
+            for (std::size_t a = 0; a < N; a++)
+            {
+                if (n & (std::size_t(1) << a)) {
+                    ncell[a] += dirs[a];
+                }
+            }
+
+            auto it = cells.find(ncell);
+            if (it == cells.end()) {
+                continue;
+            }
+
+            for (auto j = it->second; j != kNoIdx; j = next[j])
+            {
+                if (j < welds[i] && isWithin(points[i], points[j], epsilon)) {
+                    welds[i] = j;
+                }
+            }
+        }
+
+        if (welds[i] == i)
+        {
+            auto [it, inserted] = cells.try_emplace(*cell, i);
+            if (!inserted)
+            {
+                next[i]    = it->second;
+                it->second = i;
+            }
+        }
+    }
+    return welds;
+}
+
+/**
+ * Removes welded and unused points from the list.
+ * @param points - list of points.
+ * @param welds  - list of welded point indices returned by weldPoints.
+ *                 On return it holds the new index of each point or kNoIdx if point was removed as unused.
+ * @param used   - list of flags marking points referenced by world geometry.
+ */
+template<typename VecT>
+static void compactPoints(std::vector<VecT>& points, std::vector<std::size_t>& welds, const std::vector<uint8_t>& used, std::size_t& numWelded, std::size_t& numUnused)
+{
+    std::vector<std::size_t> newIdxs(points.size(), kNoIdx);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < points.size(); i++)
+    {
+        if (welds[i] != i) {
+            numWelded++;
+        }
+        else if (!used[i]) {
+            numUnused++;
+        }
+        else
+        {
+            newIdxs[i] = count;
+            points[count++] = points[i];
+        }
+    }
+    points.resize(count);
+
+    for (auto& idx : welds) {
+        idx = newIdxs[idx];
+    }
+}
+
+GeoOptimizeStats libim::content::asset::optimizeGeometry(Georesource& geo, std::span<Sector> sectors, const GeoOptimizeOptions& options)
+{
+    LIBIM_TRACE_SCOPE("world", "optimizeGeometry");
+    if (!(options.vertexEpsilon >= 0.0f) || !(options.uvEpsilon >= 0.0f)) {
+        throw std::invalid_argument("Geometry weld epsilon must not be negative");
+    }
+
+    // Verify indices first, so geometry is not modified when it's invalid
+    const auto numVerts    = geo.vertices.size();
+    const auto numTexVerts = geo.texVertices.size();
+    for (const auto& surf : geo.surfaces)
+    {
+        for (const auto& v : surf.vertices)
+        {
+            if (v.vertIdx >= numVerts) {
+                throw std::invalid_argument(format("Surface % references vertex % out of range", surf.id, v.vertIdx));
+            }
+            if (v.uvIdx && *v.uvIdx >= numTexVerts) {
+                throw std::invalid_argument(format("Surface % references texture vertex % out of range", surf.id, *v.uvIdx));
+            }
+        }
+    }
+
+    for (const auto& sec : sectors)
+    {
+        for (const auto idx : sec.vertIdxs)
+        {
+            if (idx >= numVerts) {
+                throw std::invalid_argument(format("Sector % references vertex % out of range", sec.id, idx));
+            }
+        }
+    }
+
+    GeoOptimizeStats stats;
+    stats.numVertices    = numVerts;
+    stats.numTexVertices = numTexVerts;
+
+    auto vertIdxs = weldPoints(geo.vertices, options.vertexEpsilon);
+    auto uvIdxs   = weldPoints(geo.texVertices, options.uvEpsilon);
+
+    std::vector<uint8_t> usedVerts(numVerts, 0);
+    std::vector<uint8_t> usedTexVerts(numTexVerts, 0);
+    for (const auto& surf : geo.surfaces)
+    {
+        for (const auto& v : surf.vertices)
+        {
+            usedVerts[vertIdxs[v.vertIdx]] = 1;
+            if (v.uvIdx) {
+                usedTexVerts[uvIdxs[*v.uvIdx]] = 1;
+            }
+        }
+    }
+
+    for (const auto& sec : sectors)
+    {
+        for (const auto idx : sec.vertIdxs) {
+            usedVerts[vertIdxs[idx]] = 1;
+        }
+    }
+
+    compactPoints(geo.vertices, vertIdxs, usedVerts, stats.numWeldedVertices, stats.numUnusedVertices);
+    compactPoints(geo.texVertices, uvIdxs, usedTexVerts, stats.numWeldedTexVertices, stats.numUnusedTexVertices);
+
+    // Remap indices of surfaces and sectors in chunks
+    std::atomic_size_t numCollapsed  = 0;
+    std::atomic_size_t numDegenerate = 0;
+    const auto numSurfChunks = (geo.surfaces.size() + kRemapChunkSize - 1) / kRemapChunkSize;
+    const auto numSecChunks  = (sectors.size() + kRemapChunkSize - 1) / kRemapChunkSize;
+    parallelFor(numSurfChunks + numSecChunks, [&](std::size_t chunk)
+    {
+        if (chunk < numSurfChunks)
+        {
+            const auto first = chunk * kRemapChunkSize;
+            const auto last  = std::min(geo.surfaces.size(), first + kRemapChunkSize);
+            std::size_t nCollapsed = 0, nDegenerate = 0;
+            for (auto i = first; i < last; i++)
+            {
+                // Consecutive vertices welded into the same vertex would make zero-length edges
+                auto& verts = geo.surfaces[i].vertices;
+                auto& intensities = geo.surfaces[i].vecIntensities;
+                const bool hasIntensities = intensities.size() == verts.size();
+                std::size_t n = 0;
+                for (std::size_t vi = 0; vi < verts.size(); vi++)
+                {
+                    auto v = verts[vi];
+                    v.vertIdx = vertIdxs[v.vertIdx];
+                    if (v.uvIdx) {
+                        v.uvIdx = uvIdxs[*v.uvIdx];
+                    }
+
+                    if (n > 0 && verts[n - 1].vertIdx == v.vertIdx) {
+                        continue;
+                    }
+                    if (hasIntensities) {
+                        intensities[n] = intensities[vi];
+                    }
+                    verts[n++] = v;
+                }
+
+                while (n > 1 && verts[n - 1].vertIdx == verts[0].vertIdx) {
+                    n--;
+                }
+
+                if (n < verts.size())
+                {
+                    nCollapsed += verts.size() - n;
+                    nDegenerate += n < 3 ? 1 : 0;
+                    verts.erase(verts.begin() + static_cast<std::ptrdiff_t>(n), verts.end());
+                    if (hasIntensities) {
+                        intensities.erase(intensities.begin() + static_cast<std::ptrdiff_t>(n), intensities.end());
+                    }
+                }
+            }
+            numCollapsed  += nCollapsed;
+            numDegenerate += nDegenerate;
+        }
+        else
+        {
+            const auto first = (chunk - numSurfChunks) * kRemapChunkSize;
+            const auto last  = std::min(sectors.size(), first + kRemapChunkSize);
+            for (auto i = first; i < last; i++)
+            {
+                auto& idxs = sectors[i].vertIdxs;
+                auto end = idxs.begin();
+                for (auto it = idxs.begin(); it != idxs.end(); ++it)
+                {
+                    const auto idx = vertIdxs[*it];
+                    if (std::find(idxs.begin(), end, idx) == end) {
+                        *end++ = idx;
+                    }
+                }
+                idxs.erase(end, idxs.end());
+            }
+        }
+    }, options.maxThreads);
+
+    stats.numCollapsedSurfVertices = numCollapsed;
+    stats.numDegenerateSurfaces    = numDegenerate;
+    return stats;
+}
@@ -0,0 +1,490 @@
+#include "../lightbaker.h"
+
+#include <libim/trace/trace.h>
+#include <libim/utils/parallel.h>
+#include <libim/utils/utils.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::asset;
+using namespace libim::utils;
+
+static constexpr std::size_t kNoIdx          = std::numeric_limits<std::size_t>::max();
+static constexpr std::size_t kBakeChunkSize  = 64; // number of surfaces baked by single job
+static constexpr uint32_t    kBvhLeafSize    = 4;  // max number of triangles in BVH leaf node
+static constexpr std::size_t kBvhMaxDepth    = 64;
+static constexpr float       kRayEpsilon     = 1e-6f;
+
+namespace {
+    struct Vec3
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+
+        float operator[](std::size_t axis) const
+        {
+            return axis == 0 ? x : (axis == 1 ? y : z);
+        }
+    };
+
+    inline Vec3 operator + (const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    inline Vec3 operator - (const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline Vec3 operator * (const Vec3& a, float s)       { return { a.x * s, a.y * s, a.z * s }; }
+
+    inline float dot(const Vec3& a, const Vec3& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    inline Vec3 cross(const Vec3& a, const Vec3& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    inline Vec3 toVec3(const Vector3f& v)
+    {
+        return { v.x(), v.y(), v.z() };
+    }
+
+    struct Aabb
+    {
+        Vec3 min = {  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max() };
+        Vec3 max = { -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+
+        void grow(const Vec3& p)
+        {
+            min = { std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z) };
+            max = { std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z) };
+        }
+
+        void grow(const Aabb& b)
+        {
+            grow(b.min);
+            grow(b.max);
+        }
+
+        /** Returns squared distance from point to the box, 0 if point is inside the box. */
+        float distance2(const Vec3& p) const
+        {
+            const float dx = std::max({ min.x - p.x, 0.0f, p.x - max.x });
+            const float dy = std::max({ min.y - p.y, 0.0f, p.y - max.y });
+            const float dz = std::max({ min.z - p.z, 0.0f, p.z - max.z });
+            return dx * dx + dy * dy + dz * dz;
+        }
+    };
+
+    struct PointLight
+    {
+        Vec3 position;
+        Vec3 color;
+        float falloffMin;
+        float falloffMax;
+    };
+
+    struct Triangle
+    {
+        Vec3 v0;
+        Vec3 e1; // v1 - v0
+        Vec3 e2; // v2 - v0
+        std::size_t surfIdx;
+    };
+
+    /**
+     * Bounding volume hierarchy of world surface triangles for casting shadow rays.
+     * Nodes are stored in depth-first order, the left child of inner node follows the node.
+     */
+    class SurfaceBvh final
+    {
+    public:
+        /** Builds BVH of triangles of surfaces which occlude light, i.e. all surfaces which are not adjoins. */
+        explicit SurfaceBvh(const Georesource& geo)
+        {
+            for (std::size_t s = 0; s < geo.surfaces.size(); s++)
+            {
+                const auto& surf = geo.surfaces[s];
+                if (surf.adjoinIdx || surf.vertices.size() < 3) {
+                    continue;
+                }
+
+                // Triangle fan of convex surface polygon
+                const Vec3 v0 = toVec3(geo.vertices[surf.vertices[0].vertIdx]);
+                for (std::size_t i = 1; i + 1 < surf.vertices.size(); i++)
+                {
+                    const Vec3 v1 = toVec3(geo.vertices[surf.vertices[i].vertIdx]);
+                    const Vec3 v2 = toVec3(geo.vertices[surf.vertices[i + 1].vertIdx]);
+                    tris_.push_back({ v0, v1 - v0, v2 - v0, s });
+                }
+            }
+
+            if (!tris_.empty())
+            {
+                std::vector<Aabb> boxes(tris_.size());
+                std::vector<Vec3> centroids(tris_.size());
+                for (std::size_t i = 0; i < tris_.size(); i++)
+                {
+                    const auto& t = tris_[i];
+                    boxes[i].grow(t.v0);
+                    boxes[i].grow(t.v0 + t.e1);
+                    boxes[i].grow(t.v0 + t.e2);
+                    centroids[i] = t.v0 + (t.e1 + t.e2) * (1.0f / 3.0f);
+                }
+
+                std::vector<uint32_t> idxs(tris_.size());
+                for (uint32_t i = 0; i < idxs.size(); i++) {
+                    idxs[i] = i;
+                }
+
+                nodes_.reserve(2 * tris_.size() / kBvhLeafSize + 1);
+                build(idxs, 0, static_cast<uint32_t>(idxs.size()), boxes, centroids, 0);
+
+                // Reorder triangles to leaf order
+                std::vector<Triangle> sorted;
+                sorted.reserve(tris_.size());
+                for (auto i : idxs) {
+                    sorted.push_back(tris_[i]);
+                }
+                tris_ = std::move(sorted);
+            }
+        }
+
+        /**
+         * Returns true if segment from origin to target intersects any triangle
+         * which doesn't belong to surface skipSurf.
+         */
+        bool occluded(const Vec3& origin, const Vec3& target, std::size_t skipSurf) const
+        {
+            if (nodes_.empty()) {
+                return false;
+            }
+
+            const Vec3 dir = target - origin;
+            const Vec3 invDir = { 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z };
+
+            std::array<uint32_t, kBvhMaxDepth + 1> stack;
+            std::size_t sp = 0;
+            stack[sp++] = 0;
+            while (sp > 0)
+            {
+                const auto& node = nodes_[stack[--sp]];
+                if (!intersects(node.box, origin, invDir)) {
+                    continue;
+                }
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = node.first; i < node.first + node.count; i++)
+                    {
+                        if (tris_[i].surfIdx != skipSurf && intersects(tris_[i], origin, dir)) {
+                            return true;
+                        }
+                    }
+                }
+                else
+                {
+                    stack[sp++] = static_cast<uint32_t>(&node - nodes_.data()) + 1; // left child
+                    stack[sp++] = node.first; // right child
+                }
+            }
+            return false;
+        }
+
+    private:
+        struct Node
+        {
+            Aabb box;
+            uint32_t first; // first triangle of leaf node or right child index of inner node
+            uint32_t count; // number of triangles of leaf node, 0 for inner node
+        };
+
+        void build(std::vector<uint32_t>& idxs, uint32_t first, uint32_t count,
+                   const std::vector<Aabb>& boxes, const std::vector<Vec3>& centroids, std::size_t depth)
+        {
+            const auto nodeIdx = nodes_.size();
+            nodes_.push_back({});
+
+            Aabb box, cbox;
+            for (uint32_t i = first; i < first + count; i++)
+            {
+                box.grow(boxes[idxs[i]]);
+                cbox.grow(centroids[idxs[i]]);
+            }
+            nodes_[nodeIdx].box = box;
+
+            const Vec3 extent = cbox.max - cbox.min;
+            const std::size_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+            if (count <= kBvhLeafSize || extent[axis] <= 0.0f || depth >= kBvhMaxDepth - 1)
+            {
+                nodes_[nodeIdx].first = first;
+                nodes_[nodeIdx].count = count;
+                return;
+            }
+
+            // Median split along the longest axis of centroid bounds
+            const uint32_t mid = first + count / 2;
+            std::nth_element(idxs.begin() + first, idxs.begin() + mid, idxs.begin() + first + count, [&](uint32_t a, uint32_t b) {
+                return centroids[a][axis] < centroids[b][axis];
+            });
+
+            build(idxs, first, mid - first, boxes, centroids, depth + 1);
+            nodes_[nodeIdx].first = static_cast<uint32_t>(nodes_.size());
+            nodes_[nodeIdx].count = 0;
+            build(idxs, mid, first + count - mid, boxes, centroids, depth + 1);
+        }
+
+        /** Slab test of segment origin + t * dir, t in [0, 1]. */
+        static bool intersects(const Aabb& box, const Vec3& origin, const Vec3& invDir)
+        {
+            float tmin = 0.0f;
+            float tmax = 1.0f;
+            for (std::size_t a = 0; a < 3; a++)
+            {
+                float t0 = (box.min[a] - origin[a]) * invDir[a];
+                float t1 = (box.max[a] - origin[a]) * invDir[a];
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                }
+                tmin = std::max(tmin, t0);
+                tmax = std::min(tmax, t1);
+                if (!(tmin <= tmax)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /** Moller-Trumbore intersection of segment origin + t * dir, t in (0, 1) with triangle. */
+        static bool intersects(const Triangle& tri, const Vec3& origin, const Vec3& dir)
+        {
+            const Vec3 p = cross(dir, tri.e2);
+            const float det = dot(tri.e1, p);
+            if (std::abs(det) < kRayEpsilon * kRayEpsilon) {
+                return false; // segment is parallel to triangle
+            }
+
+            const float invDet = 1.0f / det;
+            const Vec3 s = origin - tri.v0;
+            const float u = dot(s, p) * invDet;
+            if (u < 0.0f || u > 1.0f) {
+                return false;
+            }
+
+            const Vec3 q = cross(s, tri.e1);
+            const float v = dot(dir, q) * invDet;
+            if (v < 0.0f || u + v > 1.0f) {
+                return false;
+            }
+
+            const float t = dot(tri.e2, q) * invDet;
+            return t > kRayEpsilon && t < 1.0f - kRayEpsilon;
+        }
+
+    private:
+        std::vector<Triangle> tris_;
+        std::vector<Node> nodes_;
+    };
+}
+
+/** Returns true if vertex light is baked for surface. Sky surfaces and surfaces without vertices are not baked. */
+static bool isBakedSurface(const Surface& surf)
+{
+    return !(surf.surflags & Surface::HorizonSky) && !(surf.surflags & Surface::CeilingSky) && !surf.vertices.empty();
+}
+
+/** Returns surface normal, or the normal of surface polygon when surface normal is not set. */
+static Vec3 surfaceNormal(const Surface& surf, const Georesource& geo)
+{
+    Vec3 n = toVec3(surf.normal);
+    if (dot(n, n) == 0.0f)
+    {
+        // Newell's method
+        for (std::size_t i = 0; i < surf.vertices.size(); i++)
+        {
+            const Vec3 a = toVec3(geo.vertices[surf.vertices[i].vertIdx]);
+            const Vec3 b = toVec3(geo.vertices[surf.vertices[(i + 1) % surf.vertices.size()].vertIdx]);
+            n = n + Vec3{ (a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x), (a.x - b.x) * (a.y + b.y) };
+        }
+    }
+
+    const float len = std::sqrt(dot(n, n));
+    return len > 0.0f ? n * (1.0f / len) : n;
+}
+
+static std::vector<PointLight> getLights(std::span<const Sector> sectors, std::span<const CndThing> things, const LightBakeOptions& options)
+{
+    std::vector<PointLight> lights;
+    if (options.sectorLights)
+    {
+        for (const auto& sec : sectors)
+        {
+            const auto& l = sec.avgLight;
+            const Vec3 color = { l.color.red(), l.color.green(), l.color.blue() };
+            if (dot(color, color) > 0.0f && l.falloffMax > 0.0f) {
+                lights.push_back({ toVec3(l.position), color, std::clamp(l.falloffMin, 0.0f, l.falloffMax), l.falloffMax });
+            }
+        }
+    }
+
+    if (options.thingLights)
+    {
+        for (const auto& t : things)
+        {
+            const auto& c = t.light.color;
+            const Vec3 color = { c.red(), c.green(), c.blue() };
+            const float range = c.alpha() > 0.0f ? c.alpha() : options.thingLightRange;
+            if ((t.flags & Thing::Flag::EmitsLight) && dot(color, color) > 0.0f && range > 0.0f) {
+                lights.push_back({ toVec3(t.position), color, 0.0f, range });
+            }
+        }
+    }
+    return lights;
+}
+
+LightBakeStats libim::content::asset::bakeVertexLight(Georesource& geo, std::span<const Sector> sectors, std::span<const CndThing> things, const LightBakeOptions& options)
+{
+    LIBIM_TRACE_SCOPE("world", "bakeVertexLight");
+    for (const auto& surf : geo.surfaces)
+    {
+        for (const auto& v : surf.vertices)
+        {
+            if (v.vertIdx >= geo.vertices.size()) {
+                throw std::invalid_argument(format("Surface % references vertex % out of range", surf.id, v.vertIdx));
+            }
+        }
+    }
+
+    std::vector<std::size_t> surfSectors(geo.surfaces.size(), kNoIdx);
+    for (std::size_t i = 0; i < sectors.size(); i++)
+    {
+        const auto& s = sectors[i].surfaces;
+        if (s.firstIdx > geo.surfaces.size() || s.count > geo.surfaces.size() - s.firstIdx) {
+            throw std::invalid_argument(format("Sector % references surface out of range", sectors[i].id));
+        }
+        std::fill_n(surfSectors.begin() + static_cast<std::ptrdiff_t>(s.firstIdx), s.count, i);
+    }
+
+    LightBakeStats stats;
+    const auto lights = getLights(sectors, things, options);
+    stats.numLights = lights.size();
+
+    std::optional<SurfaceBvh> bvh;
+    if (options.shadows && !lights.empty()) {
+        bvh.emplace(geo);
+    }
+
+    std::atomic_size_t numSurfaces = 0;
+    std::atomic_size_t numVertices = 0;
+    std::atomic_size_t numRays     = 0;
+    std::atomic_size_t numOccluded = 0;
+
+    // Intensity lists are resized before baking, since surface lists can be allocated
+    // from memory resource which is not thread-safe, e.g. utils::Arena.
+    // Existing intensity alpha is kept only when the list has intensity for each vertex.
+    for (auto& surf : geo.surfaces)
+    {
+        if (isBakedSurface(surf) && surf.vecIntensities.size() != surf.vertices.size()) {
+            surf.vecIntensities.assign(surf.vertices.size(), LinearColor({ 0.0f, 0.0f, 0.0f, 1.0f }));
+        }
+    }
+
+    const auto numChunks = (geo.surfaces.size() + kBakeChunkSize - 1) / kBakeChunkSize;
+    parallelFor(numChunks, [&](std::size_t chunk)
+    {
+        std::size_t nSurfaces = 0, nVertices = 0, nRays = 0, nOccluded = 0;
+        std::vector<const PointLight*> surfLights;
+
+        const auto first = chunk * kBakeChunkSize;
+        const auto last  = std::min(geo.surfaces.size(), first + kBakeChunkSize);
+        for (auto si = first; si < last; si++)
+        {
+            auto& surf = geo.surfaces[si];
+            if (!isBakedSurface(surf)) {
+                continue;
+            }
+
+            // Lights which can reach any vertex of surface
+            Aabb box;
+            for (const auto& v : surf.vertices) {
+                box.grow(toVec3(geo.vertices[v.vertIdx]));
+            }
+
+            surfLights.clear();
+            for (const auto& l : lights)
+            {
+                if (box.distance2(l.position) < l.falloffMax * l.falloffMax) {
+                    surfLights.push_back(&l);
+                }
+            }
+
+            Vec3 ambient;
+            if (surfSectors[si] != kNoIdx)
+            {
+                const auto& a = sectors[surfSectors[si]].ambientLight;
+                ambient = { a.red(), a.green(), a.blue() };
+            }
+
+            const Vec3 normal = surfaceNormal(surf, geo);
+            for (std::size_t vi = 0; vi < surf.vertices.size(); vi++)
+            {
+                const Vec3 pos = toVec3(geo.vertices[surf.vertices[vi].vertIdx]);
+                Vec3 intensity = ambient;
+                for (const auto* l : surfLights)
+                {
+                    const Vec3 ldir = l->position - pos;
+                    const float dist = std::sqrt(dot(ldir, ldir));
+                    if (dist >= l->falloffMax) {
+                        continue;
+                    }
+
+                    const float cosa = dist > 0.0f ? dot(normal, ldir) / dist : 1.0f;
+                    if (cosa <= 0.0f) {
+                        continue; // light is behind surface
+                    }
+
+                    const float atten = dist <= l->falloffMin ? 1.0f : (l->falloffMax - dist) / (l->falloffMax - l->falloffMin);
+                    if (bvh)
+                    {
+                        nRays++;
+                        if (bvh->occluded(pos + normal * options.shadowBias, l->position, si))
+                        {
+                            nOccluded++;
+                            continue;
+                        }
+                    }
+                    intensity = intensity + l->color * (atten * cosa);
+                }
+
+                auto& out = surf.vecIntensities[vi];
+                out = LinearColor({
+                    std::clamp(intensity.x, 0.0f, options.maxIntensity),
+                    std::clamp(intensity.y, 0.0f, options.maxIntensity),
+                    std::clamp(intensity.z, 0.0f, options.maxIntensity),
+                    out.alpha()
+                });
+            }
+
+            nSurfaces++;
+            nVertices += surf.vertices.size();
+        }
+
+        numSurfaces += nSurfaces;
+        numVertices += nVertices;
+        numRays     += nRays;
+        numOccluded += nOccluded;
+    }, options.maxThreads);
+
+    stats.numSurfaces     = numSurfaces;
+    stats.numVertices     = numVertices;
+    stats.numRays         = numRays;
+    stats.numOccludedRays = numOccluded;
+    return stats;
+}
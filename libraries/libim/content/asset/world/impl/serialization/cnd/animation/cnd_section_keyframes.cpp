@@ -5,6 +5,7 @@
 
 #include <libim/content/asset/animation/animation.h>
 #include <libim/log/log.h>
+#include <libim/trace/trace.h>
 #include <libim/utils/utils.h>
 #include <libim/types/safe_cast.h>
 
@@ -25,8 +26,9 @@ std::size_t CND::getOffset_Keyframes(const InputStream& istream, const CndHeader
     return getOffset_Sprites(istream, header) + header.numSprites * sizeof(CndResourceName);
 }
 
-UniqueTable<Animation> CND::parseSection_Keyframes(const InputStream& istream, const CndHeader& header)
+UniqueTable<Animation> CND::parseSection_Keyframes(const InputStream& istream, const CndHeader& header, KeyframeLayout layout)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Keyframes", istream);
     try
     {
         UniqueTable<Animation>  animations;
@@ -67,13 +69,31 @@ UniqueTable<Animation> CND::parseSection_Keyframes(const InputStream& istream, c
             anim.setMarkers(std::move(markers));
 
             /* Copy key nodes and it's entries */
-            anim.nodes().resize(header.numNodes);
-            for(auto& node : anim.nodes())
+            if(layout == KeyframeLayout::Flat)
             {
-                node.meshName = utils::trim(nIt->meshName);
-                node.num = nIt->nodeNum;
-                neIt = utils::copy(neIt, nIt->numEntries, node.entries); // TODO: check bounds for nIt->numEntries
-                nIt++;
+                FlatKeyframes keyframes;
+                for(uint32_t n = 0; n < header.numNodes; n++)
+                {
+                    world_ser_assert(nIt != nodeList.end(), "Key node index out of range");
+                    world_ser_assert(nIt->numEntries <= std::size_t(nodeEntryList.end() - neIt), "Key node entry index out of range");
+                    keyframes.addNode(nIt->nodeNum, utils::trim(nIt->meshName));
+                    for(auto end = neIt + nIt->numEntries; neIt != end; neIt++) {
+                        keyframes.addEntry(*neIt);
+                    }
+                    nIt++;
+                }
+                anim.setFlatKeyframes(std::move(keyframes));
+            }
+            else
+            {
+                anim.nodes().resize(header.numNodes);
+                for(auto& node : anim.nodes())
+                {
+                    node.meshName = utils::trim(nIt->meshName);
+                    node.num = nIt->nodeNum;
+                    neIt = utils::copy(neIt, nIt->numEntries, node.entries); // TODO: check bounds for nIt->numEntries
+                    nIt++;
+                }
             }
 
             animations.pushBack(anim.name(), std::move(anim));
@@ -93,7 +113,7 @@ UniqueTable<Animation> CND::parseSection_Keyframes(const InputStream& istream, c
     }
 }
 
-UniqueTable<Animation> CND::readKeyframes(const InputStream& istream)
+UniqueTable<Animation> CND::readKeyframes(const InputStream& istream, KeyframeLayout layout)
 {
     auto cndHeader = readHeader(istream);
 
@@ -106,11 +126,12 @@ UniqueTable<Animation> CND::readKeyframes(const InputStream& istream)
     }
 
     istream.seek(sectionOffset);
-    return parseSection_Keyframes(istream, cndHeader);
+    return parseSection_Keyframes(istream, cndHeader, layout);
 }
 
 void CND::writeSection_Keyframes(OutputStream& ostream, const UniqueTable<Animation>& animations)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Keyframes", ostream);
     try
     {
         std::vector<CndKeyHeader> cndHeaders;
@@ -134,7 +155,15 @@ void CND::writeSection_Keyframes(OutputStream& ostream, const UniqueTable<Animat
             h.fps        = anim.fps();
             h.numMarkers = safe_cast<decltype(h.numMarkers)>(anim.markers().size());
             h.numJoints  = safe_cast<decltype(h.numJoints)>(anim.joints());
-            h.numNodes   = safe_cast<decltype(h.numNodes)>(anim.nodes().size());
+
+            /* Animation loaded with flat keyframe layout has no nodes */
+            std::vector<KeyNode> flatNodes;
+            if(anim.nodes().empty() && !anim.flatKeyframes().isEmpty()) {
+                flatNodes = anim.flatKeyframes().toNodes();
+            }
+            const auto& animNodes = flatNodes.empty() ? anim.nodes() : flatNodes;
+
+            h.numNodes   = safe_cast<decltype(h.numNodes)>(animNodes.size());
             cndHeaders.push_back(std::move(h));
 
             /* Copy key markers */
@@ -148,8 +177,8 @@ void CND::writeSection_Keyframes(OutputStream& ostream, const UniqueTable<Animat
             std::copy(anim.markers().begin(), anim.markers().end(), std::back_inserter(markers));
 
             /* Copy key nodes and it's entries */
-            nodes.reserve(anim.nodes().size());
-            for(auto& node : anim.nodes())
+            nodes.reserve(animNodes.size());
+            for(auto& node : animNodes)
             {
                 CndKeyNode n;
                 if(!utils::strcpy(n.meshName, node.meshName)) {
@@ -4,6 +4,7 @@
 #include "thing/cnd_thing.h"
 #include "../world_ser_common.h"
 
+#include <libim/trace/trace.h>
 #include <libim/utils/utils.h>
 #include <libim/types/safe_cast.h>
 
@@ -76,6 +77,51 @@ CndHeader CND::readHeader(const InputStream& istream)
     return cndHeader;
 }
 
+CndSectionLayout CND::getSectionLayout(const InputStream& istream, const CndHeader& header)
+{
+    AT_SCOPE_EXIT([ &istream, off = istream.tell() ](){
+        istream.seek(off);
+    });
+
+    const std::array<std::size_t, kNumCndSections> offsets {
+        0,
+        getOffset_Sounds(),
+        getOffset_Materials(istream),
+        getOffset_Georesource(istream, header),
+        getOffset_Sectors(istream, header),
+        getOffset_AIClasses(istream, header),
+        getOffset_Models(istream, header),
+        getOffset_Sprites(istream, header),
+        getOffset_Keyframes(istream, header),
+        getOffset_AnimClasses(istream, header),
+        getOffset_SoundClasses(istream, header),
+        getOffset_CogScripts(istream, header),
+        getOffset_Cogs(istream, header),
+        getOffset_Templates(istream, header),
+        getOffset_Things(istream, header),
+        getOffset_PVS(istream, header)
+    };
+
+    // PVS section is optional
+    std::size_t endPvs = offsets.back();
+    if (endPvs < istream.size())
+    {
+        istream.seek(endPvs);
+        endPvs += sizeof(uint32_t) + istream.read<uint32_t>();
+    }
+
+    CndSectionLayout layout;
+    for (std::size_t i = 0; i < kNumCndSections; i++)
+    {
+        const auto end = i + 1 < kNumCndSections ? offsets.at(i + 1) : endPvs;
+        if (end < offsets.at(i) || end > istream.size()) {
+            throw CNDError("getSectionLayout", "Invalid CND section offset");
+        }
+        layout[i] = { offsets.at(i), end - offsets.at(i) };
+    }
+    return layout;
+}
+
 std::size_t CND::getOffset_Sounds()
 {
     return sizeof(CndHeader);
@@ -83,6 +129,7 @@ std::size_t CND::getOffset_Sounds()
 
 void CND::parseSection_Sounds(const InputStream& istream, audio::SoundBank& bank, std::size_t trackIdx)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Sounds", istream);
     try {
         bank.importTrack(trackIdx, istream);
     }
@@ -101,6 +148,7 @@ void CND::readSounds(const InputStream& istream, audio::SoundBank& bank, std::si
 
 void CND::writeSection_Sounds(OutputStream& ostream, audio::SoundBank& bank, std::size_t trackIdx)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Sounds", ostream);
     try {
         bank.exportTrack(trackIdx, ostream);
     }
@@ -128,6 +176,7 @@ std::size_t CND::getOffset_AIClasses(const InputStream& istream, const CndHeader
 
 std::vector<std::string> CND::parseSection_AIClasses(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_AIClasses", istream);
     try {
         return readResourceList(istream, header.numAIClasses);
     }
@@ -148,6 +197,7 @@ std::vector<std::string> CND::readAIClasses(const InputStream& istream)
 
 void CND::writeSection_AIClasses(OutputStream& ostream, const std::vector<std::string>& aiclasses)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_AIClasses", ostream);
     try {
         writeResourceList(ostream, aiclasses);
     }
@@ -166,6 +216,7 @@ std::size_t CND::getOffset_Models(const InputStream& istream, const CndHeader& h
 
 std::vector<std::string> CND::parseSection_Models(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Models", istream);
     try {
         return readResourceList(istream, header.numModels);
     }
@@ -186,6 +237,7 @@ std::vector<std::string> CND::readModels(const InputStream& istream)
 
 void CND::writeSection_Models(OutputStream& ostream, const std::vector<std::string>& models)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Models", ostream);
     try {
         writeResourceList(ostream, models);
     }
@@ -204,6 +256,7 @@ std::size_t CND::getOffset_Sprites(const InputStream& istream, const CndHeader&
 
 std::vector<std::string> CND::parseSection_Sprites(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Sprites", istream);
     try{
         return readResourceList(istream, header.numSprites);
     }
@@ -224,6 +277,7 @@ std::vector<std::string> CND::readSprites(const InputStream& istream)
 
 void CND::writeSection_Sprites(OutputStream& ostream, const std::vector<std::string>& sprites)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Sprites", ostream);
     try {
         writeResourceList(ostream, sprites);
     }
@@ -253,6 +307,7 @@ std::size_t CND::getOffset_AnimClasses(const InputStream& istream, const CndHead
 
 std::vector<std::string> CND::parseSection_AnimClasses(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_AnimClasses", istream);
     try {
         return readResourceList(istream, header.numPuppets);
     }
@@ -273,6 +328,7 @@ std::vector<std::string> CND::readAnimClasses(const InputStream& istream)
 
 void CND::writeSection_AnimClasses(OutputStream& ostream, const std::vector<std::string>& animclasses)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_AnimClasses", ostream);
     try {
         writeResourceList(ostream, animclasses);
     }
@@ -291,6 +347,7 @@ std::size_t CND::getOffset_SoundClasses(const InputStream& istream, const CndHea
 
 std::vector<std::string> CND::parseSection_SoundClasses(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_SoundClasses", istream);
     try {
         return readResourceList(istream, header.numSoundClasses);
     }
@@ -311,6 +368,7 @@ std::vector<std::string> CND::readSoundClasses(const InputStream& istream)
 
 void CND::writeSection_SoundClasses(OutputStream& ostream, const std::vector<std::string>& sndclasses)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_SoundClasses", ostream);
     try {
         writeResourceList(ostream, sndclasses);
     }
@@ -329,6 +387,7 @@ std::size_t CND::getOffset_CogScripts(const InputStream& istream, const CndHeade
 
 std::vector<std::string> CND::parseSection_CogScripts(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_CogScripts", istream);
     try {
         return readResourceList(istream, header.numCogScripts);
     }
@@ -349,6 +408,7 @@ std::vector<std::string> CND::readCogScripts(const InputStream& istream)
 
 void CND::writeSection_CogScripts(OutputStream& ostream, const std::vector<std::string>& scripts)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_CogScripts", ostream);
     try {
         writeResourceList(ostream, scripts);
     }
@@ -368,6 +428,7 @@ std::size_t CND::getOffset_Cogs(const InputStream& istream, const CndHeader& hea
 
 std::vector<SharedRef<Cog>> CND::parseSection_Cogs(const InputStream& istream, const CndHeader& header, const UniqueTable<SharedRef<CogScript>>& scripts)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Cogs", istream);
     try
     {
         auto aSizes = istream.read<std::array<uint32_t, 2>>();
@@ -434,6 +495,7 @@ std::vector<SharedRef<Cog>> CND::readCogs(const InputStream& istream, const Uniq
 
 void CND::writeSection_Cogs(OutputStream& ostream, const std::vector<SharedRef<Cog>>& cogs)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Cogs", ostream);
     try
     {
         std::vector<std::string> cogvals;
@@ -512,6 +574,7 @@ std::size_t CND::getOffset_PVS(const InputStream& istream, const CndHeader& head
 
 ByteArray CND::parseSection_PVS(const InputStream& istream)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_PVS", istream);
     try {
         return istream.read<ByteArray>(istream.read<uint32_t>());
     }
@@ -531,6 +594,7 @@ ByteArray CND::readPVS(const InputStream& istream)
 
 void CND::writeSection_PVS(OutputStream& ostream, const ByteArray& pvs)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_PVS", ostream);
     try {
         ostream.write<int32_t>(safe_cast<int32_t>(pvs.size()));
         ostream.write(pvs);
@@ -3,7 +3,9 @@
 #include <array>
 #include <cstdint>
 #include <cstdio>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -131,11 +133,68 @@ namespace libim::content::asset {
 
     static_assert(sizeof(CndHeader) == 1568);
 
+    /** CND file sections in the order they are stored in file */
+    enum class CndSection : std::size_t
+    {
+        Header,
+        Sounds,
+        Materials,
+        Georesource,
+        Sectors,
+        AIClasses,
+        Models,
+        Sprites,
+        Keyframes,
+        AnimClasses,
+        SoundClasses,
+        CogScripts,
+        Cogs,
+        Templates,
+        Things,
+        PVS
+    };
+
+    inline constexpr std::size_t kNumCndSections = static_cast<std::size_t>(CndSection::PVS) + 1;
+
+    /** Names of CND sections indexed by CndSection */
+    inline constexpr std::array<std::string_view, kNumCndSections> kCndSectionNames = {
+        "Header", "Sounds", "Materials", "Georesource", "Sectors", "AIClasses", "Models", "Sprites",
+        "Keyframes", "AnimClasses", "SoundClasses", "CogScripts", "Cogs", "Templates", "Things", "PVS"
+    };
+
+    /** Location of section in CND file */
+    struct CndSectionInfo final
+    {
+        std::size_t offset = 0;
+        std::size_t size   = 0;
+
+        std::size_t end() const
+        {
+            return offset + size;
+        }
+
+        bool operator==(const CndSectionInfo&) const = default;
+    };
+
+    using CndSectionLayout = std::array<CndSectionInfo, kNumCndSections>;
+
 
     struct CND final
     {
         static CndHeader readHeader(const InputStream& istream);
 
+        /**
+         * Returns offset and size of every section in CND file.
+         * Sections are stored contiguously, the PVS section ends at the end of file.
+         *
+         * @param istream - Const reference to the InputStream
+         * @param header  - CND file header.
+         * @return CndSectionLayout indexed by CndSection.
+         *
+         * @throw CNDError, StreamError
+         */
+        [[nodiscard]] static CndSectionLayout getSectionLayout(const InputStream& istream, const CndHeader& header);
+
         /**
          * Returns the offset to the sounds section.
          *
@@ -178,13 +237,13 @@ namespace libim::content::asset {
         static void writeSection_Materials(OutputStream& ostream, const Table<Material>& materials);
 
         [[nodiscard]] static std::size_t getOffset_Georesource(const InputStream& istream, const CndHeader& header);
-        [[nodiscard]] static Georesource parseSection_Georesource(const InputStream& istream, const CndHeader& cndHeader);
-        [[nodiscard]] static Georesource readGeoresource(const InputStream& istream);
+        [[nodiscard]] static Georesource parseSection_Georesource(const InputStream& istream, const CndHeader& cndHeader, std::pmr::memory_resource* mr = std::pmr::get_default_resource()); // Surface vertex lists are allocated from mr.
+        [[nodiscard]] static Georesource readGeoresource(const InputStream& istream, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
         static void writeSection_Georesource(OutputStream& ostream, const Georesource& geores);
 
         [[nodiscard]] static std::size_t getOffset_Sectors(const InputStream& istream, const CndHeader& header);
-        [[nodiscard]] static std::vector<Sector> parseSection_Sectors(const InputStream& istream, const CndHeader& header);
-        [[nodiscard]] static std::vector<Sector> readSectors(const InputStream& istream);
+        [[nodiscard]] static std::vector<Sector> parseSection_Sectors(const InputStream& istream, const CndHeader& header, std::pmr::memory_resource* mr = std::pmr::get_default_resource()); // Sector vertex index lists are allocated from mr.
+        [[nodiscard]] static std::vector<Sector> readSectors(const InputStream& istream, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
         static void writeSection_Sectors(OutputStream& ostream, const std::vector<Sector>& sectors);
 
         [[nodiscard]] static std::size_t getOffset_AIClasses(const InputStream& istream, const CndHeader& header);
@@ -203,8 +262,8 @@ namespace libim::content::asset {
         static void writeSection_Sprites(OutputStream& ostream, const std::vector<std::string>& sprites);
 
         [[nodiscard]] static std::size_t getOffset_Keyframes(const InputStream& istream, const CndHeader& header);
-        [[nodiscard]] static UniqueTable<Animation> parseSection_Keyframes(const InputStream& istream, const CndHeader& header); // Reads keyframes section. Offset of istream hast to be at beginning of keyframe section.
-        [[nodiscard]] static UniqueTable<Animation> readKeyframes(const InputStream& istream);
+        [[nodiscard]] static UniqueTable<Animation> parseSection_Keyframes(const InputStream& istream, const CndHeader& header, KeyframeLayout layout = KeyframeLayout::Nodes); // Reads keyframes section. Offset of istream hast to be at beginning of keyframe section.
+        [[nodiscard]] static UniqueTable<Animation> readKeyframes(const InputStream& istream, KeyframeLayout layout = KeyframeLayout::Nodes);
         static void writeSection_Keyframes(OutputStream& ostream, const UniqueTable<Animation>& animations);
 
         [[nodiscard]] static std::size_t getOffset_AnimClasses(const InputStream& istream, const CndHeader& header);
@@ -228,8 +287,8 @@ namespace libim::content::asset {
         static void writeSection_Cogs(OutputStream& ostream, const std::vector<SharedRef<Cog>>& cogs);
 
         [[nodiscard]] static std::size_t getOffset_Templates(const InputStream& istream, const CndHeader& header);
-        [[nodiscard]] static UniqueTable<CndThing> parseSection_Templates(const InputStream& istream, const CndHeader& header);
-        [[nodiscard]] static UniqueTable<CndThing> readTemplates(const InputStream& istream);
+        [[nodiscard]] static UniqueTable<CndThing> parseSection_Templates(const InputStream& istream, const CndHeader& header, std::pmr::memory_resource* mr = std::pmr::get_default_resource()); // Returned table is allocated from mr.
+        [[nodiscard]] static UniqueTable<CndThing> readTemplates(const InputStream& istream, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
         static void writeSection_Templates(OutputStream& ostream, const UniqueTable<CndThing>& templates);
 
         [[nodiscard]] static std::size_t getOffset_Things(const InputStream& istream, const CndHeader& header);
@@ -0,0 +1,145 @@
+#include "cndpatch.h"
+
+#include <libim/io/filestream.h>
+#include <libim/io/memorystream.h>
+#include <libim/trace/trace.h>
+#include <libim/types/safe_cast.h>
+
+#include <algorithm>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+static constexpr std::size_t sectionIdx(CndSection section)
+{
+    return static_cast<std::size_t>(section);
+}
+
+CndPatch::CndPatch(std::filesystem::path cndFile) :
+    file_(std::move(cndFile))
+{
+    InputFileStream ifs(file_);
+    header_ = CND::readHeader(ifs);
+    layout_ = CND::getSectionLayout(ifs, header_);
+}
+
+void CndPatch::setMaterials(const Table<Material>& materials)
+{
+    MemoryOutputStream ostream;
+    ostream.reserve(layout_.at(sectionIdx(CndSection::Materials)).size);
+    CND::writeSection_Materials(ostream, materials);
+
+    header_.numMaterials  = safe_cast<uint32_t>(materials.size());
+    header_.sizeMaterials = std::max(header_.sizeMaterials, header_.numMaterials);
+    setSection(CndSection::Materials, ostream.release());
+}
+
+void CndPatch::setKeyframes(const UniqueTable<Animation>& animations)
+{
+    MemoryOutputStream ostream;
+    ostream.reserve(layout_.at(sectionIdx(CndSection::Keyframes)).size);
+    CND::writeSection_Keyframes(ostream, animations);
+
+    header_.numKeyframes  = safe_cast<uint32_t>(animations.size());
+    header_.sizeKeyframes = std::max(header_.sizeKeyframes, header_.numKeyframes);
+    setSection(CndSection::Keyframes, ostream.release());
+}
+
+void CndPatch::setSection(CndSection section, ByteArray data)
+{
+    if (section == CndSection::Header) {
+        throw CNDError("CndPatch::setSection", "Header section can't be replaced");
+    }
+    edits_[section] = std::move(data);
+}
+
+bool CndPatch::commit()
+{
+    LIBIM_TRACE_SCOPE_DETAIL("cnd", "CndPatch::commit", file_.generic_string());
+    if (edits_.empty()) {
+        return true;
+    }
+
+    const bool inPlace = std::all_of(edits_.begin(), edits_.end(), [&](const auto& e) {
+        return e.second.size() == layout_.at(sectionIdx(e.first)).size;
+    });
+
+    if (inPlace) {
+        writeInPlace();
+    }
+    else {
+        rebuild();
+    }
+
+    /* Update section layout */
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < kNumCndSections; i++)
+    {
+        auto& s = layout_[i];
+        if (auto it = edits_.find(static_cast<CndSection>(i)); it != edits_.end()) {
+            s.size = it->second.size();
+        }
+        s.offset = offset;
+        offset  += s.size;
+    }
+
+    edits_.clear();
+    return inPlace;
+}
+
+void CndPatch::writeInPlace()
+{
+    FileStream fs(file_, /*truncate=*/false, FileStream::ReadWrite);
+    for (const auto& [section, data] : edits_)
+    {
+        fs.seek(layout_.at(sectionIdx(section)).offset);
+        fs.write(data);
+    }
+
+    fs.seek(0);
+    fs.write(header_);
+    fs.close();
+}
+
+void CndPatch::rebuild()
+{
+    const std::filesystem::path patchedFile = file_.string() + ".patched";
+    try
+    {
+        InputFileStream ifs(file_);
+        OutputFileStream ofs(patchedFile, /*truncate=*/true);
+
+        std::size_t newSize = ifs.size();
+        for (const auto& [section, data] : edits_) {
+            newSize = newSize - layout_.at(sectionIdx(section)).size + data.size();
+        }
+        header_.fileSize = safe_cast<uint32_t>(newSize);
+
+        auto copy = [&](std::size_t begin, std::size_t end)
+        {
+            if (ofs.copyFrom(ifs, begin, end - begin) != end - begin) {
+                throw CNDError("CndPatch::commit", "Unexpected end of CND file");
+            }
+        };
+
+        ofs.write(header_);
+        std::size_t pos = layout_.at(sectionIdx(CndSection::Header)).end();
+        for (const auto& [section, data] : edits_)
+        {
+            const auto& s = layout_.at(sectionIdx(section));
+            copy(pos, s.offset);
+            ofs.write(data);
+            pos = s.end();
+        }
+        copy(pos, ifs.size());
+
+        ifs.close();
+        ofs.close();
+        renameFile(patchedFile, file_);
+    }
+    catch (...)
+    {
+        deleteFile(patchedFile);
+        throw;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef LIBIM_CNDPATCH_H
+#define LIBIM_CNDPATCH_H
+#include <filesystem>
+#include <map>
+
+#include "cnd.h"
+
+#include <libim/common.h>
+#include <libim/content/asset/animation/animation.h>
+#include <libim/content/asset/material/material.h>
+#include <libim/types/indexmap.h>
+
+namespace libim::content::asset {
+
+    /**
+     * Edits sections of existing CND file.
+     *
+     * Section edits are batched and written to file in a single transaction by commit().
+     * When every edited section keeps its size, the sections are overwritten in place.
+     * Otherwise a new file is spliced together from the unchanged ranges of the original file
+     * and the edited sections, and the new file replaces the original file.
+     * The unchanged ranges are copied with FileStream::copyFrom.
+     */
+    class CndPatch final
+    {
+    public:
+        /**
+         * Reads header and section layout of the CND file.
+         * @param cndFile - path to CND file.
+         * @throw CNDError, FileStreamError
+         */
+        explicit CndPatch(std::filesystem::path cndFile);
+
+        const CndHeader& header() const
+        {
+            return header_;
+        }
+
+        const CndSectionLayout& layout() const
+        {
+            return layout_;
+        }
+
+        /** Returns true if there are no uncommitted section edits. */
+        bool empty() const
+        {
+            return edits_.empty();
+        }
+
+        /**
+         * Replaces materials section.
+         * @throw CNDError
+         */
+        void setMaterials(const Table<Material>& materials);
+
+        /**
+         * Replaces keyframes section.
+         * @throw CNDError
+         */
+        void setKeyframes(const UniqueTable<Animation>& animations);
+
+        /**
+         * Writes all section edits to CND file.
+         * @note If writing in place fails, the CND file can be left corrupted.
+         *
+         * @return true if the file was patched in place, false if the file was rebuilt.
+         * @throw CNDError, FileStreamError
+         */
+        bool commit();
+
+    private:
+        void setSection(CndSection section, ByteArray data);
+        void writeInPlace();
+        void rebuild();
+
+    private:
+        std::filesystem::path file_;
+        CndHeader header_;
+        CndSectionLayout layout_;
+        std::map<CndSection, ByteArray> edits_;
+    };
+}
+#endif // LIBIM_CNDPATCH_H
@@ -0,0 +1,224 @@
+#include "cndview.h"
+
+#include <libim/io/binarystream.h>
+#include <libim/trace/trace.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::asset;
+using namespace std::string_literals;
+
+static constexpr std::size_t sectionIdx(CndSection section)
+{
+    return static_cast<std::size_t>(section);
+}
+
+/** Bounds checked cursor over section data. */
+class CndView::Reader final
+{
+public:
+    Reader(ByteView section, std::string_view name) :
+        data_(section),
+        name_(name)
+    {}
+
+    template<typename T>
+    T read()
+    {
+        require(sizeof(T));
+        T v;
+        std::memcpy(&v, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+
+    template<typename T>
+    PackedView<T> readArray(std::size_t count)
+    {
+        if (count > (data_.size() - pos_) / sizeof(T)) {
+            throw CNDError("CndView", "Array size exceeds the size of section '"s + std::string(name_) + "'");
+        }
+
+        PackedView<T> view(data_.data() + pos_, count);
+        pos_ += view.sizeBytes();
+        return view;
+    }
+
+    ByteView readBytes(std::size_t size)
+    {
+        require(size);
+        auto view = data_.subspan(pos_, size);
+        pos_ += size;
+        return view;
+    }
+
+    CndThingListView readThingList(std::size_t numThings)
+    {
+        CndThingListView view;
+        view.headers        = readArray<CndThingHeader>(numThings);
+        view.sizes          = read<CndThingParamListSizes>();
+        view.physicsInfos   = readArray<CndPhysicsInfo>(view.sizes.sizePhysicsInfoList);
+        view.numPathFrames  = readArray<uint32_t>(view.sizes.sizeNumPathFramesList);
+        view.pathFrames     = readArray<PathFrame>(view.sizes.sizePathFrameList);
+        view.actorInfos     = readArray<CndActorInfo>(view.sizes.sizeActorInfoList);
+        view.weaponInfos    = readArray<CndWeaponInfo>(view.sizes.sizeWeaponInfoList);
+        view.explosionInfos = readArray<CndExplosionInfo>(view.sizes.sizeExplosionInfoList);
+        view.itemInfos      = readArray<CndItemInfo>(view.sizes.sizeItemInfoList);
+        view.hintUserVals   = readArray<CndHintUserVal>(view.sizes.sizeHintUserValueList); // idx for partInfos and Hint list size are switched
+        view.particleInfos  = readArray<CndParticleInfo>(view.sizes.sizeParticleInfoList);
+        view.aiControlInfos = readArray<CndAIControlInfoHeader>(view.sizes.sizeAIControlInfoList);
+        view.aiPathFrames   = readArray<Vector3f>(view.sizes.sizeAIPathFrameList);
+        return view;
+    }
+
+    /** Verifies whole section was read. */
+    void end() const
+    {
+        if (pos_ != data_.size()) {
+            throw CNDError("CndView", "Invalid size of section '"s + std::string(name_) + "'");
+        }
+    }
+
+private:
+    void require(std::size_t size) const
+    {
+        if (size > data_.size() - pos_) {
+            throw CNDError("CndView", "Unexpected end of section '"s + std::string(name_) + "'");
+        }
+    }
+
+private:
+    ByteView data_;
+    std::string_view name_;
+    std::size_t pos_ = 0;
+};
+
+
+CndView::CndView(ByteView data) :
+    data_(data)
+{
+    init();
+}
+
+CndView::CndView(MappedFile file) :
+    file_(std::move(file)),
+    data_(file_.data())
+{
+    init();
+}
+
+CndView::CndView(const std::filesystem::path& cndFile) :
+    CndView(MappedFile(cndFile))
+{}
+
+ByteView CndView::section(CndSection section) const
+{
+    const auto& s = layout_.at(sectionIdx(section));
+    return data_.subspan(s.offset, s.size);
+}
+
+ContentManifest CndView::contentManifest(std::size_t maxThreads) const
+{
+    LIBIM_TRACE_SCOPE("cnd", "CndView::contentManifest");
+    std::vector<ContentHash> entries;
+    entries.reserve(kNumCndSections);
+    for (std::size_t i = 0; i < kNumCndSections; i++)
+    {
+        const auto& s = layout_.at(i);
+        entries.push_back({ std::string(kCndSectionNames.at(i)), s.offset, s.size, 0 });
+    }
+
+    hashContent(data_, entries, maxThreads);
+    return ContentManifest(std::move(entries));
+}
+
+void CndView::init()
+{
+    LIBIM_TRACE_SCOPE("cnd", "CndView::init");
+    try
+    {
+        // Header and section offsets are verified by the stream parser
+        InputBinaryStream<ByteView> istream(data_);
+        header_ = CND::readHeader(istream);
+        layout_ = CND::getSectionLayout(istream, header_);
+    }
+    catch (const CNDError&) { throw; }
+    catch (const std::exception& e) {
+        throw CNDError("CndView", "Invalid CND file: "s + e.what());
+    }
+
+    {
+        Reader r(section(CndSection::Materials), "Materials");
+        const auto sizePixelData = r.read<uint32_t>();
+        materials_    = r.readArray<CndMatHeader>(header_.numMaterials);
+        matPixelData_ = r.readBytes(sizePixelData);
+        r.end();
+    }
+    {
+        Reader r(section(CndSection::Georesource), "Georesource");
+        vertices_     = r.readArray<Vector3f>(header_.numVertices);
+        texVertices_  = r.readArray<Vector2f>(header_.numTexVertices);
+        adjoins_      = r.readArray<CndSurfaceAdjoin>(header_.numAdjoins);
+        surfaces_     = r.readArray<CndSurfaceHeader>(header_.numSurfaces);
+        surfaceVerts_ = r.readArray<CndSurfaceVerts>(r.read<uint32_t>());
+        r.end();
+    }
+    {
+        Reader r(section(CndSection::Sectors), "Sectors");
+        sectors_        = r.readArray<CndSectorHeader>(header_.numSectors);
+        sectorVertIdxs_ = r.readArray<uint32_t>(r.read<uint32_t>());
+        r.end();
+    }
+
+    auto readNames = [this](CndSection s, std::string_view name, std::size_t count) {
+        Reader r(section(s), name);
+        auto names = r.readArray<CndResourceName>(count);
+        r.end();
+        return names;
+    };
+    aiClasses_    = readNames(CndSection::AIClasses, "AIClass", header_.numAIClasses);
+    models_       = readNames(CndSection::Models, "Models", header_.numModels);
+    sprites_      = readNames(CndSection::Sprites, "Sprites", header_.numSprites);
+    animClasses_  = readNames(CndSection::AnimClasses, "AnimClass", header_.numPuppets);
+    soundClasses_ = readNames(CndSection::SoundClasses, "SoundClass", header_.numSoundClasses);
+    cogScripts_   = readNames(CndSection::CogScripts, "CogScripts", header_.numCogScripts);
+
+    {
+        Reader r(section(CndSection::Keyframes), "Keyframes");
+        const auto aSizes = r.read<std::array<uint32_t, 3>>();
+        keyframes_      = r.readArray<CndKeyHeader>(header_.numKeyframes);
+        keyMarkers_     = r.readArray<KeyMarker>(aSizes.at(0));
+        keyNodes_       = r.readArray<CndKeyNode>(aSizes.at(1));
+        keyNodeEntries_ = r.readArray<KeyNodeEntry>(aSizes.at(2));
+        r.end();
+    }
+    {
+        Reader r(section(CndSection::Cogs), "Cogs");
+        const auto aSizes = r.read<std::array<uint32_t, 2>>();
+        cogScriptNames_ = r.readArray<CndResourceName>(aSizes.at(0));
+        cogValues_      = r.readArray<CndResourceName>(aSizes.at(1));
+        r.end();
+    }
+    {
+        Reader r(section(CndSection::Templates), "Templates");
+        templates_ = r.readThingList(header_.numThingTemplates);
+        r.end();
+    }
+    {
+        Reader r(section(CndSection::Things), "Things");
+        things_ = r.readThingList(header_.numThings);
+        r.end();
+    }
+
+    // PVS section is optional
+    if (const auto pvsSection = section(CndSection::PVS); !pvsSection.empty())
+    {
+        Reader r(pvsSection, "PVS");
+        pvs_ = r.readBytes(r.read<uint32_t>());
+        r.end();
+    }
+}
@@ -0,0 +1,193 @@
+#ifndef LIBIM_CNDVIEW_H
+#define LIBIM_CNDVIEW_H
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+#include "cnd.h"
+#include "animation/cnd_key_structs.h"
+#include "georesource/cnd_adjoin.h"
+#include "georesource/cnd_surface.h"
+#include "material/cnd_mat_header.h"
+#include "sector/cnd_sector.h"
+#include "thing/cnd_thing.h"
+
+#include <libim/common.h>
+#include <libim/io/manifest.h>
+#include <libim/io/mappedfile.h>
+#include <libim/math/vector2.h>
+#include <libim/math/vector3.h>
+#include <libim/types/packed_view.h>
+
+namespace libim::content::asset {
+
+    /** Read-only view of serialized thing list (Templates and Things sections). */
+    struct CndThingListView final
+    {
+        PackedView<CndThingHeader> headers;
+        CndThingParamListSizes sizes {};
+        PackedView<CndPhysicsInfo> physicsInfos;
+        PackedView<uint32_t> numPathFrames;
+        PackedView<PathFrame> pathFrames;
+        PackedView<CndActorInfo> actorInfos;
+        PackedView<CndWeaponInfo> weaponInfos;
+        PackedView<CndExplosionInfo> explosionInfos;
+        PackedView<CndItemInfo> itemInfos;
+        PackedView<CndHintUserVal> hintUserVals;
+        PackedView<CndParticleInfo> particleInfos;
+        PackedView<CndAIControlInfoHeader> aiControlInfos;
+        PackedView<Vector3f> aiPathFrames;
+    };
+
+    /**
+     * Zero-copy read-only view of CND file.
+     *
+     * On construction the header and the section layout are read and verified,
+     * and the bounds of every serialized array are validated against its section.
+     * Afterwards the arrays of the CND structs are accessed directly in CND data
+     * without parsing, converting or allocating memory.
+     *
+     * Arrays are returned as PackedView since sections are not aligned in CND file,
+     * PackedView::span() can be used to access aligned array as std::span.
+     *
+     * CndView doesn't own data when constructed from ByteView,
+     * the data must outlive the view and all returned array views.
+     */
+    class CndView final
+    {
+    public:
+        /**
+         * Constructs view of CND data in memory.
+         * @param data - CND file data.
+         * @throw CNDError if data is not valid CND file.
+         */
+        explicit CndView(ByteView data);
+
+        /**
+         * Constructs view of memory mapped CND file.
+         * The view takes ownership of the mapped file.
+         * @param file - mapped CND file.
+         * @throw CNDError if file is not valid CND file.
+         */
+        explicit CndView(MappedFile file);
+
+        /**
+         * Maps CND file into memory and constructs view of it.
+         * @param cndFile - path to CND file.
+         * @throw CNDError, FileStreamError
+         */
+        explicit CndView(const std::filesystem::path& cndFile);
+
+        CndView(CndView&&) noexcept = default;
+        CndView& operator=(CndView&&) noexcept = default;
+
+        /** Returns the whole CND data. */
+        ByteView data() const
+        {
+            return data_;
+        }
+
+        const CndHeader& header() const
+        {
+            return header_;
+        }
+
+        const CndSectionLayout& layout() const
+        {
+            return layout_;
+        }
+
+        /** Returns raw data of section. */
+        ByteView section(CndSection section) const;
+
+        /**
+         * Computes content manifest of all CND sections.
+         * Entries are named by kCndSectionNames and sections are hashed in parallel.
+         * @param maxThreads - max number of threads to use. 0 = all hardware threads.
+         */
+        [[nodiscard]] ContentManifest contentManifest(std::size_t maxThreads = 0) const;
+
+        /* Materials section */
+        PackedView<CndMatHeader> materials() const { return materials_; }
+        ByteView materialPixelData() const { return matPixelData_; }
+
+        /* Georesource section */
+        PackedView<Vector3f> vertices() const { return vertices_; }
+        PackedView<Vector2f> texVertices() const { return texVertices_; }
+        PackedView<CndSurfaceAdjoin> adjoins() const { return adjoins_; }
+        PackedView<CndSurfaceHeader> surfaces() const { return surfaces_; }
+        PackedView<CndSurfaceVerts> surfaceVerts() const { return surfaceVerts_; } // Vertices of all surfaces in order, see CndSurfaceHeader::numVerts
+
+        /* Sectors section */
+        PackedView<CndSectorHeader> sectors() const { return sectors_; }
+        PackedView<uint32_t> sectorVertIdxs() const { return sectorVertIdxs_; } // Vertex indices of all sectors in order, see CndSectorHeader::verticesCount
+
+        /* Resource name sections */
+        PackedView<CndResourceName> aiClasses() const { return aiClasses_; }
+        PackedView<CndResourceName> models() const { return models_; }
+        PackedView<CndResourceName> sprites() const { return sprites_; }
+        PackedView<CndResourceName> animClasses() const { return animClasses_; }
+        PackedView<CndResourceName> soundClasses() const { return soundClasses_; }
+        PackedView<CndResourceName> cogScripts() const { return cogScripts_; }
+
+        /* Keyframes section */
+        PackedView<CndKeyHeader> keyframes() const { return keyframes_; }
+        PackedView<KeyMarker> keyMarkers() const { return keyMarkers_; }
+        PackedView<CndKeyNode> keyNodes() const { return keyNodes_; }
+        PackedView<KeyNodeEntry> keyNodeEntries() const { return keyNodeEntries_; }
+
+        /* Cogs section */
+        PackedView<CndResourceName> cogScriptNames() const { return cogScriptNames_; } // Script file name of each cog
+        PackedView<CndResourceName> cogValues() const { return cogValues_; }           // Symbol values of all cogs in order
+
+        /* Templates and Things sections */
+        const CndThingListView& templates() const { return templates_; }
+        const CndThingListView& things() const { return things_; }
+
+        /* PVS section, empty if file has no PVS section */
+        ByteView pvs() const { return pvs_; }
+
+    private:
+        class Reader;
+        void init();
+
+    private:
+        MappedFile file_;
+        ByteView data_;
+        CndHeader header_;
+        CndSectionLayout layout_;
+
+        PackedView<CndMatHeader> materials_;
+        ByteView matPixelData_;
+
+        PackedView<Vector3f> vertices_;
+        PackedView<Vector2f> texVertices_;
+        PackedView<CndSurfaceAdjoin> adjoins_;
+        PackedView<CndSurfaceHeader> surfaces_;
+        PackedView<CndSurfaceVerts> surfaceVerts_;
+
+        PackedView<CndSectorHeader> sectors_;
+        PackedView<uint32_t> sectorVertIdxs_;
+
+        PackedView<CndResourceName> aiClasses_;
+        PackedView<CndResourceName> models_;
+        PackedView<CndResourceName> sprites_;
+        PackedView<CndResourceName> animClasses_;
+        PackedView<CndResourceName> soundClasses_;
+        PackedView<CndResourceName> cogScripts_;
+
+        PackedView<CndKeyHeader> keyframes_;
+        PackedView<KeyMarker> keyMarkers_;
+        PackedView<CndKeyNode> keyNodes_;
+        PackedView<KeyNodeEntry> keyNodeEntries_;
+
+        PackedView<CndResourceName> cogScriptNames_;
+        PackedView<CndResourceName> cogValues_;
+
+        CndThingListView templates_;
+        CndThingListView things_;
+
+        ByteView pvs_;
+    };
+}
+#endif // LIBIM_CNDVIEW_H
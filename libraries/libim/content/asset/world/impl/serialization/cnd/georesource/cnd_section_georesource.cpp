@@ -4,6 +4,7 @@
 #include "cnd_adjoin.h"
 #include "cnd_surface.h"
 
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
 #include <libim/utils/utils.h>
 #include <string>
@@ -27,15 +28,16 @@ std::size_t CND::getOffset_Georesource(const InputStream& istream, const CndHead
     return istream.tell() + nPixelDataSize + header.numMaterials * sizeof(CndMatHeader);
 }
 
-Georesource CND::readGeoresource(const InputStream& istream)
+Georesource CND::readGeoresource(const InputStream& istream, std::pmr::memory_resource* mr)
 {
     auto cndHeader = readHeader(istream);
     istream.seek(getOffset_Georesource(istream, cndHeader));
-    return parseSection_Georesource(istream, cndHeader);
+    return parseSection_Georesource(istream, cndHeader, mr);
 }
 
-Georesource CND::parseSection_Georesource(const InputStream& istream, const CndHeader& cndHeader)
+Georesource CND::parseSection_Georesource(const InputStream& istream, const CndHeader& cndHeader, std::pmr::memory_resource* mr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Georesource", istream);
     try
     {
         Georesource geores;
@@ -104,7 +106,7 @@ Georesource CND::parseSection_Georesource(const InputStream& istream, const CndH
         geores.surfaces.reserve(cndHeader.numSurfaces);
         for(const auto& h : vecSurfHeaders)
         {
-            Surface s;
+            Surface s(mr);
             s.id         = std::size(geores.surfaces);
             s.matIdx     = makeOptionalIdx(h.materialIdx);
             s.surflags   = h.surfflags;
@@ -148,6 +150,7 @@ Georesource CND::parseSection_Georesource(const InputStream& istream, const CndH
 
 void CND::writeSection_Georesource(OutputStream& ostream, const Georesource& geores)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Georesource", ostream);
     try
     {
         // Write verteices and tex vertices
@@ -9,6 +9,7 @@
 #include <string>
 
 #include <libim/log/log.h>
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
 
 using namespace libim;
@@ -31,6 +32,7 @@ std::size_t CND::getOffset_Materials(const InputStream& istream)
 
 Table<Material> CND::parseSection_Materials(const InputStream& istream, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Materials", istream);
     Table<Material> materials;
     try
     {
@@ -125,6 +127,7 @@ Table<Material> CND::readMaterials(const InputStream& istream)
 
 void CND::writeSection_Materials(OutputStream& ostream, const Table<Material>& materials)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Materials", ostream);
     try
     {
         std::vector<CndMatHeader> cndHeaders;
@@ -3,6 +3,7 @@
 #include "../georesource/cnd_surface.h"
 #include "cnd_sector.h"
 
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
 #include <libim/utils/utils.h>
 #include <string>
@@ -31,8 +32,9 @@ std::size_t CND::getOffset_Sectors(const InputStream& istream, const CndHeader&
     return offs;
 }
 
-std::vector<Sector> CND::parseSection_Sectors(const InputStream& istream, const CndHeader& header)
+std::vector<Sector> CND::parseSection_Sectors(const InputStream& istream, const CndHeader& header, std::pmr::memory_resource* mr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Sectors", istream);
     try
     {
         auto headers = istream.read<std::vector<CndSectorHeader>>(header.numSectors);
@@ -46,7 +48,7 @@ std::vector<Sector> CND::parseSection_Sectors(const InputStream& istream, const
 
         for(const auto& h : headers)
         {
-            Sector s;
+            Sector s(mr);
             s.id    = std::size(sectors);
             s.flags = h.flags;
             s.tint  = h.tint;
@@ -103,6 +105,7 @@ std::vector<Sector> CND::parseSection_Sectors(const InputStream& istream, const
 
 void CND::writeSection_Sectors(OutputStream& ostream, const std::vector<Sector>& sectors)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Sectors", ostream);
     try
     {
         std::vector<CndSectorHeader> cndsectors;
@@ -168,9 +171,9 @@ void CND::writeSection_Sectors(OutputStream& ostream, const std::vector<Sector>&
     }
 }
 
-std::vector<Sector> CND::readSectors(const InputStream& istream)
+std::vector<Sector> CND::readSectors(const InputStream& istream, std::pmr::memory_resource* mr)
 {
     auto cndHeader = readHeader(istream);
     istream.seek(getOffset_Sectors(istream, cndHeader));
-    return parseSection_Sectors(istream, cndHeader);
+    return parseSection_Sectors(istream, cndHeader, mr);
 }
@@ -7,6 +7,7 @@
 #include "../../world_ser_common.h"
 #include "cnd_thing.h"
 
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
 #include <libim/utils/utils.h>
 
@@ -529,11 +530,12 @@ std::size_t CND::getOffset_Templates(const InputStream& istream, const CndHeader
            aSizes.at(1) * sizeof(CndResourceName);
 }
 
-UniqueTable<CndThing> CND::parseSection_Templates(const InputStream& istream, const CndHeader& header)
+UniqueTable<CndThing> CND::parseSection_Templates(const InputStream& istream, const CndHeader& header, std::pmr::memory_resource* mr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Templates", istream);
     try
     {
-        UniqueTable<CndThing> templates;
+        UniqueTable<CndThing> templates(mr);
         templates.reserve(header.numThingTemplates);
         parseThingList(istream, header.numThingTemplates, templates, [&](CndThing&& t){
             world_ser_assert(templates.pushBack(t.name, std::move(t)).second,
@@ -550,15 +552,16 @@ UniqueTable<CndThing> CND::parseSection_Templates(const InputStream& istream, co
     }
 }
 
-UniqueTable<CndThing> CND::readTemplates(const InputStream& istream)
+UniqueTable<CndThing> CND::readTemplates(const InputStream& istream, std::pmr::memory_resource* mr)
 {
     auto header = readHeader(istream);
     istream.seek(getOffset_Templates(istream, header));
-    return parseSection_Templates(istream, header);
+    return parseSection_Templates(istream, header, mr);
 }
 
 void CND::writeSection_Templates(OutputStream& ostream, const UniqueTable<CndThing>& templates)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Templates", ostream);
     try {
         writeThingList(ostream, templates, templates);
     }
@@ -603,6 +606,7 @@ std::size_t CND::getOffset_Things(const InputStream& istream, const CndHeader& h
 
 std::vector<CndThing> CND::parseSection_Things(const InputStream& istream, const CndHeader& header, const UniqueTable<CndThing>& templates)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::parseSection_Things", istream);
     try
     {
         std::vector<CndThing> things;
@@ -629,6 +633,7 @@ std::vector<CndThing> CND::readThings(const InputStream& istream, const UniqueTa
 
 void CND::writeSection_Things(OutputStream& ostream, const std::vector<CndThing>& things, const UniqueTable<CndThing>& templates)
 {
+    LIBIM_TRACE_STREAM_SCOPE("cnd", "CND::writeSection_Things", ostream);
     try {
         writeThingList(ostream, things, templates);
     }
@@ -2,6 +2,7 @@
 #include "../world_ser_common.h"
 #include <libim/content/text/impl/text_resource_literals.h>
 #include <libim/text/impl/schars.h>
+#include <libim/trace/trace.h>
 
 using namespace libim;
 using namespace libim::content::asset;
@@ -39,6 +40,7 @@ static constexpr auto kPvsSize           = "PVS size:"sv;
 
 bool NDY::parseSection_Copyright(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Copyright", rr);
     constexpr auto stripEol = [](std::string& str){
         constexpr auto isEol = [](unsigned char c){ return c == ChCr || c == ChEol; };
         str.erase(std::remove_if(str.begin(), str.end(), isEol), str.end());
@@ -58,6 +60,7 @@ bool NDY::parseSection_Copyright(TextResourceReader& rr)
 
 void NDY::writeSection_Copyright(TextResourceWriter& rw)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Copyright", rw);
     rw.writeLine("#### Copyright information #####"sv);
     rw.writeSection(kSectionCopyright, /*overline=*/ false);
 
@@ -72,6 +75,7 @@ void NDY::writeSection_Copyright(TextResourceWriter& rw)
 
 CndHeader NDY::parseSection_Header(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Header", rr);
     CndHeader h {};
 
     h.version = rr.readKey<decltype(h.version)>(kVersion);
@@ -99,6 +103,7 @@ CndHeader NDY::parseSection_Header(TextResourceReader& rr)
 
 void NDY::writeSection_Header(TextResourceWriter& rw, const CndHeader& header)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Header", rw);
     auto indentWidth = [&](const auto& k) {
         return kHorizonPixels.size() + 3 - k.size();
     };
@@ -140,11 +145,13 @@ void NDY::writeSection_Header(TextResourceWriter& rw, const CndHeader& header)
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_Sounds(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Sounds", rr);
     return parseResourceSection<false>(rr, kWorldSounds);
 }
 
 void NDY::writeSection_Sounds(text::TextResourceWriter& rw, std::size_t maxSounds, const std::vector<std::string>& sounds)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Sounds", rw);
     writeResourceSection<false>(rw,
         "#### Sound information  #####"sv,
         kSectionSounds,
@@ -157,6 +164,7 @@ void NDY::writeSection_Sounds(text::TextResourceWriter& rw, std::size_t maxSound
 
 void NDY::writeSection_Sounds(TextResourceWriter& rw, std::size_t maxSounds, const UniqueTable<Sound>& track)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Sounds", rw);
     writeResourceSection<false>(rw,
         "#### Sound information  #####"sv,
         kSectionSounds,
@@ -170,11 +178,13 @@ void NDY::writeSection_Sounds(TextResourceWriter& rw, std::size_t maxSounds, con
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_Materials(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Materials", rr);
     return parseResourceSection<true>(rr, kWorldMaterials);
 }
 
 void NDY::writeSection_Materials(text::TextResourceWriter& rw, const std::vector<std::string>& materials)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Materials", rw);
     writeResourceSection<true>(rw,
         "##### Material information #####"sv,
         kSectionMaterials,
@@ -187,6 +197,7 @@ void NDY::writeSection_Materials(text::TextResourceWriter& rw, const std::vector
 
 void NDY::writeSection_Materials(TextResourceWriter& rw, const Table<Material>& materials)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Materials", rw);
     writeResourceSection<true>(rw,
         "##### Material information #####"sv,
         kSectionMaterials,
@@ -200,11 +211,13 @@ void NDY::writeSection_Materials(TextResourceWriter& rw, const Table<Material>&
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_AIClasses(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_AIClasses", rr);
     return parseResourceSection<true>(rr, kWorldAIClasses);
 }
 
 void NDY::writeSection_AIClasses(TextResourceWriter& rw, std::size_t maxAIClasses, const std::vector<std::string>& aiclasses)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_AIClasses", rw);
     writeResourceSection<true>(rw,
         "######### AI Classes ###########"sv,
         kSectionAIClass,
@@ -218,11 +231,13 @@ void NDY::writeSection_AIClasses(TextResourceWriter& rw, std::size_t maxAIClasse
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_Models(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Models", rr);
     return parseResourceSection<true>(rr, kWorldModels);
 }
 
 void NDY::writeSection_Models(TextResourceWriter& rw, std::size_t maxModels, const std::vector<std::string>& models)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Models", rw);
     writeResourceSection<true>(rw,
         "###### Models information ######"sv,
         kSectionModels,
@@ -236,11 +251,13 @@ void NDY::writeSection_Models(TextResourceWriter& rw, std::size_t maxModels, con
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_Sprites(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Sprites", rr);
     return parseResourceSection<true>(rr, kWorldSprites);
 }
 
 void NDY::writeSection_Sprites(TextResourceWriter &rw,  std::size_t maxSprites, const std::vector<std::string>& sprites)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Sprites", rw);
     writeResourceSection<true>(rw,
         "###### Sprite information ######"sv,
         kSectionSprites,
@@ -254,11 +271,13 @@ void NDY::writeSection_Sprites(TextResourceWriter &rw,  std::size_t maxSprites,
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_Keyframes(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Keyframes", rr);
     return parseResourceSection<true>(rr, kWorldKeyframes);
 }
 
 void NDY::writeSection_Keyframes(text::TextResourceWriter& rw, std::size_t maxKeyframes, const std::vector<std::string>& keyframes)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Keyframes", rw);
     writeResourceSection<true>(rw,
         "##### Keyframe information #####"sv,
         kSectionKeyframes,
@@ -271,6 +290,7 @@ void NDY::writeSection_Keyframes(text::TextResourceWriter& rw, std::size_t maxKe
 
 void NDY::writeSection_Keyframes(TextResourceWriter &rw, std::size_t maxKeyframes, const UniqueTable<Animation>& keyframes)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Keyframes", rw);
     writeResourceSection<true>(rw,
         "##### Keyframe information #####"sv,
         kSectionKeyframes,
@@ -284,11 +304,13 @@ void NDY::writeSection_Keyframes(TextResourceWriter &rw, std::size_t maxKeyframe
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_AnimClasses(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_AnimClasses", rr);
     return parseResourceSection<true>(rr, kWorldPuppets);
 }
 
 void NDY::writeSection_AnimClasses(TextResourceWriter &rw, std::size_t maxAnimClasses, const std::vector<std::string>& puppets)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_AnimClasses", rw);
     writeResourceSection<true>(rw,
         "###### Animation Classes #######"sv,
         kSectionAnimClass,
@@ -302,11 +324,13 @@ void NDY::writeSection_AnimClasses(TextResourceWriter &rw, std::size_t maxAnimCl
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_SoundClasses(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_SoundClasses", rr);
     return parseResourceSection<true>(rr, kWorldSoundClasses);
 }
 
 void NDY::writeSection_SoundClasses(TextResourceWriter &rw, std::size_t maxSoundClasses, const std::vector<std::string>& sndclasses)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_SoundClasses", rw);
     writeResourceSection<true>(rw,
         "######### Sound Classes ########"sv,
         kSectionSoundClass,
@@ -320,11 +344,13 @@ void NDY::writeSection_SoundClasses(TextResourceWriter &rw, std::size_t maxSound
 std::pair<std::size_t, std::vector<std::string>>
 NDY::parseSection_CogScripts(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_CogScripts", rr);
     return parseResourceSection<true>(rr, kWorldScripts);
 }
 
 void NDY::writeSection_CogScripts(TextResourceWriter &rw, std::size_t maxCogScripts, const std::vector<std::string>& scripts)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_CogScripts", rw);
     writeResourceSection<true>(rw,
         "########## COG scripts #########"sv,
         kSectionCogScripts,
@@ -337,6 +363,7 @@ void NDY::writeSection_CogScripts(TextResourceWriter &rw, std::size_t maxCogScri
 
 ByteArray NDY::parseSection_PVS(TextResourceReader& rr, std::vector<Sector>& sectors)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_PVS", rr);
     const std::size_t sizePVS = rr.readKey<std::size_t>(kPvsSize);
     std::size_t numFrames = sizePVS / 64;
     if (sizePVS % 64 != 0) {
@@ -359,6 +386,7 @@ ByteArray NDY::parseSection_PVS(TextResourceReader& rr, std::vector<Sector>& sec
 
 void NDY::writeSection_PVS(TextResourceWriter& rw, const ByteArray& pvs, const std::vector<Sector>& sectors)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_PVS", rw);
     if (pvs.empty()) return; // Don't write empty section
 
     rw.writeLine("########### PVS Info ###########"sv);
@@ -1,5 +1,6 @@
 #include "ndy.h"
 #include "../world_ser_common.h"
+#include <libim/trace/trace.h>
 
 using namespace libim;
 using namespace libim::content::asset;
@@ -11,6 +12,7 @@ static constexpr auto kWorldCogs = "World cogs"sv;
 
 std::pair<std::size_t, std::vector<SharedRef<Cog>>> NDY::parseSection_Cogs(TextResourceReader& rr, const UniqueTable<SharedRef<CogScript>>& scripts)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Cogs", rr);
     std::size_t maxCogs = rr.readKey<std::size_t>(kWorldCogs);
 
     auto resources = rr.readList<std::vector<SharedRef<Cog>>>(
@@ -67,6 +69,7 @@ std::pair<std::size_t, std::vector<SharedRef<Cog>>> NDY::parseSection_Cogs(TextR
 
 void NDY::writeSection_Cogs(TextResourceWriter& rw, std::size_t maxCogs, const std::vector<SharedRef<Cog>>& cogs)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Cogs", rw);
     std::vector<std::string> scogs;
     scogs.reserve(cogs.size());
     for(const auto& c : cogs)
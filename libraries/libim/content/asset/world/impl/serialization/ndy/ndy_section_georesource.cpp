@@ -1,6 +1,7 @@
 #include "ndy.h"
 #include "../world_ser_common.h"
 #include <libim/content/text/impl/text_resource_literals.h>
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
 
 using namespace libim;
@@ -15,6 +16,7 @@ static constexpr auto kWorldSurfaces   = "World surfaces"sv;
 
 Georesource NDY::parseSection_Georesource(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Georesource", rr);
     Georesource res;
 
     // Read world vertices
@@ -90,6 +92,7 @@ Georesource NDY::parseSection_Georesource(TextResourceReader& rr)
 
 void NDY::writeSection_Georesource(TextResourceWriter& rw, const Georesource& geores)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Georesource", rw);
     AT_SCOPE_EXIT([&rw, ich = rw.indentChar()](){
         rw.setIndentChar(ich);
     });
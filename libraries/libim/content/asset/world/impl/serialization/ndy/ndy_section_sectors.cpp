@@ -1,4 +1,5 @@
 #include "ndy.h"
+#include <libim/trace/trace.h>
 #include <string_view>
 
 using namespace libim;
@@ -32,6 +33,7 @@ static constexpr auto kSurfaces        = "SURFACES"sv;
 
 std::vector<Sector> NDY::parseSection_Sectors(TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Sectors", rr);
     return rr.readList<std::vector<Sector>, /*hasRowIdxs=*/false>(kWorldSectors, [](TextResourceReader& rr, auto rowIdx, Sector& s){
         s.id = rowIdx;
         [[maybe_unused]] auto sidx = rr.readKey<std::size_t>(kSector); // discard sector number
@@ -130,6 +132,7 @@ std::vector<Sector> NDY::parseSection_Sectors(TextResourceReader& rr)
 
 void NDY::writeSection_Sectors(TextResourceWriter& rw, const std::vector<Sector>& sectors)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Sectors", rw);
     rw.writeLine("###### Sector information ######"sv);
     rw.writeSection(kSectionSectors, /*overline=*/ false);
     rw.writeEol();
@@ -3,6 +3,7 @@
 
 #include "../ndy.h"
 #include "../../world_ser_common.h"
+#include <libim/trace/trace.h>
 #include <libim/types/optref.h>
 
 #include <map>
@@ -37,16 +38,18 @@ UniqueTable<CndThing> NDY::parseTemplateList(text::TextResourceReader&& rr)
 std::pair<std::size_t, UniqueTable<CndThing>>
 NDY::parseSection_Templates(text::TextResourceReader& rr)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Templates", rr);
     const std::size_t sizeTemplates = rr.readKey<std::size_t>(kWorldTemplates);
     auto templates = parseTemplateList(rr);
     if (templates.size() > sizeTemplates) {
         LOG_WARNING("NDY::ParseSection_Templates(): Expected at max % templates, but found %", sizeTemplates, templates.size());
     }
-    return { sizeTemplates, templates };
+    return { sizeTemplates, std::move(templates) };
 }
 
 void NDY::writeSection_Templates(TextResourceWriter& rw, std::size_t maxTemplates, const UniqueTable<CndThing>& templates)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Templates", rw);
     rw.writeLine("##### Templates information ####"sv);
     rw.writeSection(kSectionTemplates, /*overline=*/ false);
     rw.writeEol();
@@ -63,6 +66,7 @@ void NDY::writeSection_Templates(TextResourceWriter& rw, std::size_t maxTemplate
 
 std::vector<CndThing> NDY::parseSection_Things(text::TextResourceReader& rr, const UniqueTable<CndThing>& templates)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::parseSection_Things", rr);
     const std::size_t sizeThings = rr.readKey<std::size_t>(kWorldThings);
     auto things = rr.readList<std::vector<CndThing>, /*hasRowIdxs*/false>( // Note, row idx are read by ndyParseThing
         [&templates](TextResourceReader& rr, auto rowIdx, CndThing& t) {
@@ -84,6 +88,7 @@ std::vector<CndThing> NDY::parseSection_Things(text::TextResourceReader& rr, con
 
 void NDY::writeSection_Things(TextResourceWriter& rw, const std::vector<CndThing>& things, const UniqueTable<CndThing>& templates)
 {
+    LIBIM_TRACE_STREAM_SCOPE("ndy", "NDY::writeSection_Things", rw);
     rw.writeLine("##### Things information ####"sv);
     rw.writeSection(kSectionThings, /*overline=*/ false);
     rw.writeEol();
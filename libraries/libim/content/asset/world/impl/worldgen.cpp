@@ -0,0 +1,638 @@
+#include "../worldgen.h"
+#include "serialization/world_ser_common.h"
+#include "serialization/ndy/ndy.h"
+
+#include <libim/content/asset/material/texutils.h>
+#include <libim/content/audio/impl/serialization/sound_ser_helper.h>
+#include <libim/content/text/text_resource_writer.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/memorystream.h>
+#include <libim/types/safe_cast.h>
+#include <libim/utils/utils.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+using namespace libim;
+using namespace libim::content::asset;
+using namespace libim::content::audio;
+using namespace libim::content::text;
+using namespace libim::utils;
+using namespace std::string_view_literals;
+
+static constexpr std::size_t kSoundSampleRate = 22050;
+static constexpr std::size_t kSoundChannels   = 2;
+static constexpr std::size_t kSoundBitSize    = 16;
+static constexpr std::size_t kMaxMipLevels    = 4;
+static constexpr std::size_t kKeyEntryStep    = 5; // Add key node entry every 5th frame
+
+static constexpr auto kBaseGhost = "_synth_ghost"sv;
+static constexpr auto kBaseItem  = "_synth_item"sv;
+static constexpr auto kBaseActor = "_synth_actor"sv;
+
+
+/** Makes resource name: <worldName>_<idx>.<ext> */
+static std::string makeResourceName(const WorldGenParams& params, std::size_t idx, std::string_view ext)
+{
+    return format("%_%.%", params.name, idx, ext);
+}
+
+/** Returns random float in range [min, max] */
+static float randf(std::minstd_rand& rng, float min, float max)
+{
+    constexpr auto kRange = 1u << 16;
+    return min + (max - min) * float(rng() % (kRange + 1)) / float(kRange);
+}
+
+Material libim::content::asset::generateMaterial(const WorldGenParams& params, std::size_t idx)
+{
+    const auto size = params.materialSize;
+    if (size == 0 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("Material size must be power of 2");
+    }
+
+    const auto mipLevels = std::min<uint32_t>(kMaxMipLevels, calcMaxMipmapLevels(size, size));
+    std::vector<Texture> cels;
+    cels.reserve(params.numMaterialCels);
+    for (std::size_t c = 0; c < std::max<std::size_t>(1, params.numMaterialCels); c++)
+    {
+        auto pixdata = makePixdataPtr(calcMipmapSize(size, size, mipLevels, RGB565));
+        auto it = pixdata->begin();
+        for (uint32_t lod = 0; lod < mipLevels; lod++)
+        {
+            // RGB565 gradient with checker pattern
+            const auto lsize = size >> lod;
+            for (uint32_t y = 0; y < lsize; y++)
+            {
+                for (uint32_t x = 0; x < lsize; x++)
+                {
+                    const uint16_t r = static_cast<uint16_t>(x * 31 / lsize);
+                    const uint16_t g = static_cast<uint16_t>(y * 63 / lsize);
+                    const uint16_t b = ((x * 8 / lsize + y * 8 / lsize + idx + c) & 1) ? 31 : 0;
+                    const uint16_t p = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+                    *it++ = static_cast<byte_t>(p & 0xFF);
+                    *it++ = static_cast<byte_t>(p >> 8);
+                }
+            }
+        }
+        cels.emplace_back(size, size, mipLevels, RGB565, std::move(pixdata));
+    }
+
+    Material mat(makeResourceName(params, idx, "mat"));
+    mat.setCells(std::move(cels));
+    return mat;
+}
+
+Table<Material> libim::content::asset::generateMaterials(const WorldGenParams& params)
+{
+    Table<Material> materials;
+    materials.reserve(params.numMaterials);
+    for (std::size_t i = 0; i < params.numMaterials; i++)
+    {
+        auto mat = generateMaterial(params, i);
+        auto name = mat.name();
+        materials.pushBack(std::move(name), std::move(mat));
+    }
+    return materials;
+}
+
+Animation libim::content::asset::generateAnimation(const WorldGenParams& params, std::size_t idx)
+{
+    std::minstd_rand rng(params.seed + safe_cast<uint32_t>(idx));
+    const auto numFrames = std::max<std::size_t>(1, params.numAnimationFrames);
+
+    std::vector<KeyNode> nodes;
+    nodes.reserve(params.numAnimationNodes);
+    for (std::size_t n = 0; n < params.numAnimationNodes; n++)
+    {
+        KeyNode node;
+        node.num      = safe_cast<uint32_t>(n);
+        node.meshName = format("node_%", n);
+        for (std::size_t f = 0; f < numFrames; f += kKeyEntryStep)
+        {
+            KeyNodeEntry e;
+            e.frame    = float(f);
+            e.flags    = Flags(KeyNodeEntry::PositionChange) | KeyNodeEntry::RotationChange;
+            e.position = Vector3f(randf(rng, -0.1f, 0.1f), randf(rng, -0.1f, 0.1f), randf(rng, -0.1f, 0.1f));
+            e.rot      = FRotator(randf(rng, -90.0f, 90.0f), randf(rng, -90.0f, 90.0f), randf(rng, -90.0f, 90.0f));
+            e.dpos     = Vector3f(randf(rng, -0.01f, 0.01f), randf(rng, -0.01f, 0.01f), randf(rng, -0.01f, 0.01f));
+            e.drot     = FRotator(randf(rng, -5.0f, 5.0f), randf(rng, -5.0f, 5.0f), randf(rng, -5.0f, 5.0f));
+            node.entries.push_back(std::move(e));
+        }
+        nodes.push_back(std::move(node));
+    }
+
+    Animation anim(makeResourceName(params, idx, "key"));
+    anim.setType(Animation::Torso);
+    anim.setFrames(safe_cast<uint32_t>(numFrames));
+    anim.setFps(15.0f);
+    anim.setJoints(safe_cast<uint32_t>(params.numAnimationNodes));
+    anim.setMarkers({
+        KeyMarker{ 0.0f, KeyMarker::LeftFoot },
+        KeyMarker{ float(numFrames / 2), KeyMarker::RightFoot }
+    });
+    anim.setNodes(std::move(nodes));
+    return anim;
+}
+
+UniqueTable<Animation> libim::content::asset::generateAnimations(const WorldGenParams& params)
+{
+    UniqueTable<Animation> animations;
+    animations.reserve(params.numAnimations);
+    for (std::size_t i = 0; i < params.numAnimations; i++)
+    {
+        auto anim = generateAnimation(params, i);
+        auto name = anim.name();
+        animations.pushBack(std::move(name), std::move(anim));
+    }
+    return animations;
+}
+
+ByteArray libim::content::asset::generateSoundWav(const WorldGenParams& params, std::size_t idx)
+{
+    const std::size_t numFrames = kSoundSampleRate * params.soundDuration / 1000;
+    const std::size_t dataSize  = numFrames * kSoundChannels * (kSoundBitSize / 8);
+
+    ByteArray pcm(dataSize);
+    const double freq = 220.0 + 55.0 * double(idx % 16);
+    for (std::size_t i = 0; i < numFrames; i++)
+    {
+        const double t = double(i) / double(kSoundSampleRate);
+        const auto s   = static_cast<uint16_t>(static_cast<int16_t>(8000.0 * std::sin(2.0 * 3.14159265358979 * freq * t)));
+        for (std::size_t c = 0; c < kSoundChannels; c++)
+        {
+            const auto pos = (i * kSoundChannels + c) * sizeof(int16_t);
+            pcm[pos]     = static_cast<byte_t>(s & 0xFF);
+            pcm[pos + 1] = static_cast<byte_t>(s >> 8);
+        }
+    }
+
+    MemoryOutputStream os;
+    os.reserve(dataSize + 64);
+    wavWrite(os, kSoundChannels, kSoundSampleRate, kSoundBitSize, pcm);
+    return os.release();
+}
+
+void libim::content::asset::generateSounds(const WorldGenParams& params, SoundBank& bank, std::size_t trackIdx)
+{
+    for (std::size_t i = 0; i < params.numSounds; i++)
+    {
+        auto wav = generateSoundWav(params, i);
+        InputBinaryStream<ByteArray> is(wav);
+        is.setName(makeResourceName(params, i, "wav"));
+        bank.loadSound(is, trackIdx, params.compressSounds);
+    }
+}
+
+/**
+ * Generates world geometry and sectors.
+ * Each sector is a box with floor divided into floorDivisions^2 surfaces, one ceiling surface and 4 walls.
+ * Walls shared with neighbour sectors are adjoin surfaces.
+ */
+static void generateGeometry(const WorldGenParams& params, SyntheticWorld& world)
+{
+    const std::size_t N    = params.gridSize;
+    const std::size_t D    = params.floorDivisions;
+    const std::size_t numSectors   = N * N;
+    const std::size_t floorVerts   = (D + 1) * (D + 1);
+    const std::size_t sectorVerts  = floorVerts + 4; // + ceiling
+    const std::size_t sectorSurfs  = D * D + 5;      // floor + ceiling + 4 walls
+    const float S = params.sectorSize;
+    const float H = params.sectorHeight;
+
+    std::minstd_rand rng(params.seed);
+    auto& geo = world.georesource;
+    geo.vertices.reserve(numSectors * sectorVerts);
+    geo.surfaces.reserve(numSectors * sectorSurfs);
+    geo.adjoins.reserve(4 * N * (N - 1));
+    world.sectors.reserve(numSectors);
+
+    // Texture vertices are shared between sectors: floor grid + wall/ceiling corners
+    const auto uvSize = float(params.materialSize);
+    geo.texVertices.reserve(floorVerts + 4);
+    for (std::size_t j = 0; j <= D; j++)
+    {
+        for (std::size_t i = 0; i <= D; i++) {
+            geo.texVertices.emplace_back(uvSize * float(i) / float(D), uvSize * float(j) / float(D));
+        }
+    }
+    const std::size_t uvCorner = geo.texVertices.size();
+    geo.texVertices.emplace_back(0.0f, 0.0f);
+    geo.texVertices.emplace_back(uvSize, 0.0f);
+    geo.texVertices.emplace_back(uvSize, uvSize);
+    geo.texVertices.emplace_back(0.0f, uvSize);
+
+    const auto randomMatIdx = [&]() -> std::optional<std::size_t> {
+        if (params.numMaterials == 0) return std::nullopt;
+        return rng() % params.numMaterials;
+    };
+
+    const auto addSurface = [&](Flags<Surface::SurfaceFlag> surflags, Vector3f normal, std::initializer_list<std::pair<std::size_t, std::size_t>> verts) -> Surface& {
+        Surface s;
+        s.id         = geo.surfaces.size();
+        s.surflags   = surflags;
+        s.flags      = Face::FogEnabled;
+        s.matIdx     = randomMatIdx();
+        s.geoMode    = s.matIdx ? GeoMode::Textured : GeoMode::Solid;
+        s.lightMode  = LightMode::Gouraud;
+        s.extraLight = LinearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
+        s.normal     = normal;
+        s.vertices.reserve(verts.size());
+        s.vecIntensities.reserve(verts.size());
+        for (auto [vi, uvi] : verts)
+        {
+            s.vertices.push_back({ vi, uvi });
+            const auto l = randf(rng, 0.2f, 1.0f);
+            s.vecIntensities.push_back(LinearColor({ l, l, l, 1.0f }));
+        }
+        return geo.surfaces.emplace_back(std::move(s));
+    };
+
+    // Adjoin index of each sector wall. Wall order: -y, +x, +y, -x
+    std::vector<std::optional<std::size_t>> wallAdjoins(numSectors * 4);
+    const auto neighbour = [N](std::size_t sx, std::size_t sy, std::size_t dir) -> std::optional<std::size_t> {
+        switch (dir)
+        {
+            case 0: return sy > 0     ? std::optional(sx + (sy - 1) * N) : std::nullopt;
+            case 1: return sx + 1 < N ? std::optional(sx + 1 + sy * N)   : std::nullopt;
+            case 2: return sy + 1 < N ? std::optional(sx + (sy + 1) * N) : std::nullopt;
+            default: return sx > 0    ? std::optional(sx - 1 + sy * N)   : std::nullopt;
+        }
+    };
+
+    for (std::size_t sy = 0; sy < N; sy++)
+    {
+        for (std::size_t sx = 0; sx < N; sx++)
+        {
+            const std::size_t sid   = sx + sy * N;
+            const std::size_t vbase = geo.vertices.size();
+            const float ox = float(sx) * S;
+            const float oy = float(sy) * S;
+
+            // Floor vertices with slightly uneven height
+            for (std::size_t j = 0; j <= D; j++)
+            {
+                for (std::size_t i = 0; i <= D; i++) {
+                    const bool edge = i == 0 || j == 0 || i == D || j == D;
+                    geo.vertices.emplace_back(ox + S * float(i) / float(D), oy + S * float(j) / float(D), edge ? 0.0f : randf(rng, 0.0f, 0.02f));
+                }
+            }
+
+            // Ceiling vertices
+            geo.vertices.emplace_back(ox    , oy    , H);
+            geo.vertices.emplace_back(ox + S, oy    , H);
+            geo.vertices.emplace_back(ox + S, oy + S, H);
+            geo.vertices.emplace_back(ox    , oy + S, H);
+
+            const auto fv = [&](std::size_t i, std::size_t j) { return vbase + j * (D + 1) + i; };
+            const std::array<std::size_t, 4> floorCorner = { fv(0, 0), fv(D, 0), fv(D, D), fv(0, D) };
+            const std::array<std::size_t, 4> ceilCorner  = { vbase + floorVerts, vbase + floorVerts + 1, vbase + floorVerts + 2, vbase + floorVerts + 3 };
+
+            Sector sec{};
+            sec.id = sid;
+            sec.surfaces.firstIdx = geo.surfaces.size();
+
+            // Floor
+            for (std::size_t j = 0; j < D; j++)
+            {
+                for (std::size_t i = 0; i < D; i++)
+                {
+                    const auto uv = [D](std::size_t i, std::size_t j) { return j * (D + 1) + i; };
+                    addSurface(Flags(Surface::Floor) | Surface::Collision, Vector3f(0.0f, 0.0f, 1.0f), {
+                        { fv(i, j),         uv(i, j)         },
+                        { fv(i + 1, j),     uv(i + 1, j)     },
+                        { fv(i + 1, j + 1), uv(i + 1, j + 1) },
+                        { fv(i, j + 1),     uv(i, j + 1)     }
+                    });
+                }
+            }
+
+            // Ceiling
+            addSurface(Surface::Collision, Vector3f(0.0f, 0.0f, -1.0f), {
+                { ceilCorner[3], uvCorner + 3 },
+                { ceilCorner[2], uvCorner + 2 },
+                { ceilCorner[1], uvCorner + 1 },
+                { ceilCorner[0], uvCorner     }
+            });
+
+            // Walls facing inside of the sector
+            const std::array<Vector3f, 4> wallNormals = {
+                Vector3f(0.0f, 1.0f, 0.0f), Vector3f(-1.0f, 0.0f, 0.0f), Vector3f(0.0f, -1.0f, 0.0f), Vector3f(1.0f, 0.0f, 0.0f)
+            };
+            for (std::size_t dir = 0; dir < 4; dir++)
+            {
+                const auto c0 = dir;
+                const auto c1 = (dir + 1) % 4;
+                auto& s = addSurface(Surface::Collision, wallNormals[dir], {
+                    { floorCorner[c0], uvCorner     },
+                    { floorCorner[c1], uvCorner + 1 },
+                    { ceilCorner[c1],  uvCorner + 2 },
+                    { ceilCorner[c0],  uvCorner + 3 }
+                });
+
+                if (neighbour(sx, sy, dir))
+                {
+                    // Open passage to neighbour sector, mirror adjoin is set after all sectors are made
+                    SurfaceAdjoin a;
+                    a.flags    = Flags(SurfaceAdjoin::Visible) | SurfaceAdjoin::AllowMovement | SurfaceAdjoin::AllowSound;
+                    a.distance = 0.0f;
+
+                    s.surflags  = Surface::None;
+                    s.matIdx    = std::nullopt;
+                    s.geoMode   = GeoMode::NotDrawn;
+                    s.adjoinIdx = geo.adjoins.size();
+                    wallAdjoins[sid * 4 + dir] = geo.adjoins.size();
+                    geo.adjoins.push_back(std::move(a));
+                }
+            }
+            sec.surfaces.count = geo.surfaces.size() - sec.surfaces.firstIdx;
+
+            sec.vertIdxs.resize(sectorVerts);
+            std::iota(sec.vertIdxs.begin(), sec.vertIdxs.end(), vbase);
+
+            const Vector3f min(ox, oy, 0.0f);
+            const Vector3f max(ox + S, oy + S, H);
+            sec.center     = Vector3f(ox + S / 2.0f, oy + S / 2.0f, H / 2.0f);
+            sec.radius     = std::sqrt(S * S / 2.0f + H * H / 4.0f);
+            sec.boundBox   = Box3f(min, max);
+            sec.collideBox = Box3f(min, max);
+            sec.tint       = LinearColorRgb({ 0.0f, 0.0f, 0.0f });
+            sec.thrust     = Vector3f(0.0f, 0.0f, 0.0f);
+
+            const auto ambient = randf(rng, 0.1f, 0.4f);
+            sec.ambientLight = LinearColor({ ambient, ambient, ambient, 1.0f });
+            sec.extraLight   = LinearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
+            sec.avgLight.position   = sec.center;
+            sec.avgLight.color      = LinearColor({ randf(rng, 0.0f, 1.0f), randf(rng, 0.0f, 1.0f), randf(rng, 0.0f, 1.0f), 1.0f });
+            sec.avgLight.falloffMin = 2.0f * sec.radius;
+            sec.avgLight.falloffMax = 3.0f * sec.radius;
+
+            if (params.numSounds > 0 && sid % 8 == 0) {
+                sec.ambientSound = Sector::AmbientSound{ makeResourceName(params, (sid / 8) % params.numSounds, "wav"), 0.5f };
+            }
+
+            world.sectors.push_back(std::move(sec));
+        }
+    }
+
+    // Link mirror adjoins
+    for (std::size_t sid = 0; sid < numSectors; sid++)
+    {
+        for (std::size_t dir = 0; dir < 4; dir++)
+        {
+            if (auto aidx = wallAdjoins[sid * 4 + dir]) {
+                const auto nid = *neighbour(sid % N, sid / N, dir);
+                geo.adjoins[*aidx].mirrorIdx = wallAdjoins[nid * 4 + (dir + 2) % 4];
+            }
+        }
+    }
+
+    // PVS: each sector has a row of bits of visible sectors (itself and direct neighbours)
+    const std::size_t rowSize = ((numSectors + 31) / 32) * 4;
+    world.pvs.resize(rowSize * numSectors);
+    for (std::size_t sid = 0; sid < numSectors; sid++)
+    {
+        auto& sec  = world.sectors[sid];
+        sec.pvsIdx = safe_cast<int32_t>(sid * rowSize);
+
+        const auto setVisible = [&](std::size_t vid) {
+            world.pvs[sid * rowSize + vid / 8] |= static_cast<byte_t>(1u << (vid % 8));
+        };
+        setVisible(sid);
+        for (std::size_t dir = 0; dir < 4; dir++)
+        {
+            if (auto nid = neighbour(sid % N, sid / N, dir)) {
+                setVisible(*nid);
+            }
+        }
+    }
+}
+
+/** Generates base templates and params.numTemplates templates derived from them. */
+static void generateTemplates(const WorldGenParams& params, SyntheticWorld& world)
+{
+    CndThing ghost{};
+    ghost.name     = CndResourceName(kBaseGhost);
+    ghost.baseName = "none";
+    ghost.type     = Thing::Ghost;
+    ghost.moveType = CndThingMoveType::None;
+
+    CndPhysicsInfo physics{};
+    physics.flags       = PhysicsInfo::UseGravity;
+    physics.mass        = 2.0f;
+    physics.height      = 0.05f;
+    physics.airDrag     = 1.0f;
+    physics.surfaceDrag = 3.0f;
+    physics.staticDrag  = 0.3f;
+    physics.maxRotationVelocity = 200.0f;
+    physics.maxVelocity = 1.0f;
+    physics.orientSpeed = 1.0f;
+
+    CndThing item{};
+    item.name             = CndResourceName(kBaseItem);
+    item.baseName         = "none";
+    item.type             = Thing::Item;
+    item.moveType         = CndThingMoveType::Physics;
+    item.moveInfo         = physics;
+    item.thingInfo        = CndItemInfo{};
+    item.collide.type     = Collide::Sphere;
+    item.collide.size     = 0.05f;
+    item.collide.movesize = 0.05f;
+
+    CndActorInfo actorInfo{};
+    actorInfo.health       = 100.0f;
+    actorInfo.maxHealth    = 100.0f;
+    actorInfo.maxThrust    = 1.0f;
+    actorInfo.maxRotThrust = 180.0f;
+    actorInfo.jumpSpeed    = 1.5f;
+    actorInfo.maxHeadPitch = 80.0f;
+    actorInfo.minHeadPitch = -80.0f;
+
+    CndThing actor{};
+    actor.name             = CndResourceName(kBaseActor);
+    actor.baseName         = "none";
+    actor.type             = Thing::Actor;
+    actor.moveType         = CndThingMoveType::Physics;
+    actor.moveInfo         = physics;
+    actor.thingInfo        = actorInfo;
+    actor.collide.type     = Collide::Sphere;
+    actor.collide.size     = 0.1f;
+    actor.collide.movesize = 0.1f;
+    actor.init();
+
+    std::array<CndThing, 3> bases = { ghost, item, actor };
+    for (auto& t : bases) {
+        world.templates.pushBack(t.name.toStdString(), t);
+    }
+
+    const std::size_t numModels = std::min<std::size_t>(params.numTemplates, 8);
+    for (std::size_t i = 0; i < numModels; i++) {
+        world.models.push_back(makeResourceName(params, i, "3do"));
+    }
+
+    std::minstd_rand rng(params.seed);
+    for (std::size_t i = 0; i < params.numTemplates; i++)
+    {
+        CndThing t    = bases[i % bases.size()];
+        t.baseName    = t.name;
+        t.name        = CndResourceName(format("%_tpl_%", params.name, i));
+        t.rdThingType = CndRdThingType::RdModel;
+        t.rdThingFilename = CndResourceName(world.models[i % numModels]);
+        if (t.type != Thing::Ghost) {
+            t.collide.size *= randf(rng, 0.5f, 2.0f);
+        }
+        if (!world.templates.pushBack(t.name.toStdString(), t).second) {
+            throw std::invalid_argument(format("Duplicated template name '%'", t.name));
+        }
+    }
+}
+
+/** Places params.numThings things in sectors. */
+static void generateThings(const WorldGenParams& params, SyntheticWorld& world)
+{
+    if (world.sectors.empty()) {
+        return;
+    }
+
+    std::minstd_rand rng(params.seed);
+    const auto S = params.sectorSize;
+    world.things.reserve(params.numThings);
+
+    // Things are created only from derived templates or from base templates if there is none
+    const std::size_t first = params.numTemplates > 0 ? 3 : 0;
+    const std::size_t count = world.templates.size() - first;
+    for (std::size_t i = 0; i < params.numThings; i++)
+    {
+        const auto& tpl = world.templates.value(first + i % count);
+        const auto sid  = (i * 7919) % world.sectors.size(); // spread things across the sectors
+        const auto& sec = world.sectors[sid];
+
+        CndThing t = tpl;
+        t.baseName  = tpl.name;
+        t.sectorNum = safe_cast<int32_t>(sid);
+        t.position  = Vector3f(
+            sec.center.x() + randf(rng, -S / 4.0f, S / 4.0f),
+            sec.center.y() + randf(rng, -S / 4.0f, S / 4.0f),
+            0.1f
+        );
+        t.pyrOrient = FRotator(0.0f, 0.0f, std::round(randf(rng, -180.0f, 180.0f)));
+        world.things.push_back(std::move(t));
+    }
+}
+
+SyntheticWorld libim::content::asset::generateWorld(const WorldGenParams& params)
+{
+    if (params.name.empty()) {
+        throw std::invalid_argument("World name must not be empty");
+    }
+    if (params.gridSize == 0 || params.floorDivisions == 0) {
+        throw std::invalid_argument("World grid size and floor divisions must be greater than 0");
+    }
+    if (params.sectorSize <= 0.0f || params.sectorHeight <= 0.0f) {
+        throw std::invalid_argument("Sector size and height must be greater than 0");
+    }
+
+    SyntheticWorld world;
+    world.materials  = generateMaterials(params);
+    world.animations = generateAnimations(params);
+
+    world.soundBank = std::make_unique<SoundBank>(SyntheticWorld::kSoundTrack + 1);
+    world.soundBank->setStaticTrack(SyntheticWorld::kSoundTrack, false);
+    generateSounds(params, *world.soundBank, SyntheticWorld::kSoundTrack);
+
+    generateGeometry(params, world);
+    generateTemplates(params, world);
+    generateThings(params, world);
+
+    // Header
+    auto& h = world.header;
+    h = CndHeader{};
+    h.copyright       = kWorldFileCopyright;
+    h.filePath        = CndResourceName(params.name + ".cnd");
+    h.state           = Flags(CndWorldState::UpdateFog) | CndWorldState::InitHUD;
+    h.version         = kCndFileVersion;
+    h.worldGravity    = 4.0f;
+    h.ceilingSky_Z    = 15.0f;
+    h.horizonDistance = 200.0f;
+    h.lodDistances    = { 0.3f, 0.6f, 0.9f, 1.2f };
+    h.fog.enabled     = 0;
+    h.fog.color       = LinearColor({ 0.0f, 0.0f, 0.0f, 1.0f });
+    h.fog.startDepth  = 0.0f;
+    h.fog.endDepth    = 100.0f;
+
+    h.numSounds         = safe_cast<uint32_t>(world.soundBank->getTrack(SyntheticWorld::kSoundTrack).size());
+    h.numMaterials      = safe_cast<uint32_t>(world.materials.size());
+    h.sizeMaterials     = h.numMaterials;
+    h.numVertices       = safe_cast<uint32_t>(world.georesource.vertices.size());
+    h.numTexVertices    = safe_cast<uint32_t>(world.georesource.texVertices.size());
+    h.numAdjoins        = safe_cast<uint32_t>(world.georesource.adjoins.size());
+    h.numSurfaces       = safe_cast<uint32_t>(world.georesource.surfaces.size());
+    h.numSectors        = safe_cast<uint32_t>(world.sectors.size());
+    h.numModels         = safe_cast<uint32_t>(world.models.size());
+    h.sizeModels        = h.numModels;
+    h.numKeyframes      = safe_cast<uint32_t>(world.animations.size());
+    h.sizeKeyframes     = h.numKeyframes;
+    h.numThingTemplates = safe_cast<uint32_t>(world.templates.size());
+    h.sizeThingTemplates = h.numThingTemplates;
+    h.numThings         = safe_cast<uint32_t>(world.things.size());
+    h.sizePVS           = safe_cast<uint32_t>(world.pvs.size());
+    return world;
+}
+
+void libim::content::asset::writeWorldCnd(OutputStream& ostream, const SyntheticWorld& world)
+{
+    // Reserve space for the header by writing it first, it's rewritten at the end with the file size
+    ostream.seek(0);
+    ostream.write(world.header);
+    CND::writeSection_Sounds(ostream, *world.soundBank, SyntheticWorld::kSoundTrack);
+    CND::writeSection_Materials(ostream, world.materials);
+    CND::writeSection_Georesource(ostream, world.georesource);
+    CND::writeSection_Sectors(ostream, world.sectors);
+    CND::writeSection_AIClasses(ostream, world.aiClasses);
+    CND::writeSection_Models(ostream, world.models);
+    CND::writeSection_Sprites(ostream, world.sprites);
+    CND::writeSection_Keyframes(ostream, world.animations);
+    CND::writeSection_AnimClasses(ostream, world.animClasses);
+    CND::writeSection_SoundClasses(ostream, world.soundClasses);
+    CND::writeSection_CogScripts(ostream, {});
+    CND::writeSection_Cogs(ostream, {});
+    CND::writeSection_Templates(ostream, world.templates);
+    CND::writeSection_Things(ostream, world.things, world.templates);
+    CND::writeSection_PVS(ostream, world.pvs);
+
+    CndHeader header = world.header;
+    header.fileSize  = safe_cast<uint32_t>(ostream.tell());
+    const auto end   = ostream.tell();
+    ostream.seek(0);
+    ostream.write(header);
+    ostream.seek(end);
+}
+
+void libim::content::asset::writeWorldNdy(OutputStream& ostream, const SyntheticWorld& world)
+{
+    const auto& h = world.header;
+    TextResourceWriter rw(ostream);
+    NDY::writeSection_Copyright(rw);
+    NDY::writeSection_Header(rw, h);
+    NDY::writeSection_Sounds(rw, h.numSounds, world.soundBank->getTrack(SyntheticWorld::kSoundTrack));
+    NDY::writeSection_Materials(rw, world.materials);
+    NDY::writeSection_Georesource(rw, world.georesource);
+    NDY::writeSection_Sectors(rw, world.sectors);
+    NDY::writeSection_AIClasses(rw, h.sizeAIClasses, world.aiClasses);
+    NDY::writeSection_Models(rw, h.sizeModels, world.models);
+    NDY::writeSection_Sprites(rw, h.sizeSprites, world.sprites);
+    NDY::writeSection_Keyframes(rw, h.sizeKeyframes, world.animations);
+    NDY::writeSection_AnimClasses(rw, h.sizePuppets, world.animClasses);
+    NDY::writeSection_SoundClasses(rw, h.sizeSoundClasses, world.soundClasses);
+    NDY::writeSection_CogScripts(rw, h.sizeCogScripts, {});
+    NDY::writeSection_Cogs(rw, h.sizeCogs, {});
+    NDY::writeSection_Templates(rw, h.sizeThingTemplates, world.templates);
+    NDY::writeSection_Things(rw, world.things, world.templates);
+    NDY::writeSection_PVS(rw, world.pvs, world.sectors);
+}
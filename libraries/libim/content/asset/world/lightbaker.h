@@ -0,0 +1,57 @@
+#ifndef LIBIM_LIGHTBAKER_H
+#define LIBIM_LIGHTBAKER_H
+#include <cstddef>
+#include <span>
+
+#include "impl/serialization/cnd/thing/cnd_thing.h"
+#include "georesource.h"
+#include "sector.h"
+
+namespace libim::content::asset {
+
+    /** Options of world vertex light baking. */
+    struct LightBakeOptions final
+    {
+        bool sectorLights = true;       // Use sector avgLight as point light.
+        bool thingLights  = true;       // Use light of things which have Thing::EmitsLight flag set.
+        bool shadows      = true;       // Lights are occluded by world surfaces.
+        float thingLightRange = 2.0f;   // Range of thing light in world units when thing light color alpha is 0.
+        float maxIntensity    = 1.0f;   // Baked vertex intensity is clamped to [0, maxIntensity].
+        float shadowBias      = 0.001f; // Offset of the shadow ray origin from surface along surface normal.
+        std::size_t maxThreads = 0;     // Max number of threads to bake surfaces. 0 = all hardware threads.
+    };
+
+    /** Result of world vertex light baking. */
+    struct LightBakeStats final
+    {
+        std::size_t numLights   = 0; // number of point lights
+        std::size_t numSurfaces = 0; // number of baked surfaces
+        std::size_t numVertices = 0; // number of baked surface vertices
+        std::size_t numRays     = 0; // number of cast shadow rays
+        std::size_t numOccludedRays = 0;
+    };
+
+    /**
+     * Bakes vertex intensities of world surfaces (Surface::vecIntensities).
+     *
+     * Intensity of surface vertex is the sum of ambient light of the surface sector and
+     * light of all point lights which reach the vertex. Point lights are sector avgLight and
+     * light of things which emit light. Thing light color alpha is used as the light range.
+     * Light is attenuated linearly from full intensity at falloffMin to 0 at falloffMax
+     * (thing light from 0 to its range) and by the angle between surface normal and light direction.
+     *
+     * When shadows are enabled, the light is occluded by world surfaces which are not adjoin surfaces.
+     * Shadow rays are cast through bounding volume hierarchy of surface triangles.
+     * Surfaces are baked in parallel. Sky surfaces are not baked.
+     * The alpha of existing vertex intensity is preserved, new intensities have alpha 1.
+     *
+     * @param geo     - world georesource.
+     * @param sectors - world sectors.
+     * @param things  - world things.
+     * @param options - bake options.
+     * @return LightBakeStats
+     * @throw std::invalid_argument if surface references vertex out of range, or sector references surface out of range.
+     */
+    LightBakeStats bakeVertexLight(Georesource& geo, std::span<const Sector> sectors, std::span<const CndThing> things, const LightBakeOptions& options = {});
+}
+#endif // LIBIM_LIGHTBAKER_H
@@ -8,6 +8,7 @@
 #include <libim/math/vector3.h>
 
 #include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <vector>
 
@@ -42,6 +43,14 @@ namespace libim::content::asset {
         };
 
         using Id = std::size_t;
+
+        Sector() = default;
+
+        /** Constructs sector which allocates vertex index list from memory resource mr. */
+        explicit Sector(std::pmr::memory_resource* mr) :
+            vertIdxs(mr)
+        {}
+
         Id id;
 
         Flags<Flag> flags;
@@ -65,7 +74,7 @@ namespace libim::content::asset {
         };
         std::optional<AmbientSound> ambientSound;
 
-        std::vector<std::size_t> vertIdxs;
+        std::pmr::vector<std::size_t> vertIdxs;
 
         struct {
             std::size_t firstIdx;
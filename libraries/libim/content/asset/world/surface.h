@@ -1,7 +1,9 @@
 #ifndef LIBIM_SURFACE_H
 #define LIBIM_SURFACE_H
 #include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 #include "../primitives/face.h"
 #include <libim/types/flags.h>
@@ -68,10 +70,18 @@ namespace libim::content::asset {
 
         using Id = std::size_t;
 
+        Surface() = default;
+
+        /** Constructs surface which allocates vertex and intensity lists from memory resource mr. */
+        explicit Surface(std::pmr::memory_resource* mr) :
+            Face(mr),
+            vecIntensities(mr)
+        {}
+
         Id id;
         Flags<SurfaceFlag> surflags;
         std::optional<std::size_t> adjoinIdx;
-        std::vector<LinearColor> vecIntensities;  // Verticies color. The size should be the same as `verts`.
+        std::pmr::vector<LinearColor> vecIntensities;  // Verticies color. The size should be the same as `verts`.
                                                   // The color of each vertex is applied over surface's texture and
                                                   // can give surface an additional ambient color e.g. underwater blue color.
     };
@@ -4,6 +4,7 @@
 #include <string>
 #include <optional>
 
+#include <libim/math/fmath.h>
 #include <libim/math/math.h>
 #include <libim/types/flags.h>
 
@@ -0,0 +1,104 @@
+#include "cndpatch_test.h"
+#include "../worldgen.h"
+#include "../impl/serialization/cnd/cndpatch.h"
+
+#include <libim/common.h>
+#include <libim/io/filestream.h>
+
+#include <assert.h>
+#include <cstddef>
+#include <filesystem>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+static std::filesystem::path writeTestCnd(const SyntheticWorld& world)
+{
+    const auto path = std::filesystem::temp_directory_path() / "libim_cndpatch_test.cnd";
+    OutputFileStream ofs(path, /*truncate=*/true);
+    writeWorldCnd(ofs, world);
+    return path;
+}
+
+void libim::unit_test::run_cndpatch_tests()
+{
+    WorldGenParams p;
+    p.name          = "cptest";
+    p.gridSize      = 2;
+    p.numMaterials  = 4;
+    p.materialSize  = 16;
+    p.numAnimations = 3;
+    p.numSounds     = 1;
+    p.numThings     = 5;
+    const auto world = generateWorld(p);
+
+// Test case 1: Section layout covers whole file
+    {
+        const auto path = writeTestCnd(world);
+        InputFileStream ifs(path);
+        const auto layout = CND::getSectionLayout(ifs, CND::readHeader(ifs));
+        assert(layout.front().offset == 0);
+        assert(layout.front().size == sizeof(CndHeader));
+        for (std::size_t i = 1; i < layout.size(); i++) {
+            assert(layout[i].offset == layout[i - 1].end());
+        }
+        assert(layout.back().end() == ifs.size());
+        assert(layout[std::size_t(CndSection::Materials)].offset == CND::getOffset_Materials(ifs));
+        ifs.close();
+        deleteFile(path);
+    }
+
+// Test case 2: Same size section is patched in place
+    {
+        const auto path = writeTestCnd(world);
+        auto mats = world.materials;
+        mats[mats.value(0).name()] = generateMaterial(p, 0);
+
+        CndPatch patch(path);
+        patch.setMaterials(mats);
+        assert(!patch.empty());
+        assert(patch.commit());
+        assert(patch.empty());
+
+        InputFileStream ifs(path);
+        assert(CND::readHeader(ifs).fileSize == ifs.size());
+        assert(CND::readMaterials(ifs).size() == mats.size());
+        ifs.close();
+        deleteFile(path);
+    }
+
+// Test case 3: Batched edits which change section size rebuild the file
+    {
+        const auto path = writeTestCnd(world);
+        auto mats = world.materials;
+        mats.erase(mats.value(1).name());
+        auto anims = world.animations;
+        anims.erase(anims.value(0).name());
+
+        CndPatch patch(path);
+        patch.setMaterials(mats);
+        patch.setKeyframes(anims);
+        assert(!patch.commit());
+
+        // layout is updated after commit
+        for (std::size_t i = 1; i < patch.layout().size(); i++) {
+            assert(patch.layout()[i].offset == patch.layout()[i - 1].end());
+        }
+
+        InputFileStream ifs(path);
+        [[maybe_unused]] const auto header = CND::readHeader(ifs);
+        assert(header.fileSize == ifs.size());
+        assert(header.numMaterials == mats.size());
+        assert(header.numKeyframes == anims.size());
+        assert(CND::getSectionLayout(ifs, header) == patch.layout());
+
+        const auto rmats = CND::readMaterials(ifs);
+        assert(rmats.size() == mats.size());
+        assert(!rmats.contains(world.materials.value(1).name()));
+        assert(CND::readKeyframes(ifs).size() == anims.size());
+        assert(CND::readSectors(ifs) == world.sectors);
+        assert(CND::readPVS(ifs) == world.pvs);
+        ifs.close();
+        deleteFile(path);
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef LIBIM_CNDPATCH_TEST_H
+#define LIBIM_CNDPATCH_TEST_H
+
+namespace libim::unit_test {
+    void run_cndpatch_tests();
+}
+
+#endif // LIBIM_CNDPATCH_TEST_H
@@ -0,0 +1,132 @@
+#include "cndview_test.h"
+#include "../worldgen.h"
+#include "../impl/serialization/cnd/cndview.h"
+
+#include <libim/common.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/filestream.h>
+#include <libim/io/memorystream.h>
+
+#include <assert.h>
+#include <cstddef>
+#include <filesystem>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+void libim::unit_test::run_cndview_tests()
+{
+    WorldGenParams p;
+    p.name          = "cvtest";
+    p.gridSize      = 2;
+    p.numMaterials  = 4;
+    p.materialSize  = 16;
+    p.numAnimations = 3;
+    p.numSounds     = 1;
+    p.numThings     = 5;
+    const auto world = generateWorld(p);
+
+    MemoryOutputStream ostream;
+    writeWorldCnd(ostream, world);
+    const ByteArray data = ostream.release();
+
+// Test case 1: View arrays match parsed sections
+    {
+        const CndView view(data);
+        InputBinaryStream<ByteArray> istream(data);
+        [[maybe_unused]] const auto header = CND::readHeader(istream);
+        assert(view.header().fileSize == data.size());
+        assert(view.layout() == CND::getSectionLayout(istream, header));
+        assert(view.section(CndSection::Header).size() == sizeof(CndHeader));
+
+        assert(view.materials().size() == world.materials.size());
+        for (std::size_t i = 0; i < view.materials().size(); i++) {
+            assert(view.materials()[i].name.toStdString() == world.materials.value(i).name());
+        }
+
+        const auto geores = CND::readGeoresource(istream);
+        assert(view.vertices().size() == geores.vertices.size());
+        assert(std::equal(view.vertices().begin(), view.vertices().end(), geores.vertices.begin()));
+        assert(view.texVertices().size() == geores.texVertices.size());
+        assert(view.surfaces().size() == geores.surfaces.size());
+
+        std::size_t numSurfVerts = 0;
+        for (const auto& s : view.surfaces()) {
+            numSurfVerts += s.numVerts;
+        }
+        assert(view.surfaceVerts().size() == numSurfVerts);
+
+        assert(view.sectors().size() == world.sectors.size());
+        std::size_t numSectorVerts = 0;
+        for (std::size_t i = 0; i < view.sectors().size(); i++)
+        {
+            assert(view.sectors()[i].firstSurfaceIdx == static_cast<int32_t>(world.sectors.at(i).surfaces.firstIdx));
+            numSectorVerts += world.sectors.at(i).vertIdxs.size();
+        }
+        assert(view.sectorVertIdxs().size() == numSectorVerts);
+
+        assert(view.keyframes().size() == world.animations.size());
+        for (std::size_t i = 0; i < view.keyframes().size(); i++) {
+            assert(view.keyframes()[i].name.toStdString() == world.animations.value(i).name());
+        }
+
+        assert(view.aiClasses().size() == world.aiClasses.size());
+        assert(view.models().size() == world.models.size());
+        assert(view.sprites().size() == world.sprites.size());
+        assert(view.animClasses().size() == world.animClasses.size());
+        assert(view.soundClasses().size() == world.soundClasses.size());
+        assert(view.templates().headers.size() == world.templates.size());
+        assert(view.things().headers.size() == world.things.size());
+        assert(std::equal(view.pvs().begin(), view.pvs().end(), world.pvs.begin(), world.pvs.end()));
+    }
+
+// Test case 2: Mapped file view
+    {
+        const auto path = std::filesystem::temp_directory_path() / "libim_cndview_test.cnd";
+        {
+            OutputFileStream ofs(path, /*truncate=*/true);
+            writeWorldCnd(ofs, world);
+        }
+
+        {
+            const CndView view(path);
+            assert(view.data().size() == data.size());
+            assert(std::equal(view.data().begin(), view.data().end(), data.begin()));
+            assert(view.things().headers.size() == world.things.size());
+        }
+        deleteFile(path);
+    }
+
+// Test case 3: Truncated data is rejected
+    {
+        [[maybe_unused]] bool thrown = false;
+        try {
+            const CndView view(ByteView(data.data(), data.size() - 1));
+        }
+        catch (const CNDError&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+// Test case 4: Packed view of unaligned data
+    {
+        const auto verts = CndView(data).vertices();
+        if (!verts.isAligned())
+        {
+            [[maybe_unused]] bool thrown = false;
+            try {
+                (void)verts.span();
+            }
+            catch (const std::logic_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+        else {
+            assert(verts.span().size() == verts.size());
+        }
+        assert(verts.end() - verts.begin() == static_cast<std::ptrdiff_t>(verts.size()));
+        assert(verts.subview(1, verts.size() - 1).front() == verts[1]);
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef LIBIM_CNDVIEW_TEST_H
+#define LIBIM_CNDVIEW_TEST_H
+
+namespace libim::unit_test {
+    void run_cndview_tests();
+}
+
+#endif // LIBIM_CNDVIEW_TEST_H
@@ -0,0 +1,212 @@
+#include "geooptimizer_test.h"
+#include "../geooptimizer.h"
+#include "../worldgen.h"
+
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+static Surface makeSurface(std::size_t id, const std::vector<std::pair<std::size_t, std::optional<std::size_t>>>& verts)
+{
+    Surface s;
+    s.id = id;
+    for (const auto& [vertIdx, uvIdx] : verts) {
+        s.vertices.push_back({ vertIdx, uvIdx });
+    }
+    return s;
+}
+
+static Sector makeSector(std::size_t id, const std::vector<std::size_t>& vertIdxs)
+{
+    Sector s;
+    s.id = id;
+    s.vertIdxs.assign(vertIdxs.begin(), vertIdxs.end());
+    return s;
+}
+
+static bool isNear(const Vector3f& a, const Vector3f& b, float epsilon)
+{
+    return std::abs(a.x() - b.x()) <= epsilon && std::abs(a.y() - b.y()) <= epsilon && std::abs(a.z() - b.z()) <= epsilon;
+}
+
+void libim::unit_test::run_geooptimizer_tests()
+{
+// Test case 1: Equal vertices and texture vertices are welded and unused ones are removed
+    {
+        Georesource geo;
+        geo.vertices = {
+            { 0.0f, 0.0f, 0.0f },
+            { 1.0f, 0.0f, 0.0f },
+            { 5.0f, 5.0f, 5.0f }, // unused
+            { 1.0f, 0.0f, 0.0f }, // welded with 1
+            { -0.0f, 0.0f, 0.0f }, // welded with 0
+            { 0.0f, 1.0f, 0.0f }  // used only by sector
+        };
+        geo.texVertices = {
+            { 0.0f, 0.0f },
+            { 9.0f, 9.0f }, // unused
+            { 0.0f, 0.0f }, // welded with 0
+            { 1.0f, 1.0f }
+        };
+        geo.surfaces.push_back(makeSurface(0, { { 0, 0 }, { 1, 3 }, { 3, 2 } }));
+        geo.surfaces.push_back(makeSurface(1, { { 4, std::nullopt }, { 3, std::nullopt } }));
+        std::vector<Sector> sectors = { makeSector(0, { 0, 1, 3, 4, 5 }) };
+
+        [[maybe_unused]] const auto stats = optimizeGeometry(geo, sectors, { 0.0f, 0.0f });
+        assert(stats.numVertices == 6 && stats.numWeldedVertices == 2 && stats.numUnusedVertices == 1);
+        assert(stats.numRemovedVertices() == 3);
+        assert(stats.numTexVertices == 4 && stats.numWeldedTexVertices == 1 && stats.numUnusedTexVertices == 1);
+
+        assert((geo.vertices == std::vector<Vector3f>{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }));
+        assert((geo.texVertices == std::vector<Vector2f>{ { 0.0f, 0.0f }, { 1.0f, 1.0f } }));
+
+        // Last vertex of surface 0 is collapsed into the previous one, which leaves surface degenerate
+        [[maybe_unused]] const auto& s0 = geo.surfaces.at(0).vertices;
+        assert(s0.size() == 2);
+        assert(s0.at(0).vertIdx == 0 && s0.at(0).uvIdx == 0);
+        assert(s0.at(1).vertIdx == 1 && s0.at(1).uvIdx == 1);
+        assert(stats.numCollapsedSurfVertices == 1 && stats.numDegenerateSurfaces == 1);
+
+        [[maybe_unused]] const auto& s1 = geo.surfaces.at(1).vertices;
+        assert(s1.at(0).vertIdx == 0 && !s1.at(0).uvIdx);
+        assert(s1.at(1).vertIdx == 1 && !s1.at(1).uvIdx);
+
+        // Duplicated sector vertex indices are removed
+        assert((sectors.at(0).vertIdxs == std::pmr::vector<std::size_t>{ 0, 1, 2 }));
+    }
+
+// Test case 2: Vertices within epsilon are welded across grid cell boundary, vertices not within epsilon are kept
+    {
+        Georesource geo;
+        geo.vertices = {
+            { 0.1999f, 0.0f, 0.0f },
+            { 0.2099f, 0.0f, 0.0f }, // welded with 0 from neighbour cell
+            { 0.3050f, 0.0f, 0.0f }, // within epsilon of 1, but 1 was welded
+            { 0.5000f, 0.0f, 0.0f }
+        };
+        geo.surfaces.push_back(makeSurface(0, { { 0, std::nullopt }, { 1, std::nullopt }, { 2, std::nullopt }, { 3, std::nullopt } }));
+
+        GeoOptimizeOptions opt;
+        opt.vertexEpsilon = 0.1f;
+        [[maybe_unused]] const auto stats = optimizeGeometry(geo, {}, opt);
+        assert(stats.numWeldedVertices == 1 && stats.numUnusedVertices == 0);
+        assert(geo.vertices.size() == 3);
+
+        [[maybe_unused]] const auto& v = geo.surfaces.at(0).vertices;
+        assert(v.size() == 3 && stats.numCollapsedSurfVertices == 1 && stats.numDegenerateSurfaces == 0);
+        assert(v.at(0).vertIdx == 0 && v.at(1).vertIdx == 1 && v.at(2).vertIdx == 2);
+    }
+
+// Test case 3: Invalid indices throw and geometry is not modified
+    {
+        Georesource geo;
+        geo.vertices = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+        geo.surfaces.push_back(makeSurface(0, { { 0, std::nullopt }, { 1, 0 } })); // no texture vertices
+        const auto orig = geo;
+
+        [[maybe_unused]] bool thrown = false;
+        try {
+            optimizeGeometry(geo, {});
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && geo == orig);
+
+        geo.surfaces.at(0).vertices.at(1).uvIdx.reset();
+        std::vector<Sector> sectors = { makeSector(0, { 2 }) };
+        thrown = false;
+        try {
+            optimizeGeometry(geo, sectors);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && geo.vertices.size() == 2);
+    }
+
+// Test case 4: Optimized world surfaces keep vertex positions and result doesn't depend on number of threads
+    {
+        WorldGenParams p;
+        p.gridSize     = 4;
+        p.numMaterials = 2;
+        p.materialSize = 8;
+        p.numSounds    = 1;
+        p.numThings    = 1;
+        const auto world = generateWorld(p);
+
+        auto geo1     = world.georesource;
+        auto sectors1 = world.sectors;
+        GeoOptimizeOptions opt;
+        opt.maxThreads = 1;
+        [[maybe_unused]] const auto stats1 = optimizeGeometry(geo1, sectors1, opt);
+
+        auto geo     = world.georesource;
+        auto sectors = world.sectors;
+        opt.maxThreads = 4;
+        [[maybe_unused]] const auto stats = optimizeGeometry(geo, sectors, opt);
+        assert(geo == geo1 && sectors == sectors1);
+        assert(stats.numRemovedVertices() == stats1.numRemovedVertices());
+        assert(geo.vertices.size() == world.georesource.vertices.size() - stats.numRemovedVertices());
+
+        for (std::size_t i = 0; i < geo.surfaces.size(); i++)
+        {
+            const auto& surf     = geo.surfaces.at(i);
+            const auto& origSurf = world.georesource.surfaces.at(i);
+            for (std::size_t j = 0; j < surf.vertices.size(); j++)
+            {
+                [[maybe_unused]] const auto& v  = geo.vertices.at(surf.vertices.at(j).vertIdx);
+                [[maybe_unused]] const auto& ov = world.georesource.vertices.at(origSurf.vertices.at(j).vertIdx);
+                assert(isNear(v, ov, opt.vertexEpsilon));
+            }
+        }
+
+        // Optimized geometry can't be optimized further
+        [[maybe_unused]] const auto stats2 = optimizeGeometry(geo, sectors);
+        assert(stats2.numRemovedVertices() == 0 && stats2.numRemovedTexVertices() == 0);
+    }
+
+// Test case 5: Welded adjacent surface vertices are collapsed together with vertex intensities
+    {
+        Georesource geo;
+        geo.vertices = {
+            { 0.0f, 0.0f, 0.0f },
+            { 1.0f, 0.0f, 0.0f },
+            { 1.0f, 0.0f, 0.0f }, // welded with 1
+            { 0.0f, 1.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f }  // welded with 0
+        };
+        geo.texVertices = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } };
+
+        // Adjacent vertices 1 and 2 are welded
+        geo.surfaces.push_back(makeSurface(0, { { 0, 0 }, { 1, 1 }, { 2, 1 }, { 3, 2 } }));
+        geo.surfaces.at(0).vecIntensities = {
+            LinearColor({ 0.1f, 0.1f, 0.1f, 1.0f }),
+            LinearColor({ 0.2f, 0.2f, 0.2f, 1.0f }),
+            LinearColor({ 0.3f, 0.3f, 0.3f, 1.0f }),
+            LinearColor({ 0.4f, 0.4f, 0.4f, 1.0f })
+        };
+
+        // Last vertex 4 is welded with the first vertex 0
+        geo.surfaces.push_back(makeSurface(1, { { 0, 0 }, { 1, 1 }, { 3, 2 }, { 4, 0 } }));
+
+        [[maybe_unused]] const auto stats = optimizeGeometry(geo, {}, { 0.0f, 0.0f });
+        assert(stats.numWeldedVertices == 2 && stats.numCollapsedSurfVertices == 2 && stats.numDegenerateSurfaces == 0);
+
+        [[maybe_unused]] const auto& s0 = geo.surfaces.at(0);
+        assert(s0.vertices.size() == 3 && s0.vecIntensities.size() == 3);
+        assert(s0.vertices.at(0).vertIdx == 0 && s0.vertices.at(1).vertIdx == 1 && s0.vertices.at(2).vertIdx == 2);
+        assert(s0.vertices.at(1).uvIdx == 1 && s0.vertices.at(2).uvIdx == 2);
+        assert(s0.vecIntensities.at(1) == LinearColor({ 0.2f, 0.2f, 0.2f, 1.0f }));
+        assert(s0.vecIntensities.at(2) == LinearColor({ 0.4f, 0.4f, 0.4f, 1.0f }));
+
+        [[maybe_unused]] const auto& s1 = geo.surfaces.at(1).vertices;
+        assert(s1.size() == 3 && s1.at(0).vertIdx == 0 && s1.at(1).vertIdx == 1 && s1.at(2).vertIdx == 2);
+    }
+}
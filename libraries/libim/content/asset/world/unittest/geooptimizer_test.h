@@ -0,0 +1,8 @@
+#ifndef LIBIM_GEOOPTIMIZER_TEST_H
+#define LIBIM_GEOOPTIMIZER_TEST_H
+
+namespace libim::unit_test {
+    void run_geooptimizer_tests();
+}
+
+#endif // LIBIM_GEOOPTIMIZER_TEST_H
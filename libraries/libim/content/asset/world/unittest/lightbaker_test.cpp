@@ -0,0 +1,250 @@
+#include "lightbaker_test.h"
+#include "../lightbaker.h"
+#include "../worldgen.h"
+#include "../../../../utils/arena.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::asset;
+
+/** Makes surface quad at height z from (-size, -size) to (size, size) facing up or down. */
+static Surface makeQuad(Georesource& geo, std::size_t id, float z, float size, bool up = true)
+{
+    Surface s{};
+    s.id = id;
+    s.normal = { 0.0f, 0.0f, up ? 1.0f : -1.0f };
+
+    const auto first = geo.vertices.size();
+    geo.vertices.push_back({ -size, -size, z });
+    geo.vertices.push_back({  size, -size, z });
+    geo.vertices.push_back({  size,  size, z });
+    geo.vertices.push_back({ -size,  size, z });
+    for (std::size_t i = 0; i < 4; i++) {
+        s.vertices.push_back({ first + (up ? i : 3 - i), std::nullopt });
+    }
+    return s;
+}
+
+static Sector makeSector(std::size_t firstSurf, std::size_t numSurfs, float ambient)
+{
+    Sector s{};
+    s.ambientLight = LinearColor({ ambient, ambient, ambient, 1.0f });
+    s.avgLight.position   = { 0.0f, 0.0f, 1.0f };
+    s.avgLight.color      = LinearColor({ 0.5f, 0.5f, 0.5f, 1.0f });
+    s.avgLight.falloffMin = 2.0f;
+    s.avgLight.falloffMax = 4.0f;
+    s.surfaces.firstIdx = firstSurf;
+    s.surfaces.count    = numSurfs;
+    return s;
+}
+
+static bool isNear(const LinearColor& c, float intensity, float alpha = 1.0f)
+{
+    constexpr float eps = 1e-5f;
+    return std::abs(c.red() - intensity) <= eps && std::abs(c.green() - intensity) <= eps &&
+           std::abs(c.blue() - intensity) <= eps && std::abs(c.alpha() - alpha) <= eps;
+}
+
+void libim::unit_test::run_lightbaker_tests()
+{
+// Test case 1: Vertex intensity is ambient light plus sector light, thing light behind surface and disabled thing light are ignored
+    {
+        Georesource geo;
+        geo.surfaces.push_back(makeQuad(geo, 0, 0.0f, 1.0f));
+        std::vector<Sector> sectors = { makeSector(0, 1, 0.1f) };
+
+        std::vector<CndThing> things(2);
+        things[0].position = { 0.0f, 0.0f, -0.5f }; // behind surface
+        things[0].flags    = Thing::Flag::EmitsLight;
+        things[0].light.color = LinearColor({ 1.0f, 1.0f, 1.0f, 0.0f });
+        things[1].position = { 0.0f, 0.0f, 0.5f }; // doesn't emit light
+        things[1].light.color = LinearColor({ 1.0f, 1.0f, 1.0f, 0.0f });
+
+        [[maybe_unused]] const auto stats = bakeVertexLight(geo, sectors, things);
+        assert(stats.numLights == 2 && stats.numSurfaces == 1 && stats.numVertices == 4);
+        assert(stats.numRays == 4 && stats.numOccludedRays == 0);
+
+        // All vertices are within falloffMin at distance sqrt(3) and angle cos = 1 / sqrt(3)
+        const auto& vi = geo.surfaces.at(0).vecIntensities;
+        assert(vi.size() == 4);
+        for ([[maybe_unused]] const auto& c : vi) {
+            assert(isNear(c, 0.1f + 0.5f / std::sqrt(3.0f)));
+        }
+    }
+
+// Test case 2: Light is occluded by surface but not by adjoin surface
+    {
+        Georesource geo;
+        geo.surfaces.push_back(makeQuad(geo, 0, 0.0f, 1.0f));
+        geo.surfaces.push_back(makeQuad(geo, 1, 0.5f, 2.0f, /*up=*/false));
+        std::vector<Sector> sectors = { makeSector(0, 2, 0.1f) };
+
+        auto stats = bakeVertexLight(geo, sectors, {});
+        assert(stats.numOccludedRays == 4);
+        for ([[maybe_unused]] const auto& c : geo.surfaces.at(0).vecIntensities) {
+            assert(isNear(c, 0.1f));
+        }
+
+        geo.surfaces.at(1).adjoinIdx = 0;
+        stats = bakeVertexLight(geo, sectors, {});
+        assert(stats.numOccludedRays == 0);
+        for ([[maybe_unused]] const auto& c : geo.surfaces.at(0).vecIntensities) {
+            assert(isNear(c, 0.1f + 0.5f / std::sqrt(3.0f)));
+        }
+
+        LightBakeOptions opt;
+        opt.shadows = false;
+        geo.surfaces.at(1).adjoinIdx.reset();
+        stats = bakeVertexLight(geo, sectors, {}, opt);
+        assert(stats.numRays == 0);
+        for ([[maybe_unused]] const auto& c : geo.surfaces.at(0).vecIntensities) {
+            assert(isNear(c, 0.1f + 0.5f / std::sqrt(3.0f)));
+        }
+    }
+
+// Test case 3: Light attenuation and range, intensity clamp, existing alpha is preserved and sky surfaces are not baked
+    {
+        Georesource geo;
+        geo.surfaces.push_back(makeQuad(geo, 0, 0.0f, 1.0f));
+        geo.surfaces.push_back(makeQuad(geo, 1, 0.0f, 1.0f));
+        geo.surfaces.at(1).surflags = Surface::HorizonSky;
+        geo.surfaces.at(0).vecIntensities.assign(4, LinearColor({ 0.0f, 0.0f, 0.0f, 0.5f }));
+        std::vector<Sector> sectors = { makeSector(0, 2, 0.1f) };
+
+        // Linear attenuation between falloffMin and falloffMax
+        sectors[0].avgLight.falloffMin = 1.0f;
+        sectors[0].avgLight.falloffMax = 2.0f;
+        auto stats = bakeVertexLight(geo, sectors, {});
+        assert(stats.numSurfaces == 1 && geo.surfaces.at(1).vecIntensities.empty());
+
+        [[maybe_unused]] const float atten = 2.0f - std::sqrt(3.0f);
+        for ([[maybe_unused]] const auto& c : geo.surfaces.at(0).vecIntensities) {
+            assert(isNear(c, 0.1f + 0.5f * atten / std::sqrt(3.0f), 0.5f));
+        }
+
+        // Vertices out of light range
+        sectors[0].avgLight.falloffMax = 1.5f;
+        stats = bakeVertexLight(geo, sectors, {});
+        assert(stats.numRays == 0);
+        for ([[maybe_unused]] const auto& c : geo.surfaces.at(0).vecIntensities) {
+            assert(isNear(c, 0.1f, 0.5f));
+        }
+
+        // Thing light range is color alpha, intensity is clamped to maxIntensity
+        std::vector<CndThing> things(1);
+        things[0].position = { 0.0f, 0.0f, 1.0f };
+        things[0].flags    = Thing::Flag::EmitsLight;
+        things[0].light.color = LinearColor({ 4.0f, 4.0f, 4.0f, 10.0f });
+
+        LightBakeOptions opt;
+        opt.sectorLights = false;
+        opt.maxIntensity = 0.8f;
+        stats = bakeVertexLight(geo, sectors, things, opt);
+        assert(stats.numLights == 1);
+        for ([[maybe_unused]] const auto& c : geo.surfaces.at(0).vecIntensities) {
+            assert(isNear(c, 0.8f, 0.5f));
+        }
+    }
+
+// Test case 4: Baked world doesn't depend on number of threads
+    {
+        WorldGenParams p;
+        p.gridSize     = 4;
+        p.numMaterials = 2;
+        p.materialSize = 8;
+        p.numSounds    = 1;
+        p.numThings    = 8;
+        const auto world = generateWorld(p);
+
+        auto geo1 = world.georesource;
+        LightBakeOptions opt;
+        opt.maxThreads = 1;
+        [[maybe_unused]] const auto stats1 = bakeVertexLight(geo1, world.sectors, world.things, opt);
+
+        auto geo = world.georesource;
+        opt.maxThreads = 4;
+        [[maybe_unused]] const auto stats = bakeVertexLight(geo, world.sectors, world.things, opt);
+        assert(geo == geo1);
+        assert(stats.numLights == stats1.numLights && stats.numLights >= world.sectors.size());
+        assert(stats.numRays == stats1.numRays && stats.numOccludedRays == stats1.numOccludedRays);
+        assert(stats.numVertices > 0);
+
+        for ([[maybe_unused]] const auto& surf : geo.surfaces) {
+            assert(surf.vecIntensities.size() == surf.vertices.size());
+        }
+    }
+
+// Test case 5: Surface lists allocated from arena are baked with multiple threads
+    {
+        WorldGenParams p;
+        p.gridSize     = 4;
+        p.numMaterials = 2;
+        p.materialSize = 8;
+        p.numSounds    = 1;
+        p.numThings    = 8;
+        const auto world = generateWorld(p);
+
+        auto geo1 = world.georesource;
+        for (auto& s : geo1.surfaces) {
+            s.vecIntensities.clear();
+        }
+
+        LightBakeOptions opt;
+        opt.maxThreads = 1;
+        bakeVertexLight(geo1, world.sectors, world.things, opt);
+
+        utils::Arena arena;
+        Georesource geo;
+        geo.vertices = world.georesource.vertices;
+        for (const auto& s : world.georesource.surfaces)
+        {
+            auto& as = geo.surfaces.emplace_back(&arena);
+            as = s;
+            as.vecIntensities.clear();
+        }
+
+        opt.maxThreads = 4;
+        bakeVertexLight(geo, world.sectors, world.things, opt);
+        assert(geo.surfaces.size() == geo1.surfaces.size());
+        for (std::size_t i = 0; i < geo.surfaces.size(); i++)
+        {
+            [[maybe_unused]] const auto& vi = geo.surfaces[i].vecIntensities;
+            assert(vi.get_allocator().resource() == &arena);
+            assert(vi.size() == geo.surfaces[i].vertices.size());
+            assert(std::equal(vi.begin(), vi.end(), geo1.surfaces[i].vecIntensities.begin(), geo1.surfaces[i].vecIntensities.end()));
+        }
+    }
+
+// Test case 6: Invalid indices throw
+    {
+        Georesource geo;
+        geo.surfaces.push_back(makeQuad(geo, 0, 0.0f, 1.0f));
+        std::vector<Sector> sectors = { makeSector(0, 2, 0.1f) };
+
+        [[maybe_unused]] bool thrown = false;
+        try {
+            bakeVertexLight(geo, sectors, {});
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        sectors[0].surfaces.count = 1;
+        geo.surfaces.at(0).vertices.at(0).vertIdx = 4;
+        thrown = false;
+        try {
+            bakeVertexLight(geo, sectors, {});
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef LIBIM_LIGHTBAKER_TEST_H
+#define LIBIM_LIGHTBAKER_TEST_H
+
+namespace libim::unit_test {
+    void run_lightbaker_tests();
+}
+
+#endif // LIBIM_LIGHTBAKER_TEST_H
@@ -0,0 +1,160 @@
+#include "worldgen_test.h"
+#include "../worldgen.h"
+#include "../impl/serialization/ndy/ndy.h"
+
+#include <libim/content/text/text_resource_reader.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/vfstream.h>
+
+#include <assert.h>
+#include <cstddef>
+#include <string>
+
+using namespace libim;
+using namespace libim::content::asset;
+using namespace libim::content::text;
+
+static WorldGenParams makeTestParams()
+{
+    WorldGenParams p;
+    p.name           = "wgtest";
+    p.gridSize       = 3;
+    p.floorDivisions = 2;
+    p.numMaterials   = 3;
+    p.materialSize   = 16;
+    p.numAnimations  = 2;
+    p.numSounds      = 2;
+    p.soundDuration  = 50;
+    p.numTemplates   = 4;
+    p.numThings      = 10;
+    return p;
+}
+
+void libim::unit_test::run_worldgen_tests()
+{
+// Test case 1: Generated world has expected size and linked adjoins
+    {
+        const auto p = makeTestParams();
+        const auto world = generateWorld(p);
+        assert(world.sectors.size() == 9);
+        assert(world.georesource.surfaces.size() == 9 * (2 * 2 + 5));
+        assert(world.georesource.adjoins.size() == 2 * 2 * 3 * 2);
+        assert(world.materials.size() == p.numMaterials);
+        assert(world.animations.size() == p.numAnimations);
+        assert(world.soundBank->getTrack(SyntheticWorld::kSoundTrack).size() == p.numSounds);
+        assert(world.templates.size() == 3 + p.numTemplates);
+        assert(world.things.size() == p.numThings);
+
+        const auto& adjoins = world.georesource.adjoins;
+        for (std::size_t i = 0; i < adjoins.size(); i++)
+        {
+            assert(adjoins[i].mirrorIdx.has_value());
+            assert(adjoins[*adjoins[i].mirrorIdx].mirrorIdx == i);
+        }
+    }
+
+// Test case 2: Same seed generates same world, written CND is read back equal
+    {
+        const auto p = makeTestParams();
+        const auto world = generateWorld(p);
+        assert(world.georesource.vertices == generateWorld(p).georesource.vertices);
+
+        ByteArray cnd;
+        OutputBinaryStream<ByteArray> os(cnd);
+        writeWorldCnd(os, world);
+
+        InputBinaryStream<ByteArray> is(cnd);
+        [[maybe_unused]] const auto header = CND::readHeader(is);
+        assert(header.fileSize == cnd.size());
+        assert(header.numSurfaces == world.georesource.surfaces.size());
+
+        const auto geo = CND::readGeoresource(is);
+        assert(geo.vertices    == world.georesource.vertices);
+        assert(geo.texVertices == world.georesource.texVertices);
+        assert(geo.adjoins     == world.georesource.adjoins);
+        assert(geo.surfaces    == world.georesource.surfaces);
+
+        assert(CND::readSectors(is) == world.sectors);
+        assert(CND::readPVS(is) == world.pvs);
+
+        const auto mats = CND::readMaterials(is);
+        assert(mats.size() == world.materials.size());
+        for (std::size_t i = 0; i < mats.size(); i++) {
+            assert(mats.value(i).name() == world.materials.value(i).name());
+        }
+
+        const auto anims = CND::readKeyframes(is);
+        assert(anims.size() == world.animations.size());
+        for (std::size_t i = 0; i < anims.size(); i++) {
+            assert(anims.value(i).nodes() == world.animations.value(i).nodes());
+        }
+
+        const auto templates = CND::readTemplates(is);
+        assert(templates.size() == world.templates.size());
+        const auto things = CND::readThings(is, templates);
+        assert(things.size() == world.things.size());
+        for (std::size_t i = 0; i < things.size(); i++)
+        {
+            assert(things[i].name      == world.things[i].name);
+            assert(things[i].sectorNum == world.things[i].sectorNum);
+            assert(things[i].position  == world.things[i].position);
+        }
+    }
+
+// Test case 3: Written NDY georesource and sectors are parsed back
+    {
+        const auto world = generateWorld(makeTestParams());
+
+        ByteArray ndy;
+        OutputBinaryStream<ByteArray> os(ndy);
+        writeWorldNdy(os, world);
+
+        InputBinaryStream<ByteArray> is(ndy);
+        TextResourceReader rr(is);
+        rr.assertSection(NDY::kSectionCopyright);
+        assert(NDY::parseSection_Copyright(rr));
+        rr.assertSection(NDY::kSectionHeader);
+        [[maybe_unused]] const auto header = NDY::parseSection_Header(rr);
+        assert(header.version == kCndFileVersion);
+        rr.assertSection(NDY::kSectionSounds);
+        assert(NDY::parseSection_Sounds(rr).second.size() == world.header.numSounds);
+        rr.assertSection(NDY::kSectionMaterials);
+        assert(NDY::parseSection_Materials(rr).second.size() == world.materials.size());
+        rr.assertSection(NDY::kSectionGeoresource);
+        const auto geo = NDY::parseSection_Georesource(rr);
+        assert(geo.surfaces.size() == world.georesource.surfaces.size());
+        assert(geo.adjoins.size() == world.georesource.adjoins.size());
+        rr.assertSection(NDY::kSectionSectors);
+        assert(NDY::parseSection_Sectors(rr).size() == world.sectors.size());
+    }
+
+// Test case 4: GOB written by GobWriter is loaded back
+    {
+        ByteArray gob;
+        OutputBinaryStream<ByteArray> os(gob);
+        GobWriter gw(os);
+        const ByteArray f1 = { 1, 2, 3 };
+        const ByteArray f2(1000, 7);
+        gw.add("mat/a.mat", f1);
+        gw.add("ndy/b.cnd", InputBinaryStream<ByteArray>(f2));
+
+        [[maybe_unused]] bool thrown = false;
+        try {
+            gw.add("MAT/A.mat", f1); // duplicate path
+        }
+        catch (const StreamError&) {
+            thrown = true;
+        }
+        assert(thrown);
+        gw.finish();
+        assert(gw.size() == 2);
+
+        auto c = gobLoad(makeSharedRef<InputBinaryStream<ByteArray>>(gob));
+        assert(c.size() == 2);
+        auto vf1 = c.get(std::string("mat/a.mat"));
+        auto vf2 = c.get(std::string("ndy/b.cnd"));
+        assert(vf1 && vf2);
+        assert((*vf1)->read(3) == f1);
+        assert((*vf2)->read(1000) == f2);
+    }
+}
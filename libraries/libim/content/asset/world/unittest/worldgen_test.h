@@ -0,0 +1,8 @@
+#ifndef LIBIM_WORLDGEN_TEST_H
+#define LIBIM_WORLDGEN_TEST_H
+
+namespace libim::unit_test {
+    void run_worldgen_tests();
+}
+
+#endif // LIBIM_WORLDGEN_TEST_H
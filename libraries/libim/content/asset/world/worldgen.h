@@ -0,0 +1,152 @@
+#ifndef LIBIM_WORLDGEN_H
+#define LIBIM_WORLDGEN_H
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "impl/serialization/cnd/cnd.h"
+#include "georesource.h"
+#include "sector.h"
+
+#include <libim/content/asset/animation/animation.h>
+#include <libim/content/asset/material/material.h>
+#include <libim/content/audio/soundbank.h>
+#include <libim/io/stream.h>
+#include <libim/types/indexmap.h>
+
+namespace libim::content::asset {
+
+    /**
+     * Parameters for generating synthetic world.
+     * World geometry is a grid of gridSize x gridSize box sectors
+     * which are connected to the neighbour sectors via adjoins.
+     *
+     * Total number of world surfaces is gridSize^2 * (floorDivisions^2 + 5),
+     * e.g. gridSize = 128 and floorDivisions = 8 gives ~1.1M surfaces.
+     */
+    struct WorldGenParams final
+    {
+        std::string name = "synth";     // World name. Used as prefix for all generated resource names.
+        uint32_t seed    = 1;           // Seed for pseudo random data.
+
+        std::size_t gridSize       = 8;    // Number of sectors along x and y axis.
+        std::size_t floorDivisions = 4;    // Number of floor surfaces along one side of sector.
+        float sectorSize           = 2.0f; // Sector width and length in world units.
+        float sectorHeight         = 1.0f;
+
+        std::size_t numMaterials     = 16;
+        uint32_t    materialSize     = 64; // Texture width and height, must be power of 2.
+        std::size_t numMaterialCels  = 1;
+
+        std::size_t numAnimations      = 8;
+        std::size_t numAnimationFrames = 30;
+        std::size_t numAnimationNodes  = 16;
+
+        std::size_t numSounds     = 8;
+        std::size_t soundDuration = 500;   // Sound duration in milliseconds.
+        bool compressSounds       = false; // Compress sounds with IndyWV compression.
+
+        std::size_t numTemplates = 16;     // Number of templates derived from built-in base templates.
+        std::size_t numThings    = 256;
+    };
+
+    /** Synthetic world resources. */
+    struct SyntheticWorld final
+    {
+        CndHeader header;
+        Table<Material> materials;
+        Georesource georesource;
+        std::vector<Sector> sectors;
+        std::vector<std::string> aiClasses;
+        std::vector<std::string> models;
+        std::vector<std::string> sprites;
+        UniqueTable<Animation> animations;
+        std::vector<std::string> animClasses;
+        std::vector<std::string> soundClasses;
+        UniqueTable<CndThing> templates;
+        std::vector<CndThing> things;
+        ByteArray pvs;
+
+        std::unique_ptr<audio::SoundBank> soundBank; // World sounds are stored in track kSoundTrack.
+        static constexpr std::size_t kSoundTrack = 1;
+    };
+
+    /**
+     * Generates material with numCels cels of RGB565 textures with up to 4 mipmap levels.
+     * The same params and idx always generate the same material.
+     *
+     * @param params - generator parameters
+     * @param idx    - material index, used for material name and texture pattern
+     * @return Material named <name>_<idx>.mat
+     */
+    [[nodiscard]] Material generateMaterial(const WorldGenParams& params, std::size_t idx);
+
+    /**
+     * Generates params.numMaterials materials.
+     * @see generateMaterial
+     */
+    [[nodiscard]] Table<Material> generateMaterials(const WorldGenParams& params);
+
+    /**
+     * Generates keyframe animation with params.numAnimationNodes nodes
+     * and a node entry every 5th frame.
+     *
+     * @param params - generator parameters
+     * @param idx    - animation index
+     * @return Animation named <name>_<idx>.key
+     */
+    [[nodiscard]] Animation generateAnimation(const WorldGenParams& params, std::size_t idx);
+
+    /**
+     * Generates params.numAnimations animations.
+     * @see generateAnimation
+     */
+    [[nodiscard]] UniqueTable<Animation> generateAnimations(const WorldGenParams& params);
+
+    /**
+     * Generates 16-bit stereo WAV file of sine tone.
+     * @param params - generator parameters
+     * @param idx    - sound index, used for tone frequency
+     * @return WAV file data
+     */
+    [[nodiscard]] ByteArray generateSoundWav(const WorldGenParams& params, std::size_t idx);
+
+    /**
+     * Generates params.numSounds sounds named <name>_<idx>.wav and loads them to sound bank track.
+     *
+     * @param params   - generator parameters
+     * @param bank     - sound bank to load sounds to
+     * @param trackIdx - sound bank track index
+     * @throw SoundBankError
+     */
+    void generateSounds(const WorldGenParams& params, audio::SoundBank& bank, std::size_t trackIdx);
+
+    /**
+     * Generates complete synthetic world.
+     * All generated data is valid for writing via CND::writeSection_* and NDY::writeSection_* functions.
+     *
+     * @param params - generator parameters
+     * @return SyntheticWorld
+     * @throw std::invalid_argument - if params are invalid
+     */
+    [[nodiscard]] SyntheticWorld generateWorld(const WorldGenParams& params);
+
+    /**
+     * Writes world as CND file.
+     * @param ostream  - output stream to write CND file to. CND file begins at offset 0 of the stream.
+     * @param world    - world to write
+     * @throw CNDError, StreamError
+     */
+    void writeWorldCnd(OutputStream& ostream, const SyntheticWorld& world);
+
+    /**
+     * Writes world as NDY file.
+     * @param ostream  - output stream to write NDY file to
+     * @param world    - world to write
+     * @throw StreamError
+     */
+    void writeWorldNdy(OutputStream& ostream, const SyntheticWorld& world);
+}
+#endif // LIBIM_WORLDGEN_H
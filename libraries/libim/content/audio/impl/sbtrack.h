@@ -66,7 +66,7 @@ namespace libim::content::audio {
             return *r.first;
         }
 
-        Sound& loadSound(const InputStream& istream)
+        Sound& loadSound(const InputStream& istream, bool compress = false)
         {
             auto getNameOffset =[](std::string_view path) {
                 auto offset = path.find_last_of('\\');
@@ -91,19 +91,34 @@ namespace libim::content::audio {
                 );
             }
 
-            auto pathOffset = data->write(soundFilePath);
-            auto dataOffset = data->write(dataSize, [&](byte_t* pOut, std::size_t size){
+            auto readData = [&](byte_t* pOut, std::size_t size) {
                 if (istream.read(pOut, size) != size) {
                     throw SoundBankError(
                         utils::format("SoundBank: Failed to read sound data '%' from stream!", istream.name())
                     );
                 }
                 return size;
-            });
+            };
+
+            bool isCompressed = sndType == SoundFormatType::IndyWV;
+            auto pathOffset   = data->write(soundFilePath);
+            std::size_t dataOffset;
+            if (compress && !isCompressed && IndyVW::canDeflate(numChannels, sampleBitSize))
+            {
+                ByteArray pcm(dataSize);
+                readData(pcm.data(), pcm.size());
+
+                auto cdata = IndyVW::deflate(pcm, numChannels, sampleBitSize);
+                dataSize   = safe_cast<uint32_t>(cdata.size());
+                dataOffset = data->write(ByteView{ cdata });
+                isCompressed = true;
+            }
+            else {
+                dataOffset = data->write(dataSize, readData);
+            }
 
             nameOffset += pathOffset;
             const auto soundIdx = safe_cast<uint32_t>(sounds.size());
-            const bool isCompressed = sndType == SoundFormatType::IndyWV;
 
             Sound snd(
                 SoundHandle(0),
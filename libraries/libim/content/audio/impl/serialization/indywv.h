@@ -1,13 +1,20 @@
 #ifndef LIBIM_INDYWV_H
 #define LIBIM_INDYWV_H
+#include <algorithm>
 #include <array>
-#include <assert.h>
 #include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
 
 #include <libim/common.h>
 #include <libim/log/log.h>
 #include <libim/io/binarystream.h>
+#include <libim/io/schema.h>
 #include <libim/io/stream.h>
+#include <libim/io/stremerror.h>
+#include <libim/utils/parallel.h>
+#include <libim/utils/utils.h>
 
 
 namespace libim::content::audio {
@@ -24,6 +31,24 @@ namespace libim::content::audio {
         int32_t unknown         = 0;
     });
     static_assert(sizeof(IndyWVHeader) == 26);
+}
+
+template<>
+struct libim::StructSchema<libim::content::audio::IndyWVHeader>
+{
+    using H = libim::content::audio::IndyWVHeader;
+    static constexpr std::string_view name = "IndyWVHeader";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&H::tag>("tag", libim::content::audio::kIndyWV),
+        schemaField<&H::sampleRate>("sampleRate"),
+        schemaField<&H::sampleBitSize>("sampleBitSize"),
+        schemaField<&H::numChannels>("numChannels"),
+        schemaField<&H::dataSize>("dataSize"),
+        schemaField<&H::unknown>("unknown")
+    );
+};
+
+namespace libim::content::audio {
 
     struct VWCompressorState
     {
@@ -48,91 +73,404 @@ namespace libim::content::audio {
             return static_cast<int16_t>(lo << 8) | hi;
         }
 
-        static ByteArray inflate(const InputStream& istream)
+        /** Parsed header of compressed IndyWV sound data stream. */
+        struct StreamInfo
         {
-            std::size_t numChannels = 1;
-            VWCompressorState state{};
+            std::size_t inflatedSize = 0;   // size of decompressed sound data
+            std::size_t numChannels  = 1;
+            std::size_t dataOffset   = 0;   // offset of the first compressed block
+            bool isWvsm              = false;
+        };
 
-            std::size_t infSize  = istream.read<uint32_t>();
-            auto unknown1 = istream.read<int8_t>();
-            auto unknown2 = istream.read<int16_t>();
+        /** Size of decompressed data block */
+        constexpr static std::size_t kBlockSize = 4096;
 
-            if(unknown1 < 0)
+        /**
+         * Parses the header of compressed sound data.
+         * @param data - compressed sound data
+         * @return StreamInfo
+         * @throw StreamError - if data is too short
+         */
+        static StreamInfo readStreamInfo(ByteView data)
+        {
+            auto readByte = [&](std::size_t off) -> byte_t {
+                if (off >= data.size()) {
+                    throw StreamError("IndyVW: Unexpected end of compressed sound data");
+                }
+                return data[off];
+            };
+            auto readBE16 = [&](std::size_t off) -> int16_t {
+                return static_cast<int16_t>((readByte(off) << 8) | readByte(off + 1));
+            };
+
+            StreamInfo info;
+            info.inflatedSize = static_cast<std::size_t>(readByte(0))       |
+                                static_cast<std::size_t>(readByte(1)) << 8  |
+                                static_cast<std::size_t>(readByte(2)) << 16 |
+                                static_cast<std::size_t>(readByte(3)) << 24;
+
+            VWCompressorState state{};
+            auto unknown1 = static_cast<int8_t>(readByte(4));
+            if (unknown1 < 0)
             {
-                state.unknown1 = ~unknown1;
-                numChannels = 2;
+                state.unknown1 = static_cast<byte_t>(~unknown1);
+                info.numChannels = 2;
             }
 
-            state.unknown2 = swap16(unknown2);
-            if(numChannels > 1)
+            state.unknown2 = readBE16(5);
+            info.dataOffset = 7;
+            if (info.numChannels > 1)
             {
-                state.unknown3 = istream.read<byte_t>();
-                state.unknown4 = swap16(istream.read<int16_t>());
+                state.unknown3 = readByte(7);
+                state.unknown4 = readBE16(8);
+                info.dataOffset = 10;
             }
 
-            ByteArray data;
-            data.reserve(infSize);
-            OutputBinaryStream obs(data);
-
-            if(numChannels == 2 &&
-               state.unknown2 == 0x1111 &&
-               state.unknown3 == 0x64   &&
-               state.unknown4 == 0x2222 &&
-               istream.peek<decltype(kWVSM)>() == kWVSM)
-            {
-                // WVSM decompression
-                istream.advance(kWVSM.size());
+            info.isWvsm = info.numChannels == 2  &&
+                state.unknown2 == 0x1111         &&
+                state.unknown3 == 0x64           &&
+                state.unknown4 == 0x2222         &&
+                data.size() >= info.dataOffset + kWVSM.size() &&
+                std::equal(kWVSM.begin(), kWVSM.end(), data.begin() + static_cast<std::ptrdiff_t>(info.dataOffset));
+            if (info.isWvsm) {
+                info.dataOffset += kWVSM.size();
+            }
+            return info;
+        }
 
-                constexpr std::size_t blockSize = 4096;
-                for (std::size_t i = 0; i < infSize / blockSize; i++) {
-                    wvsmInflateBlock(istream, blockSize, obs);
-                }
+        /**
+         * Returns the size of decompressed sound data.
+         * @param data - compressed sound data
+         * @return size of decompressed data
+         */
+        static std::size_t inflatedSize(ByteView data)
+        {
+            return readStreamInfo(data).inflatedSize;
+        }
 
-                /* Read the remaining data, shorter than 1 block */
-                wvsmInflateBlock(istream, infSize % blockSize, obs);
-                assert(obs.size() == infSize && obs.tell() == obs.size());
+        /**
+         * Returns true if compressed sound data can be decompressed with inflate.
+         * Only WVSM compression mode is supported.
+         * @param data - compressed sound data
+         * @return bool
+         * @throw StreamError - if data is too short
+         */
+        static bool canInflate(ByteView data)
+        {
+            return readStreamInfo(data).isWvsm;
+        }
+
+        /**
+         * Decompresses sound data into the provided buffer.
+         * Buffer must be at least inflatedSize(data) big.
+         *
+         * @param data - compressed sound data
+         * @param out  - output buffer
+         * @return number of bytes written to out
+         * @throw StreamError - if data is corrupted or out is too small
+         */
+        static std::size_t inflate(ByteView data, MutableByteView out)
+        {
+            auto info = readStreamInfo(data);
+            if (!info.isWvsm)
+            {
+                // TODO: Implement ADPCM decompression method
+                LOG_ERROR("IndyVW: Cannot inflate sound data, unknown compression mode!");
+                return 0;
+            }
+
+            if (out.size() < info.inflatedSize) {
+                throw StreamError("IndyVW: Output buffer is too small");
             }
-            else {
+
+            const byte_t* src = data.data() + info.dataOffset;
+            const byte_t* end = data.data() + data.size();
+            byte_t* dest      = out.data();
+            forEachWvsmBlock(info.inflatedSize, [&](std::size_t blockSize) {
+                dest += wvsmInflateBlock(src, end, blockSize, dest);
+            });
+            return static_cast<std::size_t>(dest - out.data());
+        }
+
+        /**
+         * Decompresses sound data block by block into output stream
+         * without allocating buffer for the whole decompressed data.
+         *
+         * @param data    - compressed sound data
+         * @param ostream - output stream
+         * @return number of bytes written to ostream
+         * @throw StreamError - if data is corrupted
+         */
+        static std::size_t inflate(ByteView data, OutputStream& ostream)
+        {
+            auto info = readStreamInfo(data);
+            if (!info.isWvsm)
+            {
                 // TODO: Implement ADPCM decompression method
                 LOG_ERROR("IndyVW: Cannot inflate sound data, unknown compression mode!");
+                return 0;
             }
 
+            std::array<byte_t, kBlockSize> block;
+            const byte_t* src = data.data() + info.dataOffset;
+            const byte_t* end = data.data() + data.size();
+            std::size_t nWritten = 0;
+            forEachWvsmBlock(info.inflatedSize, [&](std::size_t blockSize) {
+                auto n = wvsmInflateBlock(src, end, blockSize, block.data());
+                ostream.write(ByteView{ block.data(), n });
+                nWritten += n;
+            });
+            return nWritten;
+        }
+
+        static ByteArray inflate(ByteView data)
+        {
+            ByteArray out(inflatedSize(data));
+            out.resize(inflate(data, MutableByteView{ out }));
+            return out;
+        }
+
+        static ByteArray inflate(const InputStream& istream)
+        {
+            auto data = istream.read<ByteArray>(istream.size() - istream.tell());
+            return inflate(ByteView{ data });
+        }
+
+        /**
+         * Returns true if sound data of given format can be compressed with deflate.
+         * @param numChannels   - number of channels
+         * @param sampleBitSize - sample bit size
+         * @return bool
+         */
+        static bool canDeflate(std::size_t numChannels, std::size_t sampleBitSize)
+        {
+            return numChannels == 2 && sampleBitSize == 16; // WVSM
+        }
+
+        /**
+         * Compresses 16 bit stereo LPCM sound data to WVSM format.
+         * Each block is compressed independently on multiple threads.
+         * Note, WVSM compression is lossy. Samples are stored as 8 bit values
+         * scaled by the per block and channel expander, samples which can't be
+         * represented are stored as 16 bit literals.
+         *
+         * @param pcm           - LPCM sound data
+         * @param numChannels   - number of channels
+         * @param sampleBitSize - sample bit size
+         * @param maxThreads    - max number of threads to use. 0 = all hardware threads.
+         * @return compressed sound data without IndyWVHeader
+         * @throw StreamError - if sound format is not supported or data is too big
+         */
+        static ByteArray deflate(ByteView pcm, std::size_t numChannels, std::size_t sampleBitSize, std::size_t maxThreads = 0)
+        {
+            if (!canDeflate(numChannels, sampleBitSize)) {
+                throw StreamError(
+                    utils::format("IndyVW: Can't compress sound with % channel(s) and % bit samples", numChannels, sampleBitSize)
+                );
+            }
+            if (pcm.size() > std::numeric_limits<uint32_t>::max()) {
+                throw StreamError("IndyVW: Sound data too big to compress");
+            }
+
+            const std::size_t nBlocks = pcm.size() / kBlockSize + 1;
+            std::vector<ByteArray> blocks(nBlocks);
+            utils::parallelFor(nBlocks, [&](std::size_t i) {
+                const auto offset = i * kBlockSize;
+                blocks[i] = wvsmDeflateBlock(pcm.subspan(offset, std::min(kBlockSize, pcm.size() - offset)));
+            }, maxThreads);
+
+            ByteArray data;
+            std::size_t cSize = 14;
+            for (const auto& b : blocks) {
+                cSize += b.size();
+            }
+            data.reserve(cSize);
+
+            const auto infSize = static_cast<uint32_t>(pcm.size());
+            data.push_back(static_cast<byte_t>(infSize & 0xFF));
+            data.push_back(static_cast<byte_t>((infSize >> 8) & 0xFF));
+            data.push_back(static_cast<byte_t>((infSize >> 16) & 0xFF));
+            data.push_back(static_cast<byte_t>(infSize >> 24));
+            data.push_back(0xFF);              // unknown1, < 0 = stereo
+            data.push_back(0x11);              // unknown2, BE
+            data.push_back(0x11);
+            data.push_back(0x64);              // unknown3
+            data.push_back(0x22);              // unknown4, BE
+            data.push_back(0x22);
+            data.insert(data.end(), kWVSM.begin(), kWVSM.end());
+
+            for (const auto& b : blocks) {
+                data.insert(data.end(), b.begin(), b.end());
+            }
             return data;
         }
 
     private:
-        static void wvsmInflateBlock(const InputStream& istream, std::size_t blockSize, OutputStream& dest)
+        /** Table of expanded 16 bit samples for each sample expander value */
+        using ExpandTable = std::array<std::array<uint16_t, 256>, 16>;
+        constexpr static ExpandTable makeExpandTable()
         {
-            std::size_t nSamples = blockSize / 2;
-            if(nSamples == 0){
-                return;
+            ExpandTable t{};
+            for (std::size_t e = 0; e < t.size(); e++)
+            {
+                for (std::size_t b = 0; b < t[e].size(); b++) {
+                    t[e][b] = static_cast<uint16_t>(static_cast<int8_t>(b) << e);
+                }
+            }
+            return t;
+        }
+
+        /**
+         * Returns the smallest sample expander at which most of the samples
+         * can be represented as 8 bit values.
+         */
+        static byte_t wvsmChooseExpander(const int16_t* samples, std::size_t count, std::size_t step)
+        {
+            const std::size_t nSamples   = (count + step - 1) / step;
+            const std::size_t maxEscapes = nSamples / 32;
+            for (int e = 0; e < 15; e++)
+            {
+                std::size_t nEscapes = 0;
+                for (std::size_t i = 0; i < count && nEscapes <= maxEscapes; i += step)
+                {
+                    if (!wvsmQuantize(samples[i], e)) {
+                        nEscapes++;
+                    }
+                }
+                if (nEscapes <= maxEscapes) {
+                    return static_cast<byte_t>(e);
+                }
+            }
+            return 15;
+        }
+
+        /** Returns 8 bit sample value or nullopt if sample can't be represented with expander */
+        static std::optional<int8_t> wvsmQuantize(int16_t sample, int expander)
+        {
+            const int32_t round = expander > 0 ? 1 << (expander - 1) : 0;
+            const int32_t q     = (static_cast<int32_t>(sample) + round) >> expander;
+            if (q < -127 || q > 127) { // -128 = 0x80 is reserved for literal
+                return std::nullopt;
+            }
+            const int32_t v = q * (1 << expander);
+            if (v < std::numeric_limits<int16_t>::min() || v > std::numeric_limits<int16_t>::max()) {
+                return std::nullopt;
+            }
+            return static_cast<int8_t>(q);
+        }
+
+        /**
+         * Compresses one WVSM block.
+         * @param pcm - LPCM block data of max kBlockSize bytes
+         * @return compressed block
+         */
+        static ByteArray wvsmDeflateBlock(ByteView pcm)
+        {
+            const std::size_t nSamples = pcm.size() / 2;
+            if (nSamples == 0) {
+                return {};
             }
 
-            [[maybe_unused]]auto compressedSize = swap16(istream.read<uint16_t>()); // Note, big endian size
-            const byte_t  se  = istream.read<byte_t>(); // sample expander
-            const int sel = se >> 4;
-            const int ser = se & 0xF;
+            std::vector<int16_t> samples(nSamples);
+            for (std::size_t i = 0; i < nSamples; i++) {
+                samples[i] = static_cast<int16_t>(pcm[i * 2] | (pcm[i * 2 + 1] << 8));
+            }
+
+            const std::array<byte_t, 2> expanders = {
+                wvsmChooseExpander(samples.data(), nSamples, 2),
+                nSamples > 1 ? wvsmChooseExpander(samples.data() + 1, nSamples - 1, 2) : byte_t(0)
+            };
 
-            auto getChannelSample = [&](int expander) -> uint16_t
+            ByteArray block;
+            block.reserve(3 + nSamples * 3);
+            block.resize(2); // compressed size
+            block.push_back(static_cast<byte_t>((expanders[0] << 4) | expanders[1]));
+            for (std::size_t i = 0; i < nSamples; i++)
             {
-                uint16_t val = istream.read<byte_t>();
-                if(val == 0x80)
+                if (auto q = wvsmQuantize(samples[i], expanders[i & 1])) {
+                    block.push_back(static_cast<byte_t>(*q));
+                }
+                else
                 {
-                    auto s = istream.read<uint16_t>();
-                    val = swap16(s);
+                    const auto v = static_cast<uint16_t>(samples[i]);
+                    block.push_back(0x80);
+                    block.push_back(static_cast<byte_t>(v >> 8)); // Note, big endian
+                    block.push_back(static_cast<byte_t>(v & 0xFF));
                 }
-                else {
-                    val = static_cast<int8_t>(val) << expander;
+            }
+
+            // Big endian size of the compressed block following the size field.
+            // Note, decoder doesn't use this value.
+            const auto cSize = static_cast<uint16_t>(block.size() - 2);
+            block[0] = static_cast<byte_t>(cSize >> 8);
+            block[1] = static_cast<byte_t>(cSize & 0xFF);
+            return block;
+        }
+
+        template<typename BlockFunc>
+        static void forEachWvsmBlock(std::size_t inflatedSize, BlockFunc&& func)
+        {
+            for (std::size_t i = 0; i < inflatedSize / kBlockSize; i++) {
+                func(kBlockSize);
+            }
+
+            /* Inflate the remaining data, shorter than 1 block */
+            func(inflatedSize % kBlockSize);
+        }
+
+        /**
+         * Decompresses one WVSM block.
+         * @param src       - pointer to the compressed block, advanced past the block
+         * @param end       - end of compressed data
+         * @param blockSize - size of decompressed block
+         * @param dest      - output buffer of at least blockSize bytes
+         * @return number of bytes written to dest
+         */
+        static std::size_t wvsmInflateBlock(const byte_t*& src, const byte_t* end, std::size_t blockSize, byte_t* dest)
+        {
+            static constexpr ExpandTable kExpandTable = makeExpandTable();
+            const std::size_t nSamples = blockSize / 2;
+            if(nSamples == 0){
+                return 0;
+            }
+
+            auto checkRemaining = [&](std::ptrdiff_t n) {
+                if (end - src < n) {
+                    throw StreamError("IndyVW: Unexpected end of compressed sound data");
                 }
-                return val;
             };
 
-            for(std::size_t i = 0; i < nSamples; i += 2)
+            /* Skip big endian compressed size and read sample expander */
+            checkRemaining(3);
+            src += 2;
+            const byte_t se = *src++;
+            const std::array<const std::array<uint16_t, 256>*, 2> expanders = {
+                &kExpandTable[se >> 4],  // left channel
+                &kExpandTable[se & 0xF]  // right channel
+            };
+
+            /* If the worst case (3 bytes per sample) fits into the remaining data,
+               decode the block without checking bounds for each sample. */
+            const bool bCheck = end - src < static_cast<std::ptrdiff_t>(nSamples * 3);
+            for(std::size_t i = 0; i < nSamples; i++)
             {
-                dest << getChannelSample(sel);
-                if( i + 1 >= nSamples) return;
-                dest << getChannelSample(ser);
+                if (bCheck) checkRemaining(1);
+                const byte_t b = *src++;
+                uint16_t val;
+                if(b == 0x80)
+                {
+                    if (bCheck) checkRemaining(2);
+                    val = static_cast<uint16_t>((src[0] << 8) | src[1]); // Note, big endian
+                    src += 2;
+                }
+                else {
+                    val = (*expanders[i & 1])[b];
+                }
+
+                *dest++ = static_cast<byte_t>(val & 0xFF);
+                *dest++ = static_cast<byte_t>(val >> 8);
             }
+            return nSamples * 2;
         }
     };
 }
@@ -5,6 +5,7 @@
 #include "../../sound.h"
 
 #include <libim/common.h>
+#include <libim/io/schema.h>
 #include <libim/io/stream.h>
 #include <libim/types/safe_cast.h>
 
@@ -43,7 +44,7 @@ namespace libim::content::audio {
         }
         else if (istream.peek<decltype(kIndyWV)> () == kIndyWV) // parse indy wv header
         {
-            IndyWVHeader header = istream.read<IndyWVHeader>();
+            const auto header = readStruct<IndyWVHeader>(istream);
             numChannels   = header.numChannels;
             sampleRate    = header.sampleRate;
             sampleBitSize = header.sampleBitSize;
@@ -54,7 +55,7 @@ namespace libim::content::audio {
         return SoundFormatType::Unknown;
     }
 
-    static void wavWrite(OutputStream& ostream, std::size_t numChannels, std::size_t sampleRate, std::size_t sampleBitSize, ByteView data)
+    static void wavWriteHeader(OutputStream& ostream, std::size_t numChannels, std::size_t sampleRate, std::size_t sampleBitSize, std::size_t dataSize)
     {
         WavHeader wavHeader;
         wavHeader.fmt.size          = 16;
@@ -65,9 +66,8 @@ namespace libim::content::audio {
         wavHeader.fmt.byteRate      = safe_cast<decltype(wavHeader.fmt.byteRate)>     (sampleRate  * wavHeader.fmt.blockAlign);
         wavHeader.fmt.sampleBitSize = safe_cast<decltype(wavHeader.fmt.sampleBitSize)>(sampleBitSize);
 
-        WavDataChunkView dataChunk;
-        dataChunk.data = std::move(data);
-        dataChunk.size = safe_cast<decltype(dataChunk.size)>(dataChunk.data.size());
+        WavDataChunkHeader dataChunk;
+        dataChunk.size = safe_cast<decltype(dataChunk.size)>(dataSize);
         wavHeader.size = 36 + dataChunk.size; // 36 = sizeof(WavHeader) + sizeof riff header
 
         // Write to output
@@ -75,6 +75,12 @@ namespace libim::content::audio {
                 << dataChunk;
     }
 
+    static void wavWrite(OutputStream& ostream, std::size_t numChannels, std::size_t sampleRate, std::size_t sampleBitSize, ByteView data)
+    {
+        wavWriteHeader(ostream, numChannels, sampleRate, sampleBitSize, data.size());
+        ostream.write(data);
+    }
+
     inline void wvWrite(OutputStream& ostream, std::size_t numChannels, std::size_t sampleRate, std::size_t sampleBitSize, ByteView sndData)
     {
         IndyWVHeader wv;
@@ -84,7 +90,7 @@ namespace libim::content::audio {
         wv.dataSize       = safe_cast<decltype(wv.dataSize)>(sndData.size());
 
         // Write to output
-        ostream.write(wv);
+        writeStruct(ostream, wv);
         ostream.write(sndData);
     }
 }
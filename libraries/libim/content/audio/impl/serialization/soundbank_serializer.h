@@ -7,9 +7,11 @@
 #include <libim/common.h>
 #include <libim/content/audio/soundbank_error.h>
 #include <libim/log/log.h>
+#include <libim/io/schema.h>
 #include <libim/io/stream.h>
 #include <libim/types/safe_cast.h>
 
+#include <span>
 #include <sstream>
 #include <string>
 
@@ -22,15 +24,13 @@ namespace libim::content::audio {
     {
         try
         {
-            std::size_t nSounds     = istream.read<uint32_t>();
-            std::size_t sndDataSize = istream.read<uint32_t>();
-
-            auto sndInfos = istream.read<std::vector<SoundInfo>>(nSounds);
-            *track.data   = istream.read<ByteArray>(sndDataSize);
+            const auto header = readStruct<SoundBankTrackHeader>(istream);
+            auto sndInfos = readStructs<SoundInfo>(istream, header.numSounds);
+            *track.data   = istream.read<ByteArray>(header.sizeSoundData);
 
             /* Read and convert sound headers */
             track.sounds.clear();
-            track.sounds.reserve(nSounds);
+            track.sounds.reserve(sndInfos.size());
             for(const auto& sndInfo : sndInfos) {
                 track.addSound(sndInfo);
             }
@@ -61,9 +61,12 @@ namespace libim::content::audio {
             }
 
             /* Write data to stream */
-            ostream.write<uint32_t>(safe_cast<uint32_t>(sndInfos.size()));
-            ostream.write<uint32_t>(safe_cast<uint32_t>(track.data->size()));
-            ostream.write(sndInfos);
+            const SoundBankTrackHeader header {
+                .numSounds     = safe_cast<uint32_t>(sndInfos.size()),
+                .sizeSoundData = safe_cast<uint32_t>(track.data->size())
+            };
+            writeStruct(ostream, header);
+            writeStructs(ostream, std::span<const SoundInfo>(sndInfos));
             ostream.write(track.data->getDataView(0, track.data->size()));
         }
         catch(const std::exception& e)
@@ -76,13 +79,12 @@ namespace libim::content::audio {
 
     static void skipSerializedSoundBank(const InputStream& istream)
     {
-        std::size_t numSoundInfos = istream.read<uint32_t>();
-        std::size_t sizeSoundData = istream.read<uint32_t>();
+        const auto header = readStruct<SoundBankTrackHeader>(istream);
         constexpr std::size_t sizeNextHandleField = sizeof(uint32_t);
 
         const std::size_t size =
-            numSoundInfos * sizeof(SoundInfo) +
-            sizeSoundData                     +
+            std::size_t(header.numSounds) * sizeof(SoundInfo) +
+            header.sizeSoundData                              +
             sizeNextHandleField;
 
         istream.advance(size);
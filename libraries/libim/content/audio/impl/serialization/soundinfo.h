@@ -2,6 +2,7 @@
 #define LIBIM_SOUND_INFO_H
 #include <cstdint>
 #include <libim/content/audio/sound.h>
+#include <libim/io/schema.h>
 
 #include "../sound_data.h"
 
@@ -42,5 +43,45 @@ namespace libim::content::audio {
         {}
     };
     static_assert(sizeof(SoundInfo) == 48);
+
+    // Header of sound bank track stored in CND files.
+    struct SoundBankTrackHeader final
+    {
+        uint32_t numSounds;
+        uint32_t sizeSoundData;
+    };
+    static_assert(sizeof(SoundBankTrackHeader) == 8);
 }
+
+template<>
+struct libim::StructSchema<libim::content::audio::SoundInfo>
+{
+    using S = libim::content::audio::SoundInfo;
+    static constexpr std::string_view name = "SoundInfo";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&S::hSnd>("hSnd"),
+        schemaField<&S::bankIdx>("bankIdx"),
+        schemaField<&S::pathOffset>("pathOffset"),
+        schemaField<&S::nameOffset>("nameOffset"),
+        schemaField<&S::dataOffset>("dataOffset"),
+        schemaField<&S::pLipSyncData>("pLipSyncData"),
+        schemaField<&S::sampleRate>("sampleRate"),
+        schemaField<&S::sampleBitSize>("sampleBitSize"),
+        schemaField<&S::numChannels>("numChannels"),
+        schemaField<&S::dataSize>("dataSize"),
+        schemaField<&S::bCompressed>("bCompressed", 0u, 1u),
+        schemaField<&S::idx>("idx")
+    );
+};
+
+template<>
+struct libim::StructSchema<libim::content::audio::SoundBankTrackHeader>
+{
+    using H = libim::content::audio::SoundBankTrackHeader;
+    static constexpr std::string_view name = "SoundBankTrackHeader";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&H::numSounds>("numSounds"),
+        schemaField<&H::sizeSoundData>("sizeSoundData")
+    );
+};
 #endif // LIBIM_CND_SOUND_INFO_H
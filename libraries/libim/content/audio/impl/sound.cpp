@@ -4,6 +4,7 @@
 #include "../sound.h"
 
 #include <libim/io/stream.h>
+#include <libim/utils/hash.h>
 #include <exception>
 
 using namespace libim;
@@ -119,6 +120,11 @@ bool Sound::isValid() const
     return ptrData_->isValid();
 }
 
+bool Sound::canWavWrite() const
+{
+    return ptrData_->canWavWrite();
+}
+
 std::shared_ptr<SoundCache> Sound::lockOrThrow() const
 {
     return ptrData_->lockOrThrow();
@@ -134,6 +140,19 @@ ByteArray Sound::data() const
     return ptrData_->data();
 }
 
+uint64_t Sound::contentHash() const
+{
+    auto ptrData = ptrData_->lockOrThrow();
+    const auto data = ptrData->getDataView(ptrData_->dataOffset, ptrData_->dataSize);
+    return utils::Hasher64()
+        .updateValue(ptrData_->sampleRate)
+        .updateValue(ptrData_->sampleBitSize)
+        .updateValue(ptrData_->numChannels)
+        .updateValue(ptrData_->isCompressed)
+        .update(data.data(), data.size())
+        .digest();
+}
+
 void audio::wavWrite(OutputStream& ostream, const Sound& sound)
 {
     sound.ptrData_->wavWrite(ostream);
@@ -75,7 +75,7 @@ namespace libim::content::audio
             }
 
             if (isCompressed) {
-                sndData = IndyVW::inflate(InputBinaryStream(ptrData->getDataView(dataOffset, dataSize)));
+                sndData = IndyVW::inflate(ptrData->getDataView(dataOffset, dataSize));
             }
             else {
                 sndData = ptrData->read(dataOffset, dataSize);
@@ -84,13 +84,57 @@ namespace libim::content::audio
             return sndData;
         }
 
+        /** Returns true if sound can be written in WAV format. */
+        bool canWavWrite() const
+        {
+            auto ptrData = lockOrThrow();
+            if (!isValid(*ptrData)) {
+                return dataSize == 0;
+            }
+            return !isCompressed || IndyVW::canInflate(ptrData->getDataView(dataOffset, dataSize));
+        }
+
         void wavWrite(OutputStream& ostream) const
         {
-            auto data = this->data(); // Note, data is returned as decompressed data.
-            if (data.empty() && dataSize > 0) {
+            auto ptrData = lockOrThrow();
+            if (!isValid(*ptrData)) {
+                if (dataSize > 0) {
+                    throw StreamError("Cannot write invalid sound to stream in WAV format");
+                }
+                audio::wavWrite(ostream, numChannels, sampleRate, sampleBitSize, ByteView{});
+                return;
+            }
+
+            auto data = ptrData->getDataView(dataOffset, dataSize);
+            if (!isCompressed) {
+                audio::wavWrite(ostream, numChannels, sampleRate, sampleBitSize, data);
+                return;
+            }
+
+            // Verify compression mode before anything is written to the output stream
+            if (!IndyVW::canInflate(data)) {
+                throw StreamError(
+                    utils::format("Cannot write sound '%' to stream in WAV format, unsupported compression mode", name())
+                );
+            }
+
+            // Decompress data block by block directly to the output stream
+            const auto infSize = IndyVW::inflatedSize(data);
+            const auto hpos    = ostream.tell();
+            audio::wavWriteHeader(ostream, numChannels, sampleRate, sampleBitSize, infSize);
+            const auto nWritten = IndyVW::inflate(data, ostream);
+            if (nWritten == 0 && dataSize > 0) {
                 throw StreamError("Cannot write invalid sound to stream in WAV format");
             }
-            audio::wavWrite(ostream, numChannels, sampleRate, sampleBitSize, data);
+
+            if (nWritten != infSize)
+            {
+                // Patch header with the actual size of decompressed data
+                const auto end = ostream.tell();
+                ostream.seek(hpos);
+                audio::wavWriteHeader(ostream, numChannels, sampleRate, sampleBitSize, nWritten);
+                ostream.seek(end);
+            }
         }
 
         inline void wavWrite(OutputStream&& ostream) const
@@ -105,10 +149,17 @@ namespace libim::content::audio
                 throw StreamError("Cannot write invalid sound to stream in WV format");
             }
 
-            if (!isCompressed) { // TODO: implement converting of data to indyWV format
-                throw StreamError(
-                    utils::format("Cannot write uncompressed sound '%' to stream in WV format", name())
-                );
+            if (!isCompressed)
+            {
+                if (!IndyVW::canDeflate(numChannels, sampleBitSize)) {
+                    throw StreamError(
+                        utils::format("Cannot write uncompressed sound '%' to stream in WV format", name())
+                    );
+                }
+
+                auto cdata = IndyVW::deflate(ptrData->getDataView(dataOffset, dataSize), numChannels, sampleBitSize);
+                audio::wvWrite(ostream, numChannels, sampleRate, sampleBitSize, cdata);
+                return;
             }
             audio::wvWrite(ostream, numChannels, sampleRate, sampleBitSize, ptrData->getDataView(dataOffset, dataSize));
         }
@@ -6,6 +6,7 @@
 
 #include <libim/common.h>
 #include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
+#include <libim/trace/trace.h>
 #include <libim/utils/utils.h>
 
 using namespace libim;
@@ -59,15 +60,17 @@ const UniqueTable<Sound>& SoundBank::getTrack(std::size_t trackIdx) const
     return ptrImpl_->tracks.at(trackIdx).sounds;
 }
 
-const Sound& SoundBank::loadSound(InputStream& istream, std::size_t trackIdx)
+const Sound& SoundBank::loadSound(InputStream& istream, std::size_t trackIdx, bool compress)
 {
-    auto& snd = ptrImpl_->tracks.at(trackIdx).loadSound(istream);
+    LIBIM_TRACE_STREAM_SCOPE_DETAIL("asset", "SoundBank::loadSound", istream, istream.name());
+    auto& snd = ptrImpl_->tracks.at(trackIdx).loadSound(istream, compress);
     snd.ptrData_->handle = ptrImpl_->getNextHandle();
     return snd;
 }
 
 bool SoundBank::importTrack(std::size_t trackIdx, const InputStream& istream)
 {
+    LIBIM_TRACE_STREAM_SCOPE("asset", "SoundBank::importTrack", istream);
     LOG_DEBUG("SoundBank: Importing sound track % from stream: %", trackIdx, istream.name());
     if (trackIdx >= ptrImpl_->tracks.size()) {
         throw SoundBankError("Sound track index out of range!");
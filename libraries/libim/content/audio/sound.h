@@ -31,6 +31,20 @@ namespace libim::content::audio {
         bool isCompressed() const;
         bool isValid() const;
 
+        /**
+         * Returns true if sound can be written in WAV format.
+         * Compressed sound can be written only when it's compressed in supported compression mode.
+         * @throw std::logic_error if sound cache is dead.
+         */
+        bool canWavWrite() const;
+
+        /**
+         * Returns 64-bit hash of sound format and stored sound data.
+         * Sounds with equal hash produce the same output file.
+         * @throw std::logic_error if sound cache is dead.
+         */
+        uint64_t contentHash() const;
+
     protected:
         Sound();
         Sound(std::weak_ptr<SoundCache> wptrCacheData, std::size_t pathOffset,
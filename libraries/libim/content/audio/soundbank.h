@@ -43,6 +43,8 @@ namespace libim::content::audio
          *
          * @param istream  - Input stream to read data from.
          * @param trackIdx - Track index.
+         * @param compress - Compress WAV sound to IndyWV format.
+         *                   Has effect only for 16 bit stereo sounds, other sounds are stored uncompressed.
          * @return Reference to Sound object.
          *
          * @throw SoundBankError - If trackIdx is out of range or data in stream is corrupted.
@@ -50,7 +52,7 @@ namespace libim::content::audio
          *                       - If unable to read data from stream.
          * @throw StreamError    - If IO error occurs while reading from stream.
          */
-        const Sound& loadSound(InputStream& istream, std::size_t trackIdx);
+        const Sound& loadSound(InputStream& istream, std::size_t trackIdx, bool compress = false);
 
         /**
          * Imports soundbank data to track.
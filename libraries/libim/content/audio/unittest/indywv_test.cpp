@@ -0,0 +1,96 @@
+#include "indywv_test.h"
+#include "../impl/serialization/indywv.h"
+
+#include <assert.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace libim;
+using namespace libim::content::audio;
+
+static ByteArray makePcm(const std::vector<int16_t>& samples)
+{
+    ByteArray pcm;
+    pcm.reserve(samples.size() * 2);
+    for (auto s : samples)
+    {
+        const auto v = static_cast<uint16_t>(s);
+        pcm.push_back(static_cast<byte_t>(v & 0xFF));
+        pcm.push_back(static_cast<byte_t>(v >> 8));
+    }
+    return pcm;
+}
+
+static int16_t sampleAt(const ByteArray& pcm, std::size_t idx)
+{
+    return static_cast<int16_t>(pcm.at(idx * 2) | (pcm.at(idx * 2 + 1) << 8));
+}
+
+void libim::unit_test::run_indywv_tests()
+{
+// Test case 1: Small amplitude sound is compressed lossless
+    {
+        std::vector<int16_t> samples(5000);
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            samples[i] = static_cast<int16_t>(static_cast<int>(i % 255) - 127);
+        }
+
+        auto pcm  = makePcm(samples);
+        auto data = IndyVW::deflate(pcm, 2, 16);
+        assert(data.size() < pcm.size());
+        assert(IndyVW::inflatedSize(data) == pcm.size());
+        assert(IndyVW::inflate(ByteView(data)) == pcm);
+    }
+
+// Test case 2: Full block and partial block of high amplitude sound
+    {
+        std::vector<int16_t> samples(2048 * 3 + 17);
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            samples[i] = static_cast<int16_t>(30000.0 * std::sin(static_cast<double>(i) * 0.01));
+        }
+
+        auto pcm  = makePcm(samples);
+        auto data = IndyVW::deflate(pcm, 2, 16);
+        assert(data.size() < pcm.size());
+
+        auto inf = IndyVW::inflate(ByteView(data));
+        assert(inf.size() == pcm.size());
+        for (std::size_t i = 0; i < samples.size(); i++) {
+            assert(std::abs(sampleAt(inf, i) - samples[i]) <= 128);
+        }
+
+        // Decompress to stream
+        ByteArray sinf;
+        OutputBinaryStream os(sinf);
+        assert(IndyVW::inflate(ByteView(data), os) == inf.size());
+        assert(sinf == inf);
+    }
+
+// Test case 3: Outlier samples are stored as literals
+    {
+        std::vector<int16_t> samples(2048, 3);
+        samples[100] = 32767;
+        samples[101] = -32768;
+
+        auto pcm = makePcm(samples);
+        auto inf = IndyVW::inflate(ByteView(IndyVW::deflate(pcm, 2, 16)));
+        assert(inf == pcm);
+    }
+
+// Test case 4: Empty sound and unsupported format
+    {
+        auto data = IndyVW::deflate(ByteView{}, 2, 16);
+        assert(IndyVW::inflatedSize(data) == 0);
+        assert(IndyVW::inflate(ByteView(data)).empty());
+        assert(IndyVW::canInflate(data));
+
+        // Mono ADPCM compressed sound can't be decompressed
+        const ByteArray adpcm = { 4, 0, 0, 0, 0x00, 0x12, 0x34, 0x00, 0x00 };
+        assert(!IndyVW::canInflate(adpcm));
+
+        assert(!IndyVW::canDeflate(1, 16));
+        assert(!IndyVW::canDeflate(2, 8));
+    }
+}
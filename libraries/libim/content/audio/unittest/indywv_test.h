@@ -0,0 +1,8 @@
+#ifndef LIBIM_INDYWV_TEST_H
+#define LIBIM_INDYWV_TEST_H
+
+namespace libim::unit_test {
+    void run_indywv_tests();
+}
+
+#endif // LIBIM_INDYWV_TEST_H
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <cstdint>
+#include <memory_resource>
 #include <string_view>
 #include <vector>
 #include <type_traits>
@@ -41,6 +42,23 @@ namespace libim::content::text {
     public:
         using Tokenizer::Tokenizer;
 
+        /**
+         * Sets memory resource which readList uses to allocate lists and list elements
+         * which can be constructed from memory resource, e.g. std::pmr::vector, IndexMap, Surface.
+         * By default (nullptr) lists are allocated from the default memory resource.
+         *
+         * @param mr - memory resource, e.g. utils::Arena. The resource must outlive the read lists.
+         */
+        void setMemoryResource(std::pmr::memory_resource* mr)
+        {
+            mr_ = mr;
+        }
+
+        std::pmr::memory_resource* memoryResource() const
+        {
+            return mr_;
+        }
+
         /**
          * Asserts that the next token is expected label.
          * Label in stream must be in format: "label:".
@@ -313,7 +331,7 @@ namespace libim::content::text {
                 }
             };
 
-            Container container;
+            auto container = makeWithResource<Container>();
             [[maybe_unused]] std::size_t rowIdx = 0;
             std::function<bool()> isAtEnd;
 
@@ -359,7 +377,7 @@ namespace libim::content::text {
                     }
                 }
 
-                typename Container::value_type element{};
+                auto element = makeWithResource<typename Container::value_type>();
                 if constexpr(parseWithNoContainer) {
                     readRow(*this, rowIdx, element);
                 }
@@ -521,6 +539,22 @@ namespace libim::content::text {
          * @throw SyntaxError - If section line in stream is not in correct format.
         */
         std::string_view readSection();
+
+    private:
+        template<typename T>
+        T makeWithResource() const
+        {
+            if constexpr (utils::isMemoryResourceConstructible<T>)
+            {
+                if (mr_) {
+                    return T(mr_);
+                }
+            }
+            return T{};
+        }
+
+    private:
+        std::pmr::memory_resource* mr_ = nullptr;
     };
 }
 
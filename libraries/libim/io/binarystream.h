@@ -30,6 +30,8 @@ namespace libim {
         virtual std::size_t writesome(const byte_t* data, std::size_t length) override;
 
     private:
+        void grow(std::size_t size);
+
         template<typename MemFp>
         void resize(std::size_t size, MemFp&& func);
 
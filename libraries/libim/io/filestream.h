@@ -60,6 +60,22 @@ namespace libim {
          */
         virtual void flush() override;
 
+        /**
+         * Copies data from file stream src to the current position of this file stream.
+         * The position of src is not changed.
+         *
+         * On Linux the data is copied in kernel with copy_file_range which on
+         * copy-on-write file systems can share (reflink) data blocks with src.
+         * On other platforms or when kernel copy is not supported the data is copied via buffer.
+         *
+         * @param src       - readable source file stream.
+         * @param srcOffset - offset in src to copy data from.
+         * @param length    - number of bytes to copy.
+         * @return number of bytes copied. Can be less than length when end of src is reached.
+         * @throw FileStreamError - if src is not readable or an IO error occurs.
+         */
+        std::size_t copyFrom(const FileStream& src, std::size_t srcOffset, std::size_t length);
+
     protected:
         virtual std::size_t readsome(byte_t* data, std::size_t length) const override;
         virtual std::size_t writesome(const byte_t* data, std::size_t length) override;
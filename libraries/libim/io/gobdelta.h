@@ -0,0 +1,37 @@
+#ifndef LIBIM_GOBDELTA_H
+#define LIBIM_GOBDELTA_H
+#include <cstddef>
+#include <filesystem>
+
+#include "manifest.h"
+#include "stream.h"
+
+namespace libim {
+
+    /** Result of writing delta GOB file. */
+    struct GobDelta
+    {
+        ContentDiff diff;         // changes of new content from base GOB file
+        std::size_t numFiles = 0; // number of files written to delta GOB file
+        std::size_t dataSize = 0; // size of file data written to delta GOB file
+    };
+
+    /**
+     * Writes delta GOB file with only the files of newContent which were added or modified
+     * compared to baseGob. Files are compared by size and content hash, see ContentManifest.
+     *
+     * Delta GOB file is meant to be layered over the base GOB file by loading it into
+     * VirtualFileSystem before the base GOB file, since vf containers are searched in load order.
+     * Files removed from new content can't be expressed by delta GOB file and are only reported in GobDelta::diff.
+     *
+     * @param baseGob    - path to base GOB file.
+     * @param newContent - path to new GOB file or system folder with new content.
+     * @param ostream    - output stream to write delta GOB file to.
+     * @param maxThreads - max number of threads to use for hashing. 0 = all hardware threads.
+     * @return GobDelta
+     * @throw StreamError
+     */
+    GobDelta gobWriteDelta(const std::filesystem::path& baseGob, const std::filesystem::path& newContent,
+                           OutputStream& ostream, std::size_t maxThreads = 0);
+}
+#endif // LIBIM_GOBDELTA_H
@@ -180,7 +180,11 @@ struct FileStream::FileStreamImpl
     #ifdef LIBIM_OS_WINDOWS
         if(!ReadFile(hFile, reinterpret_cast<LPVOID>(data), safe_cast<DWORD>(length), reinterpret_cast<LPDWORD>(&nRead), nullptr)) {
     #else
-        nRead = ::read(fd, data, length);
+        // Read-only files are read at the tracked offset, so reading doesn't depend on
+        // the file offset which is shared with duplicated fds, e.g. in a forked process.
+        nRead = mode == Read
+            ? ::pread(fd, data, length, static_cast<off_t>(currentOffset))
+            : ::read(fd, data, length);
         if(nRead == -1) {
     #endif
             throw FileStreamError("Failed to read from file: " + getLastErrorAsString());
@@ -263,6 +267,74 @@ struct FileStream::FileStreamImpl
         return nTotalWritten;
     }
 
+    std::size_t copyFrom(FileStreamImpl& src, std::size_t srcOffset, std::size_t length)
+    {
+        if (src.mode == Write) {
+            throw FileStreamError("Failed to copy from file: source file stream is not readable");
+        }
+
+        if (srcOffset >= src.fileSize) {
+            return 0;
+        }
+        length = std::min(length, src.fileSize - srcOffset);
+
+    #ifdef MAX_WRITE_FILE_SIZE
+        if (currentOffset + length >= MAX_WRITE_FILE_SIZE) {
+            throw FileStreamError("Wrote to max file size limit");
+        }
+    #endif
+
+        // Flush data in buffers so both files are in sync with their handles
+        src.flush(/*sync=*/false);
+        flush(/*sync=*/false);
+
+        std::size_t nCopied = 0;
+    #if defined(LIBIM_OS_LINUX) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+        loff_t inOffset = static_cast<loff_t>(srcOffset);
+        while (nCopied < length)
+        {
+            auto n = ::copy_file_range(src.fd, &inOffset, fd, nullptr, length - nCopied, 0);
+            if (n == -1)
+            {
+                // Copy not supported for this pair of files, fallback to buffered copy
+                if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) {
+                    break;
+                }
+                throw FileStreamError("Failed to copy data to file: " + getLastErrorAsString());
+            }
+            else if (n == 0) {
+                break;
+            }
+            nCopied += static_cast<std::size_t>(n);
+        }
+
+        currentOffset += nCopied;
+        if (currentOffset > fileSize) {
+            fileSize = currentOffset;
+        }
+    #endif
+
+        if (nCopied < length)
+        {
+            const auto srcPos = src.currentOffset;
+            src.seek(srcOffset + nCopied);
+
+            ByteArray buffer(std::min<std::size_t>(length - nCopied, 1024 * 1024));
+            while (nCopied < length)
+            {
+                auto nRead = src.read(buffer.data(), std::min(buffer.size(), length - nCopied));
+                if (nRead == 0) {
+                    break;
+                }
+                nCopied += write(buffer.data(), nRead);
+            }
+
+            src.seek(srcPos);
+        }
+
+        return nCopied;
+    }
+
     void seek(std::size_t offset) const
     {
         const_cast<FileStreamImpl*>(this)->flush(/*sync=*/true);
@@ -392,6 +464,14 @@ void FileStream::flush()
     m_fs->flush(/*sync=*/true);
 }
 
+std::size_t FileStream::copyFrom(const FileStream& src, std::size_t srcOffset, std::size_t length)
+{
+    if (!canWrite()) {
+        throw FileStreamError("Failed to copy to file: file stream is not writable");
+    }
+    return m_fs->copyFrom(*src.m_fs, srcOffset, length);
+}
+
 std::size_t FileStream::readsome(byte_t* data, std::size_t length) const
 {
     if(m_fs->currentOffset + length >= m_fs->fileSize){
@@ -1,22 +1,32 @@
+#include <algorithm>
 #include <array>
+#include <cctype>
 #include <cstdint>
 #include <filesystem>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <libim/io/schema.h>
 #include <libim/io/stream.h>
 #include <libim/io/filestream.h>
 #include <libim/io/vfstream.h>
+#include <libim/trace/trace.h>
 #include <libim/types/fixed_string.h>
 #include <libim/types/sharedref.h>
+#include <libim/types/safe_cast.h>
+#include <libim/utils/endian.h>
 
 using namespace libim;
 
 static constexpr std::array<char,4> kGobFileMagic       = {{'G','O','B',' '}};
 static constexpr uint32_t           kGobFileVersion     = 0x14;
 static constexpr uint32_t           kGobFilePathMaxSize = 128;
+static constexpr std::size_t        kGobMaxFileSize     = std::numeric_limits<uint32_t>::max();
+static constexpr std::size_t        kGobCopyChunkSize   = 1024 * 1024;
 
 
 struct GobFileHeader
@@ -33,61 +43,179 @@ struct GobFileEntry
     FixedString<kGobFilePathMaxSize> filePath;
 };
 
+template<>
+struct libim::StructSchema<GobFileHeader>
+{
+    static constexpr std::string_view name = "GobFileHeader";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&GobFileHeader::magic>("magic", kGobFileMagic),
+        schemaField<&GobFileHeader::version>("version", kGobFileVersion),
+        schemaField<&GobFileHeader::directoryOffset>("directoryOffset", sizeof(GobFileHeader), kGobMaxFileSize)
+    );
+};
 
 template<>
-GobFileHeader Stream::read() const
+struct libim::StructSchema<GobFileEntry>
 {
-    GobFileHeader header;
-    const auto nRead = read(reinterpret_cast<byte_t*>(&header), sizeof(header));
-    if(nRead != sizeof(header)) {
-        throw StreamError("Failed to read 'GobFileHeader'");
-    }
+    static constexpr std::string_view name = "GobFileEntry";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&GobFileEntry::offset>("offset"),
+        schemaField<&GobFileEntry::size>("size"),
+        schemaField<&GobFileEntry::filePath>("filePath")
+    );
+};
+
+static std::vector<GobFileEntry> gobReadFileEntries(const InputStream& is)
+{
+    /* Read and verify header */
+    const auto header = readStruct<GobFileHeader>(is);
 
-    return header;
+    /* Seek to directory */
+    is.seek(header.directoryOffset);
+
+    /* Read directory size and entries */
+    const auto numEntries = utils::littleEndian(is.read<uint32_t>());
+    return readStructs<GobFileEntry>(is, numEntries);
 }
 
-template<>
-GobFileEntry Stream::read() const
+std::vector<GobEntry> libim::gobReadDirectory(const InputStream& is)
 {
-    GobFileEntry entry;
-    const auto nRead = read(reinterpret_cast<byte_t*>(&entry), sizeof(entry));
-    if(nRead != sizeof(entry)) {
-        throw StreamError("Failed to read 'GobFileEntry'");
-    }
+    LIBIM_TRACE_SCOPE_DETAIL("vfs", "gobReadDirectory", is.name());
+    const auto entries = gobReadFileEntries(is);
 
-    return entry;
+    std::vector<GobEntry> dir;
+    dir.reserve(entries.size());
+    for (const auto& e : entries) {
+        dir.push_back({ e.filePath.toStdString(), e.offset, e.size });
+    }
+    return dir;
 }
 
 VfContainer libim::gobLoad(SharedRef<InputStream> is)
 {
-    /* Read Header */
-    auto header = is->read<GobFileHeader>();
+    LIBIM_TRACE_SCOPE_DETAIL("vfs", "gobLoad", is->name());
+    const auto entries = gobReadFileEntries(*is);
 
-    /* Verify file signature */
-    if(header.magic != kGobFileMagic) {
-        throw StreamError("Unknown or invalid GOB file");
+    VfContainer c;
+    auto isMutex = std::make_shared<std::mutex>(); // shared by all files in GOB
+    for (const auto& e : entries) {
+        c.add(e.filePath, makeSharedRef<VirtualFile>(is, e.offset, e.size, isMutex));
     }
+    return c;
+}
+
+VfContainer libim::gobLoad(const std::filesystem::path& gobFilePath)
+{
+    return gobLoad(makeSharedRef<InputFileStream>(gobFilePath));
+}
 
-    /* Verify file version */
-    if(header.version != kGobFileVersion) {
-        throw StreamError(std::string("Wrong GOB file version: ") + utils::to_string(header.version));
+GobWriter::GobWriter(OutputStream& ostream) :
+    os_(ostream),
+    begin_(ostream.tell())
+{
+    // Reserve space for the header, it's written in finish
+    writeStruct(os_, GobFileHeader{});
+    end_ = os_.tell();
+}
+
+void GobWriter::beginFile(const std::string& filePath, std::size_t size)
+{
+    if (finished_) {
+        throw StreamError("Can't add file to finished GOB file");
     }
 
-    /* Seek to directory */
-    is->seek(header.directoryOffset);
+    if (filePath.empty() || filePath.size() >= kGobFilePathMaxSize) {
+        throw StreamError(utils::format("Invalid GOB file path '%', max path length is %", filePath, kGobFilePathMaxSize - 1));
+    }
 
-    /* Read directory size and entries */
-    const auto numEntries = is->read<uint32_t>();
-    const auto entries    = is->read<std::vector<GobFileEntry>>(numEntries);
+    std::string key(filePath.size(), '\0');
+    std::transform(filePath.begin(), filePath.end(), key.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    if (!paths_.insert(std::move(key)).second) {
+        throw StreamError(utils::format("File '%' already exists in GOB file", filePath));
+    }
 
-    VfContainer c;
-    for (const auto& e : entries) {
-        c.add(e.filePath, makeSharedRef<VirtualFile>(is, e.offset, e.size));
+    const std::size_t offset = end_ - begin_;
+    if (offset + size > kGobMaxFileSize) {
+        throw StreamError(utils::format("GOB file size exceeds 4 GB when adding file '%'", filePath));
     }
-    return c;
+
+    entries_.push_back({ filePath, static_cast<uint32_t>(offset), static_cast<uint32_t>(size) });
 }
 
-VfContainer libim::gobLoad(const std::filesystem::path& gobFilePath)
+void GobWriter::seekEnd()
 {
-    return gobLoad(makeSharedRef<InputFileStream>(gobFilePath));
-}
\ No newline at end of file
+    // Seeking file stream flushes its buffer, so seek only when ostream was moved
+    if (os_.tell() != end_) {
+        os_.seek(end_);
+    }
+}
+
+void GobWriter::add(const std::string& filePath, ByteView data)
+{
+    beginFile(filePath, data.size());
+    seekEnd();
+    if (!data.empty() && os_.write(data.data(), data.size()) != data.size()) {
+        throw StreamError(utils::format("Failed to write file '%' to GOB file", filePath));
+    }
+    end_ += data.size();
+}
+
+void GobWriter::add(const std::string& filePath, const InputStream& istream)
+{
+    const auto size = istream.size();
+    beginFile(filePath, size);
+
+    seekEnd();
+    istream.seek(0);
+    ByteArray chunk(std::min(size, kGobCopyChunkSize));
+    for (std::size_t nLeft = size; nLeft > 0;)
+    {
+        const auto n = std::min(nLeft, chunk.size());
+        if (istream.read(chunk.data(), n) != n || os_.write(chunk.data(), n) != n) {
+            throw StreamError(utils::format("Failed to copy file '%' to GOB file", filePath));
+        }
+        nLeft -= n;
+    }
+    end_ += size;
+}
+
+void GobWriter::finish()
+{
+    if (finished_) {
+        throw StreamError("GOB file was already finished");
+    }
+
+    const std::size_t dirOffset = end_ - begin_;
+    if (dirOffset + sizeof(uint32_t) + entries_.size() * sizeof(GobFileEntry) > kGobMaxFileSize) {
+        throw StreamError("GOB file size exceeds 4 GB");
+    }
+
+    /* Write directory */
+    seekEnd();
+    os_.write(utils::littleEndian(safe_cast<uint32_t>(entries_.size())));
+
+    std::vector<GobFileEntry> entries;
+    entries.reserve(entries_.size());
+    for (const auto& e : entries_)
+    {
+        GobFileEntry& entry = entries.emplace_back();
+        entry.offset   = e.offset;
+        entry.size     = e.size;
+        entry.filePath = FixedString<kGobFilePathMaxSize>(std::string_view(e.filePath));
+    }
+    writeStructs<GobFileEntry>(os_, entries);
+    end_ = os_.tell();
+
+    /* Write header */
+    GobFileHeader header;
+    header.magic           = kGobFileMagic;
+    header.version         = kGobFileVersion;
+    header.directoryOffset = static_cast<uint32_t>(dirOffset);
+    os_.seek(begin_);
+    writeStruct(os_, header);
+
+    os_.seek(end_);
+    finished_ = true;
+}
@@ -0,0 +1,57 @@
+#include "../gobdelta.h"
+#include "../filestream.h"
+#include "../mappedfile.h"
+#include "../vfstream.h"
+
+#include <libim/trace/trace.h>
+#include <libim/utils/utils.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+using namespace libim;
+namespace fs = std::filesystem;
+
+GobDelta libim::gobWriteDelta(const fs::path& baseGob, const fs::path& newContent, OutputStream& ostream, std::size_t maxThreads)
+{
+    LIBIM_TRACE_SCOPE_DETAIL("io", "gobWriteDelta", newContent.generic_string());
+    const bool fromFolder = fs::is_directory(newContent);
+    const auto base    = gobContentManifest(baseGob, maxThreads);
+    const auto content = fromFolder ? folderContentManifest(newContent, maxThreads)
+                                    : gobContentManifest(newContent, maxThreads);
+
+    std::optional<MappedFile> newGob;
+    if (!fromFolder) {
+        newGob.emplace(newContent);
+    }
+
+    GobDelta delta;
+    delta.diff = content.diff(base);
+
+    // Files are written in the order of new content
+    GobWriter gob(ostream);
+    for (const auto& e : content.entries())
+    {
+        const auto pe = base.find(e.name);
+        if (pe && pe->size == e.size && pe->hash == e.hash) {
+            continue;
+        }
+
+        if (fromFolder)
+        {
+            auto path = e.name;
+            std::replace(path.begin(), path.end(), '\\', '/');
+            gob.add(e.name, InputFileStream(newContent / path));
+        }
+        else {
+            gob.add(e.name, newGob->data().subspan(e.offset, e.size));
+        }
+
+        delta.numFiles++;
+        delta.dataSize += e.size;
+    }
+
+    gob.finish();
+    return delta;
+}
@@ -0,0 +1,187 @@
+#include "../manifest.h"
+#include "../binarystream.h"
+#include "../filestream.h"
+#include "../mappedfile.h"
+#include "../vfstream.h"
+
+#include <libim/trace/trace.h>
+#include <libim/utils/hash.h>
+#include <libim/utils/parallel.h>
+#include <libim/utils/utils.h>
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+using namespace libim;
+namespace fs = std::filesystem;
+
+static constexpr std::string_view kManifestMagic   = "libim-content-manifest";
+static constexpr uint32_t         kManifestVersion = 1;
+
+static std::string manifestKey(std::string_view name)
+{
+    std::string key(name);
+    utils::to_lower(key);
+    std::replace(key.begin(), key.end(), '\\', '/');
+    return key;
+}
+
+ContentManifest::ContentManifest(std::vector<ContentHash> entries) :
+    entries_(std::move(entries))
+{
+    index_.reserve(entries_.size());
+    for (std::size_t i = 0; i < entries_.size(); i++) {
+        index_.emplace(manifestKey(entries_[i].name), i);
+    }
+}
+
+ContentManifest ContentManifest::load(const fs::path& filePath)
+{
+    InputFileStream ifs(filePath);
+    const auto data = ifs.read(ifs.size());
+    std::istringstream ss(std::string(data.begin(), data.end()));
+
+    std::string magic;
+    uint32_t version = 0;
+    ss >> magic >> version;
+    if (magic != kManifestMagic || version != kManifestVersion) {
+        throw StreamError(utils::format("Invalid content manifest file %", filePath));
+    }
+
+    std::vector<ContentHash> entries;
+    std::string hash;
+    while (ss >> hash)
+    {
+        ContentHash e;
+        ss >> e.size;
+        std::getline(ss >> std::ws, e.name);
+        if (ss.fail() || hash.size() != 16 || e.name.empty()) {
+            throw StreamError(utils::format("Invalid entry in content manifest file %", filePath));
+        }
+
+        try {
+            e.hash = std::stoull(hash, nullptr, 16);
+        }
+        catch (const std::exception&) {
+            throw StreamError(utils::format("Invalid hash '%' in content manifest file %", hash, filePath));
+        }
+        entries.push_back(std::move(e));
+    }
+    return ContentManifest(std::move(entries));
+}
+
+void ContentManifest::save(const fs::path& filePath) const
+{
+    std::ostringstream ss;
+    ss << kManifestMagic << " " << kManifestVersion << "\n";
+    for (const auto& e : entries_) {
+        ss << utils::hashToString(e.hash) << " " << e.size << " " << e.name << "\n";
+    }
+
+    const auto str = ss.str();
+    OutputFileStream ofs(filePath, /*truncate=*/true);
+    ofs.write(reinterpret_cast<const byte_t*>(str.data()), str.size());
+}
+
+const ContentHash* ContentManifest::find(std::string_view name) const
+{
+    auto it = index_.find(manifestKey(name));
+    if (it == index_.end()) {
+        return nullptr;
+    }
+    return &entries_.at(it->second);
+}
+
+ContentDiff ContentManifest::diff(const ContentManifest& prev) const
+{
+    ContentDiff d;
+    for (const auto& e : entries_)
+    {
+        const auto pe = prev.find(e.name);
+        if (!pe) {
+            d.added.push_back(e.name);
+        }
+        else if (pe->size != e.size || pe->hash != e.hash) {
+            d.modified.push_back(e.name);
+        }
+    }
+
+    for (const auto& pe : prev.entries_)
+    {
+        if (!find(pe.name)) {
+            d.removed.push_back(pe.name);
+        }
+    }
+    return d;
+}
+
+void libim::hashContent(ByteView data, std::span<ContentHash> entries, std::size_t maxThreads)
+{
+    LIBIM_TRACE_SCOPE("io", "hashContent");
+    for (const auto& e : entries)
+    {
+        if (e.offset > data.size() || e.size > data.size() - e.offset) {
+            throw StreamError(utils::format("Content '%' is out of data bounds", e.name));
+        }
+    }
+
+    // Entries are read from different positions in data independently,
+    // so each entry is hashed on its own thread without synchronization.
+    utils::parallelFor(entries.size(), [&](std::size_t i) {
+        auto& e = entries[i];
+        e.hash = utils::hash64(data.data() + e.offset, e.size);
+    }, maxThreads);
+}
+
+ContentManifest libim::gobContentManifest(const fs::path& gobFile, std::size_t maxThreads)
+{
+    LIBIM_TRACE_SCOPE_DETAIL("io", "gobContentManifest", gobFile.generic_string());
+    MappedFile file(gobFile);
+    InputBinaryStream<ByteView> istream(file.data());
+
+    std::vector<ContentHash> entries;
+    for (auto& e : gobReadDirectory(istream)) {
+        entries.push_back({ std::move(e.filePath), e.offset, e.size, 0 });
+    }
+
+    hashContent(file.data(), entries, maxThreads);
+    return ContentManifest(std::move(entries));
+}
+
+ContentManifest libim::folderContentManifest(const fs::path& folder, std::size_t maxThreads)
+{
+    LIBIM_TRACE_SCOPE_DETAIL("io", "folderContentManifest", folder.generic_string());
+    std::vector<fs::path> files;
+    try
+    {
+        for (const auto& e : fs::recursive_directory_iterator(folder))
+        {
+            if (e.is_regular_file()) {
+                files.push_back(e.path());
+            }
+        }
+    }
+    catch (const fs::filesystem_error& e) {
+        throw StreamError(utils::format("Failed to read folder %: %", folder, e.what()));
+    }
+
+    std::vector<ContentHash> entries(files.size());
+    for (std::size_t i = 0; i < files.size(); i++)
+    {
+        auto name = files[i].lexically_relative(folder).generic_string();
+        std::replace(name.begin(), name.end(), '/', '\\');
+        entries[i].name = std::move(name);
+    }
+
+    utils::parallelFor(files.size(), [&](std::size_t i) {
+        InputFileStream ifs(files[i]);
+        entries[i].size = ifs.size();
+        entries[i].hash = utils::hash64(ifs);
+    }, maxThreads);
+
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.name < b.name;
+    });
+    return ContentManifest(std::move(entries));
+}
@@ -0,0 +1,169 @@
+#include "../mappedfile.h"
+
+#include <libim/platform.h>
+#include <libim/types/safe_cast.h>
+#include <libim/utils/utils.h>
+
+#include <string>
+#include <utility>
+
+#ifdef LIBIM_OS_WINDOWS
+# include <windows.h>
+#else
+# include <cstring>
+# include <errno.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+using namespace libim;
+
+std::string getLastErrorAsString(); // Defined in filestream.cpp
+
+
+struct MappedFile::MappedFileImpl
+{
+    MappedFileImpl(const std::filesystem::path& filePath)
+    {
+        const auto path = filePath.string();
+    #ifdef LIBIM_OS_WINDOWS
+        hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            throw FileStreamError(
+                utils::format("Failed to open file %: %", path, getLastErrorAsString())
+            );
+        }
+
+        LARGE_INTEGER lSize {{0, 0}};
+        if (!GetFileSizeEx(hFile, &lSize)) {
+            close();
+            throw FileStreamError(
+                utils::format("Failed to get the size of file %: %", path, getLastErrorAsString())
+            );
+        }
+
+        size = safe_cast<std::size_t>(lSize.QuadPart);
+        if (size == 0) {
+            return; // Empty file can't be mapped
+        }
+
+        hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (hMapping == nullptr) {
+            close();
+            throw FileStreamError(
+                utils::format("Failed to create mapping of file %: %", path, getLastErrorAsString())
+            );
+        }
+
+        data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            close();
+            throw FileStreamError(
+                utils::format("Failed to map file %: %", path, getLastErrorAsString())
+            );
+        }
+    #else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw FileStreamError(
+                utils::format("Failed to open file %: %", path, strerror(errno))
+            );
+        }
+
+        struct stat fileInfo {};
+        if (fstat(fd, &fileInfo) == -1)
+        {
+            const auto err = errno;
+            ::close(fd);
+            throw FileStreamError(
+                utils::format("Failed to get the size of file %: %", path, strerror(err))
+            );
+        }
+
+        size = safe_cast<std::size_t>(fileInfo.st_size);
+        if (size == 0)
+        {
+            ::close(fd);
+            return; // Empty file can't be mapped
+        }
+
+        // The mapping stays valid after the file descriptor is closed
+        data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const auto err = errno;
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            data = nullptr;
+            throw FileStreamError(
+                utils::format("Failed to map file %: %", path, strerror(err))
+            );
+        }
+    #endif
+    }
+
+    ~MappedFileImpl()
+    {
+        close();
+    }
+
+    void close()
+    {
+    #ifdef LIBIM_OS_WINDOWS
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (hMapping) {
+            CloseHandle(hMapping);
+        }
+        if (hFile != INVALID_HANDLE_VALUE) {
+            CloseHandle(hFile);
+        }
+        hMapping = nullptr;
+        hFile    = INVALID_HANDLE_VALUE;
+    #else
+        if (data) {
+            ::munmap(data, size);
+        }
+    #endif
+        data = nullptr;
+    }
+
+    ByteView view() const
+    {
+        return ByteView(static_cast<const byte_t*>(data), data ? size : 0);
+    }
+
+#ifdef LIBIM_OS_WINDOWS
+    HANDLE hFile    = INVALID_HANDLE_VALUE;
+    HANDLE hMapping = nullptr;
+#endif
+    void* data       = nullptr;
+    std::size_t size = 0;
+};
+
+
+MappedFile::MappedFile() noexcept = default;
+
+MappedFile::MappedFile(const std::filesystem::path& filePath) :
+    ptr_(std::make_unique<MappedFileImpl>(filePath)),
+    data_(ptr_->view())
+{}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    ptr_(std::move(other.ptr_)),
+    data_(std::exchange(other.data_, ByteView()))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        ptr_  = std::move(other.ptr_);
+        data_ = std::exchange(other.data_, ByteView());
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() = default;
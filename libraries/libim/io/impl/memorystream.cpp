@@ -0,0 +1,276 @@
+#include "../memorystream.h"
+#include <libim/types/safe_cast.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+using namespace libim;
+
+constexpr std::size_t kMinCapacity = 256;
+
+
+MemoryOutputStream::MemoryOutputStream(Storage storage, std::size_t chunkSize) :
+    storage_(storage),
+    chunkSize_(std::max<std::size_t>(chunkSize, kMinCapacity))
+{}
+
+MemoryOutputStream::MemoryOutputStream(ByteArray buffer) :
+    storage_(Storage::Contiguous),
+    chunkSize_(kDefaultChunkSize),
+    size_(buffer.size()),
+    pos_(buffer.size()),
+    buffer_(std::move(buffer))
+{}
+
+void MemoryOutputStream::seek(std::size_t position) const
+{
+    if (position > size_) {
+        throw StreamError("MemoryOutputStream: Seek position is past the end of stream");
+    }
+    pos_ = position;
+}
+
+std::size_t MemoryOutputStream::size() const
+{
+    return size_;
+}
+
+std::size_t MemoryOutputStream::tell() const
+{
+    return pos_;
+}
+
+bool MemoryOutputStream::canRead() const
+{
+    return false;
+}
+
+bool MemoryOutputStream::canWrite() const
+{
+    return true;
+}
+
+std::size_t MemoryOutputStream::capacity() const
+{
+    if (storage_ == Storage::Contiguous) {
+        return buffer_.size();
+    }
+
+    if (chunks_.empty()) {
+        return 0;
+    }
+    return size_ + (chunks_.back().data.size() - chunks_.back().size);
+}
+
+void MemoryOutputStream::reserve(std::size_t capacity)
+{
+    if (capacity <= this->capacity()) {
+        return;
+    }
+
+    if (storage_ == Storage::Contiguous) {
+        buffer_.resize(capacity);
+    }
+    else {
+        appendChunk(capacity - size_);
+    }
+}
+
+MutableByteView MemoryOutputStream::reserveSpan(std::size_t size)
+{
+    if (storage_ == Storage::Contiguous)
+    {
+        grow(pos_ + size);
+        reserved_ = size;
+        return MutableByteView(buffer_.data() + pos_, size);
+    }
+
+    if (pos_ == size_)
+    {
+        if (chunks_.empty() || chunks_.back().data.size() - chunks_.back().size < size) {
+            appendChunk(size);
+        }
+
+        auto& chunk = chunks_.back();
+        reserved_ = size;
+        return MutableByteView(chunk.data.data() + chunk.size, size);
+    }
+
+    const auto idx = chunkAt(pos_);
+    const auto offset = pos_ - chunkOffsets_[idx];
+    auto& chunk = chunks_[idx];
+    if (offset + size > chunk.size) {
+        throw StreamError("MemoryOutputStream: Reserved span crosses chunk boundary");
+    }
+
+    reserved_ = size;
+    return MutableByteView(chunk.data.data() + offset, size);
+}
+
+void MemoryOutputStream::commit(std::size_t size)
+{
+    if (size > reserved_) {
+        throw StreamError("MemoryOutputStream: Committed size is greater than reserved span");
+    }
+
+    if (storage_ == Storage::Chunked && pos_ == size_) {
+        chunks_.back().size += size;
+    }
+
+    pos_ += size;
+    size_ = std::max(size_, pos_);
+    reserved_ = 0;
+}
+
+std::vector<ByteView> MemoryOutputStream::chunks() const
+{
+    std::vector<ByteView> views;
+    if (storage_ == Storage::Contiguous)
+    {
+        if (size_ > 0) {
+            views.emplace_back(buffer_.data(), size_);
+        }
+        return views;
+    }
+
+    views.reserve(chunks_.size());
+    for (const auto& chunk : chunks_)
+    {
+        if (chunk.size > 0) {
+            views.emplace_back(chunk.data.data(), chunk.size);
+        }
+    }
+    return views;
+}
+
+void MemoryOutputStream::writeTo(OutputStream& ostream) const
+{
+    for (const auto& view : chunks())
+    {
+        if (ostream.write(view.data(), view.size()) != view.size()) {
+            throw StreamError("MemoryOutputStream: Failed to write data to stream");
+        }
+    }
+}
+
+ByteArray MemoryOutputStream::release()
+{
+    ByteArray data;
+    if (storage_ == Storage::Contiguous)
+    {
+        buffer_.resize(size_);
+        data = std::move(buffer_);
+        buffer_ = ByteArray();
+    }
+    else if (chunks_.size() == 1)
+    {
+        chunks_.front().data.resize(size_);
+        data = std::move(chunks_.front().data);
+    }
+    else
+    {
+        data.reserve(size_);
+        for (const auto& view : chunks()) {
+            data.insert(data.end(), view.begin(), view.end());
+        }
+    }
+
+    chunks_.clear();
+    chunkOffsets_.clear();
+    size_     = 0;
+    pos_      = 0;
+    reserved_ = 0;
+    return data;
+}
+
+void MemoryOutputStream::clear()
+{
+    chunks_.clear();
+    chunkOffsets_.clear();
+    size_     = 0;
+    pos_      = 0;
+    reserved_ = 0;
+}
+
+std::size_t MemoryOutputStream::readsome(byte_t* /*data*/, std::size_t /*length*/) const
+{
+    throw StreamError("MemoryOutputStream: Can't read from output stream");
+}
+
+std::size_t MemoryOutputStream::writesome(const byte_t* data, std::size_t length)
+{
+    reserved_ = 0;
+    if (storage_ == Storage::Contiguous)
+    {
+        grow(pos_ + length);
+        std::memcpy(buffer_.data() + pos_, data, length);
+        pos_ += length;
+        size_ = std::max(size_, pos_);
+        return length;
+    }
+
+    std::size_t nLeft = length;
+    while (nLeft > 0)
+    {
+        std::size_t n = 0;
+        if (pos_ == size_)
+        {
+            // Append to the last chunk
+            if (chunks_.empty() || chunks_.back().size == chunks_.back().data.size()) {
+                appendChunk(nLeft);
+            }
+
+            auto& chunk = chunks_.back();
+            n = std::min(nLeft, chunk.data.size() - chunk.size);
+            std::memcpy(chunk.data.data() + chunk.size, data, n);
+            chunk.size += n;
+            size_ += n;
+        }
+        else
+        {
+            // Overwrite existing data
+            const auto idx = chunkAt(pos_);
+            const auto offset = pos_ - chunkOffsets_[idx];
+            auto& chunk = chunks_[idx];
+            n = std::min(nLeft, chunk.size - offset);
+            std::memcpy(chunk.data.data() + offset, data, n);
+        }
+
+        pos_  += n;
+        data  += n;
+        nLeft -= n;
+    }
+    return length;
+}
+
+void MemoryOutputStream::grow(std::size_t minCapacity)
+{
+    if (minCapacity > buffer_.size()) {
+        buffer_.resize(std::max({ minCapacity, buffer_.size() * 2, kMinCapacity }));
+    }
+}
+
+std::size_t MemoryOutputStream::chunkAt(std::size_t position) const
+{
+    auto it = std::upper_bound(chunkOffsets_.begin(), chunkOffsets_.end(), position);
+    return safe_cast<std::size_t>(std::distance(chunkOffsets_.begin(), it)) - 1;
+}
+
+MemoryOutputStream::Chunk& MemoryOutputStream::appendChunk(std::size_t minSize)
+{
+    // Empty last chunk is reused, so each chunk starts at unique stream offset
+    const auto newSize = std::max(minSize, chunkSize_);
+    if (!chunks_.empty() && chunks_.back().size == 0)
+    {
+        chunks_.back().data.resize(newSize);
+        return chunks_.back();
+    }
+
+    // Unused space of the last chunk is left unused
+    chunkOffsets_.push_back(size_);
+    auto& chunk = chunks_.emplace_back();
+    chunk.data.resize(newSize);
+    return chunk;
+}
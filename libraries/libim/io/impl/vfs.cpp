@@ -1,10 +1,92 @@
 #include "../vfs.h"
 #include "../filestream.h"
+#include "../vfsindex.h"
 #include <libim/log/log.h>
+#include <libim/trace/trace.h>
+
+#include <mutex>
 
 using namespace libim;
 namespace fs = std::filesystem;
 
+/** Mounted VFS index, GOB files are opened on the first access. */
+class VirtualFileSystem::IndexMount final
+{
+public:
+    explicit IndexMount(VfsIndex index) :
+        index_(std::move(index)),
+        gobs_(index_.mounts().size())
+    {}
+
+    std::optional<SharedRef<InputStream>> findFile(const fs::path& filePath) const
+    {
+        const auto file = index_.find(filePath.string());
+        if (!file) {
+            return std::nullopt;
+        }
+
+        const auto& mount = index_.mounts().at(file->mountIdx);
+        if (mount.type == VfsIndex::MountType::SysFolder)
+        {
+            // File could have been removed after the index was built
+            auto path = mount.path / fs::path(file->path);
+            if (!fileExists(path))
+            {
+                LOG_DEBUG("VFS: Indexed file % doesn't exist in system folder %", filePath, mount.path);
+                return std::nullopt;
+            }
+
+            LOG_DEBUG("VFS: Found indexed file % in system folder %", filePath, mount.path);
+            return makeSharedRef<InputFileStream>(path);
+        }
+
+        // Indexed file offset and size are not valid when GOB file was changed
+        if (!index_.isMountUpToDate(file->mountIdx))
+        {
+            LOG_WARNING("VFS: Indexed GOB file % has changed, skipping indexed file %", mount.path, filePath);
+            return std::nullopt;
+        }
+
+        LOG_DEBUG("VFS: Found indexed file % in GOB file %", filePath, mount.path);
+        auto [is, isMutex] = openGob(file->mountIdx);
+        auto vf = makeSharedRef<VirtualFile>(std::move(is), file->offset, file->size, std::move(isMutex));
+
+        auto name = getFilename(file->path);
+        utils::to_lower(name);
+        vf->setName(std::move(name));
+        return vf;
+    }
+
+    bool isUpToDate() const
+    {
+        return index_.isUpToDate();
+    }
+
+private:
+    struct Gob
+    {
+        std::optional<SharedRef<InputStream>> stream;
+        std::shared_ptr<std::mutex> mutex; // shared by all files in GOB
+    };
+
+    std::pair<SharedRef<InputStream>, std::shared_ptr<std::mutex>> openGob(std::size_t mountIdx) const
+    {
+        std::scoped_lock lock(mutex_);
+        auto& gob = gobs_.at(mountIdx);
+        if (!gob.stream)
+        {
+            gob.stream = makeSharedRef<InputFileStream>(index_.mounts().at(mountIdx).path);
+            gob.mutex  = std::make_shared<std::mutex>();
+        }
+        return { *gob.stream, gob.mutex };
+    }
+
+private:
+    VfsIndex index_;
+    mutable std::mutex mutex_;
+    mutable std::vector<Gob> gobs_;
+};
+
 bool VirtualFileSystem::addContainer(const fs::path& containerPath, const VfContainer& c)
 {
     auto it = std::find_if(vfiles_.begin(), vfiles_.end(),
@@ -55,6 +137,40 @@ bool VirtualFileSystem::tryLoadGobContainer(const fs::path& gobFilePath) noexcep
     }
 }
 
+void VirtualFileSystem::mountIndex(const fs::path& indexFile, const std::vector<fs::path>& sysFolders, const std::vector<fs::path>& gobFiles)
+{
+    LIBIM_TRACE_SCOPE_DETAIL("vfs", "VFS::mountIndex", indexFile.generic_string());
+    if (index_) {
+        throw VfsError("VFS index already mounted");
+    }
+
+    try
+    {
+        auto index = VfsIndex::load(indexFile, sysFolders, gobFiles);
+        if (index) {
+            LOG_INFO("VFS: Loaded index file % of % file(s)", indexFile, index->size());
+        }
+        else
+        {
+            index = VfsIndex::build(sysFolders, gobFiles);
+            try
+            {
+                index->save(indexFile);
+                LOG_INFO("VFS: Saved index file % of % file(s)", indexFile, index->size());
+            }
+            catch (const std::exception& e) {
+                LOG_WARNING("VFS: Failed to save index file %, e='%'", indexFile, e.what());
+            }
+        }
+        index_ = std::make_shared<const IndexMount>(std::move(*index));
+    }
+    catch(const VfsError&) { throw; }
+    catch(const std::exception& e)
+    {
+        throw VfsError(e.what());
+    }
+}
+
 void VirtualFileSystem::addSysFolder(const fs::path& folder)
 {
     if (!isDirPath(folder) || !dirExists(folder)) {
@@ -70,8 +186,21 @@ void VirtualFileSystem::addSysFolder(const fs::path& folder)
     LOG_INFO("VFS: Added system folder %", folder);
 }
 
+bool VirtualFileSystem::isIndexUpToDate() const
+{
+    return !index_ || index_->isUpToDate();
+}
+
 std::optional<SharedRef<InputStream>> VirtualFileSystem::findFile(const fs::path& filePath) const
 {
+    LIBIM_TRACE_SCOPE_DETAIL("vfs", "VFS::findFile", filePath.generic_string());
+    if (index_)
+    {
+        if (auto f = index_->findFile(filePath)) {
+            return f;
+        }
+    }
+
     for (const auto& sysFolder : sysDirs_)
     {
         auto path = sysFolder / filePath;
@@ -89,8 +218,9 @@ std::optional<SharedRef<InputStream>> VirtualFileSystem::findFile(const fs::path
         if (const auto& fs = c.get(filePath); fs.has_value())
         {
             LOG_DEBUG("VFS: Found file % in vf container %", filePath, cpath);
-            fs.value()->seekBegin();
-            return fs.value();
+            // Return new view of the file with own read position,
+            // so the same file can be read from multiple threads
+            return fs.value()->view();
         }
     }
     LOG_DEBUG("VFS: Couldn't find file %", filePath);
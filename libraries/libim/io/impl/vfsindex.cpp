@@ -0,0 +1,497 @@
+#include "../vfsindex.h"
+#include "../binarystream.h"
+#include "../filestream.h"
+#include "../memorystream.h"
+#include "../schema.h"
+#include "../vfs.h"
+#include "../vfstream.h"
+
+#include <libim/log/log.h>
+#include <libim/trace/trace.h>
+#include <libim/types/packed_view.h>
+#include <libim/types/safe_cast.h>
+#include <libim/utils/ascii.h>
+#include <libim/utils/endian.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+using namespace libim;
+namespace fs = std::filesystem;
+
+static constexpr std::array<char, 4> kVfsIndexMagic   = {{ 'V', 'F', 'S', 'I' }};
+static constexpr uint32_t            kVfsIndexVersion = 1;
+static constexpr uint32_t            kFlagLittleEndian = 0x1; // Path hashes were computed on little-endian platform
+static constexpr uint16_t            kEmptySlot       = std::numeric_limits<uint16_t>::max();
+static constexpr std::size_t         kMinSlots        = 8;
+
+namespace {
+    struct VfsIndexHeader
+    {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t flags;
+        uint32_t numMounts;
+        uint32_t numDirs;
+        uint32_t numFiles;
+        uint32_t numSlots;
+        uint32_t sizeStrings;
+    };
+    static_assert(sizeof(VfsIndexHeader) == 32);
+
+    struct VfsIndexMount
+    {
+        VfsIndex::MountType type;
+        uint32_t pathOffset;
+        uint32_t pathSize;
+        uint32_t numDirs;  // Number of subfolder records of system folder
+        uint64_t size;     // Size of GOB file
+        int64_t mtime;     // Modification time of GOB file or system folder
+    };
+    static_assert(sizeof(VfsIndexMount) == 32);
+
+    struct VfsIndexDir
+    {
+        uint32_t pathOffset; // Path relative to system folder
+        uint32_t pathSize;
+        int64_t mtime;
+    };
+    static_assert(sizeof(VfsIndexDir) == 16);
+
+    struct VfsIndexSlot
+    {
+        uint64_t hash;
+        uint32_t pathOffset;
+        uint16_t pathSize;
+        uint16_t mountIdx; // kEmptySlot if slot is empty
+        uint32_t offset;
+        uint32_t size;
+    };
+    static_assert(sizeof(VfsIndexSlot) == 24);
+}
+
+template<>
+struct libim::StructSchema<VfsIndexHeader>
+{
+    using H = VfsIndexHeader;
+    static constexpr std::string_view name = "VfsIndexHeader";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&H::magic>("magic", kVfsIndexMagic),
+        schemaField<&H::version>("version", kVfsIndexVersion),
+        schemaField<&H::flags>("flags"),
+        schemaField<&H::numMounts>("numMounts"),
+        schemaField<&H::numDirs>("numDirs"),
+        schemaField<&H::numFiles>("numFiles"),
+        schemaField<&H::numSlots>("numSlots"),
+        schemaField<&H::sizeStrings>("sizeStrings")
+    );
+};
+
+template<>
+struct libim::StructSchema<VfsIndexMount>
+{
+    using M = VfsIndexMount;
+    static constexpr std::string_view name = "VfsIndexMount";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&M::type>("type", VfsIndex::MountType::SysFolder, VfsIndex::MountType::Gob),
+        schemaField<&M::pathOffset>("pathOffset"),
+        schemaField<&M::pathSize>("pathSize"),
+        schemaField<&M::numDirs>("numDirs"),
+        schemaField<&M::size>("size"),
+        schemaField<&M::mtime>("mtime")
+    );
+};
+
+template<>
+struct libim::StructSchema<VfsIndexDir>
+{
+    using D = VfsIndexDir;
+    static constexpr std::string_view name = "VfsIndexDir";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&D::pathOffset>("pathOffset"),
+        schemaField<&D::pathSize>("pathSize"),
+        schemaField<&D::mtime>("mtime")
+    );
+};
+
+template<>
+struct libim::StructSchema<VfsIndexSlot>
+{
+    using S = VfsIndexSlot;
+    static constexpr std::string_view name = "VfsIndexSlot";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&S::hash>("hash"),
+        schemaField<&S::pathOffset>("pathOffset"),
+        schemaField<&S::pathSize>("pathSize"),
+        schemaField<&S::mountIdx>("mountIdx"),
+        schemaField<&S::offset>("offset"),
+        schemaField<&S::size>("size")
+    );
+};
+
+/** Case folds char of path, path separators are folded to '/'. */
+static constexpr char foldPathChar(char c)
+{
+    return c == '\\' ? '/' : utils::asciiToLower(c);
+}
+
+static std::string makeKey(std::string_view path)
+{
+    std::string key(path.size(), '\0');
+    std::transform(path.begin(), path.end(), key.begin(), foldPathChar);
+    return key;
+}
+
+static bool keyEqual(std::string_view path, std::string_view key)
+{
+    return path.size() == key.size() &&
+        std::equal(path.begin(), path.end(), key.begin(), [](char c, char k) { return foldPathChar(c) == k; });
+}
+
+static int64_t fileTime(const fs::path& path, std::error_code& ec)
+{
+    return static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+}
+
+/** Returns record at idx in serialized array in native byte order. */
+template<typename T>
+static T getRecord(ByteView data, std::size_t idx)
+{
+    T r = PackedView<T>(data.data(), data.size() / sizeof(T))[idx];
+    if (!utils::kNativeLittleEndian) {
+        schemaByteSwap(r);
+    }
+    return r;
+}
+
+
+VfsIndex::VfsIndex(MappedFile file) :
+    file_(std::move(file)),
+    data_(file_.data())
+{
+    init();
+}
+
+VfsIndex::VfsIndex(ByteArray data) :
+    buffer_(std::move(data)),
+    data_(buffer_)
+{
+    init();
+}
+
+void VfsIndex::init()
+{
+    InputBinaryStream<ByteView> istream(data_);
+    const auto header = readStruct<VfsIndexHeader>(istream);
+    if (((header.flags & kFlagLittleEndian) != 0) != utils::kNativeLittleEndian) {
+        throw VfsError("VFS index was built on platform with different byte order");
+    }
+
+    if (!std::has_single_bit(header.numSlots) || header.numSlots <= header.numFiles) {
+        throw VfsError("Invalid size of VFS index hash table");
+    }
+
+    const uint64_t size = sizeof(VfsIndexHeader)
+        + uint64_t(header.numMounts) * sizeof(VfsIndexMount)
+        + uint64_t(header.numDirs)   * sizeof(VfsIndexDir)
+        + uint64_t(header.numSlots)  * sizeof(VfsIndexSlot)
+        + header.sizeStrings;
+    if (size != data_.size()) {
+        throw VfsError("Invalid size of VFS index");
+    }
+
+    std::size_t offset = sizeof(VfsIndexHeader);
+    auto nextSection = [&](std::size_t sectionSize) {
+        auto section = data_.subspan(offset, sectionSize);
+        offset += sectionSize;
+        return section;
+    };
+    mountData_ = nextSection(header.numMounts * sizeof(VfsIndexMount));
+    dirData_   = nextSection(header.numDirs   * sizeof(VfsIndexDir));
+    slotData_  = nextSection(header.numSlots  * sizeof(VfsIndexSlot));
+    strings_   = nextSection(header.sizeStrings);
+    numFiles_  = header.numFiles;
+
+    std::size_t numDirs = 0;
+    mounts_.reserve(header.numMounts);
+    for (std::size_t i = 0; i < header.numMounts; i++)
+    {
+        auto m = getRecord<VfsIndexMount>(mountData_, i);
+        schemaValidate(m);
+        numDirs += m.numDirs;
+        mounts_.push_back({ m.type, fs::path(string(m.pathOffset, m.pathSize)) });
+    }
+
+    if (numDirs != header.numDirs) {
+        throw VfsError("Invalid number of folders in VFS index");
+    }
+}
+
+std::string_view VfsIndex::string(uint32_t offset, uint32_t size) const
+{
+    if (offset > strings_.size() || size > strings_.size() - offset) {
+        throw VfsError("Corrupted VFS index, string out of bounds");
+    }
+    return std::string_view(reinterpret_cast<const char*>(strings_.data()) + offset, size);
+}
+
+bool VfsIndex::isUpToDate(const std::vector<fs::path>& sysFolders, const std::vector<fs::path>& gobFiles) const
+{
+    if (mounts_.size() != sysFolders.size() + gobFiles.size()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < mounts_.size(); i++)
+    {
+        const bool isSysFolder = i < sysFolders.size();
+        const auto& path       = isSysFolder ? sysFolders.at(i) : gobFiles.at(i - sysFolders.size());
+        const auto type        = isSysFolder ? MountType::SysFolder : MountType::Gob;
+        if (mounts_.at(i).type != type || mounts_.at(i).path != path) {
+            return false;
+        }
+    }
+    return isUpToDate();
+}
+
+bool VfsIndex::isUpToDate() const
+{
+    std::error_code ec;
+    std::size_t dirIdx = 0;
+    for (std::size_t i = 0; i < mounts_.size(); i++)
+    {
+        if (!isMountUpToDate(i)) {
+            return false;
+        }
+
+        const auto m = getRecord<VfsIndexMount>(mountData_, i);
+        if (m.type == MountType::Gob) {
+            continue;
+        }
+
+        // Folder modification time changes when any file or subfolder is added, removed or renamed
+        const auto& path = mounts_.at(i).path;
+        for (const auto end = dirIdx + m.numDirs; dirIdx < end; dirIdx++)
+        {
+            const auto d = getRecord<VfsIndexDir>(dirData_, dirIdx);
+            if (fileTime(path / string(d.pathOffset, d.pathSize), ec) != d.mtime || ec) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool VfsIndex::isMountUpToDate(std::size_t mountIdx) const
+{
+    std::error_code ec;
+    const auto& path = mounts_.at(mountIdx).path;
+    const auto m     = getRecord<VfsIndexMount>(mountData_, mountIdx);
+    if (fileTime(path, ec) != m.mtime || ec) {
+        return false;
+    }
+    return m.type != MountType::Gob || (fs::file_size(path, ec) == m.size && !ec);
+}
+
+VfsIndex VfsIndex::build(const std::vector<fs::path>& sysFolders, const std::vector<fs::path>& gobFiles)
+{
+    LIBIM_TRACE_SCOPE("vfs", "VfsIndex::build");
+    if (sysFolders.size() + gobFiles.size() >= kEmptySlot) {
+        throw VfsError("Too many VFS index mounts");
+    }
+
+    std::string strings;
+    auto addString = [&](std::string_view str) {
+        const auto offset = safe_cast<uint32_t>(strings.size());
+        strings.append(str);
+        return std::pair(offset, safe_cast<uint32_t>(str.size()));
+    };
+
+    std::vector<VfsIndexMount> mounts;
+    std::vector<VfsIndexDir> dirs;
+    std::vector<VfsIndexSlot> files;
+    std::unordered_set<std::string> keys;
+    auto addFile = [&](std::size_t mountIdx, std::string_view path, std::size_t offset, std::size_t size)
+    {
+        auto key = makeKey(path);
+        const auto hash = utils::asciiIHash(key);
+        if (!keys.insert(std::move(key)).second) {
+            return; // File is already indexed from previous mount
+        }
+
+        const auto [pathOffset, pathSize] = addString(path);
+        files.push_back({
+            .hash       = hash,
+            .pathOffset = pathOffset,
+            .pathSize   = safe_cast<uint16_t>(pathSize),
+            .mountIdx   = static_cast<uint16_t>(mountIdx),
+            .offset     = safe_cast<uint32_t>(offset),
+            .size       = safe_cast<uint32_t>(size)
+        });
+    };
+
+    std::error_code ec;
+    for (const auto& folder : sysFolders)
+    {
+        if (!isDirPath(folder) || !dirExists(folder)) {
+            throw VfsError(utils::format("Can't index non-existing or invalid system folder %", folder));
+        }
+
+        const auto [pathOffset, pathSize] = addString(folder.string());
+        auto& mount = mounts.emplace_back(VfsIndexMount{
+            .type       = MountType::SysFolder,
+            .pathOffset = pathOffset,
+            .pathSize   = pathSize,
+            .numDirs    = 0,
+            .size       = 0,
+            .mtime      = fileTime(folder, ec)
+        });
+
+        for (const auto& e : fs::recursive_directory_iterator(folder, fs::directory_options::skip_permission_denied))
+        {
+            const auto relPath = e.path().lexically_relative(folder).generic_string();
+            if (e.is_directory(ec))
+            {
+                const auto [dirOffset, dirSize] = addString(relPath);
+                dirs.push_back({ dirOffset, dirSize, fileTime(e.path(), ec) });
+                mount.numDirs++;
+            }
+            else if (e.is_regular_file(ec)) {
+                addFile(mounts.size() - 1, relPath, 0, e.file_size(ec));
+            }
+        }
+    }
+
+    for (const auto& gobFile : gobFiles)
+    {
+        InputFileStream gob(gobFile);
+        const auto [pathOffset, pathSize] = addString(gobFile.string());
+        mounts.push_back({
+            .type       = MountType::Gob,
+            .pathOffset = pathOffset,
+            .pathSize   = pathSize,
+            .numDirs    = 0,
+            .size       = gob.size(),
+            .mtime      = fileTime(gobFile, ec)
+        });
+
+        for (const auto& e : gobReadDirectory(gob)) {
+            addFile(mounts.size() - 1, e.filePath, e.offset, e.size);
+        }
+    }
+
+    // Hash table with linear probing, load factor is at most 0.5
+    const auto numSlots = std::bit_ceil(std::max(files.size() * 2, kMinSlots));
+    VfsIndexSlot emptySlot {};
+    emptySlot.mountIdx = kEmptySlot;
+    std::vector<VfsIndexSlot> slots(numSlots, emptySlot);
+    for (const auto& f : files)
+    {
+        auto i = f.hash & (numSlots - 1);
+        while (slots[i].mountIdx != kEmptySlot) {
+            i = (i + 1) & (numSlots - 1);
+        }
+        slots[i] = f;
+    }
+
+    const VfsIndexHeader header {
+        .magic       = kVfsIndexMagic,
+        .version     = kVfsIndexVersion,
+        .flags       = utils::kNativeLittleEndian ? kFlagLittleEndian : 0,
+        .numMounts   = safe_cast<uint32_t>(mounts.size()),
+        .numDirs     = safe_cast<uint32_t>(dirs.size()),
+        .numFiles    = safe_cast<uint32_t>(files.size()),
+        .numSlots    = safe_cast<uint32_t>(numSlots),
+        .sizeStrings = safe_cast<uint32_t>(strings.size())
+    };
+
+    MemoryOutputStream ms;
+    writeStruct(ms, header);
+    writeStructs<VfsIndexMount>(ms, mounts);
+    writeStructs<VfsIndexDir>(ms, dirs);
+    writeStructs<VfsIndexSlot>(ms, slots);
+    ms.write(reinterpret_cast<const byte_t*>(strings.data()), strings.size());
+
+    LOG_DEBUG("VFS: Built index of % file(s) in % mount(s)", files.size(), mounts.size());
+    return VfsIndex(ms.release());
+}
+
+std::optional<VfsIndex> VfsIndex::load(const fs::path& indexFile, const std::vector<fs::path>& sysFolders, const std::vector<fs::path>& gobFiles)
+{
+    LIBIM_TRACE_SCOPE_DETAIL("vfs", "VfsIndex::load", indexFile.generic_string());
+    if (!fileExists(indexFile)) {
+        return std::nullopt;
+    }
+
+    try
+    {
+        VfsIndex index(MappedFile{ indexFile });
+        if (!index.isUpToDate(sysFolders, gobFiles))
+        {
+            LOG_DEBUG("VFS: Index file % is stale", indexFile);
+            return std::nullopt;
+        }
+        return index;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_WARNING("VFS: Failed to load index file %, e='%'", indexFile, e.what());
+        return std::nullopt;
+    }
+}
+
+void VfsIndex::save(const fs::path& indexFile) const
+{
+    // Write to temporary file first, so the index file is never partially written
+    auto tmpFile = indexFile;
+    tmpFile += ".tmp";
+    {
+        OutputFileStream ofs(tmpFile, /*truncate=*/true);
+        ofs.write(data_.data(), data_.size());
+    }
+
+    std::error_code ec;
+    fs::rename(tmpFile, indexFile, ec);
+    if (ec)
+    {
+        fs::remove(tmpFile, ec);
+        throw FileStreamError(utils::format("Failed to write VFS index file %", indexFile));
+    }
+}
+
+std::optional<VfsIndex::File> VfsIndex::find(std::string_view filePath) const
+{
+    const auto numSlots = slotData_.size() / sizeof(VfsIndexSlot);
+    if (numFiles_ == 0) {
+        return std::nullopt;
+    }
+
+    const auto key  = makeKey(filePath);
+    const auto hash = utils::asciiIHash(key);
+    for (std::size_t i = hash & (numSlots - 1), n = 0; n < numSlots; i = (i + 1) & (numSlots - 1), n++)
+    {
+        const auto slot = getRecord<VfsIndexSlot>(slotData_, i);
+        if (slot.mountIdx == kEmptySlot) {
+            break;
+        }
+
+        if (slot.hash != hash) {
+            continue;
+        }
+
+        const auto path = string(slot.pathOffset, slot.pathSize);
+        if (keyEqual(path, key))
+        {
+            if (slot.mountIdx >= mounts_.size()) {
+                throw VfsError("Corrupted VFS index, invalid mount index");
+            }
+            return File{ slot.mountIdx, path, slot.offset, slot.size };
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,112 @@
+#ifndef LIBIM_MANIFEST_H
+#define LIBIM_MANIFEST_H
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../common.h"
+
+namespace libim {
+
+    /** Content hash of file or section stored in container file, e.g. GOB file entry or CND section. */
+    struct ContentHash
+    {
+        std::string name;
+        std::size_t offset = 0; // offset of content in container file, not stored in manifest file
+        std::size_t size   = 0;
+        uint64_t hash      = 0; // utils::hash64 of content
+    };
+
+    /** Changes between two content manifests. */
+    struct ContentDiff
+    {
+        std::vector<std::string> added;
+        std::vector<std::string> removed;
+        std::vector<std::string> modified; // size or hash of content changed
+
+        bool empty() const
+        {
+            return added.empty() && removed.empty() && modified.empty();
+        }
+    };
+
+    /**
+     * Manifest of content hashes of container file.
+     * Entry names are matched ASCII case-insensitive and path separators '\\' and '/' are equal.
+     *
+     * Manifest file is a text file with one entry per line: <hash> <size> <name>.
+     * Content hash is native byte order dependent (see utils::Hasher64),
+     * so manifests can be compared only on platforms with the same endianness.
+     */
+    class ContentManifest
+    {
+    public:
+        ContentManifest() = default;
+        explicit ContentManifest(std::vector<ContentHash> entries);
+
+        /**
+         * Reads manifest from file.
+         * @param filePath - path to manifest file.
+         * @throw StreamError if file can't be read or is invalid manifest file.
+         */
+        [[nodiscard]] static ContentManifest load(const std::filesystem::path& filePath);
+
+        /**
+         * Writes manifest to file.
+         * @param filePath - path to manifest file.
+         * @throw StreamError
+         */
+        void save(const std::filesystem::path& filePath) const;
+
+        const std::vector<ContentHash>& entries() const
+        {
+            return entries_;
+        }
+
+        /** Returns pointer to entry or nullptr if entry doesn't exist. */
+        const ContentHash* find(std::string_view name) const;
+
+        /**
+         * Returns changes of content from previous manifest to this manifest.
+         * @param prev - previous manifest.
+         */
+        [[nodiscard]] ContentDiff diff(const ContentManifest& prev) const;
+
+    private:
+        std::vector<ContentHash> entries_;
+        std::unordered_map<std::string, std::size_t> index_; // lower case name -> entry idx
+    };
+
+    /**
+     * Computes content hashes of data ranges in parallel.
+     * @param data       - container data, e.g. memory mapped file.
+     * @param entries    - entries with offset and size of content in data, hash of each entry is set.
+     * @param maxThreads - max number of threads to use. 0 = all hardware threads.
+     * @throw StreamError if range of any entry is out of data bounds.
+     */
+    void hashContent(ByteView data, std::span<ContentHash> entries, std::size_t maxThreads = 0);
+
+    /**
+     * Computes content manifest of all GOB file entries.
+     * GOB file is memory mapped and entries are hashed in parallel.
+     * @param gobFile    - path to GOB file.
+     * @param maxThreads - max number of threads to use. 0 = all hardware threads.
+     * @throw StreamError
+     */
+    [[nodiscard]] ContentManifest gobContentManifest(const std::filesystem::path& gobFile, std::size_t maxThreads = 0);
+
+    /**
+     * Computes content manifest of all files in folder and its subfolders.
+     * Entry names are file paths relative to folder with '\\' path separator as in GOB files,
+     * and entries are sorted by name. Files are hashed in parallel.
+     * @param folder     - path to system folder.
+     * @param maxThreads - max number of threads to use. 0 = all hardware threads.
+     * @throw StreamError
+     */
+    [[nodiscard]] ContentManifest folderContentManifest(const std::filesystem::path& folder, std::size_t maxThreads = 0);
+}
+#endif // LIBIM_MANIFEST_H
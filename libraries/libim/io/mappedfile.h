@@ -0,0 +1,57 @@
+#ifndef LIBIM_MAPPEDFILE_H
+#define LIBIM_MAPPEDFILE_H
+#include "stremerror.h"
+#include "../common.h"
+
+#include <filesystem>
+#include <memory>
+
+namespace libim {
+
+    /**
+     * Read-only memory mapped file.
+     * The whole file is mapped into memory on construction and unmapped on destruction.
+     * The mapped data is not copied, pages are loaded by OS on first access.
+     *
+     * Moving MappedFile doesn't change the address of mapped data.
+     */
+    class MappedFile final
+    {
+    public:
+        /** Constructs empty object without mapped file. */
+        MappedFile() noexcept;
+
+        /**
+         * Maps file into memory.
+         * @param filePath - path to file.
+         * @throw FileStreamError if file can't be opened or mapped.
+         */
+        explicit MappedFile(const std::filesystem::path& filePath);
+
+        MappedFile(MappedFile&&) noexcept;
+        MappedFile& operator=(MappedFile&&) noexcept;
+        ~MappedFile();
+
+        /** Returns view of mapped file data. */
+        ByteView data() const
+        {
+            return data_;
+        }
+
+        std::size_t size() const
+        {
+            return data_.size();
+        }
+
+        bool empty() const
+        {
+            return data_.empty();
+        }
+
+    private:
+        struct MappedFileImpl;
+        std::unique_ptr<MappedFileImpl> ptr_;
+        ByteView data_;
+    };
+}
+#endif // LIBIM_MAPPEDFILE_H
@@ -0,0 +1,140 @@
+#ifndef LIBIM_MEMORYSTREAM_H
+#define LIBIM_MEMORYSTREAM_H
+#include "stream.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace libim {
+
+    /**
+     * Growable in-memory output stream.
+     * Buffer grows geometrically so writing data through many small writes takes amortized linear time.
+     *
+     * Stream can store data in one contiguous buffer (default), which can be released without copying,
+     * or in list of chunks for very large outputs, where the written data is never reallocated or moved.
+     *
+     * Serializers can write directly into the stream memory via reserveSpan and commit.
+     */
+    class MemoryOutputStream final : public OutputStream
+    {
+    public:
+        enum class Storage
+        {
+            Contiguous, // Data is stored in single buffer which is reallocated when grown
+            Chunked     // Data is stored in list of chunks, allocated new chunk when last chunk is full
+        };
+
+        static constexpr std::size_t kDefaultChunkSize = 1024 * 1024; // 1 MiB
+
+        /**
+         * Constructs stream.
+         * @param storage   - data storage. By default Storage::Contiguous.
+         * @param chunkSize - min size of allocated chunk when storage is Storage::Chunked.
+         */
+        explicit MemoryOutputStream(Storage storage = Storage::Contiguous, std::size_t chunkSize = kDefaultChunkSize);
+
+        /**
+         * Constructs contiguous stream which appends data to existing buffer.
+         * Stream position is set to the end of buffer.
+         * @param buffer - data buffer to take over.
+         */
+        explicit MemoryOutputStream(ByteArray buffer);
+
+        virtual ~MemoryOutputStream() override = default;
+
+        /**
+         * Sets stream position.
+         * @param position - new position in range [0, size()].
+         * @throw StreamError if position is past the end of stream.
+         */
+        virtual void seek(std::size_t position) const override;
+        virtual std::size_t size() const override;
+        virtual std::size_t tell() const override;
+        virtual bool canRead() const override;
+        virtual bool canWrite() const override;
+
+        Storage storage() const
+        {
+            return storage_;
+        }
+
+        /** Returns number of bytes the stream can hold without allocating new memory. */
+        std::size_t capacity() const;
+
+        /** Reserves memory for at least capacity bytes. */
+        void reserve(std::size_t capacity);
+
+        /**
+         * Returns writable span of size bytes at current stream position.
+         * Written bytes become part of the stream after calling commit.
+         * The span is valid until the next non-const call on stream.
+         *
+         * @param size - size of span.
+         * @return writable span of size bytes.
+         * @throw StreamError if storage is Storage::Chunked and span would cross chunk boundary
+         *                    of data already written, i.e. when stream position is not at the end.
+         */
+        MutableByteView reserveSpan(std::size_t size);
+
+        /**
+         * Advances stream position by size bytes after writing to span returned by reserveSpan.
+         * @param size - number of written bytes. Must not exceed the size of reserved span.
+         * @throw StreamError if size is greater than the size of reserved span.
+         */
+        void commit(std::size_t size);
+
+        /**
+         * Returns views of written data in order.
+         * Contiguous stream returns single view.
+         * Views are valid until the next non-const call on stream.
+         */
+        std::vector<ByteView> chunks() const;
+
+        /**
+         * Writes stream data to other stream.
+         * @param ostream - output stream to write data to.
+         */
+        void writeTo(OutputStream& ostream) const;
+
+        /**
+         * Releases written data and resets the stream.
+         * Contiguous buffer and single chunk are moved out without copying,
+         * multiple chunks are concatenated into single buffer.
+         * @return stream data.
+         */
+        [[nodiscard]] ByteArray release();
+
+        /** Clears stream data and keeps allocated contiguous buffer. */
+        void clear();
+
+    protected:
+        virtual void flush() override {}
+        virtual std::size_t readsome(byte_t* data, std::size_t length) const override;
+        virtual std::size_t writesome(const byte_t* data, std::size_t length) override;
+
+    private:
+        struct Chunk
+        {
+            ByteArray data;       // Chunk buffer, data.size() is chunk capacity
+            std::size_t size = 0; // Number of used bytes
+        };
+
+        void grow(std::size_t minCapacity);
+        std::size_t chunkAt(std::size_t position) const;
+        Chunk& appendChunk(std::size_t minSize);
+
+    private:
+        Storage storage_;
+        std::size_t chunkSize_;
+        std::size_t size_ = 0;
+        mutable std::size_t pos_ = 0;
+        std::size_t reserved_ = 0;   // Size of span returned by reserveSpan
+
+        ByteArray buffer_;           // Contiguous storage, buffer_.size() is capacity
+        std::vector<Chunk> chunks_;  // Chunked storage
+        std::vector<std::size_t> chunkOffsets_; // Stream offset of each chunk
+    };
+}
+#endif // LIBIM_MEMORYSTREAM_H
@@ -0,0 +1,355 @@
+#ifndef LIBIM_SCHEMA_H
+#define LIBIM_SCHEMA_H
+#include "stream.h"
+#include "stremerror.h"
+#include "../common.h"
+
+#include <libim/utils/endian.h>
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Header file provides compile-time schema of binary structs stored in game files.
+ *
+ * On-disk struct declares its fields once by specializing libim::StructSchema:
+ *
+ *   template<>
+ *   struct libim::StructSchema<GobFileEntry>
+ *   {
+ *       static constexpr std::string_view name = "GobFileEntry";
+ *       static constexpr auto fields = std::make_tuple(
+ *           schemaField<&GobFileEntry::offset>("offset"),
+ *           schemaField<&GobFileEntry::size>("size", 0u, kMaxSize), // value range
+ *           schemaField<&GobFileEntry::filePath>("filePath")
+ *       );
+ *   };
+ *
+ * The fields must describe the whole struct without padding, which is verified at compile time.
+ * The struct can then be read and written in bulk by readStruct(s) and writeStruct(s)
+ * with a single read or write call. Read structs are converted from little-endian byte order
+ * on big-endian platforms and validated against field checks in a single pass.
+ */
+
+namespace libim {
+
+    /** Schema of binary struct T. Must be specialized for each struct, see header description. */
+    template<typename T>
+    struct StructSchema;
+
+    template<typename T>
+    concept HasStructSchema = requires {
+        { StructSchema<T>::name } -> std::convertible_to<std::string_view>;
+        StructSchema<T>::fields;
+    };
+
+    namespace detail {
+        template<typename> struct MemberPointerTraits;
+
+        template<typename S, typename M>
+        struct MemberPointerTraits<M S::*>
+        {
+            using struct_type = S;
+            using value_type  = M;
+        };
+
+        template<typename T>
+        inline constexpr bool isOrderable = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+    }
+
+    /**
+     * Field of binary struct.
+     * @tparam Member - pointer to data member of struct.
+     */
+    template<auto Member>
+    struct SchemaField final
+    {
+        using struct_type = typename detail::MemberPointerTraits<decltype(Member)>::struct_type;
+        using value_type  = typename detail::MemberPointerTraits<decltype(Member)>::value_type;
+
+        enum class Check
+        {
+            None,
+            Range, // Value must be in range [min, max]
+            Equal  // Value must be equal to min
+        };
+
+        std::string_view name;
+        Check check = Check::None;
+        value_type min {};
+        value_type max {};
+
+        // Note, fields are accessed by value since struct can be packed.
+        static constexpr value_type get(const struct_type& s)
+        {
+            return s.*Member;
+        }
+
+        static constexpr void set(struct_type& s, const value_type& v)
+        {
+            s.*Member = v;
+        }
+
+        constexpr bool isValid(const value_type& v) const
+        {
+            if constexpr (std::equality_comparable<value_type>)
+            {
+                if (check == Check::Equal) {
+                    return v == min;
+                }
+            }
+            if constexpr (detail::isOrderable<value_type>)
+            {
+                if (check == Check::Range) {
+                    return !(v < min) && !(max < v);
+                }
+            }
+            return true;
+        }
+    };
+
+    /** Declares struct field without value check. */
+    template<auto Member>
+    constexpr SchemaField<Member> schemaField(std::string_view name)
+    {
+        return { name };
+    }
+
+    /** Declares struct field which value must be equal to expected. */
+    template<auto Member>
+        requires std::equality_comparable<typename SchemaField<Member>::value_type>
+    constexpr SchemaField<Member> schemaField(std::string_view name, const typename SchemaField<Member>::value_type& expected)
+    {
+        return { name, SchemaField<Member>::Check::Equal, expected, expected };
+    }
+
+    /** Declares arithmetic or enum struct field which value must be in range [min, max]. */
+    template<auto Member>
+        requires detail::isOrderable<typename SchemaField<Member>::value_type>
+    constexpr SchemaField<Member> schemaField(std::string_view name,
+        typename SchemaField<Member>::value_type min, typename SchemaField<Member>::value_type max)
+    {
+        return { name, SchemaField<Member>::Check::Range, min, max };
+    }
+
+    namespace detail {
+        template<typename T, typename F>
+        constexpr void forEachSchemaField(F&& f)
+        {
+            std::apply([&](const auto&... field) { (f(field), ...); }, StructSchema<T>::fields);
+        }
+
+        template<HasStructSchema T>
+        consteval std::size_t schemaFieldsSize()
+        {
+            std::size_t size = 0;
+            forEachSchemaField<T>([&](const auto& field) {
+                size += sizeof(typename std::decay_t<decltype(field)>::value_type);
+            });
+            return size;
+        }
+
+        template<HasStructSchema T>
+        consteval bool isValidSchema()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Struct with schema must be trivially copyable");
+            static_assert(schemaFieldsSize<T>() == sizeof(T),
+                "Struct schema fields must cover the whole struct without padding"
+            );
+            return true;
+        }
+
+        template<typename T>
+        constexpr void byteSwapValue(T& v)
+        {
+            if constexpr (sizeof(T) == 1) {
+                return;
+            }
+            else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+                v = utils::byteSwap(v);
+            }
+            else if constexpr (HasStructSchema<T>)
+            {
+                forEachSchemaField<T>([&](const auto& field) {
+                    auto fv = field.get(v);
+                    byteSwapValue(fv);
+                    field.set(v, fv);
+                });
+            }
+            else if constexpr (requires { typename T::FlagType; }) { // libim::Flags
+                v = T(utils::byteSwap(static_cast<typename T::FlagType>(v)));
+            }
+            else if constexpr (requires { v.begin(); v.end(); }) // std::array, FixedString, AbstractVector
+            {
+                for (auto& e : v) {
+                    byteSwapValue(e);
+                }
+            }
+            else {
+                static_assert(sizeof(T) == 0, "Can't convert byte order of type T, declare StructSchema<T>");
+            }
+        }
+
+        template<typename T>
+        std::string schemaValueToString(const T& v)
+        {
+            if constexpr (std::is_enum_v<T>) {
+                return std::to_string(static_cast<std::underlying_type_t<T>>(v));
+            }
+            else if constexpr (std::is_arithmetic_v<T>) {
+                return std::to_string(v);
+            }
+            else if constexpr (requires { { *v.data() } -> std::convertible_to<const char&>; v.size(); }) {
+                return "'" + std::string(v.data(), v.size()) + "'";
+            }
+            else {
+                return "<unexpected value>";
+            }
+        }
+
+        template<typename T>
+        void schemaValidate(const T& s)
+        {
+            forEachSchemaField<T>([&](const auto& field)
+            {
+                using VT = typename std::decay_t<decltype(field)>::value_type;
+                const VT v = field.get(s);
+                if (!field.isValid(v))
+                {
+                    throw StreamError(
+                        "Invalid " + std::string(StructSchema<T>::name) + " field '" +
+                        std::string(field.name) + "' value: " + schemaValueToString(v)
+                    );
+                }
+                if constexpr (HasStructSchema<VT>) {
+                    schemaValidate(v);
+                }
+            });
+        }
+    }
+
+    /** Converts struct between native and little-endian byte order. */
+    template<HasStructSchema T>
+    constexpr void schemaByteSwap(T& s)
+    {
+        static_assert(detail::isValidSchema<T>());
+        detail::byteSwapValue(s);
+    }
+
+    /**
+     * Validates struct field values.
+     * @throw StreamError if any field value is invalid.
+     */
+    template<HasStructSchema T>
+    void schemaValidate(const T& s)
+    {
+        static_assert(detail::isValidSchema<T>());
+        detail::schemaValidate(s);
+    }
+
+    /**
+     * Converts structs read from little-endian data to native byte order and validates them in a single pass.
+     * @throw StreamError if any struct is invalid.
+     */
+    template<HasStructSchema T>
+    void decodeStructs(std::span<T> structs)
+    {
+        for (auto& s : structs)
+        {
+            if (!utils::kNativeLittleEndian) {
+                schemaByteSwap(s);
+            }
+            schemaValidate(s);
+        }
+    }
+
+    /**
+     * Reads count structs from little-endian data.
+     * @throw StreamError if data is too small or any struct is invalid.
+     */
+    template<HasStructSchema T>
+    [[nodiscard]] std::vector<T> readStructs(ByteView data, std::size_t count)
+    {
+        if (count > data.size() / sizeof(T)) {
+            throw StreamError("Failed to read '" + std::string(StructSchema<T>::name) + "' list, not enough data");
+        }
+
+        std::vector<T> structs(count);
+        std::memcpy(structs.data(), data.data(), count * sizeof(T));
+        decodeStructs(std::span(structs));
+        return structs;
+    }
+
+    /**
+     * Reads count structs from stream with single read.
+     * @throw StreamError if stream read fails or any struct is invalid.
+     */
+    template<HasStructSchema T>
+    [[nodiscard]] std::vector<T> readStructs(const InputStream& istream, std::size_t count)
+    {
+        if (count > istream.remaining() / sizeof(T)) {
+            throw StreamError("Failed to read '" + std::string(StructSchema<T>::name) + "' list, end of stream");
+        }
+
+        auto structs = istream.read<std::vector<T>>(count);
+        decodeStructs(std::span(structs));
+        return structs;
+    }
+
+    /**
+     * Reads struct from stream.
+     * @throw StreamError if stream read fails or struct is invalid.
+     */
+    template<HasStructSchema T>
+    [[nodiscard]] T readStruct(const InputStream& istream)
+    {
+        T s;
+        if (istream.read(reinterpret_cast<byte_t*>(&s), sizeof(T)) != sizeof(T)) {
+            throw StreamError("Failed to read '" + std::string(StructSchema<T>::name) + "'");
+        }
+        decodeStructs(std::span(&s, 1));
+        return s;
+    }
+
+    /**
+     * Writes structs to stream in little-endian byte order.
+     * @throw StreamError if stream write fails.
+     */
+    template<HasStructSchema T>
+    void writeStructs(OutputStream& ostream, std::span<const T> structs)
+    {
+        static_assert(detail::isValidSchema<T>());
+        const auto write = [&](const T* data, std::size_t count) {
+            const auto size = count * sizeof(T);
+            if (ostream.write(reinterpret_cast<const byte_t*>(data), size) != size) {
+                throw StreamError("Failed to write '" + std::string(StructSchema<T>::name) + "'");
+            }
+        };
+
+        if (utils::kNativeLittleEndian) {
+            write(structs.data(), structs.size());
+        }
+        else
+        {
+            std::vector<T> le(structs.begin(), structs.end());
+            for (auto& s : le) {
+                schemaByteSwap(s);
+            }
+            write(le.data(), le.size());
+        }
+    }
+
+    template<HasStructSchema T>
+    void writeStruct(OutputStream& ostream, const T& s)
+    {
+        writeStructs(ostream, std::span<const T>(&s, 1));
+    }
+}
+#endif // LIBIM_SCHEMA_H
@@ -0,0 +1,101 @@
+#include "gobdelta_test.h"
+#include "test_utils.h"
+#include "../filestream.h"
+#include "../gobdelta.h"
+#include "../vfs.h"
+#include "../vfstream.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace libim;
+namespace fs = std::filesystem;
+
+
+static std::vector<std::string> gobFiles(const fs::path& gobPath)
+{
+    std::vector<std::string> files;
+    for (const auto& e : gobReadDirectory(InputFileStream(gobPath))) {
+        files.push_back(e.filePath);
+    }
+    return files;
+}
+
+void libim::unit_test::run_gobdelta_tests()
+{
+    const auto dir = fs::temp_directory_path() / "libim_gobdelta_test";
+    fs::remove_all(dir);
+
+    const auto baseGob  = dir / "cd1.gob";
+    const auto newGob   = dir / "new.gob";
+    const auto deltaGob = dir / "delta.gob";
+    writeGob(baseGob, {
+        { "mat\\a.mat", "mat a" },
+        { "mat\\b.mat", "mat b" },
+        { "3do\\c.3do", "3do c" }
+    });
+
+// Test case 1: Delta of GOB file contains only added and modified files
+    {
+        writeGob(newGob, {
+            { "mat\\a.mat", "mat a" },   // unchanged
+            { "3do\\c.3do", "3do C" },   // modified
+            { "mat\\d.mat", "mat d" }    // added, mat\b.mat removed
+        });
+
+        OutputFileStream ofs(deltaGob, /*truncate=*/true);
+        const auto delta = gobWriteDelta(baseGob, newGob, ofs);
+        ofs.flush();
+
+        assert(delta.numFiles == 2 && delta.dataSize == 10);
+        assert(delta.diff.added    == std::vector<std::string>{ "mat\\d.mat" });
+        assert(delta.diff.modified == std::vector<std::string>{ "3do\\c.3do" });
+        assert(delta.diff.removed  == std::vector<std::string>{ "mat\\b.mat" });
+        assert((gobFiles(deltaGob) == std::vector<std::string>{ "3do\\c.3do", "mat\\d.mat" }));
+    }
+
+// Test case 2: Delta GOB file loaded before base GOB file overrides base files
+    {
+        VirtualFileSystem vfs;
+        vfs.loadGobContainer(deltaGob);
+        vfs.loadGobContainer(baseGob);
+        assert(readAll(vfs.getFile("3do\\c.3do")) == "3do C");
+        assert(readAll(vfs.getFile("mat\\d.mat")) == "mat d");
+        assert(readAll(vfs.getFile("mat\\a.mat")) == "mat a");
+    }
+
+// Test case 3: Delta of folder, path separators are matched with GOB paths
+    {
+        const auto folder = dir / "mod";
+        writeFile(folder / "mat" / "A.MAT", "mat a"); // unchanged
+        writeFile(folder / "mat" / "b.mat", "mat bb"); // modified
+        writeFile(folder / "3do" / "c.3do", "3do c"); // unchanged
+        writeFile(folder / "e.txt", "e");             // added
+
+        OutputFileStream ofs(deltaGob, /*truncate=*/true);
+        const auto delta = gobWriteDelta(baseGob, folder, ofs);
+        ofs.flush();
+
+        assert(delta.numFiles == 2 && delta.dataSize == 7);
+        assert(delta.diff.added    == std::vector<std::string>{ "e.txt" });
+        assert(delta.diff.modified == std::vector<std::string>{ "mat\\b.mat" });
+        assert(delta.diff.removed.empty());
+        assert((gobFiles(deltaGob) == std::vector<std::string>{ "e.txt", "mat\\b.mat" }));
+    }
+
+// Test case 4: Delta of identical content is empty GOB file
+    {
+        OutputFileStream ofs(deltaGob, /*truncate=*/true);
+        const auto delta = gobWriteDelta(baseGob, baseGob, ofs);
+        ofs.flush();
+
+        assert(delta.numFiles == 0 && delta.diff.empty());
+        assert(gobFiles(deltaGob).empty());
+    }
+
+    fs::remove_all(dir);
+}
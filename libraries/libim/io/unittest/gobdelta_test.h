@@ -0,0 +1,8 @@
+#ifndef LIBIM_GOBDELTA_TEST_H
+#define LIBIM_GOBDELTA_TEST_H
+
+namespace libim::unit_test {
+    void run_gobdelta_tests();
+}
+
+#endif // LIBIM_GOBDELTA_TEST_H
@@ -0,0 +1,126 @@
+#include "manifest_test.h"
+#include "test_utils.h"
+#include "../filestream.h"
+#include "../manifest.h"
+
+#include <libim/utils/hash.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace libim;
+namespace fs = std::filesystem;
+
+
+static bool contains(const std::vector<std::string>& names, std::string_view name)
+{
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+void libim::unit_test::run_manifest_tests()
+{
+    const auto dir = fs::temp_directory_path() / "libim_manifest_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto gobPath      = dir / "cd1.gob";
+    const auto manifestPath = dir / "cd1.manifest";
+    writeGob(gobPath, {
+        { "mat\\a.mat", "mat a" },
+        { "mat\\b.mat", "mat b" },
+        { "3do\\c.3do", "" }
+    });
+
+// Test case 1: GOB manifest hashes content of every entry
+    {
+        const auto m = gobContentManifest(gobPath);
+        assert(m.entries().size() == 3);
+
+        [[maybe_unused]] auto e = m.find("MAT/A.MAT");
+        assert(e && e == m.find("MAT\\A.MAT"));
+        assert(e && e->size == 5 && e->hash == utils::hash64(toBytes("mat a").data(), 5));
+        e = m.find("3do\\c.3do");
+        assert(e && e->size == 0 && e->hash == utils::hash64(nullptr, 0));
+        assert(m.diff(m).empty());
+
+        // Hashing with single thread gives the same result
+        const auto m1 = gobContentManifest(gobPath, 1);
+        for ([[maybe_unused]] const auto& e1 : m1.entries()) {
+            assert(m.find(e1.name)->hash == e1.hash);
+        }
+    }
+
+// Test case 2: Manifest save and load round trip
+    {
+        const auto m = gobContentManifest(gobPath);
+        m.save(manifestPath);
+
+        const auto lm = ContentManifest::load(manifestPath);
+        assert(lm.entries().size() == m.entries().size());
+        for (std::size_t i = 0; i < m.entries().size(); i++)
+        {
+            [[maybe_unused]] const auto& e  = m.entries().at(i);
+            [[maybe_unused]] const auto& le = lm.entries().at(i);
+            assert(le.name == e.name && le.size == e.size && le.hash == e.hash);
+        }
+        assert(gobContentManifest(gobPath).diff(lm).empty());
+    }
+
+// Test case 3: Diff reports added, removed and modified content
+    {
+        const auto prev = ContentManifest::load(manifestPath);
+        writeGob(gobPath, {
+            { "mat\\a.mat", "mat A" }, // modified content, same size
+            { "3do\\c.3do", "c" },     // modified size
+            { "mat\\d.mat", "mat d" }  // added
+        });
+
+        const auto d = gobContentManifest(gobPath).diff(prev);
+        assert(d.added.size() == 1 && contains(d.added, "mat\\d.mat"));
+        assert(d.removed.size() == 1 && contains(d.removed, "mat\\b.mat"));
+        assert(d.modified.size() == 2 && contains(d.modified, "mat\\a.mat") && contains(d.modified, "3do\\c.3do"));
+    }
+
+// Test case 4: Out of bounds content and invalid manifest file throw
+    {
+        const auto data = toBytes("0123456789");
+        std::vector<ContentHash> entries = {
+            { "a", 0, 4, 0 },
+            { "b", 8, 4, 0 }
+        };
+
+        [[maybe_unused]] bool thrown = false;
+        try {
+            hashContent(data, entries);
+        }
+        catch (const StreamError&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        entries.at(1).size = 2;
+        hashContent(data, entries);
+        assert(entries.at(1).hash == utils::hash64(data.data() + 8, 2));
+
+        {
+            OutputFileStream ofs(manifestPath, /*truncate=*/true);
+            const auto str = std::string_view("not a manifest\n");
+            ofs.write(toBytes(str).data(), str.size());
+        }
+
+        thrown = false;
+        try {
+            (void)ContentManifest::load(manifestPath);
+        }
+        catch (const StreamError&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,8 @@
+#ifndef LIBIM_MANIFEST_TEST_H
+#define LIBIM_MANIFEST_TEST_H
+
+namespace libim::unit_test {
+    void run_manifest_tests();
+}
+
+#endif // LIBIM_MANIFEST_TEST_H
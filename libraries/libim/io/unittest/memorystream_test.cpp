@@ -0,0 +1,147 @@
+#include "memorystream_test.h"
+#include "../binarystream.h"
+#include "../memorystream.h"
+
+#include <assert.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace libim;
+
+
+static ByteArray makeData(std::size_t size)
+{
+    ByteArray data(size);
+    for (std::size_t i = 0; i < size; i++) {
+        data[i] = static_cast<byte_t>(i * 31 + 7);
+    }
+    return data;
+}
+
+static void test_memorystream(MemoryOutputStream::Storage storage)
+{
+    const auto data = makeData(10000);
+
+// Test case 1: Write data in small writes and release it
+    {
+        MemoryOutputStream ms(storage, /*chunkSize=*/1000);
+        assert(ms.canWrite() && !ms.canRead());
+        for (std::size_t i = 0; i < data.size(); i += 3) {
+            ms.write(&data[i], std::min<std::size_t>(3, data.size() - i));
+        }
+
+        assert(ms.size() == data.size());
+        assert(ms.tell() == data.size());
+        assert(ms.capacity() >= data.size());
+
+        std::size_t size = 0;
+        for (const auto& c : ms.chunks()) {
+            size += c.size();
+        }
+        assert(size == data.size());
+
+        assert(ms.release() == data);
+        assert(ms.size() == 0 && ms.tell() == 0);
+    }
+
+// Test case 2: Overwrite data after seek
+    {
+        MemoryOutputStream ms(storage, /*chunkSize=*/1000);
+        ms.write(data);
+        ms.seek(998);
+        ms.write<uint32_t>(0xAABBCCDD);
+        assert(ms.size() == data.size());
+        assert(ms.tell() == 1002);
+
+        auto expected = data;
+        const uint32_t v = 0xAABBCCDD;
+        std::memcpy(&expected[998], &v, sizeof(v));
+
+        ByteArray out;
+        OutputBinaryStream obs(out);
+        ms.writeTo(obs);
+        assert(out == expected);
+        assert(ms.release() == expected);
+    }
+
+// Test case 3: Write via reserveSpan and commit
+    {
+        MemoryOutputStream ms(storage, /*chunkSize=*/1000);
+        ms.write<uint16_t>(0x0102);
+
+        auto span = ms.reserveSpan(1500);
+        assert(span.size() == 1500);
+        std::memcpy(span.data(), data.data(), 1200);
+        ms.commit(1200);
+        assert(ms.size() == 1202);
+
+        ms.seekBegin();
+        span = ms.reserveSpan(2);
+        span[0] = 0x03;
+        span[1] = 0x04;
+        ms.commit(2);
+        assert(ms.size() == 1202 && ms.tell() == 2);
+
+        auto out = ms.release();
+        assert(out.size() == 1202);
+        assert(out[0] == 0x03 && out[1] == 0x04);
+        assert(std::equal(out.begin() + 2, out.end(), data.begin()));
+    }
+
+// Test case 4: Invalid seek and commit
+    {
+        MemoryOutputStream ms(storage);
+        ms.write<uint32_t>(1);
+
+        [[maybe_unused]] bool thrown = false;
+        try {
+            ms.seek(5);
+        }
+        catch (const StreamError&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        thrown = false;
+        try
+        {
+            auto span = ms.reserveSpan(4);
+            ms.commit(span.size() + 1);
+        }
+        catch (const StreamError&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void libim::unit_test::run_memorystream_tests()
+{
+    test_memorystream(MemoryOutputStream::Storage::Contiguous);
+    test_memorystream(MemoryOutputStream::Storage::Chunked);
+
+// Test case 5: Append to existing buffer and release without copying
+    {
+        auto data = makeData(64);
+        MemoryOutputStream ms(std::move(data));
+        assert(ms.size() == 64 && ms.tell() == 64);
+        ms.write<uint8_t>(0xFF);
+
+        [[maybe_unused]] const auto* pData = ms.chunks().front().data();
+        auto out = ms.release();
+        assert(out.size() == 65);
+        assert(out.data() == pData);
+        assert(out.back() == 0xFF);
+    }
+
+// Test case 6: Chunked storage doesn't move written data
+    {
+        MemoryOutputStream ms(MemoryOutputStream::Storage::Chunked, /*chunkSize=*/256);
+        ms.write(makeData(100));
+        [[maybe_unused]] const auto* pFirst = ms.chunks().front().data();
+        ms.write(makeData(10000));
+        assert(ms.chunks().front().data() == pFirst);
+        assert(ms.chunks().size() > 1);
+    }
+}
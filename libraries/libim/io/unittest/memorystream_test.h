@@ -0,0 +1,8 @@
+#ifndef LIBIM_MEMORYSTREAM_TEST_H
+#define LIBIM_MEMORYSTREAM_TEST_H
+
+namespace libim::unit_test {
+    void run_memorystream_tests();
+}
+
+#endif // LIBIM_MEMORYSTREAM_TEST_H
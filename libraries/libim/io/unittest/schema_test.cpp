@@ -0,0 +1,141 @@
+#include "schema_test.h"
+#include "../binarystream.h"
+#include "../memorystream.h"
+#include "../schema.h"
+
+#include <assert.h>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace libim;
+
+namespace {
+    PACKED(struct TestHeader
+    {
+        std::array<char, 4> magic;
+        uint16_t version;
+        int32_t count;
+    });
+
+    PACKED(struct TestEntry
+    {
+        TestHeader header;
+        float value;
+    });
+}
+
+template<>
+struct libim::StructSchema<TestHeader>
+{
+    static constexpr std::string_view name = "TestHeader";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&TestHeader::magic>("magic", std::array<char, 4>{ 'T', 'E', 'S', 'T' }),
+        schemaField<&TestHeader::version>("version", uint16_t(1)),
+        schemaField<&TestHeader::count>("count", 0, 100)
+    );
+};
+
+template<>
+struct libim::StructSchema<TestEntry>
+{
+    static constexpr std::string_view name = "TestEntry";
+    static constexpr auto fields = std::make_tuple(
+        schemaField<&TestEntry::header>("header"),
+        schemaField<&TestEntry::value>("value")
+    );
+};
+
+static TestEntry makeEntry(int32_t count)
+{
+    return { { { 'T', 'E', 'S', 'T' }, 1, count }, static_cast<float>(count) * 0.5f };
+}
+
+static bool isEqual(const TestEntry& a, const TestEntry& b)
+{
+    return a.header.magic == b.header.magic && a.header.version == b.header.version &&
+        a.header.count == b.header.count && a.value == b.value;
+}
+
+template<typename Func>
+static bool throwsStreamError(Func&& f)
+{
+    try {
+        f();
+    }
+    catch (const StreamError&) {
+        return true;
+    }
+    return false;
+}
+
+void libim::unit_test::run_schema_tests()
+{
+// Test case 1: Write and read struct list
+    {
+        std::vector<TestEntry> entries;
+        for (int32_t i = 0; i <= 100; i++) {
+            entries.push_back(makeEntry(i));
+        }
+
+        MemoryOutputStream ms;
+        writeStruct(ms, makeEntry(7));
+        writeStructs(ms, std::span<const TestEntry>(entries));
+        assert(ms.size() == sizeof(TestEntry) * (entries.size() + 1));
+
+        const auto data = ms.release();
+        InputBinaryStream<ByteView> istream(ByteView(data.data(), data.size()));
+        assert(isEqual(readStruct<TestEntry>(istream), makeEntry(7)));
+
+        const auto read = readStructs<TestEntry>(istream, entries.size());
+        assert(read.size() == entries.size());
+        for (std::size_t i = 0; i < read.size(); i++) {
+            assert(isEqual(read[i], entries[i]));
+        }
+        assert(istream.atEnd());
+
+        const auto view = readStructs<TestEntry>(ByteView(data.data(), data.size()), 2);
+        assert(isEqual(view[0], makeEntry(7)) && isEqual(view[1], entries[0]));
+    }
+
+// Test case 2: Invalid field values and missing data throw StreamError
+    {
+        auto badMagic = makeEntry(1);
+        badMagic.header.magic[0] = 'X';
+        assert(throwsStreamError([&]{ schemaValidate(badMagic); }));
+
+        [[maybe_unused]] auto badVersion = makeEntry(1);
+        badVersion.header.version = 2;
+        assert(throwsStreamError([&]{ schemaValidate(badVersion); }));
+
+        assert(throwsStreamError([&]{ schemaValidate(makeEntry(101)); }));
+        assert(throwsStreamError([&]{ schemaValidate(makeEntry(-1)); }));
+        schemaValidate(makeEntry(0));
+        schemaValidate(makeEntry(100));
+
+        MemoryOutputStream ms;
+        writeStruct(ms, makeEntry(101));
+        writeStruct(ms, makeEntry(1));
+        const auto data = ms.release();
+        assert(throwsStreamError([&]{ (void)readStructs<TestEntry>(ByteView(data.data(), data.size()), 1); }));
+        assert(throwsStreamError([&]{ (void)readStructs<TestEntry>(ByteView(data.data(), data.size()), 3); }));
+
+        InputBinaryStream<ByteView> istream(ByteView(data.data(), data.size() - 1));
+        istream.seek(sizeof(TestEntry));
+        assert(throwsStreamError([&]{ (void)readStruct<TestEntry>(istream); }));
+    }
+
+// Test case 3: Byte swap reverses every field and is its own inverse
+    {
+        auto e = makeEntry(0x01020304);
+        schemaByteSwap(e);
+        assert(e.header.magic == (std::array<char, 4>{ 'T', 'E', 'S', 'T' }));
+        assert(e.header.version == 0x0100);
+        assert(e.header.count == 0x04030201);
+        assert(e.value != makeEntry(0x01020304).value);
+
+        schemaByteSwap(e);
+        assert(isEqual(e, makeEntry(0x01020304)));
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef LIBIM_SCHEMA_TEST_H
+#define LIBIM_SCHEMA_TEST_H
+
+namespace libim::unit_test {
+    void run_schema_tests();
+}
+
+#endif // LIBIM_SCHEMA_TEST_H
@@ -0,0 +1,56 @@
+#ifndef LIBIM_IO_TEST_UTILS_H
+#define LIBIM_IO_TEST_UTILS_H
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../filestream.h"
+#include "../memorystream.h"
+#include "../vfstream.h"
+#include "../../common.h"
+
+/**
+ * Header file provides helper functions for writing and reading
+ * test files, shared by io unit tests.
+ */
+
+namespace libim::unit_test {
+
+    inline ByteView toBytes(std::string_view str)
+    {
+        return ByteView(reinterpret_cast<const byte_t*>(str.data()), str.size());
+    }
+
+    /** Writes data to file, creates parent folders if they don't exist. */
+    inline void writeFile(const std::filesystem::path& path, std::string_view data)
+    {
+        std::filesystem::create_directories(path.parent_path());
+        OutputFileStream ofs(path, /*truncate=*/true);
+        ofs.write(toBytes(data).data(), data.size());
+    }
+
+    /** Writes GOB file of files given as pairs of file path and file data. */
+    inline void writeGob(const std::filesystem::path& path, const std::vector<std::pair<std::string, std::string>>& files)
+    {
+        MemoryOutputStream ms;
+        GobWriter gob(ms);
+        for (const auto& [filePath, data] : files) {
+            gob.add(filePath, toBytes(data));
+        }
+        gob.finish();
+
+        const auto data = ms.release();
+        writeFile(path, std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+    }
+
+    /** Reads whole stream to string. */
+    inline std::string readAll(const SharedRef<InputStream>& istream)
+    {
+        std::string str(istream->size(), '\0');
+        istream->read(reinterpret_cast<byte_t*>(str.data()), str.size());
+        return str;
+    }
+}
+#endif // LIBIM_IO_TEST_UTILS_H
@@ -0,0 +1,143 @@
+#include "vfsindex_test.h"
+#include "test_utils.h"
+#include "../vfs.h"
+#include "../vfsindex.h"
+
+#include <assert.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace libim;
+namespace fs = std::filesystem;
+
+void libim::unit_test::run_vfsindex_tests()
+{
+    const auto dir = fs::temp_directory_path() / "libim_vfsindex_test";
+    fs::remove_all(dir);
+
+    const auto sysDir    = dir / "assets";
+    const auto gobPath   = dir / "cd1.gob";
+    const auto indexPath = dir / "vfs.idx";
+    writeFile(sysDir / "mat" / "Sys.mat", "sys");
+    writeFile(sysDir / "shared.txt", "sys shared");
+    writeGob(gobPath, {
+        { "3do\\Gob.3do", "gob 3do" },
+        { "mat\\gob.mat", "gob mat" },
+        { "SHARED.txt", "gob shared" }
+    });
+
+    const std::vector<fs::path> sysDirs = { sysDir };
+    const std::vector<fs::path> gobs    = { gobPath };
+
+// Test case 1: Build index and find files ASCII case-insensitive with any path separator
+    {
+        const auto index = VfsIndex::build(sysDirs, gobs);
+        assert(index.size() == 4);
+        assert(index.mounts().size() == 2);
+        assert(index.mounts().at(0).type == VfsIndex::MountType::SysFolder);
+        assert(index.mounts().at(1).type == VfsIndex::MountType::Gob);
+
+        auto f = index.find("MAT/sys.MAT");
+        assert(f && f->mountIdx == 0 && f->path == "mat/Sys.mat" && f->size == 3);
+
+        f = index.find("3do/gob.3do");
+        assert(f && f->mountIdx == 1 && f->path == "3do\\Gob.3do" && f->size == 7);
+
+        // File in system folder has priority
+        f = index.find("shared.txt");
+        assert(f && f->mountIdx == 0 && f->size == 10);
+
+        assert(!index.find("mat/missing.mat"));
+        assert(!index.find("mat"));
+        assert(!index.find(""));
+    }
+
+// Test case 2: Save index and load it
+    {
+        assert(!VfsIndex::load(indexPath, sysDirs, gobs));
+
+        const auto index = VfsIndex::build(sysDirs, gobs);
+        index.save(indexPath);
+        assert(fs::exists(indexPath));
+
+        const auto loaded = VfsIndex::load(indexPath, sysDirs, gobs);
+        assert(loaded);
+        assert(loaded->size() == index.size());
+        assert(std::equal(loaded->data().begin(), loaded->data().end(), index.data().begin(), index.data().end()));
+
+        [[maybe_unused]] const auto f = loaded->find("mat\\GOB.mat");
+        assert(f && f->mountIdx == 1 && f->size == 7);
+    }
+
+// Test case 3: Index is stale when mounts change
+    {
+        assert(!VfsIndex::load(indexPath, {}, gobs));
+        assert(!VfsIndex::load(indexPath, sysDirs, {}));
+        assert(!VfsIndex::load(indexPath, gobs, sysDirs));
+
+        writeFile(sysDir / "mat" / "new.mat", "new");
+        assert(!VfsIndex::load(indexPath, sysDirs, gobs));
+        VfsIndex::build(sysDirs, gobs).save(indexPath);
+        assert(VfsIndex::load(indexPath, sysDirs, gobs));
+
+        writeGob(gobPath, { { "mat\\gob.mat", "changed gob mat" } });
+        assert(!VfsIndex::load(indexPath, sysDirs, gobs));
+        VfsIndex::build(sysDirs, gobs).save(indexPath);
+        assert(VfsIndex::load(indexPath, sysDirs, gobs));
+    }
+
+// Test case 4: Invalid index file is not loaded
+    {
+        const auto badPath = dir / "bad.idx";
+        writeFile(badPath, "VFSI not an index");
+        assert(!VfsIndex::load(badPath, sysDirs, gobs));
+    }
+
+// Test case 5: Mount index in VFS
+    {
+        VirtualFileSystem vfs;
+        vfs.mountIndex(indexPath, sysDirs, gobs);
+        assert(readAll(vfs.getFile("mat/sys.mat")) == "sys");
+        assert(readAll(vfs.getFile("mat/new.mat")) == "new");
+        assert(readAll(vfs.getFile("MAT/GOB.MAT")) == "changed gob mat");
+        assert(vfs.getFile("mat/gob.mat")->name() == "gob.mat");
+        assert(!vfs.hasFile("3do/gob.3do"));
+
+        [[maybe_unused]] bool thrown = false;
+        try {
+            vfs.mountIndex(indexPath, sysDirs, gobs);
+        }
+        catch (const VfsError&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+// Test case 6: Index is built and saved when missing
+    {
+        fs::remove(indexPath);
+        VirtualFileSystem vfs;
+        vfs.mountIndex(indexPath, sysDirs, gobs);
+        assert(fs::exists(indexPath));
+        assert(readAll(vfs.getFile("shared.txt")) == "sys shared");
+    }
+
+// Test case 7: Mounted index doesn't return removed system file and changed GOB file
+    {
+        VirtualFileSystem vfs;
+        vfs.mountIndex(indexPath, sysDirs, gobs);
+        assert(vfs.isIndexUpToDate());
+        assert(vfs.hasFile("mat/new.mat"));
+
+        fs::remove(sysDir / "mat" / "new.mat");
+        assert(!vfs.hasFile("mat/new.mat"));
+        assert(!vfs.isIndexUpToDate());
+
+        writeGob(gobPath, { { "mat\\gob.mat", "gob mat" }, { "3do\\gob.3do", "3do" } });
+        assert(!vfs.hasFile("mat/gob.mat"));
+        assert(readAll(vfs.getFile("mat/sys.mat")) == "sys");
+    }
+
+    fs::remove_all(dir);
+}
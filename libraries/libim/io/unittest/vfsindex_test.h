@@ -0,0 +1,8 @@
+#ifndef LIBIM_VFSINDEX_TEST_H
+#define LIBIM_VFSINDEX_TEST_H
+
+namespace libim::unit_test {
+    void run_vfsindex_tests();
+}
+
+#endif // LIBIM_VFSINDEX_TEST_H
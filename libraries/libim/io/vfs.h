@@ -2,6 +2,7 @@
 #define LIBIM_VIRTUAL_FILE_SYSTEM_H
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <utility>
@@ -52,10 +53,30 @@ namespace libim {
         */
         void addSysFolder(const std::filesystem::path& folder);
 
+        /**
+         * Mounts system folders and GOB files through persisted VFS index.
+         * When indexFile is up to date with the folders and GOB files, the index is memory mapped
+         * and no GOB directory is read, otherwise the index is rebuilt and saved to indexFile.
+         * Virtual files of indexed GOB files are created when file is found.
+         * Failure to save the index file is logged and the built index is used.
+         *
+         * @note Indexed files are searched before system folders and vf containers
+         *       added by addSysFolder, loadGobContainer and addContainer.
+         *
+         * @param indexFile  - system file path to the index file.
+         * @param sysFolders - system folders to mount, searched before GOB files.
+         * @param gobFiles   - system file paths to the GOB files to mount, searched in order.
+         * @throw VfsError if index is already mounted, any system folder doesn't exist
+         *                 or any GOB file is invalid or corrupted.
+         */
+        void mountIndex(const std::filesystem::path& indexFile,
+                        const std::vector<std::filesystem::path>& sysFolders,
+                        const std::vector<std::filesystem::path>& gobFiles);
+
         /**
          * Tres find file in the file system.
-         * @note First the system folders are searched for the file, if no file is found
-         *       then virtual file containers are searched.
+         * @note First the mounted index is searched, then the system folders are searched for the file,
+         *       if no file is found then virtual file containers are searched.
          *       Returned file stream is reset
          * @param filePath - relative file path to search for.
          * @return file SharedRef<InputStream> if file is found in the file system, otherwise std::nullopt
@@ -87,7 +108,17 @@ namespace libim {
             return findFile(filePath).has_value();
         }
 
+        /**
+         * Checks if mounted index is up to date.
+         * @see VfsIndex::isUpToDate
+         * @return false if any of the mounts of the mounted index has changed since the index was built,
+         *         true if index is up to date or no index is mounted.
+         */
+        [[nodiscard]] bool isIndexUpToDate() const;
+
     private:
+        class IndexMount;
+        std::shared_ptr<const IndexMount> index_;
         std::vector<std::filesystem::path> sysDirs_;
         std::vector<std::pair<std::filesystem::path, VfContainer>> vfiles_;
     };
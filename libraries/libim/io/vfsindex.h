@@ -0,0 +1,146 @@
+#ifndef LIBIM_VFSINDEX_H
+#define LIBIM_VFSINDEX_H
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "mappedfile.h"
+#include "../common.h"
+
+namespace libim {
+
+    /**
+     * Persisted index of files in system folders and GOB files.
+     *
+     * The index is a compact open addressing hash table of file paths keyed by case-folded path,
+     * which is stored in a single file and memory mapped on load.
+     * Loading index doesn't read any GOB directory or scan system folders and allocates
+     * no memory per indexed file, files are looked up directly in the mapped hash table.
+     *
+     * Index stores the size and modification time of each indexed GOB file and
+     * the modification time of each indexed system folder and all its subfolders.
+     * The index is stale when any of them changes, or when it was built on a platform with different byte order.
+     */
+    class VfsIndex final
+    {
+    public:
+        enum class MountType : uint32_t
+        {
+            SysFolder = 0,
+            Gob       = 1
+        };
+
+        /** Indexed system folder or GOB file. */
+        struct Mount
+        {
+            MountType type;
+            std::filesystem::path path;
+        };
+
+        /** Indexed file. */
+        struct File
+        {
+            std::size_t mountIdx;  // index of mount in mounts()
+            std::string_view path; // file path in system folder or GOB file, the view is valid for the lifetime of index
+            std::size_t offset;    // offset of file data in GOB file, 0 for file in system folder
+            std::size_t size;
+        };
+
+        /**
+         * Builds index by scanning system folders and reading directories of GOB files.
+         * Mounts are indexed in order, first system folders and then GOB files.
+         * When the same file path is found in multiple mounts, only the file in the first mount is indexed.
+         * @param sysFolders - system folders to index.
+         * @param gobFiles   - GOB files to index.
+         * @throw VfsError if any system folder doesn't exist or there are too many mounts,
+         *        StreamError if any GOB file is invalid or can't be read.
+         */
+        [[nodiscard]] static VfsIndex build(const std::vector<std::filesystem::path>& sysFolders,
+                                            const std::vector<std::filesystem::path>& gobFiles);
+
+        /**
+         * Memory maps index file.
+         * @param indexFile  - path to index file.
+         * @param sysFolders - system folders index should have indexed.
+         * @param gobFiles   - GOB files index should have indexed.
+         * @return VfsIndex or std::nullopt if index file doesn't exist, is invalid or is stale,
+         *         i.e. it doesn't index the same mounts or any of the mounts has changed since the index was built.
+         */
+        [[nodiscard]] static std::optional<VfsIndex> load(const std::filesystem::path& indexFile,
+                                                          const std::vector<std::filesystem::path>& sysFolders,
+                                                          const std::vector<std::filesystem::path>& gobFiles);
+
+        /**
+         * Writes index to file.
+         * The index is written to temporary file first, which then replaces indexFile.
+         * @param indexFile - path to index file.
+         * @throw FileStreamError
+         */
+        void save(const std::filesystem::path& indexFile) const;
+
+        /**
+         * Finds file in the index.
+         * Lookup is ASCII case-insensitive and path separators '\' and '/' are equal.
+         * @param filePath - file path to look for.
+         * @return File or std::nullopt if file is not indexed.
+         * @throw VfsError if index data is corrupted.
+         */
+        [[nodiscard]] std::optional<File> find(std::string_view filePath) const;
+
+        /**
+         * Checks if any of the indexed mounts has changed since the index was built.
+         * @return true if the modification time of every mount and indexed system subfolder and
+         *         the size of every GOB file are the same as when the index was built.
+         */
+        [[nodiscard]] bool isUpToDate() const;
+
+        /**
+         * Checks if mount has changed since the index was built.
+         * Only the modification time of the mount and the size of GOB file are compared,
+         * indexed subfolders of system folder are not checked.
+         * @param mountIdx - index of mount in mounts().
+         * @return true if mount is up to date.
+         * @throw std::out_of_range if mountIdx is invalid.
+         */
+        [[nodiscard]] bool isMountUpToDate(std::size_t mountIdx) const;
+
+        const std::vector<Mount>& mounts() const
+        {
+            return mounts_;
+        }
+
+        /** Returns number of indexed files. */
+        std::size_t size() const
+        {
+            return numFiles_;
+        }
+
+        /** Returns serialized index. */
+        ByteView data() const
+        {
+            return data_;
+        }
+
+    private:
+        explicit VfsIndex(MappedFile file);
+        explicit VfsIndex(ByteArray data);
+        void init();
+        bool isUpToDate(const std::vector<std::filesystem::path>& sysFolders,
+                        const std::vector<std::filesystem::path>& gobFiles) const;
+        std::string_view string(uint32_t offset, uint32_t size) const;
+
+    private:
+        MappedFile file_;
+        ByteArray buffer_;
+        ByteView data_;
+        std::vector<Mount> mounts_;
+        std::size_t numFiles_ = 0;
+        ByteView mountData_;
+        ByteView dirData_;
+        ByteView slotData_;
+        ByteView strings_;
+    };
+}
+#endif // LIBIM_VFSINDEX_H
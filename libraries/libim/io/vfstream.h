@@ -1,6 +1,13 @@
+#ifndef LIBIM_VFSTREAM_H
+#define LIBIM_VFSTREAM_H
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <unordered_set>
+#include <vector>
 
 #include "stream.h"
 #include <libim/types/indexmap.h>
@@ -15,10 +22,14 @@ namespace libim {
          * @param istream - input stream ref
          * @param offset  - offset in the istream to the beginning of file
          * @param size    - the size of file
+         * @param istreamMutex - mutex guarding istream, virtual files sharing the same istream
+         *                       should share the mutex so they can be read from multiple threads.
+         *                       If null, new mutex is created.
          * @throw VirtualFileError if istream is null or params offset and size are invalid
          */
-        VirtualFile(SharedRef<InputStream> istream, std::size_t offset, std::size_t size) :
+        VirtualFile(SharedRef<InputStream> istream, std::size_t offset, std::size_t size, std::shared_ptr<std::mutex> istreamMutex = nullptr) :
             istream_(std::move(istream)),
+            istreamMutex_(istreamMutex ? std::move(istreamMutex) : std::make_shared<std::mutex>()),
             offset_(offset),
             size_(size)
         {
@@ -28,13 +39,23 @@ namespace libim {
             seekBegin(); // set the offset in the istream
         }
 
+        /**
+         * Returns new virtual file of the same file data with own read position.
+         * Each thread reading the same file should read from own view.
+         */
+        SharedRef<VirtualFile> view() const
+        {
+            auto vf = makeSharedRef<VirtualFile>(istream_, offset_, size_, istreamMutex_);
+            vf->setName(name());
+            return vf;
+        }
+
         virtual void seek(std::size_t offset) const override
         {
             if (offset >= size_) {
                 throw VirtualFileError("Seek beyond EOF");
             }
-            istream_->seek(offset_ + offset);
-            pos_ = offset;
+            pos_ = offset; // istream is positioned on read
         }
 
         virtual std::size_t size() const override
@@ -68,7 +89,8 @@ namespace libim {
             if((tell() + length) > size_) {
                  throw VirtualFileError("Read beyond EOF");
             }
-            seek(pos_);
+            std::scoped_lock lock(*istreamMutex_);
+            istream_->seek(offset_ + pos_);
             auto nRead = istream_->read(data, length);
             pos_ += nRead;
             return nRead;
@@ -81,6 +103,7 @@ namespace libim {
 
     private:
         SharedRef<InputStream> istream_;
+        std::shared_ptr<std::mutex> istreamMutex_;
         std::size_t offset_;
         std::size_t size_;
         mutable std::size_t pos_ = 0;
@@ -187,6 +210,21 @@ namespace libim {
     };
 
 
+    /* GOB directory entry */
+    struct GobEntry
+    {
+        std::string filePath;
+        uint32_t offset; // offset of file data from the beginning of GOB file
+        uint32_t size;
+    };
+
+    /**
+     * Reads directory of GOB file without creating virtual files.
+     * @param is - GOB file input stream
+     * @throw StreamError
+     */
+    std::vector<GobEntry> gobReadDirectory(const InputStream& is);
+
     /**
      * Loads VfContainer from GOB file
      * @param is - pointer to GOB file input stream
@@ -200,4 +238,68 @@ namespace libim {
      * @throw StreamError
      */
     VfContainer gobLoad(const std::filesystem::path& filePath);
+
+
+    /**
+     * Writes GOB file to output stream.
+     * File data is written to the stream as files are added,
+     * so big GOB files can be written without keeping file data in memory.
+     * GOB directory and header are written when finish is called.
+     */
+    class GobWriter final
+    {
+    public:
+        /**
+         * Constructs new GobWriter and reserves the space for GOB header in the output stream.
+         * GOB file begins at the current offset of ostream.
+         * @param ostream - output stream to write GOB file to. Stream must outlive this object.
+         * @throw StreamError
+         */
+        explicit GobWriter(OutputStream& ostream);
+        GobWriter(const GobWriter&) = delete;
+        GobWriter& operator = (const GobWriter&) = delete;
+
+        /**
+         * Adds file to GOB.
+         * @param filePath - the file path in GOB, e.g.: mat/dflt.mat
+         * @param data     - file data
+         * @throw StreamError - if filePath is too long or file with the same path was already added,
+         *                      if finish was already called or GOB file would grow beyond 4 GB.
+         */
+        void add(const std::string& filePath, ByteView data);
+
+        /**
+         * Adds file to GOB by copying whole input stream in chunks.
+         * @param filePath - the file path in GOB, e.g.: mat/dflt.mat
+         * @param istream  - input stream to copy file data from
+         * @throw StreamError - see add(filePath, data)
+         */
+        void add(const std::string& filePath, const InputStream& istream);
+
+        /**
+         * Writes GOB directory and header to the output stream.
+         * Output stream offset is set to the end of GOB file.
+         * @throw StreamError
+         */
+        void finish();
+
+        /** Returns number of added files. */
+        std::size_t size() const
+        {
+            return entries_.size();
+        }
+
+    private:
+        void beginFile(const std::string& filePath, std::size_t size);
+        void seekEnd();
+
+    private:
+        OutputStream& os_;
+        std::size_t begin_;
+        std::size_t end_;
+        bool finished_ = false;
+        std::vector<GobEntry> entries_;
+        std::unordered_set<std::string> paths_; // lower case file paths
+    };
 }
+#endif // LIBIM_VFSTREAM_H
@@ -0,0 +1,155 @@
+#include "../log.h"
+#include "../log_sink.h"
+
+#include <iostream>
+#include <utility>
+
+using namespace libim;
+
+namespace {
+    struct SinkRegistry final
+    {
+        std::mutex mutex;
+        std::shared_ptr<LogSink> sink = std::make_shared<ConsoleLogSink>();
+    };
+
+    SinkRegistry& sinkRegistry()
+    {
+        static SinkRegistry r;
+        return r;
+    }
+}
+
+std::ostringstream& libim::detail::logLineStream()
+{
+    thread_local std::ostringstream ss = []{
+        std::ostringstream s;
+        s << std::boolalpha;
+        return s;
+    }();
+
+    // Reuse string buffer of the previous line
+    auto buffer = std::move(ss).str();
+    buffer.clear();
+    ss.str(std::move(buffer));
+    ss.clear();
+    return ss;
+}
+
+void ConsoleLogSink::write(LogLevel level, std::string_view line)
+{
+    std::scoped_lock lock(mutex_);
+    if (level <= LogLevel::Warning)
+    {
+        std::cout.flush(); // keep order of output
+        std::cerr << line << '\n';
+    }
+    else {
+        std::cout << line << '\n';
+    }
+}
+
+void ConsoleLogSink::flush()
+{
+    std::scoped_lock lock(mutex_);
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+AsyncLogSink::AsyncLogSink(std::shared_ptr<LogSink> sink, std::size_t maxQueueSize) :
+    sink_(std::move(sink)),
+    maxQueueSize_(maxQueueSize > 0 ? maxQueueSize : 1)
+{
+    if (!sink_) {
+        throw LoggingError("AsyncLogSink: target sink is null");
+    }
+    thread_ = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        stop_ = true;
+    }
+    cvWrite_.notify_one();
+    thread_.join();
+    sink_->flush();
+}
+
+void AsyncLogSink::write(LogLevel level, std::string_view line)
+{
+    {
+        std::unique_lock lock(mutex_);
+        cvDone_.wait(lock, [&]{ return queue_.size() < maxQueueSize_; });
+        queue_.push_back({ level, std::string(line) });
+    }
+    cvWrite_.notify_one();
+}
+
+void AsyncLogSink::flush()
+{
+    {
+        std::unique_lock lock(mutex_);
+        cvDone_.wait(lock, [&]{ return queue_.empty() && numWriting_ == 0; });
+    }
+    sink_->flush();
+}
+
+void AsyncLogSink::run()
+{
+    std::deque<Line> lines;
+    std::unique_lock lock(mutex_);
+    while (true)
+    {
+        cvWrite_.wait(lock, [&]{ return stop_ || !queue_.empty(); });
+        if (queue_.empty() && stop_) {
+            break;
+        }
+
+        lines.swap(queue_);
+        numWriting_ = lines.size();
+        lock.unlock();
+        cvDone_.notify_all(); // queue has space again
+
+        for (const auto& l : lines)
+        {
+            try {
+                sink_->write(l.level, l.text);
+            }
+            catch (...) {} // nowhere to report error
+        }
+        lines.clear();
+
+        lock.lock();
+        numWriting_ = 0;
+        cvDone_.notify_all();
+    }
+}
+
+std::shared_ptr<LogSink> libim::logSink()
+{
+    auto& r = sinkRegistry();
+    std::scoped_lock lock(r.mutex);
+    return r.sink;
+}
+
+void libim::setLogSink(std::shared_ptr<LogSink> sink)
+{
+    if (!sink) {
+        sink = std::make_shared<ConsoleLogSink>();
+    }
+
+    std::shared_ptr<LogSink> old;
+    {
+        auto& r = sinkRegistry();
+        std::scoped_lock lock(r.mutex);
+        old = std::exchange(r.sink, std::move(sink));
+    }
+    old->flush();
+}
+
+void libim::flushLog()
+{
+    logSink()->flush();
+}
@@ -1,52 +1,89 @@
 #ifndef LIBIM_LOG_H
 #define LIBIM_LOG_H
 #include "log_level.h"
+#include "log_sink.h"
 #include <libim/utils/utils.h>
 
-#include <algorithm>
-#include <iostream>
-#include <string>
+#include <atomic>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+
+/**
+ * Max log level compiled in the program.
+ * Log calls with higher level are removed at compile time,
+ * their arguments are never evaluated.
+ * Can be set with LIBIM_LOG_LEVEL cmake option.
+ */
+#ifndef LIBIM_LOG_LEVEL
+#  define LIBIM_LOG_LEVEL Verbose
+#endif
 
 namespace libim {
     struct LoggingError : public std::runtime_error {
         using std::runtime_error::runtime_error;
     };
 
-    inline LogLevel gLogLevel = LogLevel::Debug;
+    constexpr inline LogLevel kMaxLogLevel = LogLevel::LIBIM_LOG_LEVEL;
 
-    template<typename ...Args>
-    static void writeLog(const char* file, int line, LogLevel level, std::string_view msg, Args&&... args)
+    /** Runtime log level. Log calls with higher level than gLogLevel are not written. */
+    inline std::atomic<LogLevel> gLogLevel { LogLevel::Debug };
+
+    /** Returns true if log level is compiled in the program. */
+    [[nodiscard]] constexpr bool isLogLevelCompiled(LogLevel level)
     {
-        if(gLogLevel < level) {
-            return;
-        }
-        std::stringstream ss;
-        std::stringstream prefix;
+        return level <= kMaxLogLevel;
+    }
+
+    /** Returns true if log calls with level are written. */
+    [[nodiscard]] inline bool isLogEnabled(LogLevel level) noexcept
+    {
+        return isLogLevelCompiled(level) && level <= gLogLevel.load(std::memory_order_relaxed);
+    }
+
+    namespace detail {
+        /** Returns cleared string stream of the calling thread for formatting log line. */
+        std::ostringstream& logLineStream();
+    }
 
-        ss << std::boolalpha << "[" << level.toString() << "]" << " ";
+    /**
+     * Formats log line and writes it to log sink.
+     * @note Function doesn't check the log level, use LOG_* macros instead
+     *       so the arguments are evaluated only when log level is enabled.
+     */
+    template<typename ...Args>
+    inline void writeLog([[maybe_unused]] const char* file, [[maybe_unused]] int line, LogLevel level, std::string_view msg, Args&&... args)
+    {
+        auto& ss = detail::logLineStream();
+        ss << "[" << level.toString() << "]" << " ";
         utils::ssprintf(ss, msg, args...);
-        if(level <= LogLevel::Warning)
-        {
 #ifdef DEBUG
+        if(level <= LogLevel::Warning) {
             ss << "\nfile: '" << file << "':" << line << " ";
-#endif
-            std::cerr << ss.str() << std::endl;
-        } else {
-            std::cout << ss.str() << std::endl;
         }
+#endif
+        logSink()->write(level, ss.view());
     }
 }
 
 #ifdef DEBUG
-    #define LOG_WITH_LEVEL(l, ...) \
-        libim::writeLog(__FILE__, __LINE__, l, __VA_ARGS__)
+    #define LIBIM_LOG_FILE __FILE__
+    #define LIBIM_LOG_LINE __LINE__
 #else
-    #define LOG_WITH_LEVEL(l, ...) \
-        libim::writeLog("", 0, l, __VA_ARGS__)
+    #define LIBIM_LOG_FILE ""
+    #define LIBIM_LOG_LINE 0
 #endif
 
+/* Arguments are evaluated only when the log level is enabled */
+#define LOG_WITH_LEVEL(l, ...)                                                      \
+    do {                                                                            \
+        if constexpr (libim::isLogLevelCompiled(l)) {                               \
+            if (libim::isLogEnabled(l)) {                                           \
+                libim::writeLog(LIBIM_LOG_FILE, LIBIM_LOG_LINE, l, __VA_ARGS__);    \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
 #define LOG_VERBOSE(...) \
     LOG_WITH_LEVEL(libim::LogLevel::Verbose, __VA_ARGS__)
 
@@ -38,7 +38,7 @@ namespace libim {
         }
 
         friend constexpr bool operator >= (LogLevel ll1, LogLevel ll2) {
-            return ll1.m_level == ll2.m_level;
+            return ll1.m_level >= ll2.m_level;
         }
 
         constexpr std::string_view toString() const
@@ -0,0 +1,112 @@
+#ifndef LIBIM_LOG_SINK_H
+#define LIBIM_LOG_SINK_H
+#include "log_level.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace libim {
+
+    /**
+     * Log output interface.
+     * Sink implementations must be thread-safe, as log lines can be written from multiple threads.
+     */
+    class LogSink
+    {
+    public:
+        virtual ~LogSink() = default;
+
+        /**
+         * Writes log line.
+         * @param level - log level of the line.
+         * @param line  - formatted log line without line terminator.
+         */
+        virtual void write(LogLevel level, std::string_view line) = 0;
+
+        /** Flushes buffered log lines. */
+        virtual void flush() = 0;
+    };
+
+
+    /**
+     * Writes log lines to std::cout, warnings and errors to std::cerr.
+     * Lines written to std::cout are not flushed per line,
+     * std::cout is flushed before writing a warning or an error and on flush.
+     */
+    class ConsoleLogSink final : public LogSink
+    {
+    public:
+        void write(LogLevel level, std::string_view line) override;
+        void flush() override;
+
+    private:
+        std::mutex mutex_;
+    };
+
+
+    /**
+     * Writes log lines to target sink on a background thread.
+     * When queue is full the writing thread is blocked until
+     * the background thread catches up.
+     */
+    class AsyncLogSink final : public LogSink
+    {
+    public:
+        /**
+         * @param sink         - target sink.
+         * @param maxQueueSize - max number of queued log lines.
+         */
+        explicit AsyncLogSink(std::shared_ptr<LogSink> sink, std::size_t maxQueueSize = 4096);
+
+        AsyncLogSink(const AsyncLogSink&) = delete;
+        AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+        /** Writes all queued log lines to target sink and stops background thread. */
+        ~AsyncLogSink() override;
+
+        void write(LogLevel level, std::string_view line) override;
+
+        /** Blocks until all queued log lines are written and flushes target sink. */
+        void flush() override;
+
+    private:
+        void run();
+
+    private:
+        struct Line
+        {
+            LogLevel level;
+            std::string text;
+        };
+
+        std::shared_ptr<LogSink> sink_;
+        std::size_t maxQueueSize_;
+        std::mutex mutex_;
+        std::condition_variable cvWrite_;
+        std::condition_variable cvDone_;
+        std::deque<Line> queue_;
+        std::size_t numWriting_ = 0;
+        bool stop_ = false;
+        std::thread thread_;
+    };
+
+
+    /** Returns current log sink. By default, it is ConsoleLogSink. */
+    [[nodiscard]] std::shared_ptr<LogSink> logSink();
+
+    /**
+     * Sets log sink. Previous sink is flushed.
+     * @param sink - new log sink. If nullptr, the default ConsoleLogSink is set.
+     */
+    void setLogSink(std::shared_ptr<LogSink> sink);
+
+    /** Flushes current log sink. */
+    void flushLog();
+}
+#endif // LIBIM_LOG_SINK_H
@@ -1,6 +1,8 @@
 #ifndef LIBIM_FMATH_H
 #define LIBIM_FMATH_H
 #include <cfloat>
+#include <cmath>
+#include <limits>
 #include <type_traits>
 
 
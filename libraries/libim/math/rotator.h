@@ -15,7 +15,7 @@ namespace libim {
         using  AbstractVector<T, 3, rotation_vector_tag>::AbstractVector;
 
         constexpr inline Rotator(T pich, T roll, T yaw) noexcept :
-            Base_{ pich, roll, yaw }
+            Base_{{ pich, roll, yaw }}
         {}
 
         explicit constexpr inline Rotator(std::array<T, 3> a) noexcept :
@@ -0,0 +1,226 @@
+#include "../trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+using namespace libim;
+using namespace libim::trace;
+using namespace std::string_view_literals;
+
+namespace {
+    /* Events are recorded to per-thread buffers to avoid contention between worker threads.
+       Buffers are owned by the registry so the events outlive threads which recorded them. */
+    struct ThreadBuffer final
+    {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        std::size_t threadId = 0;
+    };
+
+    struct Registry final
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::atomic<uint64_t> epoch = 0;
+    };
+
+    Registry& registry()
+    {
+        static Registry r;
+        return r;
+    }
+
+    ThreadBuffer& threadBuffer()
+    {
+        thread_local std::shared_ptr<ThreadBuffer> tb = []{
+            auto b = std::make_shared<ThreadBuffer>();
+            auto& r = registry();
+            std::scoped_lock lock(r.mutex);
+            b->threadId = r.buffers.size() + 1;
+            r.buffers.push_back(b);
+            return b;
+        }();
+        return *tb;
+    }
+
+    uint64_t now() noexcept
+    {
+        using namespace std::chrono;
+        return static_cast<uint64_t>(
+            duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count()
+        );
+    }
+
+    void writeJsonString(std::string& out, std::string_view str)
+    {
+        constexpr auto hex = "0123456789abcdef"sv;
+        out += '"';
+        for (char c : str)
+        {
+            switch (c)
+            {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n";  break;
+                case '\r': out += "\\r";  break;
+                case '\t': out += "\\t";  break;
+                default:
+                    if (const auto uc = static_cast<unsigned char>(c); uc < 0x20)
+                    {
+                        out += "\\u00";
+                        out += hex[static_cast<std::size_t>(uc >> 4)];
+                        out += hex[static_cast<std::size_t>(uc & 0xF)];
+                    }
+                    else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    /* Chrome trace time is in microseconds */
+    void writeJsonTime(std::string& out, uint64_t ns)
+    {
+        out += std::to_string(ns / 1000);
+        out += '.';
+        const auto frac = std::to_string(ns % 1000);
+        out.append(3 - frac.size(), '0');
+        out += frac;
+    }
+}
+
+void libim::trace::start()
+{
+    clear();
+    registry().epoch = now();
+    detail::gEnabled = true;
+}
+
+void libim::trace::stop() noexcept
+{
+    detail::gEnabled = false;
+}
+
+void libim::trace::clear()
+{
+    auto& r = registry();
+    std::scoped_lock lock(r.mutex);
+    for (auto& b : r.buffers)
+    {
+        std::scoped_lock block(b->mutex);
+        b->events.clear();
+    }
+}
+
+std::vector<TraceEvent> libim::trace::events()
+{
+    std::vector<TraceEvent> events;
+    {
+        auto& r = registry();
+        std::scoped_lock lock(r.mutex);
+        for (auto& b : r.buffers)
+        {
+            std::scoped_lock block(b->mutex);
+            events.insert(events.end(), b->events.begin(), b->events.end());
+        }
+    }
+
+    // Parent spans start before and end after their children,
+    // order them first so the trace viewers can nest events properly.
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        if (a.start != b.start) {
+            return a.start < b.start;
+        }
+        return a.duration > b.duration;
+    });
+    return events;
+}
+
+void libim::trace::writeChromeTrace(OutputStream& ostream)
+{
+    std::string json;
+    json.reserve(4096);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto& e : events())
+    {
+        json += first ? "\n" : ",\n";
+        first = false;
+
+        json += "{\"name\":";
+        writeJsonString(json, e.name);
+        json += ",\"cat\":";
+        writeJsonString(json, e.category);
+        json += ",\"ph\":\"X\",\"ts\":";
+        writeJsonTime(json, e.start);
+        json += ",\"dur\":";
+        writeJsonTime(json, e.duration);
+        json += ",\"pid\":1,\"tid\":";
+        json += std::to_string(e.threadId);
+        json += ",\"args\":{\"bytes\":";
+        json += std::to_string(e.bytes);
+        json += ",\"allocs\":";
+        json += std::to_string(e.allocs);
+        if (!e.detail.empty())
+        {
+            json += ",\"detail\":";
+            writeJsonString(json, e.detail);
+        }
+        json += "}}";
+
+        if (json.size() > 1024 * 1024)
+        {
+            ostream.write(reinterpret_cast<const byte_t*>(json.data()), json.size());
+            json.clear();
+        }
+    }
+
+    json += "\n]}\n";
+    ostream.write(reinterpret_cast<const byte_t*>(json.data()), json.size());
+}
+
+void Span::begin(const char* category, const char* name) noexcept
+{
+    try {
+        threadBuffer(); // register thread in order of the first traced span
+    }
+    catch (...) {
+        return;
+    }
+
+    category_ = category;
+    name_     = name;
+    allocs_   = detail::tlNumAllocs;
+    active_   = true;
+    start_    = now();
+}
+
+void Span::end() noexcept
+{
+    const auto end    = now();
+    const auto allocs = detail::tlNumAllocs - allocs_;
+    try
+    {
+        auto& tb = threadBuffer();
+        const auto epoch = registry().epoch.load();
+
+        TraceEvent e;
+        e.category = category_;
+        e.name     = name_;
+        e.detail   = std::move(detail_);
+        e.start    = start_ > epoch ? start_ - epoch : 0;
+        e.duration = end - start_;
+        e.bytes    = bytes_;
+        e.allocs   = allocs;
+        e.threadId = tb.threadId;
+
+        std::scoped_lock lock(tb.mutex);
+        tb.events.push_back(std::move(e));
+    }
+    catch (...) {} // Event is dropped if it can't be recorded
+}
@@ -0,0 +1,214 @@
+#ifndef LIBIM_TRACE_H
+#define LIBIM_TRACE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <libim/io/stream.h>
+
+/**
+ * Scoped span tracing.
+ * When tracing is started, every traced scope records one TraceEvent
+ * with its wall time, number of processed bytes and number of heap allocations.
+ * Recorded events can be written as Chrome trace-event JSON file
+ * (chrome://tracing or https://ui.perfetto.dev).
+ *
+ * When tracing is not started, the cost of a traced scope is one relaxed atomic load.
+ * Defining LIBIM_NO_TRACE removes trace scopes at compile time.
+ */
+
+namespace libim::trace {
+
+    struct TraceEvent final
+    {
+        const char* category = "";
+        const char* name     = "";
+        std::string detail;           // optional event detail, e.g.: file path
+        uint64_t    start    = 0;     // start time in nanoseconds since trace start
+        uint64_t    duration = 0;     // duration in nanoseconds
+        std::size_t bytes    = 0;     // number of bytes processed
+        std::size_t allocs   = 0;     // number of heap allocations made by the traced thread
+        std::size_t threadId = 0;     // sequential id of traced thread
+    };
+
+    namespace detail {
+        inline std::atomic_bool gEnabled = false;
+        inline thread_local std::size_t tlNumAllocs = 0;
+    }
+
+    /** Returns true if tracing was started. */
+    inline bool isEnabled() noexcept
+    {
+        return detail::gEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts heap allocation for trace spans of the calling thread.
+     * To be called from program's replaced global operator new,
+     * otherwise the number of allocations in TraceEvent is always 0.
+     */
+    inline void countAllocation() noexcept
+    {
+        detail::tlNumAllocs++;
+    }
+
+    /** Clears previously recorded events and starts tracing. */
+    void start();
+
+    /** Stops tracing. Recorded events are retained. */
+    void stop() noexcept;
+
+    /** Clears all recorded events. */
+    void clear();
+
+    /** Returns all recorded events sorted by start time. */
+    [[nodiscard]] std::vector<TraceEvent> events();
+
+    /**
+     * Writes recorded events as Chrome trace-event JSON.
+     * @param ostream - output stream to write JSON to.
+     * @throw StreamError
+     */
+    void writeChromeTrace(OutputStream& ostream);
+
+
+    /**
+     * Records TraceEvent of the enclosing scope when tracing is enabled.
+     * @note category and name must be string literals.
+     */
+    class Span
+    {
+    public:
+        Span(const char* category, const char* name) noexcept
+        {
+            if (isEnabled()) {
+                begin(category, name);
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        ~Span()
+        {
+            if (active_) {
+                end();
+            }
+        }
+
+        bool isActive() const noexcept
+        {
+            return active_;
+        }
+
+        void setBytes(std::size_t bytes) noexcept
+        {
+            bytes_ = bytes;
+        }
+
+        void addBytes(std::size_t bytes) noexcept
+        {
+            bytes_ += bytes;
+        }
+
+        /**
+         * Sets event detail.
+         * Should be called only when isActive returns true to avoid constructing detail string.
+         */
+        void setDetail(std::string detail)
+        {
+            detail_ = std::move(detail);
+        }
+
+    private:
+        void begin(const char* category, const char* name) noexcept;
+        void end() noexcept;
+
+    private:
+        const char* category_ = nullptr;
+        const char* name_     = nullptr;
+        std::string detail_;
+        uint64_t    start_    = 0;
+        std::size_t allocs_   = 0;
+        std::size_t bytes_    = 0;
+        bool        active_   = false;
+    };
+
+
+    /**
+     * Span which sets the number of processed bytes
+     * to the change of stream position during the enclosing scope.
+     * @tparam StreamT - stream type with tell() member function.
+     */
+    template<typename StreamT>
+    class StreamSpan final : public Span
+    {
+    public:
+        StreamSpan(const char* category, const char* name, const StreamT& stream) noexcept :
+            Span(category, name),
+            stream_(stream)
+        {
+            if (isActive()) {
+                begin_ = tell();
+            }
+        }
+
+        ~StreamSpan()
+        {
+            if (isActive())
+            {
+                const auto end = tell();
+                setBytes(end > begin_ ? end - begin_ : begin_ - end);
+            }
+        }
+
+    private:
+        std::size_t tell() const noexcept
+        {
+            try {
+                return stream_.tell();
+            }
+            catch (...) {
+                return begin_;
+            }
+        }
+
+    private:
+        const StreamT& stream_;
+        std::size_t begin_ = 0;
+    };
+}
+
+#define LIBIM_TRACE_CONCAT_IMPL(a, b) a##b
+#define LIBIM_TRACE_CONCAT(a, b) LIBIM_TRACE_CONCAT_IMPL(a, b)
+
+#ifndef LIBIM_NO_TRACE
+    /** Traces enclosing scope. */
+    #define LIBIM_TRACE_SCOPE(category, name) \
+        ::libim::trace::Span LIBIM_TRACE_CONCAT(libim_trace_span_, __LINE__)(category, name)
+
+    /** Traces enclosing scope and records number of bytes read from or written to stream. */
+    #define LIBIM_TRACE_STREAM_SCOPE(category, name, stream) \
+        ::libim::trace::StreamSpan LIBIM_TRACE_CONCAT(libim_trace_span_, __LINE__)(category, name, stream)
+
+    /** Traces enclosing scope with event detail. Detail expression is evaluated only when tracing is enabled. */
+    #define LIBIM_TRACE_SCOPE_DETAIL(category, name, detail) \
+        LIBIM_TRACE_SCOPE(category, name); \
+        if (LIBIM_TRACE_CONCAT(libim_trace_span_, __LINE__).isActive()) \
+            LIBIM_TRACE_CONCAT(libim_trace_span_, __LINE__).setDetail(detail)
+
+    /** Traces enclosing scope with event detail and records number of bytes read from or written to stream. */
+    #define LIBIM_TRACE_STREAM_SCOPE_DETAIL(category, name, stream, detail) \
+        LIBIM_TRACE_STREAM_SCOPE(category, name, stream); \
+        if (LIBIM_TRACE_CONCAT(libim_trace_span_, __LINE__).isActive()) \
+            LIBIM_TRACE_CONCAT(libim_trace_span_, __LINE__).setDetail(detail)
+#else
+    #define LIBIM_TRACE_SCOPE(category, name) ((void)0)
+    #define LIBIM_TRACE_STREAM_SCOPE(category, name, stream) ((void)0)
+    #define LIBIM_TRACE_SCOPE_DETAIL(category, name, detail) ((void)0)
+    #define LIBIM_TRACE_STREAM_SCOPE_DETAIL(category, name, stream, detail) ((void)0)
+#endif
+
+#endif // LIBIM_TRACE_H
@@ -0,0 +1,116 @@
+#ifndef LIBIM_ATOM_H
+#define LIBIM_ATOM_H
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace libim {
+
+    /**
+     * Compact handle of string interned in the global thread-safe atom pool, e.g. resource name.
+     * Each interned string is stored only once and is never released.
+     *
+     * Atoms compare ASCII case-insensitive by comparing integer keys:
+     * atoms of strings which differ only in case are equal, but keep their own spelling (see str()).
+     * Case-insensitive hash of string is precomputed when string is interned.
+     */
+    class Atom final
+    {
+    public:
+        /** Constructs empty atom of empty string. */
+        constexpr Atom() = default;
+
+        /** Constructs atom by interning string. */
+        Atom(std::string_view str) : Atom(intern(str)) {}
+        Atom(const char* str) : Atom(std::string_view(str)) {}
+        Atom(const std::string& str) : Atom(std::string_view(str)) {}
+
+        /** Interns string and returns its atom. */
+        static Atom intern(std::string_view str);
+
+        /**
+         * Returns atom of already interned string. The string is not interned if not found.
+         * Lookup is ASCII case-insensitive, returned atom has spelling of the first interned string which matches str.
+         */
+        static std::optional<Atom> find(std::string_view str);
+
+        /** Returns number of interned strings. */
+        static std::size_t poolSize();
+
+        /** Returns interned string. The returned view is valid for the lifetime of program. */
+        std::string_view str() const;
+
+        /**
+         * Returns precomputed ASCII case-insensitive hash of string.
+         * The hash is equal to libim::utils::asciiIHash(str()).
+         */
+        uint64_t hash() const;
+
+        /** Returns unique id of interned string spelling. */
+        constexpr uint32_t id() const
+        {
+            return id_;
+        }
+
+        /** Returns case-insensitive key. Atoms with equal key represent case-insensitive equal strings. */
+        constexpr uint32_t key() const
+        {
+            return key_;
+        }
+
+        constexpr bool isEmpty() const
+        {
+            return key_ == 0;
+        }
+
+        /** Returns true if atoms have the same spelling. */
+        constexpr bool isSame(Atom other) const
+        {
+            return id_ == other.id_;
+        }
+
+        friend constexpr bool operator == (Atom a1, Atom a2)
+        {
+            return a1.key_ == a2.key_;
+        }
+
+        friend constexpr bool operator != (Atom a1, Atom a2)
+        {
+            return !(a1 == a2);
+        }
+
+    private:
+        constexpr Atom(uint32_t id, uint32_t key) :
+            id_(id),
+            key_(key)
+        {}
+
+    private:
+        uint32_t id_  = 0;
+        uint32_t key_ = 0;
+    };
+
+    struct AtomHash
+    {
+        std::size_t operator()(Atom a) const
+        {
+            return std::hash<uint32_t>{}(a.key());
+        }
+    };
+
+    /** Case-insensitive set of atoms. */
+    using AtomSet = std::unordered_set<Atom, AtomHash>;
+
+    /** Case-insensitive map of atom to value. */
+    template<typename T>
+    using AtomMap = std::unordered_map<Atom, T, AtomHash>;
+}
+
+template<>
+struct std::hash<libim::Atom> : libim::AtomHash {};
+
+#endif // LIBIM_ATOM_H
@@ -0,0 +1,169 @@
+#include "../atom.h"
+#include "../string_map.h"
+#include <libim/utils/ascii.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+
+using namespace libim;
+
+namespace {
+    struct AtomIds
+    {
+        uint32_t id;
+        uint32_t key;
+    };
+
+    struct AtomEntry
+    {
+        std::string name;
+        uint64_t hash = 0;
+        uint32_t key  = 0;
+    };
+
+    /**
+     * Global pool of interned strings.
+     * Entries are stored in fixed size blocks which are never moved or freed,
+     * so entry of atom can be read without locking.
+     */
+    class AtomPool final
+    {
+        static constexpr std::size_t kBlockSize = 4096;
+        static constexpr std::size_t kMaxBlocks = 4096;
+
+    public:
+        AtomPool()
+        {
+            // Id 0 is reserved for empty string
+            auto& e = add(std::string_view());
+            exact_.emplace(e.name, 0);
+            folded_.emplace(e.name, 0);
+            size_.store(1, std::memory_order_release);
+        }
+
+        const AtomEntry& at(uint32_t id) const
+        {
+            const auto* block = blocks_[id / kBlockSize].load(std::memory_order_acquire);
+            return block[id % kBlockSize];
+        }
+
+        std::size_t size() const
+        {
+            return size_.load(std::memory_order_acquire);
+        }
+
+        AtomIds intern(std::string_view str)
+        {
+            {
+                std::shared_lock lock(mutex_);
+                if (auto it = exact_.find(str); it != exact_.end()) {
+                    return { it->second, at(it->second).key };
+                }
+            }
+
+            std::unique_lock lock(mutex_);
+            if (auto it = exact_.find(str); it != exact_.end()) { // Could be interned by other thread meanwhile
+                return { it->second, at(it->second).key };
+            }
+
+            const auto id = static_cast<uint32_t>(size_.load(std::memory_order_relaxed));
+            auto& e = add(str);
+            if (auto it = folded_.find(str); it != folded_.end()) {
+                e.key = it->second;
+            }
+            else
+            {
+                e.key = id;
+                folded_.emplace(e.name, id);
+            }
+
+            exact_.emplace(e.name, id);
+            size_.store(id + 1, std::memory_order_release);
+            return { id, e.key };
+        }
+
+        std::optional<AtomIds> find(std::string_view str) const
+        {
+            std::shared_lock lock(mutex_);
+            if (auto it = exact_.find(str); it != exact_.end()) {
+                return AtomIds{ it->second, at(it->second).key };
+            }
+            if (auto it = folded_.find(str); it != folded_.end()) {
+                return AtomIds{ it->second, it->second };
+            }
+            return std::nullopt;
+        }
+
+    private:
+        AtomEntry& add(std::string_view str)
+        {
+            const auto id = size_.load(std::memory_order_relaxed);
+            const auto bidx = id / kBlockSize;
+            if (bidx >= kMaxBlocks) {
+                throw std::length_error("AtomPool: Atom pool is full");
+            }
+
+            auto* block = blocks_[bidx].load(std::memory_order_relaxed);
+            if (!block)
+            {
+                storage_[bidx] = std::make_unique<AtomEntry[]>(kBlockSize);
+                block = storage_[bidx].get();
+                blocks_[bidx].store(block, std::memory_order_release);
+            }
+
+            auto& e = block[id % kBlockSize];
+            e.name = std::string(str);
+            e.hash = utils::asciiIHash(str);
+            return e;
+        }
+
+    private:
+        mutable std::shared_mutex mutex_;
+        std::atomic<std::size_t> size_ = 0;
+        std::array<std::atomic<AtomEntry*>, kMaxBlocks> blocks_ {};
+        std::array<std::unique_ptr<AtomEntry[]>, kMaxBlocks> storage_;
+        std::unordered_map<std::string_view, uint32_t> exact_; // Exact spelling -> id
+        std::unordered_map<std::string_view, uint32_t,
+            StringCaseInsensitiveHash, StringCaseInsensitiveEqual> folded_; // Case-insensitive spelling -> key
+    };
+
+    AtomPool& pool()
+    {
+        static AtomPool p;
+        return p;
+    }
+}
+
+
+Atom Atom::intern(std::string_view str)
+{
+    const auto p = pool().intern(str);
+    return Atom(p.id, p.key);
+}
+
+std::optional<Atom> Atom::find(std::string_view str)
+{
+    if (auto p = pool().find(str)) {
+        return Atom(p->id, p->key);
+    }
+    return std::nullopt;
+}
+
+std::size_t Atom::poolSize()
+{
+    return pool().size();
+}
+
+std::string_view Atom::str() const
+{
+    return pool().at(id_).name;
+}
+
+uint64_t Atom::hash() const
+{
+    return pool().at(id_).hash;
+}
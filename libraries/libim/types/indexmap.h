@@ -5,6 +5,7 @@
 #include <functional>
 #include <iterator>
 #include <list>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -20,6 +21,9 @@ namespace libim {
      * Hash table which elements are ordered by insertion and mapped to the key.
      * Each element can be retrieved by the key or by the index.
      *
+     * Internal containers allocate memory from the memory resource, the map was constructed with
+     * (default memory resource by default). Copy of map uses default memory resource.
+     *
      * @tparam KeyT       - The key type.
      * @tparam T          - The value type.
      * @tparam LookupKeyT - The lookup key type (should be compatible with KeyT).
@@ -43,7 +47,7 @@ namespace libim {
         using idx_t       = size_type;
 
         using ContainerElement = std::pair<KeyT, T>;
-        using ContainerType    = std::list<ContainerElement>;
+        using ContainerType    = std::pmr::list<ContainerElement>;
 
         using key_type             = KeyT;
         using key_reference        = key_type&;
@@ -61,7 +65,42 @@ namespace libim {
 
         IndexMap() = default;
         IndexMap(IndexMap&&) = default;
-        IndexMap& operator = (IndexMap&&) noexcept = default;
+
+        /**
+         * Constructs empty map which allocates memory from the memory resource.
+         * @param mr - memory resource, e.g. utils::Arena. The resource must outlive the map.
+         */
+        explicit IndexMap(std::pmr::memory_resource* mr) :
+            data_(mr),
+            index_(mr),
+            map_(mr)
+        {}
+
+        /**
+         * Move assigns rhs to this map.
+         * When maps use different memory resources, elements are moved one by one
+         * to the memory of this map, which allocates and may throw std::bad_alloc.
+         */
+        IndexMap& operator = (IndexMap&& rhs)
+        {
+            if (&rhs != this)
+            {
+                if (resource()->is_equal(*rhs.resource()))
+                {
+                    data_  = std::move(rhs.data_);
+                    index_ = std::move(rhs.index_);
+                    map_   = std::move(rhs.map_);
+                }
+                else
+                {
+                    // Elements are moved to the memory of this map, index and map have to be rebuilt
+                    data_ = std::move(rhs.data_);
+                    reconstruct();
+                    rhs.clear();
+                }
+            }
+            return *this;
+        }
 
         IndexMap(const IndexMap& rhs) : data_(rhs.data_)
         {
@@ -653,15 +692,31 @@ namespace libim {
 
         /**
          * Swaps the contents of the container with those of other.
+         * When containers use different memory resources, elements are moved
+         * between containers, which allocates and may throw std::bad_alloc.
          * @param other - The container to swap contents with.
          */
-        void swap(IndexMap& other) noexcept
+        void swap(IndexMap& other)
         {
+            if (!resource()->is_equal(*other.resource()))
+            {
+                IndexMap tmp(std::move(other));
+                other = std::move(*this);
+                *this = std::move(tmp);
+                return;
+            }
+
             data_.swap(other.data_);
             index_.swap(other.index_);
             map_.swap(other.map_);
         }
 
+        /** Returns memory resource the map allocates memory from. */
+        std::pmr::memory_resource* resource() const noexcept
+        {
+            return data_.get_allocator().resource();
+        }
+
     private:
         static inline auto crefOrKey(key_const_reference key)
         {
@@ -708,8 +763,8 @@ namespace libim {
 
     private:
         // TODO: When moved to C++20 refactor MapType to directly support std::string_view
-        using IndexType = std::deque<typename ContainerType::iterator>;
-        using MapType = std::unordered_map<
+        using IndexType = std::pmr::deque<typename ContainerType::iterator>;
+        using MapType = std::pmr::unordered_map<
             MapKeyT,
             typename ContainerType::iterator,
             Hash,
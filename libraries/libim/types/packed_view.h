@@ -0,0 +1,190 @@
+#ifndef LIBIM_PACKED_VIEW_H
+#define LIBIM_PACKED_VIEW_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include <libim/common.h>
+
+namespace libim {
+
+    /**
+     * Read-only view of array of trivially copyable objects of type T stored in byte buffer.
+     * Serialized arrays (e.g. CND sections) are packed and can start at any byte offset,
+     * therefore elements are accessed by value via memcpy which is safe for unaligned data.
+     * When data is aligned for T the view can also be accessed as std::span<const T>, see span().
+     *
+     * The view doesn't own data and is valid as long as the underlying buffer is valid.
+     */
+    template<typename T>
+    class PackedView final
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable type");
+
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        class iterator final
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using iterator_concept  = std::random_access_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = T;
+
+            constexpr iterator() = default;
+            constexpr explicit iterator(const byte_t* p) : p_(p) {}
+
+            T operator*() const
+            {
+                return load(p_);
+            }
+
+            T operator[](difference_type n) const
+            {
+                return load(p_ + n * difference_type(sizeof(T)));
+            }
+
+            iterator& operator++()                     { p_ += sizeof(T); return *this; }
+            iterator  operator++(int)                  { auto it = *this; ++*this; return it; }
+            iterator& operator--()                     { p_ -= sizeof(T); return *this; }
+            iterator  operator--(int)                  { auto it = *this; --*this; return it; }
+            iterator& operator+=(difference_type n)    { p_ += n * difference_type(sizeof(T)); return *this; }
+            iterator& operator-=(difference_type n)    { p_ -= n * difference_type(sizeof(T)); return *this; }
+
+            friend iterator operator+(iterator it, difference_type n) { return it += n; }
+            friend iterator operator+(difference_type n, iterator it) { return it += n; }
+            friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(iterator a, iterator b)
+            {
+                return (a.p_ - b.p_) / difference_type(sizeof(T));
+            }
+
+            friend bool operator==(iterator a, iterator b) { return a.p_ == b.p_; }
+            friend auto operator<=>(iterator a, iterator b) { return a.p_ <=> b.p_; }
+
+        private:
+            const byte_t* p_ = nullptr;
+        };
+
+        constexpr PackedView() = default;
+
+        /**
+         * Constructs view of count elements starting at data.
+         * @param data  - pointer to the first byte of the first element.
+         * @param count - number of elements.
+         */
+        constexpr PackedView(const byte_t* data, std::size_t count) :
+            data_(data),
+            size_(count)
+        {}
+
+        constexpr std::size_t size() const
+        {
+            return size_;
+        }
+
+        constexpr std::size_t sizeBytes() const
+        {
+            return size_ * sizeof(T);
+        }
+
+        constexpr bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        /** Returns raw bytes of the view. */
+        ByteView bytes() const
+        {
+            return ByteView(data_, sizeBytes());
+        }
+
+        T operator[](std::size_t idx) const
+        {
+            return load(data_ + idx * sizeof(T));
+        }
+
+        /**
+         * Returns element at index idx.
+         * @throw std::out_of_range if idx is out of range.
+         */
+        T at(std::size_t idx) const
+        {
+            if (idx >= size_) {
+                throw std::out_of_range("PackedView: Index out of range");
+            }
+            return (*this)[idx];
+        }
+
+        T front() const
+        {
+            return at(0);
+        }
+
+        T back() const
+        {
+            return at(size_ - 1);
+        }
+
+        iterator begin() const
+        {
+            return iterator(data_);
+        }
+
+        iterator end() const
+        {
+            return iterator(data_ + sizeBytes());
+        }
+
+        /**
+         * Returns sub-view of count elements starting at element offset.
+         * @throw std::out_of_range if sub-view is out of range.
+         */
+        PackedView subview(std::size_t offset, std::size_t count) const
+        {
+            if (offset > size_ || count > size_ - offset) {
+                throw std::out_of_range("PackedView: Sub-view out of range");
+            }
+            return PackedView(data_ + offset * sizeof(T), count);
+        }
+
+        /** Returns true if data is aligned for T and view can be accessed via span(). */
+        bool isAligned() const
+        {
+            return reinterpret_cast<std::uintptr_t>(data_) % alignof(T) == 0;
+        }
+
+        /**
+         * Returns view as span of T.
+         * @throw std::logic_error if data is not aligned for T. See isAligned().
+         */
+        std::span<const T> span() const
+        {
+            if (!isAligned()) {
+                throw std::logic_error("PackedView: Data is not aligned for type T");
+            }
+            return std::span<const T>(reinterpret_cast<const T*>(data_), size_);
+        }
+
+    private:
+        static T load(const byte_t* p)
+        {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            return v;
+        }
+
+    private:
+        const byte_t* data_ = nullptr;
+        std::size_t size_   = 0;
+    };
+}
+#endif // LIBIM_PACKED_VIEW_H
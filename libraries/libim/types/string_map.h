@@ -7,6 +7,8 @@
 #include <string_view>
 #include <type_traits>
 
+#include <libim/utils/ascii.h>
+
 namespace libim{
 
     /** A case-insensitive string hash function. */
@@ -14,24 +16,7 @@ namespace libim{
     {
         size_t operator()(const std::string_view val) const
         {
-            // FNV-1a hash function
-            // TODO: Use faster hash function for smaller strings with better avalanche effect.
-            //       Check MurmurHash3, CityHash....
-            #if defined(LIBIM_PLATFORM_64BIT)
-                static constexpr size_t fnvOffsetBasis = 14695981039346656037ULL;
-                static constexpr size_t fnvPrime       = 1099511628211ULL;
-            #else
-                static constexpr size_t fnvOffsetBasis = 2166136261U;
-                static constexpr size_t fnvPrime       = 16777619U;
-            #endif
-
-            std::size_t hash = fnvOffsetBasis;
-            for (auto c : val)
-            {
-                hash ^= static_cast<std::size_t>(std::tolower(c));
-                hash *= fnvPrime;
-            }
-            return hash;
+            return static_cast<size_t>(utils::asciiIHash(val));
         }
     };
 
@@ -50,11 +35,7 @@ namespace libim{
     {
         bool operator()(const std::string_view lhs, const std::string_view rhs) const
         {
-            return lhs.size() == rhs.size() &&
-                std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
-                    [](const char& lhs, const char& rhs) {
-                        return std::tolower(lhs) == std::tolower(rhs);
-                });
+            return utils::asciiIEqual(lhs, rhs);
         }
     };
 
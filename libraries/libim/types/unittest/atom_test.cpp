@@ -0,0 +1,165 @@
+#include "atom_test.h"
+#include "../atom.h"
+#include "../string_map.h"
+#include <libim/utils/ascii.h>
+
+#include <assert.h>
+#include <cctype>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace libim;
+using namespace libim::utils;
+
+
+static void test_ascii()
+{
+// Test case 1: Word case folding matches char case folding for all byte values
+    {
+        for (int b = 0; b < 256; b++)
+        {
+            const char c = static_cast<char>(b);
+            [[maybe_unused]] const uint64_t w = static_cast<uint8_t>(c) * 0x0101010101010101ULL;
+            [[maybe_unused]] const uint64_t lw = static_cast<uint8_t>(asciiToLower(c)) * 0x0101010101010101ULL;
+            assert(asciiToLower(w) == lw);
+            if (b < 128) {
+                assert(asciiToLower(c) == static_cast<char>(std::tolower(b)));
+            }
+        }
+    }
+
+// Test case 2: Case-insensitive equality and hash of strings of different lengths
+    {
+        const std::string base = "Gen_Whip_Fire.WAV@[`{\xC0\xE0";
+        for (std::size_t len = 0; len <= base.size(); len++)
+        {
+            const auto s1 = base.substr(0, len);
+            std::string s2 = s1;
+            for (auto& c : s2) {
+                c = static_cast<char>(std::isupper(static_cast<uint8_t>(c)) ? std::tolower(c) : std::toupper(c));
+            }
+
+            assert(asciiIEqual(s1, s2));
+            assert(asciiIHash(s1) == asciiIHash(s2));
+            assert(StringCaseInsensitiveHash()(s1) == StringCaseInsensitiveHash()(s2));
+            if (len > 0)
+            {
+                auto s3 = s1;
+                s3.back() = s3.back() == '_' ? '-' : '_';
+                assert(!asciiIEqual(s1, s3));
+                assert(!asciiIEqual(s1, s1.substr(0, len - 1)));
+            }
+        }
+
+        // Chars which differ by 0x20 but are not letters
+        assert(!asciiIEqual("@", "`"));
+        assert(!asciiIEqual("[", "{"));
+        assert(!asciiIEqual("\xC0", "\xE0"));
+        assert(asciiIEqual("", ""));
+        assert(asciiIHash("a") != asciiIHash("b"));
+        assert(asciiIHash("") != asciiIHash(std::string_view("\0", 1)));
+    }
+}
+
+static void test_atom()
+{
+// Test case 1: Empty atom
+    {
+        Atom a;
+        assert(a.isEmpty());
+        assert(a.id() == 0 && a.key() == 0);
+        assert(a.str().empty());
+        assert(a == Atom(""));
+        assert(a.hash() == asciiIHash(""));
+    }
+
+// Test case 2: Interning the same string returns the same atom
+    {
+        [[maybe_unused]] const auto size = Atom::poolSize();
+        [[maybe_unused]] Atom a1 = "atom_test_gen_whip_fire.wav";
+        [[maybe_unused]] Atom a2 = std::string("atom_test_gen_whip_fire.wav");
+        assert(!a1.isEmpty());
+        assert(a1 == a2 && a1.isSame(a2));
+        assert(a1.str() == "atom_test_gen_whip_fire.wav");
+        assert(a1.hash() == asciiIHash(a1.str()));
+        assert(Atom::poolSize() == size + 1);
+    }
+
+// Test case 3: Atoms of strings which differ in case are equal and keep their spelling
+    {
+        [[maybe_unused]] Atom a1 = "atom_test_mat.3do";
+        [[maybe_unused]] Atom a2 = "ATOM_TEST_Mat.3DO";
+        assert(a1 == a2);
+        assert(!a1.isSame(a2));
+        assert(a1.key() == a2.key());
+        assert(a1.hash() == a2.hash());
+        assert(AtomHash()(a1) == AtomHash()(a2));
+        assert(a1.str() == "atom_test_mat.3do");
+        assert(a2.str() == "ATOM_TEST_Mat.3DO");
+        assert(a1 != Atom("atom_test_mat.3do2"));
+    }
+
+// Test case 4: Find doesn't intern string
+    {
+        [[maybe_unused]] const auto size = Atom::poolSize();
+        assert(!Atom::find("atom_test_not_interned"));
+        assert(Atom::poolSize() == size);
+
+        [[maybe_unused]] auto a = Atom::find("ATOM_TEST_GEN_WHIP_FIRE.wav");
+        assert(a.has_value());
+        assert(a->str() == "atom_test_gen_whip_fire.wav");
+        assert(Atom::poolSize() == size);
+    }
+
+// Test case 5: Atom set is case-insensitive
+    {
+        AtomSet set = { "atom_test_a.key", "Atom_Test_A.KEY", "atom_test_b.key" };
+        assert(set.size() == 2);
+        assert(set.contains(Atom("ATOM_TEST_B.key")));
+        assert(!set.contains(Atom("atom_test_c.key")));
+    }
+
+// Test case 6: Concurrent interning
+    {
+        constexpr std::size_t numThreads = 8;
+        constexpr std::size_t numNames   = 5000;
+        std::vector<std::vector<Atom>> atoms(numThreads);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < numThreads; t++)
+        {
+            threads.emplace_back([t, &atoms] {
+                for (std::size_t i = 0; i < numNames; i++)
+                {
+                    auto name = "atom_test_concurrent_" + std::to_string(i);
+                    if ((i + t) % 2 == 0) {
+                        for (auto& c : name) c = static_cast<char>(std::toupper(c));
+                    }
+                    atoms[t].push_back(Atom::intern(name));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        for (std::size_t i = 0; i < numNames; i++)
+        {
+            const auto name = "atom_test_concurrent_" + std::to_string(i);
+            for (std::size_t t = 0; t < numThreads; t++)
+            {
+                [[maybe_unused]] const auto& a = atoms[t][i];
+                assert(a == atoms[0][i]);
+                assert(asciiIEqual(a.str(), name));
+                assert(a.hash() == asciiIHash(name));
+                assert(a.isSame(atoms[t % 2][i]));
+            }
+        }
+    }
+}
+
+void libim::unit_test::run_atom_tests()
+{
+    test_ascii();
+    test_atom();
+}
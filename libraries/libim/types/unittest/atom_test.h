@@ -0,0 +1,8 @@
+#ifndef LIBIM_ATOM_TEST_H
+#define LIBIM_ATOM_TEST_H
+
+namespace libim::unit_test {
+    void run_atom_tests();
+}
+
+#endif // LIBIM_ATOM_TEST_H
@@ -0,0 +1,107 @@
+#include "indexmap_test.h"
+#include "../indexmap.h"
+#include <libim/utils/arena.h>
+
+#include <assert.h>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+using namespace libim;
+using namespace libim::utils;
+
+
+static UniqueTable<int> makeTable(std::pmr::memory_resource* mr, int n)
+{
+    UniqueTable<int> t(mr);
+    for (int i = 0; i < n; i++) {
+        t.pushBack("key_" + std::to_string(i), i);
+    }
+    return t;
+}
+
+static void checkTable(const UniqueTable<int>& t, int n)
+{
+    assert(t.size() == static_cast<std::size_t>(n));
+    for (int i = 0; i < n; i++)
+    {
+        assert(t[static_cast<std::size_t>(i)] == i);
+        [[maybe_unused]] auto it = t.find("KEY_" + std::to_string(i));
+        assert(it != t.end() && *it == i);
+    }
+}
+
+static void test_indexmap_resource()
+{
+// Test case 1: Map allocates from arena
+    {
+        Arena arena;
+        auto t = makeTable(&arena, 100);
+        assert(t.resource() == &arena);
+        assert(arena.numAllocations() > 0);
+        checkTable(t, 100);
+    }
+
+// Test case 2: Copy of map is allocated from default memory resource
+    {
+        UniqueTable<int> copy;
+        {
+            Arena arena;
+            auto t = makeTable(&arena, 100);
+            copy = t;
+            UniqueTable<int> copy2(t);
+            assert(copy2.resource() == std::pmr::get_default_resource());
+            checkTable(copy2, 100);
+        }
+        assert(copy.resource() == std::pmr::get_default_resource());
+        checkTable(copy, 100);
+    }
+
+// Test case 3: Move assign between maps with different memory resources
+    {
+        UniqueTable<int> dst;
+        {
+            Arena arena;
+            auto t = makeTable(&arena, 100);
+            dst = std::move(t);
+            assert(t.isEmpty());
+        }
+        assert(dst.resource() == std::pmr::get_default_resource());
+        checkTable(dst, 100);
+
+        dst.pushBack("key_100", 100);
+        checkTable(dst, 101);
+    }
+
+// Test case 4: Move and swap maps with the same memory resource
+    {
+        Arena arena;
+        auto t1 = makeTable(&arena, 10);
+        auto t2 = makeTable(&arena, 20);
+        t1.swap(t2);
+        checkTable(t1, 20);
+        checkTable(t2, 10);
+
+        UniqueTable<int> t3(&arena);
+        t3 = std::move(t1);
+        assert(t3.resource() == &arena);
+        checkTable(t3, 20);
+    }
+
+// Test case 5: Swap maps with different memory resources
+    {
+        Arena arena;
+        auto t1 = makeTable(&arena, 10);
+        auto t2 = makeTable(std::pmr::get_default_resource(), 20);
+        t1.swap(t2);
+        checkTable(t1, 20);
+        checkTable(t2, 10);
+        assert(t1.resource() == &arena);
+        assert(t2.resource() == std::pmr::get_default_resource());
+    }
+}
+
+void libim::unit_test::run_indexmap_tests()
+{
+    test_indexmap_resource();
+}
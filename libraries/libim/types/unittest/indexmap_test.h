@@ -0,0 +1,8 @@
+#ifndef LIBIM_INDEXMAP_TEST_H
+#define LIBIM_INDEXMAP_TEST_H
+
+namespace libim::unit_test {
+    void run_indexmap_tests();
+}
+
+#endif // LIBIM_INDEXMAP_TEST_H
@@ -0,0 +1,85 @@
+#ifndef LIBIM_ARENA_H
+#define LIBIM_ARENA_H
+#include <cstddef>
+#include <memory_resource>
+
+namespace libim::utils {
+
+    /**
+     * Monotonic memory arena.
+     * Memory is allocated from large blocks and is never freed individually,
+     * all memory is released at once when the arena is released or destroyed.
+     *
+     * Arena is meant to be passed as memory resource to parsers of large data, e.g. world (level) data,
+     * where hundreds of thousands of small objects are allocated and then freed all together.
+     * Objects allocated from the arena must not outlive the arena.
+     * Copy of object is allocated from the default memory resource,
+     * so the copy can be safely used after the arena is released.
+     *
+     * Arena is not thread-safe and must not be shared across threads.
+     * Containers allocated from the arena must not grow or shrink concurrently,
+     * e.g. when arena-backed data is processed in parallel, reallocations must be done before the parallel work starts.
+     */
+    class Arena final : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr std::size_t kDefaultBlockSize = 64 * 1024; // 64 KiB
+
+        /**
+         * Constructs arena.
+         * @param initialBlockSize - size of the first memory block. Next blocks grow geometrically.
+         * @param upstream         - memory resource arena blocks are allocated from.
+         */
+        explicit Arena(std::size_t initialBlockSize = kDefaultBlockSize, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+            mr_(initialBlockSize, upstream)
+        {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /** Returns total number of bytes allocated from the arena since the last release. */
+        std::size_t bytesAllocated() const
+        {
+            return bytesAllocated_;
+        }
+
+        /** Returns number of allocations made from the arena since the last release. */
+        std::size_t numAllocations() const
+        {
+            return numAllocations_;
+        }
+
+        /**
+         * Releases all memory allocated from the arena.
+         * All objects allocated from the arena must be destroyed before calling this function.
+         */
+        void release()
+        {
+            mr_.release();
+            bytesAllocated_ = 0;
+            numAllocations_ = 0;
+        }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            bytesAllocated_ += bytes;
+            numAllocations_++;
+            return mr_.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* /*p*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override
+        {} // Memory is freed on release
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        std::pmr::monotonic_buffer_resource mr_;
+        std::size_t bytesAllocated_ = 0;
+        std::size_t numAllocations_ = 0;
+    };
+}
+#endif // LIBIM_ARENA_H
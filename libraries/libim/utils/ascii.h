@@ -0,0 +1,106 @@
+#ifndef LIBIM_ASCII_H
+#define LIBIM_ASCII_H
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * Header file provides ASCII case-insensitive string comparison and hashing.
+ * Strings are processed 8 characters at a time by case folding whole 64-bit words (SWAR),
+ * non-ASCII characters are compared as is.
+ */
+
+namespace libim::utils {
+    namespace detail {
+        static constexpr uint64_t kAsciiOnes = 0x0101010101010101ULL;
+        static constexpr uint64_t kAsciiHigh = 0x8080808080808080ULL;
+
+        /** Reads up to 8 chars into word, missing chars are 0. */
+        inline uint64_t asciiLoad(const char* p, std::size_t n) noexcept
+        {
+            uint64_t w = 0;
+            std::memcpy(&w, p, n < 8 ? n : 8);
+            return w;
+        }
+
+        inline constexpr uint64_t asciiRotl(uint64_t x, int r) noexcept
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+    }
+
+    /** Converts ASCII upper case char to lower case. Other chars are returned as is. */
+    [[nodiscard]] inline constexpr char asciiToLower(char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    /** Converts ASCII upper case chars packed in 64-bit word to lower case. */
+    [[nodiscard]] inline constexpr uint64_t asciiToLower(uint64_t w) noexcept
+    {
+        using namespace detail;
+        // High bit of each byte is set if 7-bit char value >= 'A' or > 'Z'
+        const uint64_t heptets = w & ~kAsciiHigh;
+        const uint64_t geA = heptets + (0x80 - 'A') * kAsciiOnes;
+        const uint64_t gtZ = heptets + (0x80 - 'Z' - 1) * kAsciiOnes;
+        const uint64_t isUpper = (geA ^ gtZ) & ~w & kAsciiHigh;
+        return w | (isUpper >> 2); // 0x80 >> 2 = 0x20 = 'a' - 'A'
+    }
+
+    /** ASCII case-insensitive comparison of two strings. */
+    [[nodiscard]] inline bool asciiIEqual(std::string_view s1, std::string_view s2) noexcept
+    {
+        if (s1.size() != s2.size()) {
+            return false;
+        }
+
+        const char* p1 = s1.data();
+        const char* p2 = s2.data();
+        for (std::size_t n = s1.size(); n > 0;)
+        {
+            const auto w1 = detail::asciiLoad(p1, n);
+            const auto w2 = detail::asciiLoad(p2, n);
+            if (w1 != w2 && asciiToLower(w1) != asciiToLower(w2)) {
+                return false;
+            }
+
+            const std::size_t step = n < 8 ? n : 8;
+            p1 += step;
+            p2 += step;
+            n  -= step;
+        }
+        return true;
+    }
+
+    /**
+     * Returns 64-bit ASCII case-insensitive hash of string.
+     * Strings which are equal by asciiIEqual have equal hash.
+     * @note The hash is not stable across platforms with different endianness and should not be persisted.
+     */
+    [[nodiscard]] inline uint64_t asciiIHash(std::string_view str) noexcept
+    {
+        constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+        uint64_t h = static_cast<uint64_t>(str.size()) * kPrime1;
+        const char* p = str.data();
+        for (std::size_t n = str.size(); n > 0;)
+        {
+            const auto w = asciiToLower(detail::asciiLoad(p, n));
+            h = detail::asciiRotl(h ^ (w * kPrime2), 31) * kPrime1;
+
+            const std::size_t step = n < 8 ? n : 8;
+            p += step;
+            n -= step;
+        }
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+}
+#endif // LIBIM_ASCII_H
@@ -0,0 +1,50 @@
+#ifndef LIBIM_ENDIAN_H
+#define LIBIM_ENDIAN_H
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace libim::utils {
+
+    /** True if native byte order is little-endian, the byte order of all game file formats. */
+    inline constexpr bool kNativeLittleEndian = std::endian::native == std::endian::little;
+
+    /** Reverses byte order of integer, float or enum value. */
+    template<typename T>
+    [[nodiscard]] constexpr T byteSwap(T v) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "T must be arithmetic or enum type");
+        if constexpr (sizeof(T) == 1) {
+            return v;
+        }
+        else
+        {
+            using U = std::conditional_t<sizeof(T) == 2, uint16_t,
+                      std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+            static_assert(sizeof(T) == sizeof(U), "Unsupported type size");
+
+            auto u = std::bit_cast<U>(v);
+            U r = 0;
+            for (std::size_t i = 0; i < sizeof(U); i++)
+            {
+                r = static_cast<U>((r << 8) | (u & 0xFF));
+                u = static_cast<U>(u >> 8);
+            }
+            return std::bit_cast<T>(r);
+        }
+    }
+
+    /** Converts value between native and little-endian byte order. */
+    template<typename T>
+    [[nodiscard]] constexpr T littleEndian(T v) noexcept
+    {
+        if constexpr (kNativeLittleEndian) {
+            return v;
+        }
+        else {
+            return byteSwap(v);
+        }
+    }
+}
+#endif // LIBIM_ENDIAN_H
@@ -0,0 +1,221 @@
+#ifndef LIBIM_HASH_H
+#define LIBIM_HASH_H
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <libim/common.h>
+#include <libim/io/stream.h>
+
+namespace libim::utils {
+
+    /**
+     * 64-bit non-cryptographic content hash (XXH64 algorithm).
+     * Data can be hashed in parts by calling update multiple times,
+     * the result doesn't depend on how data is split.
+     */
+    class Hasher64 final
+    {
+    public:
+        explicit Hasher64(uint64_t seed = 0) noexcept :
+            seed_(seed),
+            acc_{ seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1 }
+        {}
+
+        Hasher64& update(const void* data, std::size_t size) noexcept
+        {
+            auto p = static_cast<const byte_t*>(data);
+            total_ += size;
+
+            // Fill partial stripe
+            if (bufSize_ > 0)
+            {
+                const auto n = std::min(size, kStripeSize - bufSize_);
+                std::memcpy(buf_.data() + bufSize_, p, n);
+                bufSize_ += n;
+                p        += n;
+                size     -= n;
+                if (bufSize_ < kStripeSize) {
+                    return *this;
+                }
+                consumeStripe(buf_.data());
+                bufSize_ = 0;
+            }
+
+            for (; size >= kStripeSize; p += kStripeSize, size -= kStripeSize) {
+                consumeStripe(p);
+            }
+
+            std::memcpy(buf_.data(), p, size);
+            bufSize_ = size;
+            return *this;
+        }
+
+        Hasher64& update(std::string_view str) noexcept
+        {
+            return update(str.data(), str.size());
+        }
+
+        Hasher64& update(const ByteArray& data) noexcept
+        {
+            return update(data.data(), data.size());
+        }
+
+        /** Updates hash with value bytes of a trivially copyable type. */
+        template<typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+        Hasher64& updateValue(const T& v) noexcept
+        {
+            return update(&v, sizeof(T));
+        }
+
+        /** Returns hash of the data passed so far. */
+        [[nodiscard]] uint64_t digest() const noexcept
+        {
+            uint64_t h;
+            if (total_ >= kStripeSize)
+            {
+                h = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+                for (auto a : acc_) {
+                    h = mergeRound(h, a);
+                }
+            }
+            else {
+                h = seed_ + kPrime5;
+            }
+            h += total_;
+
+            const byte_t* p   = buf_.data();
+            std::size_t  size = bufSize_;
+            for (; size >= 8; p += 8, size -= 8)
+            {
+                h ^= round(0, read64(p));
+                h  = rotl(h, 27) * kPrime1 + kPrime4;
+            }
+
+            if (size >= 4)
+            {
+                h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+                h  = rotl(h, 23) * kPrime2 + kPrime3;
+                p    += 4;
+                size -= 4;
+            }
+
+            for (; size > 0; p++, size--)
+            {
+                h ^= static_cast<uint64_t>(*p) * kPrime5;
+                h  = rotl(h, 11) * kPrime1;
+            }
+
+            h ^= h >> 33;
+            h *= kPrime2;
+            h ^= h >> 29;
+            h *= kPrime3;
+            h ^= h >> 32;
+            return h;
+        }
+
+    private:
+        static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+        static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+        static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+        static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+        static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+        static constexpr std::size_t kStripeSize = 32;
+
+        static constexpr uint64_t rotl(uint64_t x, int r) noexcept
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        static constexpr uint64_t round(uint64_t acc, uint64_t input) noexcept
+        {
+            acc += input * kPrime2;
+            acc  = rotl(acc, 31);
+            return acc * kPrime1;
+        }
+
+        static constexpr uint64_t mergeRound(uint64_t acc, uint64_t val) noexcept
+        {
+            acc ^= round(0, val);
+            return acc * kPrime1 + kPrime4;
+        }
+
+        // Note: Values are read in native byte order, the hash of the same data
+        //       is therefore equal only on platforms with the same endianness.
+        static uint64_t read64(const byte_t* p) noexcept
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        static uint32_t read32(const byte_t* p) noexcept
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        void consumeStripe(const byte_t* p) noexcept
+        {
+            acc_[0] = round(acc_[0], read64(p));
+            acc_[1] = round(acc_[1], read64(p + 8));
+            acc_[2] = round(acc_[2], read64(p + 16));
+            acc_[3] = round(acc_[3], read64(p + 24));
+        }
+
+    private:
+        uint64_t seed_;
+        std::array<uint64_t, 4> acc_;
+        std::array<byte_t, kStripeSize> buf_ {};
+        std::size_t bufSize_ = 0;
+        uint64_t total_ = 0;
+    };
+
+
+    /** Returns 64-bit content hash of data. See Hasher64. */
+    [[nodiscard]] inline uint64_t hash64(const void* data, std::size_t size, uint64_t seed = 0) noexcept
+    {
+        return Hasher64(seed).update(data, size).digest();
+    }
+
+    [[nodiscard]] inline uint64_t hash64(std::string_view str, uint64_t seed = 0) noexcept
+    {
+        return hash64(str.data(), str.size(), seed);
+    }
+
+    /**
+     * Returns 64-bit content hash of stream data
+     * from the current stream position to the end of stream.
+     * @throw StreamError
+     */
+    [[nodiscard]] inline uint64_t hash64(const InputStream& istream, uint64_t seed = 0)
+    {
+        Hasher64 h(seed);
+        std::array<byte_t, 64 * 1024> buf;
+        while (istream.tell() < istream.size())
+        {
+            const auto n = istream.read(buf.data(), std::min(buf.size(), istream.size() - istream.tell()));
+            if (n == 0) {
+                throw StreamError("Error while reading stream");
+            }
+            h.update(buf.data(), n);
+        }
+        return h.digest();
+    }
+
+    /** Returns hash as 16 character hex string. */
+    [[nodiscard]] inline std::string hashToString(uint64_t hash)
+    {
+        constexpr std::string_view digits = "0123456789abcdef";
+        std::string s(16, '0');
+        for (std::size_t i = 16; i-- > 0; hash >>= 4) {
+            s[i] = digits[hash & 0xF];
+        }
+        return s;
+    }
+}
+#endif // LIBIM_HASH_H
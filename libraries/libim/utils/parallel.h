@@ -0,0 +1,87 @@
+#ifndef LIBIM_PARALLEL_H
+#define LIBIM_PARALLEL_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libim::utils {
+
+    /**
+     * Returns the number of concurrent threads supported by the system.
+     * @return number of threads, at least 1.
+     */
+    inline std::size_t hardwareConcurrency()
+    {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Calls func(i) for each i in range [0, count) on multiple threads.
+     * Indices are dispatched dynamically to worker threads, so func
+     * should not rely on the call order.
+     * The first exception thrown by func is rethrown after all threads finished,
+     * and remaining indices are not processed.
+     *
+     * @param count      - number of indices to process.
+     * @param func       - function to call with the index.
+     * @param maxThreads - max number of threads to use. 0 = hardwareConcurrency().
+     */
+    template<typename Func>
+    void parallelFor(std::size_t count, Func&& func, std::size_t maxThreads = 0)
+    {
+        if (maxThreads == 0) {
+            maxThreads = hardwareConcurrency();
+        }
+
+        const std::size_t nThreads = std::min(maxThreads, count);
+        if (nThreads <= 1)
+        {
+            for (std::size_t i = 0; i < count; i++) {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic_size_t next = 0;
+        std::atomic_bool failed = false;
+        std::exception_ptr error;
+        std::mutex mutex;
+
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < count && !failed; i = next++)
+            {
+                try {
+                    func(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    failed = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (std::size_t t = 0; t < nThreads - 1; t++) {
+            threads.emplace_back(worker);
+        }
+
+        worker(); // calling thread participates too
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+#endif // LIBIM_PARALLEL_H
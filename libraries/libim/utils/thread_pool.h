@@ -0,0 +1,134 @@
+#ifndef LIBIM_THREAD_POOL_H
+#define LIBIM_THREAD_POOL_H
+#include "parallel.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace libim::utils {
+
+    /**
+     * Fixed size pool of worker threads executing submitted jobs in FIFO order.
+     * Jobs should not block on the result of other jobs submitted to the same pool.
+     */
+    class ThreadPool final
+    {
+    public:
+        /**
+         * Constructs pool and starts worker threads.
+         * @param nThreads - number of worker threads. 0 = hardwareConcurrency().
+         */
+        explicit ThreadPool(std::size_t nThreads = 0)
+        {
+            if (nThreads == 0) {
+                nThreads = hardwareConcurrency();
+            }
+
+            threads_.reserve(nThreads);
+            for (std::size_t i = 0; i < nThreads; i++) {
+                threads_.emplace_back([this]{ run(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /** Finishes all queued jobs and joins worker threads. */
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            cvJob_.notify_all();
+            for (auto& t : threads_) {
+                t.join();
+            }
+        }
+
+        /**
+         * Returns the number of worker threads.
+         * @return number of threads.
+         */
+        std::size_t size() const
+        {
+            return threads_.size();
+        }
+
+        /**
+         * Submits job to the pool.
+         * Any exception thrown by the job is stored in the returned future.
+         *
+         * @param func - job function.
+         * @return future of the job result.
+         */
+        template<typename Func>
+        [[nodiscard]] auto submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+        {
+            using R = std::invoke_result_t<std::decay_t<Func>>;
+            auto task   = std::make_shared<std::packaged_task<R()>>(std::forward<Func>(func));
+            auto result = task->get_future();
+            {
+                std::lock_guard lock(mutex_);
+                jobs_.emplace_back([task]{ (*task)(); });
+            }
+            cvJob_.notify_one();
+            return result;
+        }
+
+        /** Blocks until all submitted jobs are finished. */
+        void wait()
+        {
+            std::unique_lock lock(mutex_);
+            cvIdle_.wait(lock, [this]{ return jobs_.empty() && nActive_ == 0; });
+        }
+
+    private:
+        void run()
+        {
+            while (true)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock lock(mutex_);
+                    cvJob_.wait(lock, [this]{ return stop_ || !jobs_.empty(); });
+                    if (jobs_.empty()) {
+                        return; // stopped
+                    }
+
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                    nActive_++;
+                }
+
+                job();
+                {
+                    std::lock_guard lock(mutex_);
+                    nActive_--;
+                    if (jobs_.empty() && nActive_ == 0) {
+                        cvIdle_.notify_all();
+                    }
+                }
+            }
+        }
+
+    private:
+        std::vector<std::thread> threads_;
+        std::deque<std::function<void()>> jobs_;
+        std::mutex mutex_;
+        std::condition_variable cvJob_;
+        std::condition_variable cvIdle_;
+        std::size_t nActive_ = 0;
+        bool stop_ = false;
+    };
+}
+#endif // LIBIM_THREAD_POOL_H
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <memory>
+#include <memory_resource>
 #include <span>
 #include <type_traits>
 #include <vector>
@@ -176,6 +177,12 @@ namespace libim::utils {
     template<typename T>
     constexpr bool isStdVector = detail::is_std_vector<T>::value;
 
+    // Can T be explicitly constructed from std::pmr::memory_resource*, e.g. std::pmr::vector
+    template<typename T>
+    constexpr bool isMemoryResourceConstructible = std::is_class_v<T>
+        && std::is_constructible_v<T, std::pmr::memory_resource*>
+        && !std::is_convertible_v<std::pmr::memory_resource*, T>;
+
     /* Utility type traits */
     template<typename T>
     constexpr std::size_t arraySize = detail::array_size<T>::size;
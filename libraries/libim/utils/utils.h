@@ -17,6 +17,7 @@
 #include <vector>
 
 #include <libim/types/safe_cast.h>
+#include <libim/utils/ascii.h>
 
 #define CONCATENATE_DIRECT(s1, s2) s1##s2
 #define CONCATENATE(s1, s2) CONCATENATE_DIRECT(s1, s2)
@@ -30,17 +31,6 @@
 
 namespace libim::utils {
     namespace detail {
-        inline bool compare_char(char c1, char c2)
-        {
-            if (c1 == c2) {
-                return true;
-            }
-            else if (std::toupper(c1) == std::toupper(c2)) {
-                return true;
-            }
-            return false;
-        }
-
         [[nodiscard]] inline std::string trim(const char* str, std::size_t len)
         {
             std::size_t end = 0;
@@ -193,16 +183,12 @@ namespace libim::utils {
     /** Case insensitive comparison of two strings */
     [[nodiscard]] inline bool iequal(const std::string& s1, const std::string& s2)
     {
-        return ((s1.size() == s2.size()) &&
-            std::equal(s1.begin(), s1.end(), s2.begin(), &detail::compare_char)
-        );
+        return asciiIEqual(s1, s2);
     }
 
     [[nodiscard]] inline bool iequal(std::string_view s1, std::string_view s2)
     {
-        return ((s1.size() == s2.size()) &&
-            std::equal(s1.begin(), s1.end(), s2.begin(), &detail::compare_char)
-        );
+        return asciiIEqual(s1, s2);
     }
 
 
@@ -1,22 +1,33 @@
 #ifndef CNDTOOL_CND_H
 #define CNDTOOL_CND_H
+#include <algorithm>
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <cmdutils/cmdutils.h>
 
 #include <libim/content/asset/material/material.h>
-#include <libim/content/asset/world/impl/serialization/cnd/animation/cnd_key_structs.h>
+#include <libim/content/asset/world/geooptimizer.h>
+#include <libim/content/asset/world/lightbaker.h>
 #include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
-#include <libim/content/asset/world/impl/serialization/cnd/material/cnd_mat_header.h>
+#include <libim/content/asset/world/impl/serialization/cnd/cndpatch.h>
 #include <libim/content/audio/soundbank.h>
 
 #include <libim/io/filestream.h>
 #include <libim/io/stream.h>
+#include <libim/trace/trace.h>
 #include <libim/types/flags.h>
 #include <libim/types/indexmap.h>
 #include <libim/types/safe_cast.h>
+#include <libim/types/string_map.h>
+#include <libim/utils/arena.h>
+#include <libim/utils/hash.h>
 
+#include "config.h"
+#include "incremental.h"
 #include "ndy.h"
 #include "resource.h"
 
@@ -27,137 +38,134 @@ namespace cndtool {
     using namespace libim::content::audio;
     using namespace libim::utils;
 
-    bool patchCndMaterials(const fs::path& cndFile, const Table<Material>& materials)
+    /**
+     * Applies section edits made by patchFunc to CND file in a single transaction.
+     * See CndPatch.
+     */
+    template<typename PatchF>
+    bool patchCnd(const fs::path& cndFile, std::string_view sectionName, PatchF&& patchFunc)
     {
-        const fs::path patchedCndFile = cndFile.string() + ".patched";
         try
         {
-            InputFileStream ifstream(cndFile);
-
-            /* Read cnd file header (this alos verifies if flie is valid cnd) */
-            auto cndHeader = CND::readHeader(ifstream);
-
-            /* Open new output cnd file */
-            OutputFileStream ofstream(patchedCndFile, /*truncate=*/true);
-
-            /* Copy input cnd file to output stream until materials section */
-            const auto matSectionOffset = CND::getOffset_Materials(ifstream);
-            ofstream.write(ifstream, 0, matSectionOffset);
-            std::size_t oldSizePixeldata = ifstream.read<uint32_t>();
-
-            /* Write new materials section */
-            CND::writeSection_Materials(ofstream, materials);
-
-            /* Write the rest of inputted cnd file to the output */
-            std::size_t endOffsMatSection = ifstream.tell() + sizeof(CndMatHeader) * cndHeader.numMaterials + oldSizePixeldata;
-            ofstream.write(ifstream, endOffsMatSection);
-
-            /* Write new file size to the beginning of the output cnd file*/
-            ofstream.seekBegin();
-            ofstream.write(safe_cast<uint32_t>(ofstream.size()));
-
-            /* Update materials info in CND header */
-            ofstream.seek(offsetof(CndHeader, numMaterials));
-            ofstream.write(safe_cast<uint32_t>(materials.size())); // numMaterials field
-            if (cndHeader.sizeMaterials < materials.size()) {
-                ofstream.write(safe_cast<uint32_t>(materials.size())); // sizeMaterials field
-            }
-
-            /* Close IO file stream */
-            ifstream.close();
-            ofstream.close();
-
-            /* Rename patched file name to original name */
-            renameFile(patchedCndFile, cndFile);
+            CndPatch patch(cndFile);
+            patchFunc(patch);
+            patch.commit();
             return true;
         }
         catch(const std::exception& e)
         {
-            std::cerr << "ERROR: Failed to patch material section!\n";
+            std::cerr << "ERROR: Failed to patch " << sectionName << " section!\n";
             std::cerr << "       Reason: " << e.what() << std::endl;
-            deleteFile(patchedCndFile);
             return false;
         }
     }
 
-    bool patchCndAnimations(const fs::path& cndFile, const UniqueTable<Animation>& animations)
+    bool patchCndMaterials(const fs::path& cndFile, const Table<Material>& materials)
     {
-        const fs::path patchedCndFile = cndFile.string() + ".patched";
-        try
-        {
-            InputFileStream ifstream(cndFile);
-
-            /* Read cnd file header (this alos verifies if flie is valid cnd) */
-            auto cndHeader = CND::readHeader(ifstream);
-
-            /* Open new output cnd file */
-            OutputFileStream ofstream(patchedCndFile, /*truncate=*/true);
-
-            /* Copy input cnd file to output stream until materials section */
-            const auto keySectionOffset = CND::getOffset_Keyframes(ifstream, cndHeader);
-            ofstream.write(ifstream, 0, keySectionOffset);
-
-            /* Write new materials section */
-            CND::writeSection_Keyframes(ofstream, animations);
-
-            /* Write the rest of inputted cnd file to the output */
-            auto aOldNumEntries = ifstream.read<std::array<uint32_t, 3>>();
-            std::size_t endOffsKeySection = ifstream.tell()       +
-                    sizeof(CndKeyHeader) * cndHeader.numKeyframes +
-                    sizeof(KeyMarker)    * aOldNumEntries.at(0)   +
-                    sizeof(CndKeyNode)   * aOldNumEntries.at(1)   +
-                    sizeof(KeyNodeEntry) * aOldNumEntries.at(2);
+        LIBIM_TRACE_SCOPE_DETAIL("cndtool", "patchCndMaterials", cndFile.generic_string());
+        return patchCnd(cndFile, "material", [&](CndPatch& patch) {
+            patch.setMaterials(materials);
+        });
+    }
 
-            ofstream.write(ifstream, /*offset=*/endOffsKeySection);
+    bool patchCndAnimations(const fs::path& cndFile, const UniqueTable<Animation>& animations)
+    {
+        LIBIM_TRACE_SCOPE_DETAIL("cndtool", "patchCndAnimations", cndFile.generic_string());
+        return patchCnd(cndFile, "keyframe", [&](CndPatch& patch) {
+            patch.setKeyframes(animations);
+        });
+    }
 
-            /* Write new file size to the beginning of the output cnd file*/
-            ofstream.seekBegin();
-            ofstream.write(safe_cast<uint32_t>(ofstream.size()));
+    /**
+     * Returns hash of NDY to CND conversion options.
+     * Output CND file sections depend on these options.
+     */
+    uint64_t ndyToCndOptionsHash(const StaticResourceNames& staticResources, SoundHandle soundHandleSeed, bool staticCnd, bool cleanUp, bool compressSounds, bool optimizeGeo, bool bakeLight)
+    {
+        Hasher64 h;
+        h.update(kVersion)
+         .updateValue(kCndFileVersion)
+         .updateValue(soundHandleSeed)
+         .updateValue(staticCnd)
+         .updateValue(cleanUp)
+         .updateValue(compressSounds)
+         .updateValue(optimizeGeo)
+         .updateValue(bakeLight);
+
+        if (cleanUp)
+        {
+            for (const auto* names : { &staticResources.keyframes, &staticResources.models, &staticResources.sounds, &staticResources.scripts, &staticResources.sprites })
+            {
+                // Atom sets are unordered, names are hashed in case-insensitive order to keep the hash stable
+                std::vector<std::string_view> sorted;
+                sorted.reserve(names->size());
+                for (const auto& name : *names) {
+                    sorted.push_back(name.str());
+                }
+                std::sort(sorted.begin(), sorted.end(), StringCaseInsensitiveLess());
 
-            /* Update materials info in CND header */
-            ofstream.seek(offsetof(CndHeader, numKeyframes));
-            ofstream.write(safe_cast<uint32_t>(animations.size())); // numKeyframes field
-            if(cndHeader.sizeKeyframes < animations.size()) {
-                ofstream.write(safe_cast<uint32_t>(animations.size())); // sizeKeyframes field
+                for (const auto& name : sorted) {
+                    h.update(name).update("\n"sv);
+                }
             }
 
-            /* Close IO file stream */
-            ifstream.close();
-            ofstream.close();
-
-            /* Rename patched file name to original name */
-            renameFile(patchedCndFile, cndFile);
-            return true;
-        }
-        catch(const std::exception& e)
-        {
-            std::cerr << "ERROR: Failed to patch keyframe section!\n";
-            std::cerr << "       Reason: " << e.what() << std::endl;
-            deleteFile(patchedCndFile);
-            return false;
+            for (std::size_t i = 0; i < staticResources.materials.size(); i++) {
+                h.update(staticResources.materials.key(i)).update("\n"sv);
+            }
         }
+        return h.digest();
     }
 
     /**
      * Converts NDY file to CND file.
+     * When incremental is true, only the CND sections which inputs changed since the previous conversion
+     * are built, the rest are copied from the previous CND file. See IncrementalCndBuild.
+     * When optimizeGeo is true, world vertices and texture vertices are welded and unused ones are removed.
+     * See optimizeGeometry.
+     * When bakeLight is true, surface vertex intensities are baked from sector and thing lights.
+     * See bakeVertexLight.
      */
-    bool convertNdyToCnd(const fs::path& ndyPath, const libim::VirtualFileSystem& vfs, const StaticResourceNames& staticResources, const fs::path& outDir, SoundHandle soundHandleSeed, bool staticCnd, bool verify, bool cleanUp, bool verbose)
+    bool convertNdyToCnd(const fs::path& ndyPath, const libim::VirtualFileSystem& vfs, const StaticResourceNames& staticResources, const fs::path& outDir, SoundHandle soundHandleSeed, bool staticCnd, bool verify, bool cleanUp, bool compressSounds, bool optimizeGeo, bool bakeLight, bool incremental, bool verbose)
     {
-        fs::path cndPath;
+        LIBIM_TRACE_SCOPE_DETAIL("cndtool", "convertNdyToCnd", ndyPath.generic_string());
+        const fs::path cndPath = outDir / "ndy" / ndyPath.filename().replace_extension("cnd");
         using namespace cmdutils;
         try
         {
             cleanUp = cleanUp && !staticCnd;
             verify  = verify  && !staticCnd;
 
-            const std::size_t total = (cleanUp ? 21U : 20U) + (verify ? 1U : 0U);
+            const std::size_t total = (cleanUp ? 21U : 20U) + (verify ? 1U : 0U) + (optimizeGeo ? 1U : 0U) + (bakeLight ? 1U : 0U);
             constexpr auto progressTitle = "Converting to CND ... "sv;
             std::size_t progress = 0;
             if (!verbose) printProgress(progressTitle, progress++, total);
 
-            LOG_DEBUG("Reading NDY file %", ndyPath);
-            auto world = ndyReadFile(ndyPath, vfs);
+            // World data is allocated from arena and freed at once at the end of conversion
+            utils::Arena arena;
+            std::unique_ptr<IncrementalCndBuild> ib;
+            NdyWorld world;
+            if (incremental)
+            {
+                LOG_DEBUG("Creating output CND file path %", cndPath);
+                makePath(cndPath);
+                ib = std::make_unique<IncrementalCndBuild>(ndyPath, cndPath, vfs,
+                    ndyToCndOptionsHash(staticResources, soundHandleSeed, staticCnd, cleanUp, compressSounds, optimizeGeo, bakeLight),
+                    optimizeGeo, bakeLight
+                );
+
+                LOG_DEBUG("Reading changed sections of NDY file %", ndyPath);
+                world = ib->readWorld(vfs, &arena);
+            }
+            else
+            {
+                LOG_DEBUG("Reading NDY file %", ndyPath);
+                world = ndyReadFile(ndyPath, vfs, &arena);
+            }
             LOG_DEBUG("NDY file was successfully read.");
+
+            const auto isDirty = [&](CndSection section) {
+                return !ib || ib->isDirty(section);
+            };
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             /* Clean up resources */
@@ -231,11 +239,45 @@ namespace cndtool {
             if (verify)
             {
                 LOG_DEBUG("Verifying loaded NDY file ...");
-                checkNdyWorld(world, staticResources);
+                checkNdyWorld(world, staticResources, ib ? ib->parsedSections() : CndSectionSet().set());
                 LOG_DEBUG("Finished verifying NDY file.");
                 if (!verbose) printProgress(progressTitle, progress++, total);
             }
 
+            /* Optimize geometry */
+            if (optimizeGeo)
+            {
+                // Sectors are parsed with georesource and rebuilt when georesource changes, see cndSectionInputs
+                if (isDirty(CndSection::Georesource))
+                {
+                    LOG_DEBUG("Optimizing world geometry ...");
+                    const auto stats = optimizeGeometry(world.georesource, world.sectors);
+                    LOG_INFO("Geometry optimization removed % of % vertices (% welded, % unused) and % of % texture vertices (% welded, % unused)",
+                        stats.numRemovedVertices(), stats.numVertices, stats.numWeldedVertices, stats.numUnusedVertices,
+                        stats.numRemovedTexVertices(), stats.numTexVertices, stats.numWeldedTexVertices, stats.numUnusedTexVertices
+                    );
+                    if (stats.numDegenerateSurfaces > 0) {
+                        LOG_WARNING("Geometry optimization left % surface(s) with less than 3 vertices", stats.numDegenerateSurfaces);
+                    }
+                }
+                if (!verbose) printProgress(progressTitle, progress++, total);
+            }
+
+            /* Bake light */
+            if (bakeLight)
+            {
+                // Sectors and things are parsed with georesource when light is baked, see cndSectionInputs
+                if (isDirty(CndSection::Georesource))
+                {
+                    LOG_DEBUG("Baking world vertex light ...");
+                    const auto stats = bakeVertexLight(world.georesource, world.sectors, world.things);
+                    LOG_INFO("Light baking lit % vertices of % surfaces by % lights, % of % shadow rays occluded",
+                        stats.numVertices, stats.numSurfaces, stats.numLights, stats.numOccludedRays, stats.numRays
+                    );
+                }
+                if (!verbose) printProgress(progressTitle, progress++, total);
+            }
+
             /* Load resources */
             LOG_DEBUG("Loading required CND resources ...");
             if (!verbose) printProgress(progressTitle, progress++, total);
@@ -244,91 +286,117 @@ namespace cndtool {
             SoundBank bank(sndbankIdx + 1);
             bank.setHandleSeed(soundHandleSeed);
             bank.setStaticTrack(sndbankIdx, staticCnd); // Don't forget for this one!
-            loadSounds(vfs, bank, sndbankIdx, world.sounds.second); // Always import to track 1 the normal world bank and to 0 the static world.
+            if (isDirty(CndSection::Sounds)) {
+                loadSounds(vfs, bank, sndbankIdx, world.sounds.second, compressSounds); // Always import to track 1 the normal world bank and to 0 the static world.
+            }
 
             if (!verbose) printProgress(progressTitle, progress++, total);
-            auto mats  = loadMaterials(vfs, world.materials.second);
-            auto anims = loadAnimations(vfs, world.keyframes.second);
+            Table<Material> mats;
+            if (isDirty(CndSection::Materials)) {
+                mats = loadMaterials(vfs, world.materials.second);
+            }
+
+            UniqueTable<Animation> anims;
+            if (isDirty(CndSection::Keyframes)) {
+                anims = loadAnimations(vfs, world.keyframes.second);
+            }
 
             LOG_DEBUG("Loading resources succeed!");
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             /* Write CND file */
-            cndPath = outDir / "ndy" / ndyPath.filename().replace_extension("cnd");
-            LOG_DEBUG("Creating output CND file path %", cndPath);
-            makePath(cndPath);
-            OutputFileStream cnds(cndPath, /*truncate=*/true);
+            if (!ib)
+            {
+                LOG_DEBUG("Creating output CND file path %", cndPath);
+                makePath(cndPath);
+            }
+            OutputFileStream cnds(ib ? ib->outputPath() : cndPath, /*truncate=*/true);
 
             /* Move beyond file header */
             cnds.seek(sizeof(CndHeader));
 
             /* Write sections */
-            LOG_DEBUG("Writing CND section 'Sounds' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Sounds(cnds, bank, sndbankIdx);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            const auto writeSection = [&](CndSection section, std::string_view name, auto&& writeFunc)
+            {
+                if (isDirty(section))
+                {
+                    LOG_DEBUG("Writing CND section '%' at offset: %", name, utils::to_string<16>(cnds.tell()));
+                    writeFunc();
+                }
+                else
+                {
+                    LOG_DEBUG("Copying unchanged CND section '%' to offset: %", name, utils::to_string<16>(cnds.tell()));
+                    ib->copySection(cnds, section);
+                }
+                if (!verbose) printProgress(progressTitle, progress++, total);
+            };
 
-            LOG_DEBUG("Writing CND section 'Materials' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Materials(cnds, mats);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Sounds, "Sounds", [&]{
+                CND::writeSection_Sounds(cnds, bank, sndbankIdx);
+            });
 
-            LOG_DEBUG("Writing CND section 'GeoResource' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Georesource(cnds, world.georesource);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Materials, "Materials", [&]{
+                CND::writeSection_Materials(cnds, mats);
+            });
 
-            LOG_DEBUG("Writing CND section 'Sectors' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Sectors(cnds, world.sectors);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Georesource, "GeoResource", [&]{
+                CND::writeSection_Georesource(cnds, world.georesource);
+            });
 
-            LOG_DEBUG("Writing CND section 'AIClasses' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_AIClasses(cnds, world.aiClasses.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Sectors, "Sectors", [&]{
+                CND::writeSection_Sectors(cnds, world.sectors);
+            });
 
-            LOG_DEBUG("Writing CND section 'Models' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Models(cnds, world.models.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::AIClasses, "AIClasses", [&]{
+                CND::writeSection_AIClasses(cnds, world.aiClasses.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'Sprites' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Sprites(cnds, world.sprites.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Models, "Models", [&]{
+                CND::writeSection_Models(cnds, world.models.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'Keyframes' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Keyframes(cnds, anims);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Sprites, "Sprites", [&]{
+                CND::writeSection_Sprites(cnds, world.sprites.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'AnimClasses' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_AnimClasses(cnds, world.animClasses.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Keyframes, "Keyframes", [&]{
+                CND::writeSection_Keyframes(cnds, anims);
+            });
 
-            LOG_DEBUG("Writing CND section 'SoundClasses' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_SoundClasses(cnds, world.soundClasses.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::AnimClasses, "AnimClasses", [&]{
+                CND::writeSection_AnimClasses(cnds, world.animClasses.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'COGScripts' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_CogScripts(cnds, world.cogScripts.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::SoundClasses, "SoundClasses", [&]{
+                CND::writeSection_SoundClasses(cnds, world.soundClasses.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'COGs' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Cogs(cnds, world.cogs.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::CogScripts, "COGScripts", [&]{
+                CND::writeSection_CogScripts(cnds, world.cogScripts.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'Templates' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Templates(cnds, world.templates.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Cogs, "COGs", [&]{
+                CND::writeSection_Cogs(cnds, world.cogs.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'Things' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_Things(cnds, world.things, world.templates.second);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Templates, "Templates", [&]{
+                CND::writeSection_Templates(cnds, world.templates.second);
+            });
 
-            LOG_DEBUG("Writing CND section 'PVS' at offset: %", utils::to_string<16>(cnds.tell()));
-            CND::writeSection_PVS(cnds, world.pvs);
-            if (!verbose) printProgress(progressTitle, progress++, total);
+            writeSection(CndSection::Things, "Things", [&]{
+                CND::writeSection_Things(cnds, world.things, world.templates.second);
+            });
+
+            writeSection(CndSection::PVS, "PVS", [&]{
+                CND::writeSection_PVS(cnds, world.pvs);
+            });
 
             // Init Header and write it to file
             LOG_DEBUG("Initializing CND file header ...");
             CndHeader header = world.header;
             header.fileSize  = cnds.tell();
             header.copyright = kWorldFileCopyright;
-            header.filePath  = CndResourceName(cnds.name());
+            header.filePath  = CndResourceName(cndPath.filename().string());
             header.version   = kCndFileVersion;
 
             header.state |= Flags(CndWorldState::UpdateFog) | CndWorldState::InitHUD;
@@ -403,10 +471,19 @@ namespace cndtool {
                 header.sizePVS = safe_cast<uint32_t>(world.pvs.size());
             }
 
+            if (ib) {
+                ib->updateHeader(header);
+            }
+
             // Write header to stream
             LOG_DEBUG("Writing CND file header to stream");
             cnds.seek(0);
             cnds.write(header);
+            cnds.close();
+
+            if (ib) {
+                ib->commit(vfs);
+            }
             LOG_DEBUG("Finish converting NDY to CND.");
 
             if (!verbose) printProgress(progressTitle, progress++, total);
@@ -417,7 +494,9 @@ namespace cndtool {
         {
             std::cerr << std::endl;
             printError(e.what());
-            deleteFile(cndPath);
+            if (!incremental) {
+                deleteFile(cndPath);
+            }
             return false;
         }
     }
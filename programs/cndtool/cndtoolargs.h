@@ -1,7 +1,6 @@
 #ifndef CNDTOOL_CNDTOOLARGS_H
 #define CNDTOOL_CNDTOOLARGS_H
 #include <filesystem>
-#include <stdexcept>
 
 #include <libim/common.h>
 #include <libim/utils/utils.h>
@@ -54,20 +53,14 @@ namespace cndtool {
             }
             else if(positionalArgs().empty()) // try parsing cnd or ndy file paths
             {
-                if(libim::fileExtMatch(token, ".cnd"))
+                if(libim::fileExtMatch(token, ".cnd") && cndfile_.empty())
                 {
-                    if (!cndfile_.empty()) {
-                        throw std::invalid_argument("Multiple CND file paths");
-                    }
-                    cndfile_ = token;
+                    cndfile_ = token; // Any following CND file path is stored as positional argument
                     return;
                 }
-                else if(libim::fileExtMatch(token, ".ndy"))
+                else if(libim::fileExtMatch(token, ".ndy") && ndyfile_.empty())
                 {
-                    if (!ndyfile_.empty()) {
-                        throw std::invalid_argument("Multiple NDY file paths");
-                    }
-                    ndyfile_ = token;
+                    ndyfile_ = token; // Any following NDY file path is stored as positional argument
                     return;
                 }
             }
@@ -0,0 +1,451 @@
+#ifndef CNDTOOL_GLTF_H
+#define CNDTOOL_GLTF_H
+#include <libim/content/asset/material/texture.h>
+#include <libim/content/asset/material/texutils.h>
+#include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/filestream.h>
+#include <libim/utils/utils.h>
+
+#include "config.h"
+#include "obj.h"
+#include "resource.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cndtool {
+    namespace detail {
+        constexpr uint32_t kGlbMagic        = 0x46546C67; // "glTF"
+        constexpr uint32_t kGlbVersion      = 2;
+        constexpr uint32_t kGlbChunkJson    = 0x4E4F534A; // "JSON"
+        constexpr uint32_t kGlbChunkBin     = 0x004E4942; // "BIN\0"
+        constexpr uint32_t kGlbHeaderSize   = 12;
+        constexpr uint32_t kGlbChunkHdrSize = 8;
+
+        constexpr uint32_t kGltfArrayBuffer        = 34962;
+        constexpr uint32_t kGltfElementArrayBuffer = 34963;
+        constexpr uint32_t kGltfFloat              = 5126;
+        constexpr uint32_t kGltfUnsignedInt        = 5125;
+
+        struct GlbVertex
+        {
+            std::array<float, 3> pos;
+            std::array<float, 3> normal;
+            std::array<float, 2> uv;
+        };
+        static_assert(sizeof(GlbVertex) == 32, "GlbVertex must be tightly packed");
+
+        struct GlbPrimitive
+        {
+            std::size_t material;
+            std::vector<GlbVertex> vertices;
+            std::vector<uint32_t> indices;
+            std::unordered_map<uint64_t, uint32_t> vertexMap; // (vertIdx, uvIdx) => index in vertices
+            std::array<float, 3> min { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+            std::array<float, 3> max { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+        };
+
+        struct GlbMaterial
+        {
+            std::string name;
+            const libim::content::asset::Material* mat = nullptr;
+            bool transparent = false;
+            std::optional<std::size_t> image; // index of embedded PNG image
+        };
+
+        inline void glbAlign(std::vector<libim::byte_t>& buffer, libim::byte_t pad = 0)
+        {
+            buffer.resize((buffer.size() + 3) & ~std::size_t(3), pad);
+        }
+
+        inline void glbAppend(std::vector<libim::byte_t>& buffer, const void* data, std::size_t size)
+        {
+            const auto p = static_cast<const libim::byte_t*>(data);
+            buffer.insert(buffer.end(), p, p + size);
+        }
+
+        inline void jsonAppend(std::string& json, float v)
+        {
+            std::array<char, 32> buf;
+            const auto r = std::to_chars(buf.data(), buf.data() + buf.size(), std::isfinite(v) ? v : 0.0f);
+            json.append(buf.data(), r.ptr);
+        }
+
+        inline void jsonAppend(std::string& json, std::size_t v)
+        {
+            json += std::to_string(v);
+        }
+
+        inline void jsonAppendString(std::string& json, std::string_view str)
+        {
+            constexpr std::string_view digits = "0123456789abcdef";
+            json += '"';
+            for (const char c : str)
+            {
+                const auto uc = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    json += '\\';
+                    json += c;
+                }
+                else if (uc < 0x20)
+                {
+                    json += "\\u00";
+                    json += digits[uc >> 4];
+                    json += digits[uc & 0xF];
+                }
+                else {
+                    json += c;
+                }
+            }
+            json += '"';
+        }
+
+        inline void jsonAppendVec(std::string& json, const std::array<float, 3>& v)
+        {
+            json += '[';
+            for (std::size_t i = 0; i < v.size(); i++)
+            {
+                if (i > 0) json += ',';
+                jsonAppend(json, v[i]);
+            }
+            json += ']';
+        }
+    }
+
+    /**
+     * Extracts level geometry from CND file and writes it as binary glTF 2.0 (.glb) file.
+     * Surfaces are grouped into one mesh primitive per material with interleaved
+     * position, normal and UV vertex buffer and triangle index buffer.
+     * If extractMat is true, surface textures are embedded into the file as PNG images.
+     *
+     * @param inCndPath       - path to CND file.
+     * @param staticResources - static resource names, used to name materials not found in jones3dstatic.cnd.
+     * @param outFolder       - output folder.
+     * @param extractMat      - embed surface textures.
+     * @param pngOptions      - PNG encoder options of embedded textures.
+     * @throw std::runtime_error if CND file has no geometry or no surface with at least 3 vertices.
+     */
+    void convertCndToGlb(const std::filesystem::path& inCndPath, const StaticResourceNames& staticResources, const std::filesystem::path& outFolder, bool extractMat, const libim::content::asset::PngWriteOptions& pngOptions = {})
+    {
+        using namespace libim;
+        using namespace libim::content::asset;
+        using namespace detail;
+        namespace fs = std::filesystem;
+
+        InputFileStream icnds(inCndPath);
+        auto mats   = CND::readMaterials(icnds);
+        auto geores = CND::readGeoresource(icnds);
+        if (geores.vertices.empty()) {
+            throw std::runtime_error("CND file has no geometry resources");
+        }
+
+        // Load materials from jones3dstatic.cnd
+        fs::path scndPath = inCndPath;
+        scndPath.replace_filename(kDefaultStaticResourcesFilename);
+        const auto psmats = loadStaticCndMaterials(scndPath);
+        const Table<Material>& smats = *psmats;
+        if (!fileExists(scndPath)) {
+            LOG_WARNING("File % was not found. Some surfaces might have incomplete texture information.", kDefaultStaticResourcesFilename);
+        }
+
+        // Build mesh primitives
+        const auto normals = getVertexNormals(geores);
+        std::vector<GlbMaterial> glbMats;
+        std::unordered_map<std::string, std::size_t> glbMatMap;  // mat name => index in glbMats
+        std::vector<GlbPrimitive> prims; // one primitive per material in glbMats
+
+        auto getPrimitive = [&](std::optional<SurfaceMaterial> sm) -> GlbPrimitive& {
+            const auto name = sm ? sm->name : std::string("transparent");
+            auto [it, inserted] = glbMatMap.try_emplace(name, glbMats.size());
+            if (inserted)
+            {
+                auto& m = glbMats.emplace_back();
+                m.name        = name;
+                m.mat         = sm ? sm->mat : nullptr;
+                m.transparent = !sm.has_value();
+                prims.emplace_back().material = it->second;
+            }
+            return prims[it->second];
+        };
+
+        for (const auto& s : geores.surfaces)
+        {
+            if (s.vertices.size() < 3) {
+                continue;
+            }
+
+            auto& prim = getPrimitive(getSurfaceMaterial(s, mats, smats, staticResources));
+            std::array<uint32_t, 2> fan;
+            for (std::size_t i = 0; i < s.vertices.size(); i++)
+            {
+                const auto& v    = s.vertices[i];
+                const auto uvIdx = fromOptionalIdx(v.uvIdx);
+                const auto key   = (uint64_t(v.vertIdx) << 32) | uint32_t(uvIdx + 1);
+                auto [it, inserted] = prim.vertexMap.try_emplace(key, static_cast<uint32_t>(prim.vertices.size()));
+                if (inserted)
+                {
+                    const auto pos = getObjCoords(geores.vertices.at(v.vertIdx));
+                    auto n = getObjCoords(normals[v.vertIdx]);
+                    const float len = std::sqrt(n.x() * n.x() + n.y() * n.y() + n.z() * n.z());
+                    n = len > 0.0f ? n / len : getObjCoords(s.normal);
+
+                    // Note: Unlike OBJ, glTF UV origin is at the top left corner same as in Mat texture, hence UV.y is not flipped.
+                    const auto uv = uvIdx >= 0 ? geores.texVertices.at(static_cast<std::size_t>(uvIdx)) : Vector2f(0.0f, 0.0f);
+                    prim.vertices.push_back(GlbVertex{
+                        { pos.x(), pos.y(), pos.z() },
+                        { n.x(), n.y(), n.z() },
+                        { uv.x(), uv.y() }
+                    });
+
+                    for (std::size_t c = 0; c < 3; c++)
+                    {
+                        prim.min[c] = std::min(prim.min[c], pos.at(c));
+                        prim.max[c] = std::max(prim.max[c], pos.at(c));
+                    }
+                }
+
+                // Triangulate surface polygon as triangle fan
+                if (i == 0) {
+                    fan[0] = it->second;
+                }
+                else if (i == 1) {
+                    fan[1] = it->second;
+                }
+                else
+                {
+                    prim.indices.insert(prim.indices.end(), { fan[0], fan[1], it->second });
+                    fan[1] = it->second;
+                }
+            }
+        }
+
+        // glTF requires mesh to have at least one primitive and buffer views to be non-empty
+        if (prims.empty()) {
+            throw std::runtime_error("CND file has no surface with at least 3 vertices");
+        }
+
+        // Write binary buffer: vertices, indices, images
+        std::vector<byte_t> bin;
+        std::vector<std::size_t> vertexOffsets, indexOffsets;
+        for (const auto& p : prims)
+        {
+            vertexOffsets.push_back(bin.size());
+            glbAppend(bin, p.vertices.data(), p.vertices.size() * sizeof(GlbVertex));
+        }
+
+        const auto indicesOffset = bin.size();
+        for (const auto& p : prims)
+        {
+            indexOffsets.push_back(bin.size() - indicesOffset);
+            glbAppend(bin, p.indices.data(), p.indices.size() * sizeof(uint32_t));
+        }
+        const auto indicesSize = bin.size() - indicesOffset;
+
+        std::vector<std::pair<std::size_t, std::size_t>> imageViews; // offset, size
+        if (extractMat)
+        {
+            for (auto& m : glbMats)
+            {
+                if (m.transparent) {
+                    continue;
+                }
+                if (!m.mat || m.mat->isEmpty())
+                {
+                    LOG_WARNING("Couldn't find material: '%'", m.name);
+                    continue;
+                }
+
+                glbAlign(bin);
+                const auto offset = bin.size();
+                OutputBinaryStream bs(bin);
+                bs.seekEnd();
+                pngWrite(bs, m.mat->cells().at(0), pngOptions);
+                m.image = imageViews.size();
+                imageViews.emplace_back(offset, bin.size() - offset);
+            }
+        }
+        glbAlign(bin);
+
+        // Write JSON
+        std::string json;
+        json.reserve(1024 + prims.size() * 512);
+        json += R"({"asset":{"version":"2.0","generator":)";
+        jsonAppendString(json, std::string(kProgramName) + " v" + std::string(kVersion));
+        json += R"(},"scene":0,"scenes":[{"nodes":[0]}],"nodes":[{"mesh":0,"name":)";
+        jsonAppendString(json, inCndPath.stem().string());
+        json += "}]";
+
+        json += R"(,"buffers":[{"byteLength":)";
+        jsonAppend(json, bin.size());
+        json += "}]";
+
+        json += R"(,"bufferViews":[{"buffer":0,"byteOffset":0,"byteLength":)";
+        jsonAppend(json, indicesOffset);
+        json += R"(,"byteStride":32,"target":)";
+        jsonAppend(json, std::size_t(kGltfArrayBuffer));
+        json += R"(},{"buffer":0,"byteOffset":)";
+        jsonAppend(json, indicesOffset);
+        json += R"(,"byteLength":)";
+        jsonAppend(json, indicesSize);
+        json += R"(,"target":)";
+        jsonAppend(json, std::size_t(kGltfElementArrayBuffer));
+        json += "}";
+        for (const auto& [offset, size] : imageViews)
+        {
+            json += R"(,{"buffer":0,"byteOffset":)";
+            jsonAppend(json, offset);
+            json += R"(,"byteLength":)";
+            jsonAppend(json, size);
+            json += "}";
+        }
+        json += "]";
+
+        // Accessors: position, normal, uv and indices per primitive
+        json += R"(,"accessors":[)";
+        for (std::size_t i = 0; i < prims.size(); i++)
+        {
+            const auto& p = prims[i];
+            auto vertexAccessor = [&](std::size_t attrOffset, std::string_view type) {
+                json += R"({"bufferView":0,"byteOffset":)";
+                jsonAppend(json, vertexOffsets[i] + attrOffset);
+                json += R"(,"componentType":)";
+                jsonAppend(json, std::size_t(kGltfFloat));
+                json += R"(,"count":)";
+                jsonAppend(json, p.vertices.size());
+                json += R"(,"type":")";
+                json += type;
+                json += '"';
+            };
+
+            if (i > 0) json += ',';
+            vertexAccessor(offsetof(GlbVertex, pos), "VEC3");
+            json += R"(,"min":)";
+            jsonAppendVec(json, p.min);
+            json += R"(,"max":)";
+            jsonAppendVec(json, p.max);
+            json += "},";
+            vertexAccessor(offsetof(GlbVertex, normal), "VEC3");
+            json += "},";
+            vertexAccessor(offsetof(GlbVertex, uv), "VEC2");
+            json += "},";
+
+            json += R"({"bufferView":1,"byteOffset":)";
+            jsonAppend(json, indexOffsets[i]);
+            json += R"(,"componentType":)";
+            jsonAppend(json, std::size_t(kGltfUnsignedInt));
+            json += R"(,"count":)";
+            jsonAppend(json, p.indices.size());
+            json += R"(,"type":"SCALAR"})";
+        }
+        json += "]";
+
+        json += R"(,"meshes":[{"primitives":[)";
+        for (std::size_t i = 0; i < prims.size(); i++)
+        {
+            if (i > 0) json += ',';
+            json += R"({"attributes":{"POSITION":)";
+            jsonAppend(json, i * 4);
+            json += R"(,"NORMAL":)";
+            jsonAppend(json, i * 4 + 1);
+            json += R"(,"TEXCOORD_0":)";
+            jsonAppend(json, i * 4 + 2);
+            json += R"(},"indices":)";
+            jsonAppend(json, i * 4 + 3);
+            json += R"(,"material":)";
+            jsonAppend(json, prims[i].material);
+            json += "}";
+        }
+        json += "]}]";
+
+        json += R"(,"materials":[)";
+        for (std::size_t i = 0; i < glbMats.size(); i++)
+        {
+            const auto& m = glbMats[i];
+            if (i > 0) json += ',';
+            json += R"({"name":)";
+            jsonAppendString(json, m.name);
+            json += R"(,"pbrMetallicRoughness":{)";
+            if (m.image) {
+                json += R"("baseColorTexture":{"index":)";
+                jsonAppend(json, *m.image);
+                json += "},";
+            }
+            else if (m.transparent) {
+                json += R"("baseColorFactor":[1,1,1,0],)";
+            }
+            json += R"("metallicFactor":0,"roughnessFactor":1})";
+            if (m.transparent) {
+                json += R"(,"alphaMode":"BLEND")";
+            }
+            else if (m.mat && !m.mat->isEmpty() && m.mat->format().alphaBPP > 0) {
+                json += m.mat->format().alphaBPP == 1 ? R"(,"alphaMode":"MASK")" : R"(,"alphaMode":"BLEND")";
+            }
+            json += "}";
+        }
+        json += "]";
+
+        if (!imageViews.empty())
+        {
+            json += R"(,"images":[)";
+            for (std::size_t i = 0; i < imageViews.size(); i++)
+            {
+                if (i > 0) json += ',';
+                json += R"({"bufferView":)";
+                jsonAppend(json, i + 2);
+                json += R"(,"mimeType":"image/png"})";
+            }
+            json += R"(],"textures":[)";
+            for (std::size_t i = 0; i < imageViews.size(); i++)
+            {
+                if (i > 0) json += ',';
+                json += R"({"source":)";
+                jsonAppend(json, i);
+                json += "}";
+            }
+            json += "]";
+        }
+        json += "}";
+        json.resize((json.size() + 3) & ~std::size_t(3), ' ');
+
+        // Write GLB file
+        const auto totalSize = kGlbHeaderSize + 2 * kGlbChunkHdrSize + json.size() + bin.size();
+        if (totalSize > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Level geometry is too big for GLB file");
+        }
+
+        const auto glbOutPath = outFolder / fs::path(inCndPath).filename().replace_extension(".glb");
+        makePath(glbOutPath);
+
+        OutputFileStream glbs(glbOutPath, /*truncate=*/true);
+        glbs.write(kGlbMagic);
+        glbs.write(kGlbVersion);
+        glbs.write(static_cast<uint32_t>(totalSize));
+
+        glbs.write(static_cast<uint32_t>(json.size()));
+        glbs.write(kGlbChunkJson);
+        if (glbs.write(reinterpret_cast<const byte_t*>(json.data()), json.size()) != json.size()) {
+            throw std::runtime_error("Failed to write file " + glbOutPath.filename().string());
+        }
+
+        glbs.write(static_cast<uint32_t>(bin.size()));
+        glbs.write(kGlbChunkBin);
+        if (glbs.write(bin.data(), bin.size()) != bin.size()) {
+            throw std::runtime_error("Failed to write file " + glbOutPath.filename().string());
+        }
+    }
+}
+
+#endif // CNDTOOL_GLTF_H
@@ -0,0 +1,653 @@
+#ifndef CNDTOOL_INCREMENTAL_H
+#define CNDTOOL_INCREMENTAL_H
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <libim/common.h>
+#include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
+#include <libim/content/text/text_resource_reader.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/filestream.h>
+#include <libim/io/vfs.h>
+#include <libim/log/log.h>
+#include <libim/trace/trace.h>
+#include <libim/utils/hash.h>
+#include <libim/utils/utils.h>
+
+#include "ndy.h"
+#include "resource.h"
+
+/**
+ * Incremental NDY to CND conversion.
+ *
+ * The manifest file stored next to the output CND file records the content hash
+ * of every NDY section and of every asset file referenced by the CND sections.
+ * On the next conversion only the CND sections which inputs changed are parsed
+ * and serialized again, the rest are copied byte-for-byte from the previous CND file.
+ */
+
+namespace cndtool {
+    namespace fs = std::filesystem;
+    using namespace libim;
+    using namespace libim::content::asset;
+    using namespace libim::content::text;
+    using namespace libim::utils;
+
+    constexpr std::string_view kExtCndManifest = ".manifest";
+
+    constexpr std::size_t sectionIdx(CndSection section)
+    {
+        return static_cast<std::size_t>(section);
+    }
+
+    /**
+     * Returns CND section which is built from NDY section.
+     * Both, NDY copyright and header sections map to CndSection::Header.
+     */
+    std::optional<CndSection> ndySectionToCndSection(std::string_view section)
+    {
+        static const std::array<std::pair<std::string_view, CndSection>, kNumCndSections + 1> map = {{
+            { NDY::kSectionCopyright  , CndSection::Header       },
+            { NDY::kSectionHeader     , CndSection::Header       },
+            { NDY::kSectionSounds     , CndSection::Sounds       },
+            { NDY::kSectionMaterials  , CndSection::Materials    },
+            { NDY::kSectionGeoresource, CndSection::Georesource  },
+            { NDY::kSectionSectors    , CndSection::Sectors      },
+            { NDY::kSectionAIClass    , CndSection::AIClasses    },
+            { NDY::kSectionModels     , CndSection::Models       },
+            { NDY::kSectionSprites    , CndSection::Sprites      },
+            { NDY::kSectionKeyframes  , CndSection::Keyframes    },
+            { NDY::kSectionAnimClass  , CndSection::AnimClasses  },
+            { NDY::kSectionSoundClass , CndSection::SoundClasses },
+            { NDY::kSectionCogScripts , CndSection::CogScripts   },
+            { NDY::kSectionCogs       , CndSection::Cogs         },
+            { NDY::kSectionTemplates  , CndSection::Templates    },
+            { NDY::kSectionThings     , CndSection::Things       },
+            { NDY::kSectionPVS        , CndSection::PVS          }
+        }};
+
+        for (const auto& [name, cs] : map)
+        {
+            if (iequal(name, section)) {
+                return cs;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Returns NDY sections (mapped to CND sections) which are parsed to build the CND section.
+     * @param section     - CND section.
+     * @param optimizeGeo - true if world geometry is optimized, see optimizeGeometry.
+     * @param bakeLight   - true if surface vertex light is baked, see bakeVertexLight.
+     */
+    CndSectionSet cndSectionInputs(CndSection section, bool optimizeGeo, bool bakeLight)
+    {
+        CndSectionSet inputs;
+        inputs.set(sectionIdx(section));
+        switch (section)
+        {
+            case CndSection::Georesource: // surface material indices are remapped on static resources clean up
+                inputs.set(sectionIdx(CndSection::Materials));
+                if (optimizeGeo || bakeLight) { // vertices referenced by sectors are kept, sector lights are baked
+                    inputs.set(sectionIdx(CndSection::Sectors));
+                }
+                if (bakeLight) { // surface vertex intensities are baked from thing lights
+                    inputs.set(sectionIdx(CndSection::Things));
+                    inputs.set(sectionIdx(CndSection::Templates));
+                }
+                break;
+            case CndSection::Sectors:
+                if (optimizeGeo) { // sector vertex indices are remapped
+                    inputs.set(sectionIdx(CndSection::Georesource));
+                }
+                break;
+            case CndSection::Cogs:
+                inputs.set(sectionIdx(CndSection::CogScripts));
+                break;
+            case CndSection::Things:
+                inputs.set(sectionIdx(CndSection::Templates));
+                break;
+            case CndSection::PVS:
+                inputs.set(sectionIdx(CndSection::Sectors));
+                break;
+            default:
+                break;
+        }
+        return inputs;
+    }
+
+    /** Returns search folders of asset files referenced by CND section, or empty list if section doesn't reference any. */
+    std::vector<fs::path> cndSectionAssetDirs(CndSection section)
+    {
+        switch (section)
+        {
+            case CndSection::Sounds:    return { kSoundDir1, kSoundDir2, kSoundDir3 };
+            case CndSection::Materials: return { kMaterialDir };
+            case CndSection::Keyframes: return { kAnimationDir1, kAnimationDir2 };
+            case CndSection::Cogs:      return { kCogScriptDir };
+            default:                    return {};
+        }
+    }
+
+    /** Returns content hash of asset file or 0 if file doesn't exist. */
+    uint64_t hashAssetFile(const VirtualFileSystem& vfs, CndSection section, std::string_view filename)
+    {
+        try
+        {
+            auto file = searchFile(vfs, cndSectionAssetDirs(section), filename);
+            return hash64(*file);
+        }
+        catch (const std::exception&) {
+            return 0;
+        }
+    }
+
+    /**
+     * Copies header fields which are computed from the section data.
+     */
+    void copyCndHeaderSectionFields(CndSection section, const CndHeader& src, CndHeader& dst)
+    {
+        switch (section)
+        {
+            case CndSection::Sounds:
+                dst.numSounds = src.numSounds;
+                break;
+            case CndSection::Materials:
+                dst.numMaterials  = src.numMaterials;
+                dst.sizeMaterials = src.sizeMaterials;
+                break;
+            case CndSection::Georesource:
+                dst.numVertices    = src.numVertices;
+                dst.numTexVertices = src.numTexVertices;
+                dst.numAdjoins     = src.numAdjoins;
+                dst.numSurfaces    = src.numSurfaces;
+                break;
+            case CndSection::Sectors:
+                dst.numSectors = src.numSectors;
+                break;
+            case CndSection::AIClasses:
+                dst.numAIClasses  = src.numAIClasses;
+                dst.sizeAIClasses = src.sizeAIClasses;
+                break;
+            case CndSection::Models:
+                dst.numModels  = src.numModels;
+                dst.sizeModels = src.sizeModels;
+                break;
+            case CndSection::Sprites:
+                dst.numSprites  = src.numSprites;
+                dst.sizeSprites = src.sizeSprites;
+                break;
+            case CndSection::Keyframes:
+                dst.numKeyframes  = src.numKeyframes;
+                dst.sizeKeyframes = src.sizeKeyframes;
+                break;
+            case CndSection::AnimClasses:
+                dst.numPuppets  = src.numPuppets;
+                dst.sizePuppets = src.sizePuppets;
+                break;
+            case CndSection::SoundClasses:
+                dst.numSoundClasses  = src.numSoundClasses;
+                dst.sizeSoundClasses = src.sizeSoundClasses;
+                break;
+            case CndSection::CogScripts:
+                dst.numCogScripts  = src.numCogScripts;
+                dst.sizeCogScripts = src.sizeCogScripts;
+                break;
+            case CndSection::Cogs:
+                dst.numCogs  = src.numCogs;
+                dst.sizeCogs = src.sizeCogs;
+                break;
+            case CndSection::Templates:
+                dst.numThingTemplates  = src.numThingTemplates;
+                dst.sizeThingTemplates = src.sizeThingTemplates;
+                break;
+            case CndSection::Things:
+                dst.numThings = src.numThings;
+                break;
+            case CndSection::PVS:
+                dst.sizePVS = src.sizePVS;
+                break;
+            default:
+                break;
+        }
+    }
+
+
+    /** Location of a section in the NDY file text */
+    struct NdySectionRange
+    {
+        std::string name;
+        std::size_t offset = 0;
+        std::size_t size   = 0;
+        std::size_t line   = 1; // line number of section label
+    };
+
+    /** Raw NDY file text split into sections */
+    struct NdyFileIndex
+    {
+        ByteArray data;
+        std::vector<NdySectionRange> sections;
+    };
+
+    /**
+     * Reads NDY file and splits its text into sections.
+     * Section text starts at the line with section label and ends before the next section label.
+     * The text is not tokenized.
+     */
+    NdyFileIndex ndyIndexFile(const fs::path& ndyPath)
+    {
+        LIBIM_TRACE_SCOPE_DETAIL("cndtool", "ndyIndexFile", ndyPath.generic_string());
+        NdyFileIndex index;
+        {
+            InputFileStream ifs(ndyPath);
+            index.data = ifs.read(ifs.size());
+        }
+
+        constexpr std::string_view ws = " \t\r";
+        const std::string_view text(reinterpret_cast<const char*>(index.data.data()), index.data.size());
+        std::size_t line = 1;
+        for (std::size_t pos = 0; pos < text.size(); line++)
+        {
+            auto eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) {
+                eol = text.size();
+            }
+
+            auto l = text.substr(pos, eol - pos);
+            l.remove_prefix(std::min(l.find_first_not_of(ws), l.size()));
+            if (l.size() > kResName_Section.size() && iequal(l.substr(0, kResName_Section.size()), kResName_Section))
+            {
+                l.remove_prefix(kResName_Section.size());
+                l.remove_prefix(std::min(l.find_first_not_of(ws), l.size()));
+                if (!l.empty() && l.front() == ':')
+                {
+                    l.remove_prefix(1);
+                    l.remove_prefix(std::min(l.find_first_not_of(ws), l.size()));
+                    l = l.substr(0, l.find_first_of(" \t\r#"));
+
+                    if (!index.sections.empty()) {
+                        index.sections.back().size = pos - index.sections.back().offset;
+                    }
+                    index.sections.push_back({ std::string(l), pos, 0, line });
+                }
+            }
+            pos = eol + 1;
+        }
+
+        if (!index.sections.empty()) {
+            index.sections.back().size = text.size() - index.sections.back().offset;
+        }
+        return index;
+    }
+
+
+    /** Incremental conversion manifest */
+    struct CndBuildManifest
+    {
+        static constexpr std::string_view kMagic = "cndtool-manifest";
+        static constexpr uint32_t kVersion       = 1;
+
+        uint64_t optionsHash = 0;
+        std::size_t cndSize  = 0;
+        uint64_t cndHash     = 0;
+        std::array<uint64_t, kNumCndSections> ndyHashes {};                                 // hash of NDY sections mapped to CND section
+        std::array<std::vector<std::pair<std::string, uint64_t>>, kNumCndSections> assets;  // hash of asset files referenced by CND section
+
+        /** Loads manifest from file. Returns std::nullopt if file doesn't exist or is invalid. */
+        static std::optional<CndBuildManifest> load(const fs::path& path)
+        {
+            if (!fileExists(path)) {
+                return std::nullopt;
+            }
+
+            try
+            {
+                InputFileStream ifs(path);
+                const auto data = ifs.read(ifs.size());
+                std::istringstream ss(std::string(data.begin(), data.end()));
+
+                CndBuildManifest m;
+                std::string magic;
+                uint32_t version = 0;
+                ss >> magic >> version;
+                if (magic != kMagic || version != kVersion) {
+                    return std::nullopt;
+                }
+
+                const auto findSection = [](std::string_view name) {
+                    auto it = std::find(kCndSectionNames.begin(), kCndSectionNames.end(), name);
+                    if (it == kCndSectionNames.end()) {
+                        throw std::runtime_error("Invalid section name");
+                    }
+                    return static_cast<std::size_t>(std::distance(kCndSectionNames.begin(), it));
+                };
+
+                std::string key, section, hash;
+                while (ss >> key)
+                {
+                    if (key == "options") {
+                        ss >> hash;
+                        m.optionsHash = std::stoull(hash, nullptr, 16);
+                    }
+                    else if (key == "cnd") {
+                        ss >> m.cndSize >> hash;
+                        m.cndHash = std::stoull(hash, nullptr, 16);
+                    }
+                    else if (key == "ndy") {
+                        ss >> section >> hash;
+                        m.ndyHashes.at(findSection(section)) = std::stoull(hash, nullptr, 16);
+                    }
+                    else if (key == "asset")
+                    {
+                        std::string name;
+                        ss >> section >> hash;
+                        std::getline(ss >> std::ws, name);
+                        m.assets.at(findSection(section)).emplace_back(std::move(name), std::stoull(hash, nullptr, 16));
+                    }
+                    else {
+                        return std::nullopt;
+                    }
+
+                    if (ss.fail()) {
+                        return std::nullopt;
+                    }
+                }
+                return m;
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Failed to read manifest file '%': %", path, e.what());
+                return std::nullopt;
+            }
+        }
+
+        void save(const fs::path& path) const
+        {
+            std::ostringstream ss;
+            ss << kMagic << " " << kVersion << "\n";
+            ss << "options " << hashToString(optionsHash) << "\n";
+            ss << "cnd " << cndSize << " " << hashToString(cndHash) << "\n";
+            for (std::size_t i = 0; i < kNumCndSections; i++) {
+                ss << "ndy " << kCndSectionNames.at(i) << " " << hashToString(ndyHashes.at(i)) << "\n";
+            }
+
+            for (std::size_t i = 0; i < kNumCndSections; i++)
+            {
+                for (const auto& [name, hash] : assets.at(i)) {
+                    ss << "asset " << kCndSectionNames.at(i) << " " << hashToString(hash) << " " << name << "\n";
+                }
+            }
+
+            const auto str = ss.str();
+            OutputFileStream ofs(path, /*truncate=*/true);
+            ofs.write(reinterpret_cast<const byte_t*>(str.data()), str.size());
+        }
+    };
+
+
+    /**
+     * Incremental NDY to CND conversion state.
+     * On construction the NDY file is split into sections and compared
+     * to the manifest of the previous conversion to find the CND sections which have to be built.
+     * When there is no valid previous conversion all sections are built.
+     *
+     * The new CND file is written to outputPath() and it replaces the previous CND file on commit().
+     */
+    class IncrementalCndBuild final
+    {
+    public:
+        /**
+         * @param ndyPath     - path to input NDY file.
+         * @param cndPath     - path to output CND file.
+         * @param vfs         - virtual file system to search asset files in.
+         * @param optionsHash - hash of conversion options. Any change of options rebuilds all sections.
+         * @param optimizeGeo - true if world geometry is optimized, see cndSectionInputs.
+         * @param bakeLight   - true if surface vertex light is baked, see cndSectionInputs.
+         */
+        IncrementalCndBuild(const fs::path& ndyPath, const fs::path& cndPath, const VirtualFileSystem& vfs, uint64_t optionsHash, bool optimizeGeo, bool bakeLight) :
+            ndyPath_(ndyPath),
+            cndPath_(cndPath),
+            manifestPath_(cndPath.string() + std::string(kExtCndManifest)),
+            outPath_(cndPath.string() + ".building"),
+            ndy_(ndyIndexFile(ndyPath)),
+            optimizeGeo_(optimizeGeo),
+            bakeLight_(bakeLight)
+        {
+            LIBIM_TRACE_SCOPE_DETAIL("cndtool", "IncrementalCndBuild", ndyPath.generic_string());
+            manifest_.optionsHash = optionsHash;
+            for (const auto& s : ndy_.sections)
+            {
+                if (auto cs = ndySectionToCndSection(s.name))
+                {
+                    auto& h = manifest_.ndyHashes.at(sectionIdx(*cs));
+                    h = Hasher64(h)
+                        .update(s.name)
+                        .update(ndy_.data.data() + s.offset, s.size)
+                        .digest();
+                }
+            }
+
+            dirty_.set();
+            prevManifest_ = CndBuildManifest::load(manifestPath_);
+            if (!prevManifest_ || !fileExists(cndPath_)) {
+                LOG_DEBUG("No previous incremental build of %, building all CND sections", ndyPath_);
+                return;
+            }
+
+            if (prevManifest_->optionsHash != optionsHash)
+            {
+                LOG_DEBUG("Conversion options changed, building all CND sections");
+                return;
+            }
+
+            try
+            {
+                prevCnd_ = std::make_unique<InputFileStream>(cndPath_);
+                if (prevCnd_->size() != prevManifest_->cndSize || hash64(*prevCnd_) != prevManifest_->cndHash)
+                {
+                    LOG_DEBUG("CND file % was modified after the last build, building all CND sections", cndPath_);
+                    prevCnd_.reset();
+                    return;
+                }
+
+                prevHeader_ = CND::readHeader(*prevCnd_);
+                prevLayout_ = CND::getSectionLayout(*prevCnd_, prevHeader_);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_DEBUG("Failed to read previous CND file %: %", cndPath_, e.what());
+                prevCnd_.reset();
+                return;
+            }
+
+            for (std::size_t i = sectionIdx(CndSection::Sounds); i < kNumCndSections; i++)
+            {
+                const auto section = static_cast<CndSection>(i);
+                const auto inputs  = cndSectionInputs(section, optimizeGeo_, bakeLight_);
+                bool dirty = false;
+                for (std::size_t j = 0; j < kNumCndSections && !dirty; j++) {
+                    dirty = inputs.test(j) && manifest_.ndyHashes.at(j) != prevManifest_->ndyHashes.at(j);
+                }
+
+                for (const auto& [name, hash] : prevManifest_->assets.at(i))
+                {
+                    if (dirty) break;
+                    dirty = hashAssetFile(vfs, section, name) != hash;
+                }
+
+                dirty_.set(i, dirty);
+                if (dirty) {
+                    LOG_DEBUG("CND section '%' changed", kCndSectionNames.at(i));
+                }
+            }
+        }
+
+        IncrementalCndBuild(const IncrementalCndBuild&) = delete;
+        IncrementalCndBuild& operator=(const IncrementalCndBuild&) = delete;
+
+        /** Removes output file if the build was not committed. */
+        ~IncrementalCndBuild()
+        {
+            prevCnd_.reset();
+            if (!committed_) {
+                deleteFile(outPath_);
+            }
+        }
+
+        /** Returns path of the file to write new CND file to. */
+        const fs::path& outputPath() const
+        {
+            return outPath_;
+        }
+
+        /** Returns CND sections to be built. CndSection::Header is always built. */
+        const CndSectionSet& dirtySections() const
+        {
+            return dirty_;
+        }
+
+        bool isDirty(CndSection section) const
+        {
+            return dirty_.test(sectionIdx(section));
+        }
+
+        /** Returns NDY sections (mapped to CND sections) which have to be parsed to build dirty sections. */
+        CndSectionSet parsedSections() const
+        {
+            CndSectionSet parsed;
+            parsed.set(sectionIdx(CndSection::Header));
+            for (std::size_t i = 0; i < kNumCndSections; i++)
+            {
+                if (dirty_.test(i)) {
+                    parsed |= cndSectionInputs(static_cast<CndSection>(i), optimizeGeo_, bakeLight_);
+                }
+            }
+            return parsed;
+        }
+
+        /**
+         * Parses NDY sections returned by parsedSections().
+         * Records the asset files referenced by dirty CND sections.
+         * World lists are allocated from mr if not null. See TextResourceReader::setMemoryResource.
+         */
+        NdyWorld readWorld(const VirtualFileSystem& vfs, std::pmr::memory_resource* mr = nullptr)
+        {
+            LIBIM_TRACE_SCOPE_DETAIL("cndtool", "ndyReadSections", ndyPath_.generic_string());
+            NdyWorld world{};
+            const auto parsed = parsedSections();
+            std::string section;
+            for (const auto& s : ndy_.sections)
+            {
+                auto cs = ndySectionToCndSection(s.name);
+                if (!cs || !parsed.test(sectionIdx(*cs))) {
+                    continue;
+                }
+
+                const auto begin = std::next(ndy_.data.begin(), static_cast<std::ptrdiff_t>(s.offset));
+                InputBinaryStream<ByteArray> istream(ndy_.data, begin, std::next(begin, static_cast<std::ptrdiff_t>(s.size)));
+                istream.setName(ndyPath_.filename().string());
+
+                TextResourceReader rr(istream);
+                rr.setReportEol(false);
+                rr.setMemoryResource(mr);
+                section = std::string(rr.readSection());
+                ndyParseSection(section, rr, vfs, world, s.line - 1);
+            }
+
+            // Record referenced assets before static resources are removed from the lists
+            assetNames_.at(sectionIdx(CndSection::Sounds))    = world.sounds.second;
+            assetNames_.at(sectionIdx(CndSection::Materials)) = world.materials.second;
+            assetNames_.at(sectionIdx(CndSection::Keyframes)) = world.keyframes.second;
+            assetNames_.at(sectionIdx(CndSection::Cogs))      = world.cogScripts.second;
+            return world;
+        }
+
+        /**
+         * Writes section of previous CND file to ostream.
+         * @throw FileStreamError
+         */
+        void copySection(OutputFileStream& ostream, CndSection section) const
+        {
+            LIBIM_TRACE_SCOPE_DETAIL("cndtool", "copyCndSection", std::string(kCndSectionNames.at(sectionIdx(section))));
+            const auto& s = prevLayout_.at(sectionIdx(section));
+            if (ostream.copyFrom(*prevCnd_, s.offset, s.size) != s.size) {
+                throw FileStreamError("Failed to copy section from previous CND file");
+            }
+        }
+
+        /** Sets header fields of the sections which are copied from the previous CND file. */
+        void updateHeader(CndHeader& header) const
+        {
+            for (std::size_t i = sectionIdx(CndSection::Sounds); i < kNumCndSections; i++)
+            {
+                if (!dirty_.test(i)) {
+                    copyCndHeaderSectionFields(static_cast<CndSection>(i), prevHeader_, header);
+                }
+            }
+        }
+
+        /**
+         * Replaces the previous CND file with the new one and writes manifest file.
+         * @param vfs - virtual file system to search asset files in.
+         * @throw FileStreamError
+         */
+        void commit(const VirtualFileSystem& vfs)
+        {
+            LIBIM_TRACE_SCOPE_DETAIL("cndtool", "IncrementalCndBuild::commit", cndPath_.generic_string());
+            prevCnd_.reset();
+            deleteFile(manifestPath_); // in case of failure next build is full build
+
+            renameFile(outPath_, cndPath_);
+            committed_ = true;
+
+            for (std::size_t i = sectionIdx(CndSection::Sounds); i < kNumCndSections; i++)
+            {
+                const auto section = static_cast<CndSection>(i);
+                if (!dirty_.test(i)) {
+                    manifest_.assets.at(i) = prevManifest_->assets.at(i);
+                }
+                else if (!cndSectionAssetDirs(section).empty())
+                {
+                    auto& assets = manifest_.assets.at(i);
+                    for (const auto& name : assetNames_.at(i)) {
+                        assets.emplace_back(name, hashAssetFile(vfs, section, name));
+                    }
+                }
+            }
+
+            InputFileStream cnd(cndPath_);
+            manifest_.cndSize = cnd.size();
+            manifest_.cndHash = hash64(cnd);
+            manifest_.save(manifestPath_);
+        }
+
+    private:
+        fs::path ndyPath_;
+        fs::path cndPath_;
+        fs::path manifestPath_;
+        fs::path outPath_;
+        NdyFileIndex ndy_;
+        bool optimizeGeo_;
+        bool bakeLight_;
+        CndBuildManifest manifest_;
+        std::optional<CndBuildManifest> prevManifest_;
+        std::unique_ptr<InputFileStream> prevCnd_;
+        CndHeader prevHeader_ {};
+        CndSectionLayout prevLayout_ {};
+        CndSectionSet dirty_;
+        std::array<std::vector<std::string>, kNumCndSections> assetNames_;
+        bool committed_ = false;
+    };
+}
+#endif // CNDTOOL_INCREMENTAL_H
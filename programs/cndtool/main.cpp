@@ -1,10 +1,20 @@
+#include <algorithm>
+#include <cctype>
+#include <deque>
 #include <filesystem>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 
 #include <cmdutils/cmdutils.h>
+#include <cmdutils/file_dedup.h>
+#include <cmdutils/output_capture.h>
+#include <cmdutils/trace.h>
 #include <matool/utils.h>
 
 #include <imfixes/cogscript_fixes.h>
@@ -19,6 +29,7 @@
 #include <libim/content/asset/material/texture_view.h>
 #include <libim/content/asset/material/texutils.h>
 #include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
+#include <libim/content/asset/world/impl/serialization/cnd/cndview.h>
 #include <libim/content/asset/world/impl/serialization/ndy/ndy.h>
 #include <libim/content/asset/world/impl/serialization/ndy/thing/ndy_thing_oser.h>
 #include <libim/content/audio/soundbank.h>
@@ -26,13 +37,18 @@
 #include <libim/io/filestream.h>
 #include <libim/io/vfs.h>
 #include <libim/log/log.h>
+#include <libim/trace/trace.h>
 #include <libim/types/safe_cast.h>
+#include <libim/utils/hash.h>
+#include <libim/utils/thread_pool.h>
 
 #include "config.h"
 #include "cnd.h"
 #include "cndtoolargs.h"
 #include "ndy.h"
+#include "gltf.h"
 #include "obj.h"
+#include "serve.h"
 
 using namespace cmdutils;
 using namespace cndtool;
@@ -58,6 +74,7 @@ constexpr static auto cmdConvert = "convert"sv;
 constexpr static auto cmdExtract = "extract"sv;
 constexpr static auto cmdList    = "list"sv;
 constexpr static auto cmdRemove  = "remove"sv;
+constexpr static auto cmdServe   = "serve"sv;
 constexpr static auto cmdHelp    = "help"sv;
 
 constexpr static auto scmdAnimation = "animation"sv;
@@ -65,11 +82,20 @@ constexpr static auto scmdMaterial  = "material"sv;
 constexpr static auto scmdCnd       = "cnd"sv;
 constexpr static auto scmdNdy       = "ndy"sv;
 constexpr static auto scmdObj       = "obj"sv;
+constexpr static auto scmdGlb       = "glb"sv;
 
 constexpr static auto optAnimations            = "--key"sv;
+constexpr static auto optConnect               = "--connect"sv;
+constexpr static auto optDedupLink             = "--dedup-link"sv;
+constexpr static auto optDedupManifest         = "--dedup-manifest"sv;
 constexpr static auto optExtractAsBmp          = "--mat-bmp"sv;
 constexpr static auto optExtractAsBmpShort     = "-b"sv;
 constexpr static auto optExtractLod            = "--mat-mipmap"sv;
+constexpr static auto optGeoOptimize           = "--geo-optimize"sv;
+constexpr static auto optIncremental           = "--incremental"sv;
+constexpr static auto optJobs                  = "--jobs"sv;
+constexpr static auto optJobsShort             = "-j"sv;
+constexpr static auto optLightBake             = "--light-bake"sv;
 constexpr static auto optMaxTex                = "--mat-max-tex"sv;
 constexpr static auto optMaterials             = "--mat"sv;
 constexpr static auto optNoAnimations          = "--no-key"sv;
@@ -81,14 +107,17 @@ constexpr static auto optOutputDir             = "--output-dir"sv;
 constexpr static auto optOutputDirShort        = "-o"sv;
 constexpr static auto optConvertToPng          = "--mat-png"sv;
 constexpr static auto optConvertToPngShort     = "-p"sv;
+constexpr static auto optPngLevel              = "--mat-png-level"sv;
 constexpr static auto optReplace               = "--replace"sv;
 constexpr static auto optReplaceShort          = "-r"sv;
 constexpr static auto optSounds                = "--sound"sv;
+constexpr static auto optSoundCompress         = "--sound-compress"sv;
 constexpr static auto optSoundStartHandle      = "--sound-handle"sv;
 constexpr static auto optSoundStartHandleShort = "-h"sv;
 constexpr static auto optStatic                = "--static"sv;
 constexpr static auto optStrict                = "--strict"sv;
 constexpr static auto optVerbose               = "--verbose"sv;
+constexpr static auto optVfsIndex              = "--vfs-index"sv;
 constexpr static auto optVerboseShort          = "-v"sv;
 constexpr static auto optConvertToWav          = "--sound-wav"sv;
 constexpr static auto optConvertToWavShort     = "-w"sv;
@@ -98,6 +127,9 @@ constexpr static auto optOverwriteTemplates    = "--template-overwrite"sv;
 struct ExtractOptions final
 {
     bool verboseOutput = false;
+    bool printProgress = true;  // false when output of concurrent jobs is captured
+    std::size_t numThreads = 0; // 0 = all hardware threads
+    cmdutils::FileDedup* dedup = nullptr; // registry of extracted files with the same content, can be nullptr
     struct {
         bool extract = false;
     } key;
@@ -109,6 +141,7 @@ struct ExtractOptions final
         bool convertToPng = false;
         std::optional<uint64_t> maxTex;
         bool convertMipMap = false;
+        PngWriteOptions pngOptions;
     } mat;
 
     struct
@@ -135,22 +168,135 @@ bool hasOptReplace(const CndToolArgs& args)
     return args.hasArg(optReplace) || args.hasArg(optReplaceShort);
 }
 
-fs::path getOptOutputDir(const CndToolArgs& args, std::optional<fs::path> optPath = std::nullopt)
+fs::path getOptVfsIndex(const CndToolArgs& args)
 {
+    return args.hasArg(optVfsIndex) ? fs::path(args.arg(optVfsIndex)) : fs::path();
+}
+
+std::size_t getOptJobs(const CndToolArgs& args)
+{
+    // 0 = use all hardware threads
+    if (args.hasArg(optJobsShort)){
+        return args.uintArg(optJobsShort, 0);
+    }
+    return args.uintArg(optJobs, 0);
+}
+
+/**
+ * Returns output folder set by --output-dir option or optPath when option is not set.
+ * In batch mode the output folder of each input file is optPath subfolder of --output-dir,
+ * so concurrent jobs don't write files with the same name into the same folder.
+ */
+fs::path getOptOutputDir(const CndToolArgs& args, std::optional<fs::path> optPath = std::nullopt, bool batch = false)
+{
+    fs::path outDir;
     if (args.hasArg(optOutputDirShort)){
-        return args.arg(optOutputDirShort);
+        outDir = args.arg(optOutputDirShort);
     }
     else if (args.hasArg(optOutputDir)){
-        return args.arg(optOutputDir);
+        outDir = args.arg(optOutputDir);
     }
-    return optPath.value_or(fs::path());
+    else {
+        return optPath.value_or(fs::path());
+    }
+
+    if (batch && optPath) {
+        outDir /= *optPath;
+    }
+    return outDir;
 }
 
+/**
+ * Returns PNG encoder options for value of --mat-png-level option.
+ * Large images are compressed in parallel only when --jobs is 1,
+ * otherwise images are already written concurrently by multiple threads.
+ * If level is not in range 0-9, error is printed and std::nullopt is returned.
+ */
+std::optional<PngWriteOptions> getOptPngWriteOptions(const CndToolArgs& args)
+{
+    PngWriteOptions opt;
+    if (args.hasArg(optPngLevel))
+    {
+        const auto level = args.uintArg(optPngLevel);
+        if (level > 9)
+        {
+            printError("Option '%' must be in range 0-9!\n", optPngLevel);
+            return std::nullopt;
+        }
+        opt = PngWriteOptions::withLevel(static_cast<int>(level));
+    }
+
+    if (getOptJobs(args) == 1) {
+        opt.maxThreads = 0; // all hardware threads
+    }
+    return opt;
+}
+
+/** Returns true if path file name is wildcard pattern, e.g.: *.ndy */
+bool isGlobPattern(const fs::path& path)
+{
+    return path.filename().string().find_first_of("*?") != std::string::npos;
+}
+
+/**
+ * Returns true if name matches wildcard pattern.
+ * Wildcard '*' matches any sequence of characters and '?' matches any single character.
+ * Matching is case-insensitive.
+ */
+bool wildcardMatch(std::string_view pattern, std::string_view name)
+{
+    std::size_t p = 0, n = 0;
+    std::size_t starP = std::string_view::npos, starN = 0;
+    while (n < name.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || std::tolower(static_cast<unsigned char>(pattern[p])) == std::tolower(static_cast<unsigned char>(name[n]))))
+        {
+            p++;
+            n++;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            starP = p++;
+            starN = n;
+        }
+        else if (starP != std::string_view::npos)
+        {
+            p = starP + 1;
+            n = ++starN;
+        }
+        else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+/**
+ * Returns files with extension ext from path.
+ * Path can be file path, folder path or wildcard pattern of file name.
+ */
 std::vector<fs::path> getFilesFromPath(const fs::path path, std::string_view ext)
 {
     std::vector<fs::path> files;
     files.reserve(17);
-    if (isFilePath(path)) {
+    if (isGlobPattern(path))
+    {
+        const auto dir     = path.has_parent_path() ? path.parent_path() : fs::path(".");
+        const auto pattern = path.filename().string();
+        for (const auto& entry : fs::directory_iterator(dir))
+        {
+            const auto& path = entry.path();
+            if (entry.is_regular_file() && fileExtMatch(path, ext) && wildcardMatch(pattern, path.filename().string())) {
+                files.push_back(path);
+            }
+        }
+        std::sort(files.begin(), files.end()); // directory iteration order is unspecified
+    }
+    else if (isFilePath(path)) {
         files.push_back(path);
     }
     else // Scan folder for files
@@ -165,10 +311,152 @@ std::vector<fs::path> getFilesFromPath(const fs::path path, std::string_view ext
                 }
             }
         }
+        std::sort(files.begin(), files.end()); // directory iteration order is unspecified
     }
     return files;
 }
 
+/**
+ * Returns files with extension ext from list of input paths.
+ * Each input can be file path, folder path or wildcard pattern of file name.
+ * Duplicate files are removed.
+ * @throw std::invalid_argument if input path doesn't exist or input file has wrong extension.
+ */
+std::vector<fs::path> getFilesFromPaths(const std::vector<fs::path>& inputs, std::string_view ext)
+{
+    std::vector<fs::path> files;
+    for (const auto& input : inputs)
+    {
+        const bool isGlob = isGlobPattern(input);
+        if (!isGlob && !fileExists(input) && !dirExists(input)) {
+            throw std::invalid_argument(utils::format("Input path '%' doesn't exist!", input.string()));
+        }
+
+        if (!isGlob && isFilePath(input) && !fileExtMatch(input, ext)) {
+            throw std::invalid_argument(utils::format("Input file '%' is not % file!", input.string(), ext));
+        }
+
+        for (auto& file : getFilesFromPath(input, ext))
+        {
+            if (std::find(files.begin(), files.end(), file) == files.end()) {
+                files.push_back(std::move(file));
+            }
+        }
+    }
+    return files;
+}
+
+/**
+ * Returns number of concurrent batch jobs.
+ * @param optJobs  - value of --jobs option, 0 = all hardware threads.
+ * @param numFiles - number of input files.
+ */
+std::size_t getBatchJobCount(std::size_t optJobs, std::size_t numFiles)
+{
+    if (optJobs == 0) {
+        optJobs = utils::hardwareConcurrency();
+    }
+    return std::clamp<std::size_t>(optJobs, 1, std::max<std::size_t>(numFiles, 1));
+}
+
+/**
+ * Runs job for each file on up to numJobs worker threads and reports failed files.
+ *
+ * When jobs run concurrently, console output of each job is captured and printed
+ * in order of files after the job has finished.
+ * At most 2 * numJobs files are scheduled at once, the next file is scheduled
+ * when the output of the oldest scheduled file was printed.
+ *
+ * @param files   - input files.
+ * @param numJobs - number of concurrent jobs, see getBatchJobCount.
+ * @param title   - title printed before the output of each file in batch mode.
+ * @param job     - function processing file, returns true on success.
+ * @return number of failed files.
+ */
+template<typename JobF>
+std::size_t runBatchJobs(const std::vector<fs::path>& files, std::size_t numJobs, std::string_view title, JobF&& job)
+{
+    const auto runJob = [&](const fs::path& file)
+    {
+        try {
+            return job(file);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << std::endl;
+            printError("Failed to process file '%'!", file.filename().string());
+            std::cerr << "       Reason: " << e.what() << std::endl;
+            return false;
+        }
+    };
+
+    const auto printTitle = [&](const fs::path& file) {
+        if (files.size() > 1) std::cout << "\n" << title << file.filename().string() << std::endl;
+    };
+
+    std::vector<fs::path> failed;
+    if (numJobs <= 1)
+    {
+        for (const auto& file : files)
+        {
+            printTitle(file);
+            if (!runJob(file)) {
+                failed.push_back(file);
+            }
+        }
+    }
+    else
+    {
+        struct JobResult
+        {
+            bool success;
+            CapturedOutput output;
+        };
+
+        utils::ThreadPool pool(numJobs);
+        std::deque<std::pair<fs::path, std::future<JobResult>>> scheduled;
+        const auto finishOldest = [&]()
+        {
+            auto [file, result] = std::move(scheduled.front());
+            scheduled.pop_front();
+
+            auto r = result.get();
+            printTitle(file);
+            r.output.print();
+            if (!r.success) {
+                failed.push_back(file);
+            }
+        };
+
+        for (const auto& file : files)
+        {
+            if (scheduled.size() >= 2 * numJobs) {
+                finishOldest();
+            }
+
+            scheduled.emplace_back(file, pool.submit([&runJob, file]() {
+                OutputCapture capture;
+                const bool success = runJob(file);
+                return JobResult{ success, capture.take() };
+            }));
+        }
+
+        while (!scheduled.empty()) {
+            finishOldest();
+        }
+    }
+
+    if (!failed.empty() && files.size() > 1)
+    {
+        std::cerr << std::endl;
+        printError("Failed to process % of % file(s):", failed.size(), files.size());
+        for (const auto& file : failed) {
+            std::cerr << "       " << file.string() << std::endl;
+        }
+    }
+    return failed.size();
+}
+
 void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
 {
     if (cmd == cmdAdd)
@@ -202,12 +490,16 @@ void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
     {
         if (subcmd == scmdCnd)
         {
-            std::cout << "Convert NDY level file(s) to CND file format." << std::endl << std::endl;
-            std::cout << "  Usage: cndtool convert cnd [options] <ndy-file-path|ndy-folder> <game-assets-folder>" << std::endl << std::endl;
+            std::cout << "Convert NDY level file(s) to CND file format." << std::endl;
+            std::cout << "Multiple NDY files, folders or file name patterns (e.g.: levels/*.ndy) can be specified." << std::endl << std::endl;
+            std::cout << "  Usage: cndtool convert cnd [options] <ndy-file-path|ndy-folder> ... <game-assets-folder>" << std::endl << std::endl;
             printOptionHeader();
             printOption( optSoundStartHandle , optSoundStartHandleShort , "Start sound handle."                                                       );
             printOption( ""                  , ""                       , "By default 349 for normal and 0 for static CND file.\n"                    );
 
+            printOption( optSoundCompress    , ""                       , "Compress WAV sound assets to IndyWV format."                               );
+            printOption( ""                  , ""                       , "Only 16 bit stereo sounds are compressed.\n"                              );
+
             printOption( optNoCleanup        , ""                       , "Don't remove static game assets from jones3dstatic."                       );
             printOption( ""                  , ""                       , utils::format("Has no effect if % is set.\n", optStatic)                    );
 
@@ -216,26 +508,60 @@ void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
 
             printOption( optStrict           , ""                       , "Verify all required sections are set and valid.\n"                         );
 
+            printOption( optGeoOptimize      , ""                       , "Weld equal vertices and texture vertices and remove unused ones."          );
+            printOption( ""                  , ""                       , "Surface and sector vertex indices are remapped.\n"                         );
+
+            printOption( optLightBake        , ""                       , "Bake surface vertex light from sector and thing lights."                   );
+            printOption( ""                  , ""                       , "Lights are occluded by world surfaces.\n"                                  );
+
+            printOption( optIncremental      , ""                       , "Build only CND sections which NDY sections or assets changed"              );
+            printOption( ""                  , ""                       , "since the previous conversion. Unchanged sections are copied"              );
+            printOption( ""                  , ""                       , "from the previous CND file. Build manifest is stored to the file"          );
+            printOption( ""                  , ""                       , utils::format("<cnd-file>%.\n", kExtCndManifest)                         );
+
+            printOption( optJobs             , optJobsShort             , "Number of files converted concurrently, e.g.: --jobs=4."                   );
+            printOption( ""                  , ""                       , "By default all hardware threads are used.\n"                               );
+
+            printOption( optVfsIndex         , ""                       , "Game assets index file, e.g.: --vfs-index=assets.idx. The assets folder"   );
+            printOption( ""                  , ""                       , "and GOB files are indexed to the file when it's missing or outdated,"     );
+            printOption( ""                  , ""                       , "following conversions load the game assets from the index.\n"             );
+
             printOption( optOutputDir        , optOutputDirShort        , "Output folder"                                                             );
             printOption( optVerbose          , optVerboseShort          , "Verbose printout to the console"                                           );
         }
         else if (subcmd == scmdNdy)
         {
-            std::cout << "Convert CND level file(s) to NDY file format." << std::endl << std::endl;
-            std::cout << "  Usage: cndtool convert ndy [options] <cnd-file-path|cnd-folder> <cog-scripts-folder>" << std::endl << std::endl;
+            std::cout << "Convert CND level file(s) to NDY file format." << std::endl;
+            std::cout << "Multiple CND files, folders or file name patterns (e.g.: levels/*.cnd) can be specified." << std::endl << std::endl;
+            std::cout << "  Usage: cndtool convert ndy [options] <cnd-file-path|cnd-folder> ... <cog-scripts-folder>" << std::endl << std::endl;
             printOptionHeader();
             printOption( optNoAnimations , ""               , "Don't extract animation assets"  );
             printOption( optNoMaterials  , ""               , "Don't extract material assets"   );
             printOption( optNoSounds     , ""               , "Don't extract sound assets"      );
+            printOption( optJobs         , optJobsShort     , "Number of files converted concurrently and number of asset worker threads" );
+            printOption( optVfsIndex     , ""               , "Game assets index file, see: cndtool help convert cnd" );
             printOption( optOutputDir    , optOutputDirShort, "Output folder"                   );
             printOption( optVerbose      , optVerboseShort  , "Verbose printout to the console" );
         }
         else if (subcmd == scmdObj)
         {
             std::cout << "Extract level geometry from CND file and convert to Wavefront OBJ file format." << std::endl << std::endl;
-            std::cout << "  Usage: cndtool convert obj [options] <cnd-file-path>" << std::endl << std::endl;
+            std::cout << "  Usage: cndtool convert obj [options] <cnd-file-path|cnd-folder> ..." << std::endl << std::endl;
             printOptionHeader();
             printOption( optNoMaterials, ""               , "Don't extract material assets"   );
+            printOption( optPngLevel   , ""               , "PNG compression level 0-9"       );
+            printOption( optJobs       , optJobsShort     , "Number of files converted concurrently" );
+            printOption( optOutputDir  , optOutputDirShort, "Output folder"                   );
+            printOption( optVerbose    , optVerboseShort  , "Verbose printout to the console" );
+        }
+        else if (subcmd == scmdGlb)
+        {
+            std::cout << "Extract level geometry from CND file and convert to binary glTF 2.0 (GLB) file format." << std::endl << std::endl;
+            std::cout << "  Usage: cndtool convert glb [options] <cnd-file-path|cnd-folder> ..." << std::endl << std::endl;
+            printOptionHeader();
+            printOption( optNoMaterials, ""               , "Don't embed material textures"   );
+            printOption( optPngLevel   , ""               , "PNG compression level 0-9"       );
+            printOption( optJobs       , optJobsShort     , "Number of files converted concurrently" );
             printOption( optOutputDir  , optOutputDirShort, "Output folder"                   );
             printOption( optVerbose    , optVerboseShort  , "Verbose printout to the console" );
         }
@@ -247,18 +573,21 @@ void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
             printSubCommand( scmdCnd, "Convert NDY to CND file format." );
             printSubCommand( scmdNdy, "Convert CND to NDY file format." );
             printSubCommand( scmdObj, "Extract level geometry and convert to Wavefront OBJ file format." );
+            printSubCommand( scmdGlb, "Extract level geometry and convert to binary glTF 2.0 file format." );
         }
     }
     else if (cmd == cmdExtract)
     {
         std::cout << "Extract animation [KEY], material [MAT], sound [IndyWV] and Thing template assets from CND level file(s)." << std::endl << std::endl;
-        std::cout << "  Usage: cndtool extract [options] <cnd-file-path|cnd-folder>" << std::endl << std::endl;
+        std::cout << "  Usage: cndtool extract [options] <cnd-file-path|cnd-folder> ..." << std::endl << std::endl;
         printOptionHeader();
         printOption( optExtractAsBmp       , optExtractAsBmpShort , "Convert extracted material assets to BMP format."                            );
         printOption( optConvertToPng       , optConvertToPngShort , "Convert extracted material assets to PNG format."                            );
         printOption( optMaxTex             , ""                   , "Max number of images to convert from each material file."                    );
         printOption( ""                    , ""                   , "By default all are converted."                                               );
-        printOption( optExtractLod         , ""                   , "Extract also MipMap LOD images when converting material file.\n"             );
+        printOption( optExtractLod         , ""                   , "Extract also MipMap LOD images when converting material file."               );
+        printOption( optPngLevel           , ""                   , "PNG compression level 0-9, e.g.: --mat-png-level=1."                         );
+        printOption( ""                    , ""                   , "Lower level is faster, 0 stores images uncompressed.\n"                     );
 
         printOption( optConvertToWav       , optConvertToWavShort , "If extracted sound is in IndyWV compressed format convert it to WAV format." );
         printOption( optExportSoundbank    , ""                   , "Export soundbank track to file.\n"                                            );
@@ -271,6 +600,14 @@ void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
         printOption( optNoSounds           , ""                   , "Don't extract sound assets."                                                 );
         printOption( optNoTemplates        , ""                   , "Don't extract Thing templates.\n"                                            );
 
+        printOption( optDedupLink          , ""                   , "Hard link extracted images and sounds with duplicate content."               );
+        printOption( ""                    , ""                   , "By default duplicates are encoded once and copied."                          );
+        printOption( optDedupManifest      , ""                   , "Manifest file of extracted files, e.g.: --dedup-manifest=out/manifest.txt." );
+        printOption( ""                    , ""                   , "Files listed in existing manifest are not extracted again.\n"               );
+
+        printOption( optJobs               , optJobsShort         , "Number of worker threads, e.g.: --jobs=4."                                   );
+        printOption( ""                    , ""                   , "By default all hardware threads are used.\n"                                 );
+
         printOption( optOutputDir          , optOutputDirShort    , "Output folder."                                                              );
         printOption( optVerbose            , optVerboseShort      , "Verbose printout to the console."                                            );
     }
@@ -308,6 +645,18 @@ void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
             printSubCommand( scmdMaterial , "Remove material assets"  );
         }
     }
+    else if (cmd == cmdServe)
+    {
+        std::cout << "Run server which executes cndtool commands sent over Unix socket." << std::endl;
+        std::cout << "Game assets folders and static resources are loaded once and reused by all requests." << std::endl;
+        std::cout << utils::format("Commands are sent to the server with the global option %, e.g.:", optConnect) << std::endl;
+        std::cout << utils::format("  cndtool list %=cndtool.sock 01_bab.cnd", optConnect) << std::endl << std::endl;
+        std::cout << "  Usage: cndtool serve [options] <socket-path> [game-assets-folder] ..." << std::endl << std::endl;
+        printOptionHeader();
+        printOption( optJobs   , optJobsShort   , "Max number of concurrently executed requests, e.g.: --jobs=4." );
+        printOption( ""        , ""             , "By default the number of hardware threads.\n"                 );
+        printOption( optVerbose, optVerboseShort, "Verbose printout to the console."                             );
+    }
     else
     {
         std::cout << "Command-line interface tool to extract and modify\ngame assets stored in a CND level file.\n\n";
@@ -318,7 +667,12 @@ void printHelp(std::string_view cmd = "sv", std::string_view subcmd = ""sv)
         printCommand( cmdExtract, "Extract game assets"                              );
         printCommand( cmdList   , "Print to the console stored game assets"          );
         printCommand( cmdRemove , "Remove one or more game assets"                   );
+        printCommand( cmdServe  , "Run server executing commands sent over socket"   );
         printCommand( cmdHelp   , "Show this message or help for a specific command" );
+        std::cout << std::endl;
+        printOptionHeader("Global option");
+        printTraceOption();
+        printOption(optConnect, "", "Execute command on cndtool server, e.g.: --connect=cndtool.sock");
     }
 }
 
@@ -471,43 +825,126 @@ int execCmdAdd(std::string_view scmd, const CndToolArgs& args)
     return 1;
 }
 
-void writeAnimations(const UniqueTable<Animation>& animations, const fs::path& outDir, const std::string& cndName, const ExtractOptions& opt)
+/**
+ * Asset encode and write jobs scheduled on the worker pool.
+ * Jobs are collected in the order they were scheduled, so that
+ * progress and error printout doesn't depend on the job execution order.
+ */
+struct AssetJobs final
+{
+    struct Job
+    {
+        std::string name;
+        std::future<CapturedOutput> result; // captured console output of the job
+    };
+    std::vector<Job> jobs;
+
+    AssetJobs() = default;
+    AssetJobs(AssetJobs&&) noexcept = default;
+    AssetJobs& operator=(AssetJobs&&) noexcept = default;
+
+    ~AssetJobs()
+    {
+        // Make sure no job outlives the assets it references
+        for (auto& job : jobs)
+        {
+            if (job.result.valid()) {
+                job.result.wait();
+            }
+        }
+    }
+
+    template<typename Func>
+    void schedule(utils::ThreadPool& pool, std::string name, Func&& func)
+    {
+        // Console output of the job is captured and printed by the thread waiting for the result,
+        // so it's captured together with the output of the batch job which scheduled it.
+        auto job = [func = std::forward<Func>(func), assetName = name]() mutable {
+            LIBIM_TRACE_SCOPE_DETAIL("cndtool", "writeAsset", std::move(assetName));
+            OutputCapture capture;
+            func();
+            return capture.take();
+        };
+        jobs.push_back({ std::move(name), pool.submit(std::move(job)) });
+    }
+
+    std::size_t size() const
+    {
+        return jobs.size();
+    }
+};
+
+/**
+ * Waits for scheduled jobs in order and prints progress and errors.
+ * @param jobs     - scheduled jobs.
+ * @param title    - progress title.
+ * @param onWait   - function called with job index before waiting for the job result, used for verbose printout.
+ * @param opt      - extract options.
+ * @return number of successfully written assets.
+ */
+template<typename OnWaitF>
+std::size_t waitAssetJobs(AssetJobs& jobs, std::string_view title, OnWaitF&& onWait, const ExtractOptions& opt)
+{
+    std::size_t nWritten = 0;
+    std::vector<std::string> errors;
+    for (const auto[idx, job] : enumerate(jobs.jobs))
+    {
+        if (opt.verboseOutput) {
+            onWait(idx);
+        }
+        else if (opt.printProgress) {
+            printProgress(title, idx + 1, jobs.size());
+        }
+
+        try
+        {
+            job.result.get().print();
+            nWritten++;
+        }
+        catch (const std::exception& e) {
+            errors.push_back(utils::format("Failed to extract '%': %", job.name, e.what()));
+        }
+    }
+
+    if (!opt.verboseOutput) std::cout << "\r" << title << (errors.empty() ? kSuccess : kFailed) << std::endl;
+    for (const auto& e : errors) {
+        printError(e);
+    }
+    return nWritten;
+}
+
+AssetJobs writeAnimations(utils::ThreadPool& pool, const UniqueTable<Animation>& animations, const fs::path& outDir, const std::string& cndName)
 {
-    if (animations.isEmpty()) return;
+    AssetJobs jobs;
+    if (animations.isEmpty()) return jobs;
 
     auto keyDir = outDir / "key";
     makePath(keyDir);
 
     /* Save extracted animations to file */
-    const std::vector<std::string> headerComments = [&]() {
+    auto headerComments = std::make_shared<const std::vector<std::string>>([&]() {
         std::vector<std::string> cmt;
         cmt.emplace_back("Extracted from CND file '"s + cndName + "' with " +
             std::string(kProgramName) + " v" + std::string(kVersion)
         );
         cmt.emplace_back(kProgramUrl);
         return cmt;
-    }();
+    }());
 
-    for(const auto[idx, anim] : enumerate(animations))
+    for (const auto& anim : animations)
     {
-        if (opt.verboseOutput){
-            std::cout << "Extracting animation: " << anim.name() << std::endl;
-        }
-        else {
-            printProgress("Extracting animations... ", idx, animations.size());
-        }
-
-        fs::path keyFilePath = keyDir / anim.name();
-        OutputFileStream ofs(std::move(keyFilePath), /*truncate=*/true);
-        keyWrite(anim, TextResourceWriter(ofs), headerComments);
+        jobs.schedule(pool, anim.name(), [&anim, keyDir, headerComments]() {
+            OutputFileStream ofs(keyDir / anim.name(), /*truncate=*/true);
+            keyWrite(anim, TextResourceWriter(ofs), *headerComments);
+        });
     }
-
-    if (!opt.verboseOutput) std::cout << "\rExtracting animations... " << kSuccess << std::endl;
+    return jobs;
 }
 
-void writeMaterials(const Table<Material>& materials, const fs::path& outDir, const ExtractOptions& opt)
+AssetJobs writeMaterials(utils::ThreadPool& pool, const Table<Material>& materials, const fs::path& outDir, const ExtractOptions& opt)
 {
-    if (materials.isEmpty()) return;
+    AssetJobs jobs;
+    if (materials.isEmpty()) return jobs;
 
     const fs::path matDir = outDir / "mat";
     makePath(matDir);
@@ -532,40 +969,31 @@ void writeMaterials(const Table<Material>& materials, const fs::path& outDir, co
         std::cout << "Warning: Materials won't be converted because option '" << optMaxTex << "' is 0!\n";
     }
 
-    for (const auto[idx, mat] : enumerate(materials))
+    for (const auto& mat : materials)
     {
-        if (opt.verboseOutput)
-        {
-            std::cout << "\nExtracting material: " <<  mat.name() << std::endl;
-            matool::matPrintInfo(mat);
-        }
-        else {
-            printProgress("Extracting materials... ", idx + 1, materials.size());
-        }
-
-        /* Save MAT file to disk */
-        const auto outMatFile = matDir / mat.name();
-        matWrite(mat, OutputFileStream(outMatFile, /*truncate=*/true));
+        jobs.schedule(pool, mat.name(), [&mat, &opt, matDir, bmpDir, pngDir, convert]() {
+            /* Save MAT file to disk */
+            matWrite(mat, OutputFileStream(matDir / mat.name(), /*truncate=*/true));
 
-        /* Extract images from MAT file and save them to disk */
-        if (convert)
-        {
-            if (opt.mat.convertToBmp) {
-                matool::matExtractImages(mat, bmpDir, opt.mat.maxTex, opt.mat.convertMipMap, /*extractAsBmp*/true);
-            }
-            if (opt.mat.convertToPng) {
-                matool::matExtractImages(mat, pngDir, opt.mat.maxTex, opt.mat.convertMipMap);
+            /* Extract images from MAT file and save them to disk */
+            if (convert)
+            {
+                if (opt.mat.convertToBmp) {
+                    matool::matExtractImages(mat, bmpDir, opt.mat.maxTex, opt.mat.convertMipMap, /*extractAsBmp*/true, opt.mat.pngOptions, opt.dedup);
+                }
+                if (opt.mat.convertToPng) {
+                    matool::matExtractImages(mat, pngDir, opt.mat.maxTex, opt.mat.convertMipMap, /*extractAsBmp*/false, opt.mat.pngOptions, opt.dedup);
+                }
             }
-        }
+        });
     }
-
-    if (!opt.verboseOutput) std::cout << "\rExtracting materials... " << kSuccess << std::endl;
+    return jobs;
 }
 
-void writeSounds(const UniqueTable<Sound>& sounds, const fs::path& outDir, const ExtractOptions& opt)
+AssetJobs writeSounds(utils::ThreadPool& pool, const UniqueTable<Sound>& sounds, const fs::path& outDir, const ExtractOptions& opt)
 {
-    if (sounds.isEmpty()) return;
-    if (!opt.verboseOutput) printProgress("Extracting sounds... ", 0, 1);
+    AssetJobs jobs;
+    if (sounds.isEmpty()) return jobs;
 
     fs::path outPath = outDir / "sound";
     makePath(outPath);
@@ -577,32 +1005,43 @@ void writeSounds(const UniqueTable<Sound>& sounds, const fs::path& outDir, const
         makePath(wavDir);
     }
 
-    for (const auto[idx, s] : enumerate(sounds))
+    for (const auto& s : sounds)
     {
-        if (opt.verboseOutput) {
-            std::cout << "\rExtracting sound: " << s.name() << std::endl;
-        }
-        else {
-            printProgress("Extracting sounds... ", idx + 1, sounds.size());
-        }
+        jobs.schedule(pool, std::string(s.name()), [&s, &opt, outPath, wavDir]() {
+            auto writeSound = [&s, &opt](const fs::path& path, std::string_view fileType, auto&& write) {
+                if (!opt.dedup) {
+                    return write(path);
+                }
 
-        if (s.isCompressed())
-        {
-            OutputFileStream ofs(outPath.append(s.name()), /*truncate=*/true);
-            wvWrite(ofs, s);
-            outPath = outPath.parent_path();
-        }
+                /* Content key of sound file is hash of file type, sound format and payload */
+                const auto key = utils::Hasher64()
+                    .update(fileType)
+                    .updateValue(s.contentHash())
+                    .digest();
+                opt.dedup->produce(key, path, write);
+            };
 
-        /* Save in WAV format */
-        if (!s.isCompressed() || opt.sound.convertToWav)
-        {
-            OutputFileStream ofs(wavDir.append(s.name()), /*truncate=*/true);
-            wavWrite(ofs, s);
-            wavDir = wavDir.parent_path();
-        }
-    }
+            if (s.isCompressed())
+            {
+                writeSound(outPath / s.name(), "wv", [&s](const fs::path& path) {
+                    wvWrite(OutputFileStream(path, /*truncate=*/true), s);
+                });
+            }
 
-    if (!opt.verboseOutput) std::cout << "\rExtracting sounds... " << kSuccess << std::endl;
+            /* Save in WAV format */
+            if (!s.isCompressed() || opt.sound.convertToWav)
+            {
+                writeSound(wavDir / s.name(), "wav", [&s](const fs::path& path) {
+                    // Verify sound before output file is created, so no truncated file is left behind
+                    if (!s.canWavWrite()) {
+                        throw StreamError(utils::format("Cannot write sound '%' in WAV format, unsupported compression mode", s.name()));
+                    }
+                    wavWrite(OutputFileStream(path, /*truncate=*/true), s);
+                });
+            }
+        });
+    }
+    return jobs;
 }
 
 std::size_t writeTemplates(const UniqueTable<CndThing>& templates, const fs::path& outDir, const ExtractOptions& opt)
@@ -646,113 +1085,143 @@ std::size_t writeTemplates(const UniqueTable<CndThing>& templates, const fs::pat
     return newTemplates;
 }
 
-std::size_t extractAnimations(const InputStream& istream, const fs::path& outDir, const ExtractOptions& opt)
+/** Assets read from CND file */
+struct CndAssets final
 {
-    if (!opt.key.extract) {
-        return 0;
-    }
+    fs::path cndFile;
+    fs::path outDir;
+    UniqueTable<Animation> animations;
+    Table<Material> materials;
+    std::unique_ptr<SoundBank> soundBank;
+    std::size_t soundTrackIdx = 0;
+    UniqueTable<CndThing> templates;
+};
 
-    if (!opt.verboseOutput) printProgress("Extracting animations... ", 1, 0);
-    auto animations = CND::readKeyframes(istream);
-    if (!animations.isEmpty())
-    {
-        if (opt.verboseOutput) {
-            std::cout << "\nFound: " << animations.size() << std::endl;
-        }
-        writeAnimations(animations, outDir, istream.name(), opt);
+/**
+ * Reads selected asset sections from CND file.
+ * Function can be run on a worker thread.
+ */
+CndAssets readCndAssets(const fs::path& cndFile, const fs::path& outDir, const ExtractOptions& opt)
+{
+    CndAssets assets;
+    assets.cndFile = cndFile;
+    assets.outDir  = outDir;
+
+    InputFileStream istream(cndFile);
+    if (opt.key.extract) {
+        assets.animations = CND::readKeyframes(istream);
     }
-    return animations.size();
-}
 
-std::size_t extractMaterials(const InputStream& istream, const fs::path& outDir, const ExtractOptions& opt)
-{
-    if (!opt.mat.extract) {
-        return 0;
+    if (opt.mat.extract) {
+        assets.materials = CND::readMaterials(istream);
     }
 
-    if (!opt.verboseOutput) printProgress("Extracting materials... ", 0, 1);
+    if (opt.sound.extract)
+    {
+        const auto header = CND::readHeader(istream);
+        assets.soundTrackIdx = getSoundBankTrackIdx(header.state & CndWorldState::Static);
+
+        assets.soundBank = std::make_unique<SoundBank>(assets.soundTrackIdx + 1);
+        assets.soundBank->setStaticTrack(assets.soundTrackIdx, header.state & CndWorldState::Static); // Never forget this or the exported track sounds will have incorrect indices.
+        CND::readSounds(istream, *assets.soundBank, assets.soundTrackIdx); // Import to correct track idx so the original soundbank num is preserved
+    }
 
-    auto materials = CND::readMaterials(istream);
-    if (!materials.isEmpty())
+    if (opt.templates.extract)
     {
-        if (opt.verboseOutput) {
-            std:: cout << " Found: " << materials.size() << std::endl;
-        }
-        writeMaterials(materials, outDir, opt);
+        assets.templates = CND::readTemplates(istream);
+        LOG_DEBUG("Thing template(s) to extract: %", assets.templates.size());
     }
-    return materials.size();
+    return assets;
 }
 
-std::size_t extractSounds(const InputStream& istream, const fs::path& outDir, const ExtractOptions& opt)
+/**
+ * Schedules write jobs for all assets of CND file and waits for them to finish.
+ * @return true if all assets were extracted successfully.
+ */
+bool extractAssets(utils::ThreadPool& pool, const CndAssets& assets, const ExtractOptions& opt)
 {
-    if (!opt.sound.extract) {
-        return 0;
-    }
-
-    if (!opt.verboseOutput) printProgress("Extracting sounds... ", 0, 1);
-
-    // Parse sounds
-    const auto header = CND::readHeader(istream);
-    const std::size_t sbtIdx = getSoundBankTrackIdx(header.state & CndWorldState::Static);
-
-    SoundBank sb(sbtIdx + 1);
-    sb.setStaticTrack(sbtIdx, header.state & CndWorldState::Static); // Never forget this or the exported track sounds will have incorrect indices.
-    CND::readSounds(istream, sb, sbtIdx); // Import to correct track idx so the original soundbank num is preserved
+    /* Schedule all encode & write jobs at once so the pool is kept busy across asset types */
+    AssetJobs animJobs = writeAnimations(pool, assets.animations, assets.outDir, assets.cndFile.filename().string());
+    AssetJobs matJobs  = writeMaterials(pool, assets.materials, assets.outDir, opt);
 
-    if (opt.sound.exportSoundbank)
+    AssetJobs sndJobs;
+    AssetJobs bankJobs;
+    if (assets.soundBank)
     {
-        auto bankPath = outDir / (getBaseName(istream.name()) + "_soundbank.bin");
-        LOG_DEBUG("Exporting soundbank track % to file: %", sbtIdx, bankPath);
-        sb.exportTrack(sbtIdx, OutputFileStream(bankPath, /*truncate=*/true));
+        auto& sounds = assets.soundBank->getTrack(assets.soundTrackIdx);
+        sndJobs = writeSounds(pool, sounds, assets.outDir, opt);
+        if (opt.sound.exportSoundbank)
+        {
+            auto bankPath = assets.outDir / (getBaseName(assets.cndFile.filename().string()) + "_soundbank.bin");
+            bankJobs.schedule(pool, bankPath.filename().string(), [&assets, bankPath]() {
+                LOG_DEBUG("Exporting soundbank track % to file: %", assets.soundTrackIdx, bankPath);
+                assets.soundBank->exportTrack(assets.soundTrackIdx, OutputFileStream(bankPath, /*truncate=*/true));
+            });
+        }
     }
 
-    auto& sounds = sb.getTrack(sbtIdx);
-    if (!sounds.isEmpty())
+    /* Wait for results in deterministic order */
+    std::size_t nExtAnimFiles = 0;
+    if (animJobs.size() > 0)
     {
-        if (opt.verboseOutput) {
-            std::cout << "\nFound: " << sounds.size() << std::endl;
-        }
-        writeSounds(sounds, outDir, opt);
+        if (opt.verboseOutput) std::cout << "\nFound: " << assets.animations.size() << std::endl;
+        nExtAnimFiles = waitAssetJobs(animJobs, "Extracting animations... ", [&](std::size_t idx) {
+            std::cout << "Extracting animation: " << assets.animations.value(idx).name() << std::endl;
+        }, opt);
     }
-    return sounds.size();
-}
 
-std::size_t extractTemplates(const InputStream& istream, const fs::path& outDir, const ExtractOptions& opt)
-{
-    if (!opt.templates.extract) {
-        return 0;
+    std::size_t nExtMatFiles = 0;
+    if (matJobs.size() > 0)
+    {
+        if (opt.verboseOutput) std::cout << " Found: " << assets.materials.size() << std::endl;
+        nExtMatFiles = waitAssetJobs(matJobs, "Extracting materials... ", [&](std::size_t idx) {
+            const auto& mat = assets.materials.value(idx);
+            std::cout << "\nExtracting material: " <<  mat.name() << std::endl;
+            matool::matPrintInfo(mat);
+        }, opt);
     }
 
-    auto templates = CND::readTemplates(istream);
-    LOG_DEBUG("Thing template(s) to extract: %", templates.size());
-
-    std::size_t numWritten = 0;
-    if (!templates.isEmpty())
+    bool success = nExtAnimFiles == animJobs.size() && nExtMatFiles == matJobs.size();
+    for (auto& job : bankJobs.jobs)
     {
-        if (!opt.verboseOutput) std::cout << "\rExtracting templates... " << std::flush;
-        numWritten = writeTemplates(templates, outDir, opt);
-        if (!opt.verboseOutput) std::cout << "\rExtracting templates... " << kSuccess << std::endl;
+        try {
+            job.result.get().print();
+        }
+        catch (const std::exception& e)
+        {
+            printError("Failed to export soundbank to file '%': %", job.name, e.what());
+            success = false;
+        }
     }
-    return numWritten;
-}
 
-void extractAssets(const fs::path& cndFile, const fs::path& outDir, const ExtractOptions& opt)
-{
-    if (!opt.key.extract   &&
-        !opt.mat.extract   &&
-        !opt.sound.extract &&
-        !opt.templates.extract)
+    std::size_t nExtSndFiles = 0;
+    if (sndJobs.size() > 0)
     {
-        std::cout << "Nothing to be done!\n";
-        return;
+        const auto& sounds = assets.soundBank->getTrack(assets.soundTrackIdx);
+        if (opt.verboseOutput) std::cout << "\nFound: " << sounds.size() << std::endl;
+        nExtSndFiles = waitAssetJobs(sndJobs, "Extracting sounds... ", [&](std::size_t idx) {
+            std::cout << "\rExtracting sound: " << sounds.value(idx).name() << std::endl;
+        }, opt);
+        success = success && nExtSndFiles == sndJobs.size();
     }
 
-    InputFileStream ifstream(cndFile);
-
-    auto nExtAnimFiles = extractAnimations(ifstream, outDir, opt);
-    auto nExtMatFiles  = extractMaterials(ifstream, outDir, opt);
-    auto nExtSndFiles  = extractSounds(ifstream, outDir, opt);
-    auto nExtTemplates = extractTemplates(ifstream, outDir, opt);
+    /* Templates are merged into single file, therefore written in order on this thread */
+    std::size_t nExtTemplates = 0;
+    if (!assets.templates.isEmpty())
+    {
+        if (!opt.verboseOutput) std::cout << "\rExtracting templates... " << std::flush;
+        try
+        {
+            nExtTemplates = writeTemplates(assets.templates, assets.outDir, opt);
+            if (!opt.verboseOutput) std::cout << "\rExtracting templates... " << kSuccess << std::endl;
+        }
+        catch (const std::exception& e)
+        {
+            if (!opt.verboseOutput) std::cout << "\rExtracting templates... " << kFailed << std::endl;
+            printError("Failed to extract templates: %", e.what());
+            success = false;
+        }
+    }
 
     std::cout << "\n-------------------------------------\n";
     if (opt.key.extract) {
@@ -767,43 +1236,61 @@ void extractAssets(const fs::path& cndFile, const fs::path& outDir, const Extrac
     if (opt.templates.extract) {
         std::cout << "Total extracted templates:  " << nExtTemplates << std::endl;
     }
+    return success;
 }
 
 int execCmdExtract(const CndToolArgs& args)
 {
     try
     {
-        fs::path input = args.cndFile();
-        if (input.empty()) {
-            input = !args.subcmd().empty()
-                ? fs::path(args.subcmd())
-                : !args.positionalArgs().empty()
-                    ? fs::path(args.positionalArgs().at(0))
-                    : fs::path();
+        // Collect input CND files and folders
+        std::vector<fs::path> inputs;
+        if (!args.subcmd().empty()) {
+            inputs.emplace_back(args.subcmd());
+        }
+        if (!args.cndFile().empty()) {
+            inputs.push_back(args.cndFile());
+        }
+        for (const auto& p : args.positionalArgs()) {
+            inputs.emplace_back(p);
         }
 
-        if (input.empty() || (!fileExists(input) && !dirExists(input)))
+        if (inputs.empty())
         {
             printError("Invalid positional argument for input CND file path or folder path!\n");
             printHelp(cmdExtract);
             return 1;
         }
 
-        if (!isDirPath(getOptOutputDir(args)))
+        std::vector<fs::path> cndFiles;
+        for (const auto& input : inputs)
         {
-            printError("Output path is not directory!\n");
-            return 1;
+            if (!fileExists(input) && !dirExists(input) && !isGlobPattern(input))
+            {
+                printError("Invalid positional argument for input CND file path or folder path: '%'!\n", input.string());
+                printHelp(cmdExtract);
+                return 1;
+            }
+
+            auto files = getFilesFromPath(input, kExtCnd);
+            cndFiles.insert(cndFiles.end(), files.begin(), files.end());
         }
 
-        std::vector<fs::path> cndFiles = getFilesFromPath(input, kExtCnd);
         if (cndFiles.empty())
         {
             printError("No CND file found!\n");
             return 1;
         }
 
+        if (!isDirPath(getOptOutputDir(args)))
+        {
+            printError("Output path is not directory!\n");
+            return 1;
+        }
+
         ExtractOptions opt;
         opt.verboseOutput      = hasOptVerbose(args);
+        opt.numThreads         = getOptJobs(args);
         opt.key.extract        = !args.hasArg(optNoAnimations);
         opt.mat.extract        = !args.hasArg(optNoMaterials);
 
@@ -822,16 +1309,80 @@ int execCmdExtract(const CndToolArgs& args)
             opt.mat.maxTex = args.uintArg(optMaxTex);
         }
 
-        /* Extract animations, materials & sounds */
+        const auto pngOptions = getOptPngWriteOptions(args);
+        if (!pngOptions) {
+            return 1;
+        }
+        opt.mat.pngOptions = *pngOptions;
+
+        /* Files with the same content are extracted only once and copied or hard linked */
+        FileDedup dedup(args.hasArg(optDedupLink) ? FileDedup::Mode::Hardlink : FileDedup::Mode::Copy);
+        const fs::path dedupManifest = args.hasArg(optDedupManifest) ? fs::path(args.arg(optDedupManifest)) : fs::path();
+        if (!dedupManifest.empty()) {
+            dedup.loadManifest(dedupManifest);
+        }
+        opt.dedup = &dedup;
+
+        if (!opt.key.extract   &&
+            !opt.mat.extract   &&
+            !opt.sound.extract &&
+            !opt.templates.extract)
+        {
+            std::cout << "Nothing to be done!\n";
+            return 0;
+        }
+
+        /* Extract animations, materials, sounds & templates.
+           While assets of one file are written, the next file is read in the background. */
+        utils::ThreadPool pool(opt.numThreads);
+        std::deque<std::future<CndAssets>> pending;
+        std::size_t nextFile = 0;
+        auto readNextFile = [&]() {
+            if (nextFile >= cndFiles.size()) return;
+            const auto& cndFile = cndFiles.at(nextFile++);
+            auto outDir = getOptOutputDir(args, cndFile.stem(), /*batch=*/cndFiles.size() > 1);
+            makePath(outDir);
+            pending.push_back(pool.submit([cndFile, outDir, &opt]() {
+                return readCndAssets(cndFile, outDir, opt);
+            }));
+        };
+
+        readNextFile();
+        std::size_t nFailed = 0;
         for (const auto& cndFile : cndFiles)
         {
+            readNextFile();
             if (cndFiles.size() > 1) std::cout << "\nExtracting assets from: " << cndFile.filename().string() << std::endl;
-            auto outDir = getOptOutputDir(args, cndFile.stem());
-            makePath(outDir);
-            extractAssets(cndFile, outDir, opt);
+
+            auto assets = std::move(pending.front());
+            pending.pop_front();
+            try
+            {
+                if (!extractAssets(pool, assets.get(), opt)) {
+                    nFailed++;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << std::endl;
+                printError("Failed to extract assets from CND file '%'!", cndFile.filename().string());
+                std::cerr << "       Reason: " << e.what() << std::endl;
+                nFailed++;
+            }
         }
 
-        return 0;
+        if (nFailed > 0 && cndFiles.size() > 1) {
+            printError("Failed to extract assets from % of % CND file(s)!", nFailed, cndFiles.size());
+        }
+
+        if (dedup.numDeduplicated() > 0) {
+            std::cout << "\nSkipped encoding of " << dedup.numDeduplicated() << " file(s) with duplicate content." << std::endl;
+        }
+
+        if (!dedupManifest.empty()) {
+            dedup.saveManifest(dedupManifest);
+        }
+        return nFailed > 0 ? 1 : 0;
     }
     catch (const std::exception& e)
     {
@@ -842,61 +1393,65 @@ int execCmdExtract(const CndToolArgs& args)
     }
 }
 
+/**
+ * Returns input paths of convert sub-command,
+ * i.e.: input file path parsed by args followed by positional arguments.
+ */
+std::vector<fs::path> getConvertInputs(const fs::path& inputFile, const CndToolArgs& args)
+{
+    std::vector<fs::path> inputs;
+    if (!inputFile.empty()) {
+        inputs.push_back(inputFile);
+    }
+    for (const auto& p : args.positionalArgs()) {
+        inputs.emplace_back(p);
+    }
+    return inputs;
+}
+
 int execSubCmdConvertToCnd(const CndToolArgs& args)
 {
     try
     {
-        // Get NDY file path or folder path
-        fs::path ndyPath = args.ndyFile();
-        if (ndyPath.empty())
+        if (args.ndyFile().empty() && !args.cndFile().empty())
         {
-            if (!args.cndFile().empty())
-            {
-                printError("Positional argument is CND file but NDY file is required!\n");
-                return 1;
-            }
-
-            // Get folder
-            ndyPath = !args.subcmd().empty() && args.positionalArgs().size() > 0
-                ? fs::path(args.positionalArgs().at(0))
-                : args.positionalArgs().size() > 1
-                    ? fs::path(args.positionalArgs().at(1))
-                    : fs::path();
-
+            printError("Positional argument is CND file but NDY file is required!\n");
+            return 1;
         }
 
-        if (ndyPath.empty() || (!fileExists(ndyPath) && !dirExists(ndyPath)))
+        // Input NDY files, folders or patterns are followed by game assets folder
+        auto inputs = getConvertInputs(args.ndyFile(), args);
+        if (inputs.empty())
         {
             printError("Invalid positional argument for input NDY file path or folder path!\n");
             printHelp(cmdConvert, scmdCnd);
             return 1;
         }
 
-        std::vector<fs::path> ndyFiles = getFilesFromPath(ndyPath, kExtNdy);
-        if (ndyFiles.empty())
+        if (inputs.size() < 2)
         {
-            if (fileExists(ndyPath)) {
-                printError("Positional argument is not a valid NDY file!\n");
-            }
-            else {
-                printError("No NDY file(s) found in specified folder!\n");
-            }
+            printError("Missing positional argument for game assets folder!\n");
             return 1;
         }
 
-        if (args.positionalArgs().empty())
+        const fs::path resourceDir = inputs.back();
+        inputs.pop_back();
+
+        std::vector<fs::path> ndyFiles;
+        try {
+            ndyFiles = getFilesFromPaths(inputs, kExtNdy);
+        }
+        catch (const std::invalid_argument& e)
         {
-            printError("Missing positional argument for game assets folder!\n");
+            printError("%\n", e.what());
+            printHelp(cmdConvert, scmdCnd);
             return 1;
         }
 
-        fs::path resourceDir = args.positionalArgs().at(0);
-        if (args.ndyFile().empty()) {
-            resourceDir = !args.subcmd().empty() && args.positionalArgs().size() > 1
-                ? fs::path(args.positionalArgs().at(1))
-                : args.positionalArgs().size() > 2
-                    ? fs::path(args.positionalArgs().at(2))
-                    : fs::path();
+        if (ndyFiles.empty())
+        {
+            printError("No NDY file(s) found!\n");
+            return 1;
         }
 
         if (!isDirPath(resourceDir) || !dirExists(resourceDir))
@@ -911,16 +1466,6 @@ int execSubCmdConvertToCnd(const CndToolArgs& args)
             return 1;
         }
 
-        VirtualFileSystem vfs;
-        vfs.addSysFolder(resourceDir);
-        if (!vfs.tryLoadGobContainer(resourceDir / "cd1.gob")) {
-            vfs.tryLoadGobContainer(resourceDir / "Resource" / "cd1.gob");
-        }
-
-        if (!vfs.tryLoadGobContainer(resourceDir / "cd2.gob")) {
-            vfs.tryLoadGobContainer(resourceDir / "Resource" / "cd2.gob");
-        }
-
         const bool staticCnd = args.hasArg(optStatic);
         if (ndyFiles.size() > 1 && staticCnd)
         {
@@ -928,8 +1473,13 @@ int execSubCmdConvertToCnd(const CndToolArgs& args)
             return 1;
         }
 
+        const bool verbose = hasOptVerbose(args);
         const bool verify  = args.hasArg(optStrict);
         const bool cleanUp = !args.hasArg(optNoCleanup);
+        const bool compressSounds = args.hasArg(optSoundCompress);
+        const bool incremental    = args.hasArg(optIncremental);
+        const bool optimizeGeo    = args.hasArg(optGeoOptimize);
+        const bool bakeLight      = args.hasArg(optLightBake);
 
         SoundHandle sndStartHandle = getDefaultStartSoundHandle(staticCnd);
         if (args.hasArg(optSoundStartHandle)){
@@ -939,20 +1489,20 @@ int execSubCmdConvertToCnd(const CndToolArgs& args)
             sndStartHandle = SoundHandle(args.uintArg(optSoundStartHandleShort));
         }
 
-        // Init static resources
-        StaticResourceNames staticResources;
-        staticResources.setDefault();
+        // Read-only state shared by all jobs
+        const auto pvfs = getAssetsVfs(resourceDir, getOptVfsIndex(args));
+        const VirtualFileSystem& vfs = *pvfs;
+        const auto& staticResources = defaultStaticResources();
 
-        /* Extract animations, materials & sounds */
-        for (const auto& ndyFile : ndyFiles)
-        {
-            if (ndyFiles.size() > 1) std::cout << "\nConverting to CND: " << ndyFile.filename().string() << std::endl;
-            auto ndyOutDir = getOptOutputDir(args, ndyFile.stem());
+        const auto numJobs = getBatchJobCount(getOptJobs(args), ndyFiles.size());
+        const auto nFailed = runBatchJobs(ndyFiles, numJobs, "Converting to CND: ", [&](const fs::path& ndyFile) {
+            auto ndyOutDir = getOptOutputDir(args, ndyFile.stem(), /*batch=*/ndyFiles.size() > 1);
             makePath(ndyOutDir);
-            convertNdyToCnd(ndyFile, vfs, staticResources, ndyOutDir, sndStartHandle, staticCnd, verify, cleanUp, hasOptVerbose(args));
-        }
+            // Progress is not printed when files are converted concurrently
+            return convertNdyToCnd(ndyFile, vfs, staticResources, ndyOutDir, sndStartHandle, staticCnd, verify, cleanUp, compressSounds, optimizeGeo, bakeLight, incremental, verbose || numJobs > 1);
+        });
 
-        return 0;
+        return nFailed > 0 ? 1 : 0;
     }
     catch (const std::exception& e)
     {
@@ -967,55 +1517,45 @@ int execSubCmdConvertToNdy(const CndToolArgs& args)
 {
     try
     {
-        fs::path cndPath = args.cndFile();
-        if (cndPath.empty())
+        if (args.cndFile().empty() && !args.ndyFile().empty())
         {
-            if (!args.ndyFile().empty())
-            {
-                printError("Positional argument is NDY file but CND file is required!\n");
-                return 1;
-            }
-
-            // Get folder path
-            cndPath = !args.subcmd().empty() && args.positionalArgs().size() > 0
-                ? fs::path(args.positionalArgs().at(0))
-                : args.positionalArgs().size() > 1
-                    ? fs::path(args.positionalArgs().at(1))
-                    : fs::path();
+            printError("Positional argument is NDY file but CND file is required!\n");
+            return 1;
         }
 
-        if (cndPath.empty() || (!fileExists(cndPath) && !dirExists(cndPath)))
+        // Input CND files, folders or patterns are followed by COG scripts folder
+        auto inputs = getConvertInputs(args.cndFile(), args);
+        if (inputs.empty())
         {
             printError("Invalid positional argument for input CND file path or folder path!\n");
             printHelp(cmdConvert, scmdNdy);
             return 1;
         }
 
-        std::vector<fs::path> cndFiles = getFilesFromPath(cndPath, kExtCnd);
-        if (cndFiles.empty())
+        if (inputs.size() < 2)
         {
-            if (isFilePath(cndPath)) {
-                printError("Positional argument is not a valid CND file!\n");
-            }
-            else {
-                printError("No CND file(s) found in specified folder!\n");
-            }
+            printError("Missing positional argument for COG scripts folder!\n");
             return 1;
         }
 
-        if (args.positionalArgs().empty())
+        const fs::path resourceDir = inputs.back();
+        inputs.pop_back();
+
+        std::vector<fs::path> cndFiles;
+        try {
+            cndFiles = getFilesFromPaths(inputs, kExtCnd);
+        }
+        catch (const std::invalid_argument& e)
         {
-            printError("Missing positional argument for COG scripts folder!\n");
+            printError("%\n", e.what());
+            printHelp(cmdConvert, scmdNdy);
             return 1;
         }
 
-        fs::path resourceDir = args.positionalArgs().at(0);
-        if (args.cndFile().empty()) {
-            resourceDir = !args.subcmd().empty() && args.positionalArgs().size() > 1
-                ? fs::path(args.positionalArgs().at(1))
-                : args.positionalArgs().size() > 2
-                    ? fs::path(args.positionalArgs().at(2))
-                    : fs::path();
+        if (cndFiles.empty())
+        {
+            printError("No CND file(s) found!\n");
+            return 1;
         }
 
         if (!isDirPath(resourceDir) || !dirExists(resourceDir))
@@ -1030,39 +1570,50 @@ int execSubCmdConvertToNdy(const CndToolArgs& args)
             return 1;
         }
 
-        VirtualFileSystem vfs;
-        vfs.addSysFolder(resourceDir);
-        if (!vfs.tryLoadGobContainer(resourceDir / "cd1.gob")) {
-            vfs.tryLoadGobContainer(resourceDir / "Resource" / "cd1.gob");
-        }
-
-        if (!vfs.tryLoadGobContainer(resourceDir / "cd2.gob")) {
-            vfs.tryLoadGobContainer(resourceDir / "Resource" / "cd2.gob");
-        }
+        const auto numJobs = getBatchJobCount(getOptJobs(args), cndFiles.size());
 
         ExtractOptions eopt;
         eopt.verboseOutput     = hasOptVerbose(args);
+        eopt.printProgress     = numJobs <= 1;
+        eopt.numThreads        = getOptJobs(args);
         eopt.key.extract       = !args.hasArg(optNoAnimations);
         eopt.mat.extract       = !args.hasArg(optNoMaterials);
         eopt.sound.extract     = !args.hasArg(optNoSounds);
         eopt.templates.extract = false;
 
+        FileDedup dedup; // sounds shared by levels are encoded once
+        eopt.dedup = &dedup;
+
         bool bExtractAssets = eopt.key.extract || eopt.mat.extract || eopt.sound.extract;
 
-        /* Extract animations, materials & sounds */
-        for (const auto& cndFile : cndFiles)
-        {
-            if (cndFiles.size() > 1) std::cout << "\nConverting to NDY: " << cndFile.filename().string() << std::endl;
-            auto ndyOutDir = getOptOutputDir(args, cndFile.stem());
+        // Read-only state shared by all jobs
+        const auto pvfs = getAssetsVfs(resourceDir, getOptVfsIndex(args));
+        const VirtualFileSystem& vfs = *pvfs;
+
+        // Assets of all files are written by shared pool
+        std::optional<utils::ThreadPool> assetPool;
+        if (bExtractAssets) {
+            assetPool.emplace(eopt.numThreads);
+        }
+
+        /* Convert to NDY and extract animations, materials & sounds */
+        const auto nFailed = runBatchJobs(cndFiles, numJobs, "Converting to NDY: ", [&](const fs::path& cndFile) {
+            auto ndyOutDir = getOptOutputDir(args, cndFile.stem(), /*batch=*/cndFiles.size() > 1);
             makePath(ndyOutDir);
-            if (convertCndToNdy(cndFile, vfs, ndyOutDir, eopt.verboseOutput) && bExtractAssets)
+            // Progress is not printed when files are converted concurrently
+            if (!convertCndToNdy(cndFile, vfs, ndyOutDir, eopt.verboseOutput || numJobs > 1)) {
+                return false;
+            }
+
+            if (bExtractAssets)
             {
                 LOG_DEBUG("Extracting assets key:% mat:% sound:%", eopt.key.extract, eopt.mat.extract, eopt.sound.extract);
-                extractAssets(cndFile, ndyOutDir, eopt);
+                return extractAssets(*assetPool, readCndAssets(cndFile, ndyOutDir, eopt), eopt);
             }
-        }
+            return true;
+        });
 
-        return 0;
+        return nFailed > 0 ? 1 : 0;
     }
     catch (const std::exception& e)
     {
@@ -1073,47 +1624,76 @@ int execSubCmdConvertToNdy(const CndToolArgs& args)
     }
 }
 
-int execSubCmdConvertToObj(const CndToolArgs& args)
+using ConvertGeometryF = void(*)(const fs::path&, const StaticResourceNames&, const fs::path&, bool, const PngWriteOptions&);
+
+int execSubCmdConvertGeometry(const CndToolArgs& args, std::string_view scmd, std::string_view formatName, ConvertGeometryF convert)
 {
     try
     {
-        const fs::path inputFile = args.cndFile();
-        if (!fileExists(inputFile))
+        const auto inputs = getConvertInputs(args.cndFile(), args);
+        if (inputs.empty())
         {
-            printErrorInvalidCnd(inputFile, cmdConvert, args.subcmd());
+            printErrorInvalidCnd(args.cndFile(), cmdConvert, args.subcmd());
             return 1;
         }
 
-        fs::path outDir;
-        if (args.hasArg(optOutputDirShort)){
-            outDir = args.arg(optOutputDirShort);
+        std::vector<fs::path> cndFiles;
+        try {
+            cndFiles = getFilesFromPaths(inputs, kExtCnd);
         }
-        else if (args.hasArg(optOutputDir)){
-            outDir = args.arg(optOutputDir);
+        catch (const std::invalid_argument& e)
+        {
+            printError("%\n", e.what());
+            printHelp(cmdConvert, scmd);
+            return 1;
         }
-        else {
-            outDir = getBaseName(inputFile.string());
+
+        if (cndFiles.empty())
+        {
+            printError("No CND file(s) found!\n");
+            return 1;
         }
 
-        if (!isDirPath(outDir))
+        if (!isDirPath(getOptOutputDir(args)))
         {
             printError("Output path is not directory!\n");
             return 1;
         }
 
-        // Init static resources
-        StaticResourceNames staticResources;
-        staticResources.setDefault();
+        const auto& staticResources = defaultStaticResources();
+        const bool extractMat = !args.hasArg(optNoMaterials);
+        const auto pngOptions = getOptPngWriteOptions(args);
+        if (!pngOptions) {
+            return 1;
+        }
+
+        const auto numJobs = getBatchJobCount(getOptJobs(args), cndFiles.size());
+        const auto nFailed = runBatchJobs(cndFiles, numJobs, "Converting to " + std::string(formatName) + ": ", [&](const fs::path& cndFile) {
+            const auto outDir = getOptOutputDir(args, getBaseName(cndFile.string()), /*batch=*/cndFiles.size() > 1);
+            std::cout << "Converting level geometry to " << formatName << " ... " << std::flush;
+            try
+            {
+                convert(cndFile, staticResources, outDir, extractMat, *pngOptions);
+                std::cout << kSuccess << std::endl;
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << kFailed << std::endl;
+                printError("Failed to convert level geometry to % file format!", formatName);
+                if (hasOptVerbose(args)) {
+                    std::cerr << "  Reason: " << e.what() << std::endl;
+                }
+                return false;
+            }
+        });
 
-        std::cout << "Converting level geometry to OBJ ... " << std::flush;
-        convertCndToObj(inputFile, staticResources, outDir, !args.hasArg(optNoMaterials));
-        std::cout << kSuccess << std::endl;
-        return 0;
+        return nFailed > 0 ? 1 : 0;
     }
     catch (const std::exception& e)
     {
         std::cerr << std::endl;
-        printError("Failed to convert level geometry to OBJ file format!");
+        printError("Failed to convert level geometry to % file format!", formatName);
         if (hasOptVerbose(args)) {
             std::cerr << "  Reason: " << e.what() << std::endl;
         }
@@ -1130,7 +1710,10 @@ int execCmdConvert(std::string_view scmd, const CndToolArgs& args)
         return execSubCmdConvertToNdy(args);
     }
     else if (scmd == scmdObj) {
-        return execSubCmdConvertToObj(args);
+        return execSubCmdConvertGeometry(args, scmdObj, "OBJ", convertCndToObj);
+    }
+    else if (scmd == scmdGlb) {
+        return execSubCmdConvertGeometry(args, scmdGlb, "GLB", convertCndToGlb);
     }
 
     if (scmd.empty()) {
@@ -1161,32 +1744,36 @@ int execCmdList(const CndToolArgs& args)
         listAnim = listMat = listSnd = true;
     }
 
-    auto printList = [](const auto& l) {
-        for(std::size_t i = 0; i < l.size(); i++) {
-            std::cout << "  " << i << ": " << l.value(i).name() << std::endl;
-        }
-        std::cout << std::endl;
-    };
-
-    InputFileStream istream(cndFile);
+    // Asset names are read directly from section headers of mapped file without parsing the assets
+    const CndView cnd(cndFile);
     if (listAnim)
     {
-        auto anims = CND::readKeyframes(istream);
         std::cout << "Animations:\n";
-        printList(anims);
+        std::size_t i = 0;
+        for (const auto& h : cnd.keyframes()) {
+            std::cout << "  " << i++ << ": " << h.name.toStdString() << std::endl;
+        }
+        std::cout << std::endl;
     }
 
     if (listMat)
     {
-        auto mats = CND::readMaterials(istream);
         std::cout << "Materials:\n";
-        printList(mats);
+        std::size_t i = 0;
+        for (const auto& h : cnd.materials())
+        {
+            if (h.celCount > 0 && h.mipLevels > 0) { // Materials without pixel data are not imported
+                std::cout << "  " << i++ << ": " << h.name.toStdString() << std::endl;
+            }
+        }
+        std::cout << std::endl;
     }
 
     if (listSnd)
     {
+        InputFileStream istream(cndFile);
         SoundBank sb(1);
-        sb.importTrack(0, istream);
+        CND::readSounds(istream, sb, 0);
         auto& sounds = sb.getTrack(0);
 
         std::cout << "Sounds:\n";
@@ -1290,6 +1877,111 @@ int execCmdRemove(std::string_view scmd, const CndToolArgs& args)
     return 1;
 }
 
+int execCmd(std::string_view cmd, const CndToolArgs& args);
+
+int execCmdServe(const CndToolArgs& args)
+{
+#ifdef LIBIM_OS_WINDOWS
+    printError("Command '%' is not supported on this platform!", cmdServe);
+    return 1;
+#else
+    try
+    {
+        // Socket path is the first positional argument, it's parsed as sub-command when no option precedes it
+        auto resourceDirs = args.positionalArgs();
+        fs::path socketPath = args.subcmd();
+        if (socketPath.empty() && !resourceDirs.empty())
+        {
+            socketPath = resourceDirs.front();
+            resourceDirs.erase(resourceDirs.begin());
+        }
+
+        if (socketPath.empty())
+        {
+            printError("Missing positional argument for socket path!\n");
+            printHelp(cmdServe);
+            return 1;
+        }
+
+        // Resources loaded here are inherited by all requests
+        [[maybe_unused]] const auto& staticResources = defaultStaticResources();
+        for (const fs::path resourceDir : resourceDirs)
+        {
+            if (!isDirPath(resourceDir) || !dirExists(resourceDir))
+            {
+                printError("Game assets path '%' is not directory!\n", resourceDir);
+                return 1;
+            }
+
+            std::cout << "Loading game assets folder " << resourceDir << std::endl;
+            [[maybe_unused]] auto vfs   = getAssetsVfs(resourceDir);
+            [[maybe_unused]] auto smats = loadStaticCndMaterials(resourceDir / kDefaultStaticResourcesFilename);
+        }
+
+        std::size_t maxJobs = getOptJobs(args);
+        if (maxJobs == 0) {
+            maxJobs = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        std::cout << "Listening on " << socketPath << ", press Ctrl+C to stop the server." << std::endl;
+        serve(socketPath, maxJobs, [](const std::vector<std::string>& reqArgs)
+        {
+            std::vector<const char*> argv = { "cndtool" };
+            for (const auto& a : reqArgs) {
+                argv.push_back(a.c_str());
+            }
+
+            CndToolArgs rargs(argv.size(), argv.data());
+            if (rargs.cmd().empty() || rargs.cmd() == cmdServe)
+            {
+                printError("Invalid request command '%'!", rargs.cmd());
+                return 1;
+            }
+
+            gLogLevel = hasOptVerbose(rargs) ? LogLevel::Verbose : LogLevel::Warning;
+            TraceSession trace(rargs, "cndtool");
+            return execCmd(rargs.cmd(), rargs);
+        });
+
+        std::cout << "Server stopped." << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        printError("Failed to run server!");
+        std::cerr << "       Reason: " << e.what() << std::endl;
+        return 1;
+    }
+#endif
+}
+
+int execCmdOnServer(const CndToolArgs& args, int argc, const char* argv[])
+{
+#ifdef LIBIM_OS_WINDOWS
+    printError("Option '%' is not supported on this platform!", optConnect);
+    return 1;
+#else
+    try
+    {
+        std::vector<std::string> reqArgs;
+        for (int i = 1; i < argc; i++)
+        {
+            std::string_view arg = argv[i];
+            if (!arg.starts_with(optConnect)) {
+                reqArgs.emplace_back(arg);
+            }
+        }
+        return sendServeRequest(args.arg(optConnect), reqArgs);
+    }
+    catch (const std::exception& e)
+    {
+        printError("Failed to execute command on cndtool server!");
+        std::cerr << "       Reason: " << e.what() << std::endl;
+        return 1;
+    }
+#endif
+}
+
 int execCmd(std::string_view cmd, const CndToolArgs& args)
 {
 
@@ -1308,6 +2000,9 @@ int execCmd(std::string_view cmd, const CndToolArgs& args)
     else if (cmd == cmdRemove) {
         return execCmdRemove(args.subcmd(), args);
     }
+    else if (cmd == cmdServe) {
+        return execCmdServe(args);
+    }
     else
     {
         if (cmd != cmdHelp) {
@@ -1339,5 +2034,10 @@ int main(int argc, const char* argv[])
         gLogLevel = LogLevel::Verbose;
     }
 
+    if (args.hasArg(optConnect) && args.cmd() != cmdServe) {
+        return execCmdOnServer(args, argc, argv);
+    }
+
+    TraceSession trace(args, "cndtool");
     return execCmd(args.cmd(), args);
 }
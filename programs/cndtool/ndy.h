@@ -17,10 +17,14 @@
 #include <libim/io/filestream.h>
 #include <libim/io/vfs.h>
 #include <libim/log/log.h>
+#include <libim/trace/trace.h>
+#include <libim/utils/arena.h>
 #include <libim/utils/utils.h>
 
+#include <bitset>
 #include <exception>
 #include <filesystem>
+#include <memory_resource>
 #include <vector>
 
 namespace cndtool {
@@ -51,11 +55,15 @@ namespace cndtool {
         ByteArray pvs;
     };
 
+    /** Set of CND sections indexed by CndSection, e.g. sections of NdyWorld which were read. */
+    using CndSectionSet = std::bitset<kNumCndSections>;
+
      /**
      * Verifies that the normal world contains all required data. Throws exception if not.
      * Note, function expects StaticResourceNames to be already initialized when the function is called.
+     * Only the world sections in set sections are verified.
      */
-    void checkNdyWorld(const NdyWorld& world, const StaticResourceNames& staticResources)
+    void checkNdyWorld(const NdyWorld& world, const StaticResourceNames& staticResources, const CndSectionSet& sections = CndSectionSet().set())
     {
         using namespace libim::utils;
         check(world.sounds.second.size()       <= kStaticResourceIndexMask , "Too many sounds in the list, max=%!"        , kStaticResourceIndexMask);
@@ -71,13 +79,20 @@ namespace cndtool {
         check(world.templates.second.size()    <= kMaxTemplates            , "Too many templates in the list, max=%!"     , kMaxTemplates);
         check(world.things.size()              <= kMaxThings               , "Too many things in the list, max=%!"        , kMaxThings);
 
-        check(world.georesource.adjoins.size()     > 0 , "Georesource section is missing adjoins!");
-        check(world.georesource.surfaces.size()    > 0 , "Georesource section is missing surfaces!");
-        check(world.georesource.vertices.size()    > 0 , "Georesource section is missing vertices!");
-        check(world.georesource.texVertices.size() > 0 , "Georesource section is missing texture vertices!");
+        const auto isSet = [&](CndSection s) {
+            return sections.test(static_cast<std::size_t>(s));
+        };
 
-        check(world.sectors.size() > 0 , "Sector section is empty!");
-        check(world.things.size()  > 0 , "Thing section is empty!");
+        if (isSet(CndSection::Georesource))
+        {
+            check(world.georesource.adjoins.size()     > 0 , "Georesource section is missing adjoins!");
+            check(world.georesource.surfaces.size()    > 0 , "Georesource section is missing surfaces!");
+            check(world.georesource.vertices.size()    > 0 , "Georesource section is missing vertices!");
+            check(world.georesource.texVertices.size() > 0 , "Georesource section is missing texture vertices!");
+        }
+
+        check(!isSet(CndSection::Sectors) || world.sectors.size() > 0 , "Sector section is empty!");
+        check(!isSet(CndSection::Things)  || world.things.size()  > 0 , "Thing section is empty!");
 
         // Check surface indices are in bounds
         for (std::size_t i = 0; i < world.georesource.surfaces.size(); i++)
@@ -138,6 +153,7 @@ namespace cndtool {
      */
     bool convertCndToNdy(const fs::path& cndPath, const VirtualFileSystem& vfs, const fs::path& outDir, bool verbose)
     {
+        LIBIM_TRACE_SCOPE_DETAIL("cndtool", "convertCndToNdy", cndPath.generic_string());
         using namespace cmdutils;
         fs::path ndyPath;
         try
@@ -147,6 +163,9 @@ namespace cndtool {
             std::size_t progress = 0;
             if (!verbose) printProgress(progressTitle, progress++, total);
 
+            // World data is allocated from arena and freed at once at the end of conversion
+            utils::Arena arena;
+
             LOG_DEBUG("Opening file stream and reading CND header of file %", cndPath);
             InputFileStream icnds(cndPath);
             auto header = CND::readHeader(icnds);
@@ -162,11 +181,11 @@ namespace cndtool {
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             LOG_DEBUG("Parsing CND section 'GeoResource' at offset: %", utils::to_string<16>(icnds.tell()));
-            auto geores = CND::parseSection_Georesource(icnds, header);
+            auto geores = CND::parseSection_Georesource(icnds, header, &arena);
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             LOG_DEBUG("Parsing CND section 'Sectors' at offset: %", utils::to_string<16>(icnds.tell()));
-            auto sectors = CND::parseSection_Sectors(icnds, header);
+            auto sectors = CND::parseSection_Sectors(icnds, header, &arena);
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             LOG_DEBUG("Parsing CND section 'AIClasses' at offset: %", utils::to_string<16>(icnds.tell()));
@@ -208,7 +227,7 @@ namespace cndtool {
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             LOG_DEBUG("Parsing CND section 'Templates' at offset: %", utils::to_string<16>(icnds.tell()));
-            auto cndTemplates = CND::parseSection_Templates(icnds, header);
+            auto cndTemplates = CND::parseSection_Templates(icnds, header, &arena);
             if (!verbose) printProgress(progressTitle, progress++, total);
 
             LOG_DEBUG("Parsing CND section 'Things' at offset: %", utils::to_string<16>(icnds.tell()));
@@ -306,7 +325,11 @@ namespace cndtool {
         }
     }
 
-    void ndyParseSection(std::string_view section, TextResourceReader& rr, const VirtualFileSystem& vfs, NdyWorld& world)
+    /**
+     * Parses NDY section into world.
+     * @param lineOffset - number of lines preceding the section's text stream, added to line numbers in error messages.
+     */
+    void ndyParseSection(std::string_view section, TextResourceReader& rr, const VirtualFileSystem& vfs, NdyWorld& world, std::size_t lineOffset = 0)
     {
         try
         {
@@ -372,29 +395,35 @@ namespace cndtool {
             else
             {
                 auto loc = rr.currentLocation();
-                LOG_INFO("%:%:%: Skipping unknown section '%'", loc.filename, loc.firstLine, loc.firstColumn, section);
+                LOG_INFO("%:%:%: Skipping unknown section '%'", loc.filename, loc.firstLine + lineOffset, loc.firstColumn, section);
             }
         }
         catch (const SyntaxError& e)
         {
             auto loc = e.location();
             throw std::runtime_error(
-                utils::format("%:%:%: Syntax error encountered while parsing NDY section '%': %", loc.filename, loc.firstLine, loc.firstColumn, section, e.what())
+                utils::format("%:%:%: Syntax error encountered while parsing NDY section '%': %", loc.filename, loc.firstLine + lineOffset, loc.firstColumn, section, e.what())
             );
         }
         catch (const std::exception& e)
         {
             auto loc = rr.currentLocation();
             throw std::runtime_error(
-                utils::format("%:%:%: An exception encountered while parsing NDY section '%': %", loc.filename, loc.firstLine, loc.firstColumn, section, e.what())
+                utils::format("%:%:%: An exception encountered while parsing NDY section '%': %", loc.filename, loc.firstLine + lineOffset, loc.firstColumn, section, e.what())
             );
         }
     }
 
-    NdyWorld ndyReadFile(const fs::path& ndyPath, const VirtualFileSystem& vfs)
+    /**
+     * Reads NDY file.
+     * World lists are allocated from mr if not null. See TextResourceReader::setMemoryResource.
+     */
+    NdyWorld ndyReadFile(const fs::path& ndyPath, const VirtualFileSystem& vfs, std::pmr::memory_resource* mr = nullptr)
     {
+        LIBIM_TRACE_SCOPE_DETAIL("cndtool", "ndyReadFile", ndyPath.generic_string());
         InputFileStream ndyStream(ndyPath);
         TextResourceReader ndytrr(ndyStream);
+        ndytrr.setMemoryResource(mr);
 
         NdyWorld world{};
 
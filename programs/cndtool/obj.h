@@ -5,8 +5,8 @@
 #include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
 #include <libim/content/asset/world/impl/serialization/world_ser_common.h>
 #include <libim/content/text/text_resource_writer.h>
-#include <libim/io/binarystream.h>
 #include <libim/io/filestream.h>
+#include <libim/io/memorystream.h>
 #include <libim/utils/utils.h>
 
 #include "config.h"
@@ -15,10 +15,14 @@
 #include <array>
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
 #include <stdexcept>
+#include <vector>
 
 namespace cndtool {
     constexpr std::string_view kMtlFolder              = "mtl";
@@ -64,7 +68,121 @@ namespace cndtool {
         return libim::Vector3f(v.x(), v.z(), -v.y()); // Right-hand coord sys with y as up axis.
     }
 
-    void convertCndToObj(const std::filesystem::path& inCndPath, const StaticResourceNames& staticResources, const std::filesystem::path& outFolder, bool extractMat)
+    /**
+     * Returns materials of static CND file (jones3dstatic.cnd).
+     * Loaded materials are cached per process until the file is changed.
+     * If file doesn't exist, empty table is returned.
+     */
+    [[nodiscard]] inline std::shared_ptr<const libim::Table<libim::content::asset::Material>> loadStaticCndMaterials(const std::filesystem::path& scndPath)
+    {
+        using namespace libim;
+        using namespace libim::content::asset;
+        using CacheEntry = std::pair<FileStamp, std::shared_ptr<const Table<Material>>>;
+        static std::mutex mutex;
+        static std::map<std::filesystem::path, CacheEntry> cache;
+
+        std::error_code ec;
+        auto key = std::filesystem::weakly_canonical(scndPath, ec);
+        if (ec) {
+            key = scndPath;
+        }
+
+        const auto stamp = FileStamp::of(scndPath);
+        std::scoped_lock lock(mutex);
+        if (auto it = cache.find(key); it != cache.end() && it->second.first == stamp) {
+            return it->second.second;
+        }
+
+        auto mats = std::make_shared<Table<Material>>();
+        if (stamp.exists)
+        {
+            LOG_DEBUG("Loading materials from %", scndPath);
+            InputFileStream icnds(scndPath);
+            *mats = CND::readMaterials(icnds);
+        }
+
+        cache[key] = { stamp, mats };
+        return mats;
+    }
+
+    /**
+     * Returns vertex normals of georesource vertices.
+     * Vertex normal is calculated by averaging normals of surfaces that contain the vertex (see unweightedVertexNormal).
+     * The normals are accumulated in a single pass over surfaces.
+     */
+    [[nodiscard]] inline std::vector<libim::Vector3f> getVertexNormals(const libim::content::asset::Georesource& geores)
+    {
+        using namespace libim;
+        std::vector<Vector3f> normals(geores.vertices.size());
+        std::vector<std::size_t> counts(geores.vertices.size(), 0);
+        for (const auto& s : geores.surfaces)
+        {
+            for (const auto& v : s.vertices)
+            {
+                normals.at(v.vertIdx) += s.normal;
+                counts[v.vertIdx]++;
+            }
+        }
+
+        for (std::size_t i = 0; i < normals.size(); i++)
+        {
+            if (counts[i] > 0) {
+                normals[i] /= static_cast<float>(counts[i]);
+            }
+        }
+        return normals;
+    }
+
+    struct SurfaceMaterial
+    {
+        std::string name;
+        const libim::content::asset::Material* mat = nullptr; // nullptr if material asset is not available
+    };
+
+    /**
+     * Returns name and material asset of surface material.
+     * The material is looked up in the level materials and in the materials of jones3dstatic.cnd.
+     * If surface has no material i.e. is transparent, std::nullopt is returned.
+     */
+    [[nodiscard]] inline std::optional<SurfaceMaterial> getSurfaceMaterial(const libim::content::asset::Surface& s,
+        const libim::Table<libim::content::asset::Material>& mats, const libim::Table<libim::content::asset::Material>& smats, const StaticResourceNames& staticResources)
+    {
+        using namespace libim;
+        using namespace libim::content::asset;
+        namespace fs = std::filesystem;
+
+        auto matIdx = fromOptionalIdx(s.matIdx);
+        if (matIdx < 0) {
+            return std::nullopt;
+        }
+
+        if (matIdx < mats.size())
+        {
+            const auto& mat = mats.value(matIdx);
+            return SurfaceMaterial{ fs::path(mat.name()).stem().string(), &mat };
+        }
+
+        // mat in jones3dstatic
+        matIdx = getStaticResourceIdx(matIdx);
+        if (matIdx < smats.size())
+        {
+            // mat is in jones3dStatic.cnd
+            const auto& mat = smats.value(matIdx);
+            return SurfaceMaterial{ fs::path(mat.name()).stem().string(), &mat };
+        }
+
+        // mat is not in jones3dStatic
+        // or jones3dStatic.cnd was not found
+        if (matIdx < staticResources.materials.size()) {
+            // TODO: Try to load mat from specified in staticResources
+            return SurfaceMaterial{ getBaseName(staticResources.materials.key(matIdx)) };
+        }
+
+        LOG_WARNING("Unknown surface % material asset from jones3dstatic at index %. Setting surface material as %.", s.id, matIdx, kImgDefault);
+        return SurfaceMaterial{ std::string(kImgDefault) };
+    }
+
+    void convertCndToObj(const std::filesystem::path& inCndPath, const StaticResourceNames& staticResources, const std::filesystem::path& outFolder, bool extractMat, const libim::content::asset::PngWriteOptions& pngOptions = {})
     {
         using namespace libim;
         using namespace libim::content::asset;
@@ -81,14 +199,9 @@ namespace cndtool {
         // Load materials from jones3dstatic.cnd
         fs::path scndPath = inCndPath;
         scndPath.replace_filename(kDefaultStaticResourcesFilename);
-        Table<Material> smats;
-        if (fileExists(scndPath))
-        {
-            LOG_DEBUG("Loading materials from %", kDefaultStaticResourcesFilename);
-            InputFileStream icnds(scndPath);
-            smats = CND::readMaterials(icnds);
-        }
-        else {
+        const auto psmats = loadStaticCndMaterials(scndPath);
+        const Table<Material>& smats = *psmats;
+        if (!fileExists(scndPath)) {
             LOG_WARNING("File % was not found. Some surfaces might have incomplete texture information.", kDefaultStaticResourcesFilename);
         }
 
@@ -125,53 +238,18 @@ namespace cndtool {
                 rw.writeEol();
             }
 
-            // Write surfaces & vertex normals to buffers
-            std::vector<std::vector<Vector3f>> fnormals(geores.vertices.size()); // face normals that share the same vertex
-            std::vector<byte_t> fbuffer;
+            // Write surfaces to buffer
+            MemoryOutputStream fbuffer;
             fbuffer.reserve(geores.surfaces.size() * kFaceLineMaxChars);
 
-            OutputBinaryStream<decltype(fbuffer)> bs(fbuffer);
-            TextResourceWriter brw(bs);
+            TextResourceWriter brw(fbuffer);
             for (const auto& s : geores.surfaces)
             {
                 // Write texture to use with face
-                auto matIdx = fromOptionalIdx(s.matIdx);
-                if (matIdx >= 0)
+                if (auto sm = getSurfaceMaterial(s, mats, smats, staticResources))
                 {
-                    std::string name;
-                    const Material* pMat = nullptr;
-                    if (matIdx < mats.size()) {
-                        const auto& mat = mats.value(matIdx);
-                        name = fs::path(mat.name()).stem().string();
-                        pMat = &mat;
-                    }
-                    else // mat in jones3dstatic
-                    {
-                        matIdx = getStaticResourceIdx(matIdx);
-                        if (matIdx < smats.size())
-                        {
-                            // mat is in jones3dStatic.cnd
-                            pMat = &smats.value(matIdx);
-                            name = fs::path(pMat->name()).stem().string();
-                        }
-                        else
-                        {
-                            // mat is not in jones3dStatic
-                            // or jones3dStatic.cnd was not found
-                            if (matIdx < staticResources.materials.size()) {
-                                // TODO: Try to load mat from specified in staticResources
-                                name = getBaseName(staticResources.materials.key(matIdx));
-                            }
-                            else
-                            {
-                                LOG_WARNING("Unknown surface % material asset from jones3dstatic at index %. Setting surface material as %.", s.id, matIdx, kImgDefault);
-                                name = kImgDefault;
-                            }
-                        }
-                    }
-
-                    usedMats.pushBack(name, pMat);
-                    brw.writeLine("usemtl "s + name);
+                    usedMats.pushBack(sm->name, sm->mat);
+                    brw.writeLine("usemtl "s + sm->name);
                 }
                 else {
                     brw.writeLine(kUseMtlTransparent);
@@ -190,26 +268,20 @@ namespace cndtool {
                     brw.write("/");
                     brw.writeNumber(v.vertIdx + 1); // normal idx. Note: idx in obj starts at 1
                     brw.indent(1);
-
-                    // Write vertex normal
-                    fnormals[v.vertIdx].push_back(s.normal);
                 }
                 brw.writeEol();
             }
 
-            // Calculate & write vertex normals
-            int i = 0;
-            for (const auto& fn : fnormals)
+            // Write vertex normals
+            for (const auto& vn : getVertexNormals(geores))
             {
-                auto vn = unweightedVertexNormal(fn);
                 rw.write("vn");
                 rw.writeVector(getObjCoords(vn), /*width=*/ 1);
                 rw.writeEol();
-                i++;
             }
 
             // Write object mesh faces
-            objs << fbuffer;
+            fbuffer.writeTo(objs);
         }
 
         // Write mtl
@@ -260,7 +332,7 @@ namespace cndtool {
                     {
                         const auto matOutPath =  outFolder / kMtlPngFolder / (name + ".png");
                         makePath(matOutPath);
-                        pngWrite(OutputFileStream(matOutPath, /*truncate=*/true), mat->cells().at(0));
+                        pngWrite(OutputFileStream(matOutPath, /*truncate=*/true), mat->cells().at(0), pngOptions);
                     }
                     else { // mat in jones3dstatic
                         LOG_WARNING("Couldn't find material: '%'", name);
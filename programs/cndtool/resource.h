@@ -1,7 +1,12 @@
 #ifndef CNDTOOL_RESOURCE_H
 #define CNDTOOL_RESOURCE_H
+#include <array>
+#include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -15,6 +20,7 @@
 
 #include <libim/io/vfs.h>
 #include <libim/log/log.h>
+#include <libim/types/atom.h>
 #include <libim/types/indexmap.h>
 #include <libim/types/sharedref.h>
 #include <libim/types/string_map.h>
@@ -89,12 +95,12 @@ namespace cndtool {
         return materials;
     }
 
-    void loadSounds(const VirtualFileSystem& vfs, SoundBank& bank, std::size_t trackIdx, const std::vector<std::string>& soundFilenames)
+    void loadSounds(const VirtualFileSystem& vfs, SoundBank& bank, std::size_t trackIdx, const std::vector<std::string>& soundFilenames, bool compress = false)
     {
         for (const auto& sndFilename : soundFilenames)
         {
             auto file = searchFile(vfs, { kSoundDir1, kSoundDir2, kSoundDir3 }, sndFilename);
-            bank.loadSound(file.get(), trackIdx);
+            bank.loadSound(file.get(), trackIdx, compress);
         }
     }
 
@@ -171,14 +177,33 @@ namespace cndtool {
         );
     }
 
+    /**
+     * Removes strings found in the atom set from list.
+     * Strings of list are looked up in the atom pool and are not interned.
+     */
+    inline void filterStringList(std::vector<std::string>& list, const AtomSet& filter)
+    {
+        if (filter.size() == 0) {
+            return;
+        }
+
+        list.erase(
+            std::remove_if(list.begin(), list.end(), [&filter](const auto& str) {
+                auto atom = Atom::find(str);
+                return atom && filter.contains(*atom);
+            }),
+            list.end()
+        );
+    }
+
     struct StaticResourceNames
     {
         std::string filename; //The name of the file containing the static resource names
-        StringSet<> keyframes;
-        StringSet<> models;
-        StringSet<> sounds;
-        StringSet<> scripts;
-        StringSet<> sprites;
+        AtomSet keyframes;
+        AtomSet models;
+        AtomSet sounds;
+        AtomSet scripts;
+        AtomSet sprites;
         UniqueTable<uint32_t> materials;
 
         void setDefault()
@@ -1295,6 +1320,135 @@ namespace cndtool {
             };
         }
     };
+
+    /** Returns default static resource names. The list is built only once per process. */
+    [[nodiscard]] inline const StaticResourceNames& defaultStaticResources()
+    {
+        static const StaticResourceNames res = []{
+            StaticResourceNames r;
+            r.setDefault();
+            return r;
+        }();
+        return res;
+    }
+
+    /** File size and modification time, used to detect changed files of cached resources. */
+    struct FileStamp
+    {
+        bool exists = false;
+        std::uintmax_t size = 0;
+        fs::file_time_type mtime;
+
+        [[nodiscard]] static FileStamp of(const fs::path& path)
+        {
+            std::error_code ec;
+            FileStamp s;
+            s.size   = fs::file_size(path, ec);
+            s.exists = !ec;
+            if (s.exists) {
+                s.mtime = fs::last_write_time(path, ec);
+            }
+            return s;
+        }
+
+        bool operator == (const FileStamp&) const = default;
+    };
+
+    /**
+     * Returns VFS of game assets folder.
+     * The VFS consists of the assets folder and cd1.gob & cd2.gob GOB files
+     * found either in the assets folder or in its Resource subfolder.
+     *
+     * The VFS is cached per process and reused by following calls for the same folder
+     * until any of the GOB files is changed or the mounted VFS index becomes stale.
+     *
+     * When indexFile is set, the assets folder and GOB files are mounted through persisted VFS index,
+     * see VirtualFileSystem::mountIndex. If the index can't be mounted, GOB files are loaded as usual.
+     *
+     * @param assetsDir - game assets folder path.
+     * @param indexFile - optional VFS index file path.
+     * @throw VfsError if assetsDir is not existing folder.
+     */
+    [[nodiscard]] inline std::shared_ptr<const VirtualFileSystem> getAssetsVfs(const fs::path& assetsDir, const fs::path& indexFile = {})
+    {
+        struct CacheEntry
+        {
+            std::vector<FileStamp> gobStamps;
+            std::shared_ptr<const VirtualFileSystem> vfs;
+        };
+        static std::mutex mutex;
+        static std::map<fs::path, CacheEntry> cache;
+
+        // Absolute path is used, so cached VFS is valid after the working directory is changed
+        std::error_code ec;
+        auto dir = fs::weakly_canonical(fs::absolute(assetsDir, ec), ec);
+        if (ec) {
+            dir = assetsDir;
+        }
+        dir /= ""; // dir path ends with separator
+
+        constexpr std::array<std::string_view, 2> gobNames = { "cd1.gob", "cd2.gob" };
+        std::vector<fs::path> gobPaths;
+        for (auto gobName : gobNames)
+        {
+            gobPaths.push_back(dir / gobName);
+            gobPaths.push_back(dir / "Resource" / gobName);
+        }
+
+        std::vector<FileStamp> gobStamps;
+        for (const auto& p : gobPaths) {
+            gobStamps.push_back(FileStamp::of(p));
+        }
+
+        std::scoped_lock lock(mutex);
+        if (auto it = cache.find(dir); it != cache.end() && it->second.gobStamps == gobStamps)
+        {
+            // Mounted index is a snapshot of the system folder which could have changed since it was cached
+            if (it->second.vfs->isIndexUpToDate())
+            {
+                LOG_DEBUG("Using cached VFS of folder %", assetsDir);
+                return it->second.vfs;
+            }
+            LOG_DEBUG("Cached VFS index of folder % is stale", assetsDir);
+        }
+
+        if (!indexFile.empty())
+        {
+            std::vector<fs::path> gobFiles;
+            for (std::size_t i = 0; i < gobPaths.size(); i += 2)
+            {
+                if (fileExists(gobPaths.at(i))) {
+                    gobFiles.push_back(gobPaths.at(i));
+                }
+                else if (fileExists(gobPaths.at(i + 1))) {
+                    gobFiles.push_back(gobPaths.at(i + 1));
+                }
+            }
+
+            try
+            {
+                auto vfs = std::make_shared<VirtualFileSystem>();
+                vfs->mountIndex(indexFile, { dir }, gobFiles);
+                cache[dir] = { std::move(gobStamps), vfs };
+                return vfs;
+            }
+            catch (const VfsError& e) {
+                LOG_WARNING("Failed to mount VFS index file '%': %", indexFile, e.what());
+            }
+        }
+
+        auto vfs = std::make_shared<VirtualFileSystem>();
+        vfs->addSysFolder(dir);
+        for (std::size_t i = 0; i < gobPaths.size(); i += 2)
+        {
+            if (!vfs->tryLoadGobContainer(gobPaths.at(i))) {
+                vfs->tryLoadGobContainer(gobPaths.at(i + 1));
+            }
+        }
+
+        cache[dir] = { std::move(gobStamps), vfs };
+        return vfs;
+    }
 }
 
 #endif // CNDTOOL_RESOURCE_H
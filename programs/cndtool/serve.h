@@ -0,0 +1,447 @@
+#ifndef CNDTOOL_SERVE_H
+#define CNDTOOL_SERVE_H
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <libim/log/log.h>
+#include <libim/platform.h>
+#include <libim/utils/utils.h>
+
+#ifndef LIBIM_OS_WINDOWS
+# include <fcntl.h>
+# include <poll.h>
+# include <signal.h>
+# include <sys/socket.h>
+# include <sys/types.h>
+# include <sys/un.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+/**
+ * Server mode of cndtool.
+ *
+ * The server listens on Unix socket and executes cndtool commands sent by clients.
+ * Each request is executed in child process forked from the server process,
+ * so the request inherits the state which was loaded once by the server (mounted VFS, static resources, ...)
+ * and requests can run concurrently without sharing any mutable state.
+ *
+ * Protocol:
+ *   request:  <working-dir>\0<arg-1>\0...<arg-n>\0\0
+ *   response: <console output of the command>\0<exit code>
+ *
+ * The request arguments are cndtool command arguments without the program path.
+ * Relative paths in arguments are resolved against the request working directory.
+ * The response console output contains both stdout and stderr output of the command.
+ */
+
+namespace cndtool {
+    namespace fs = std::filesystem;
+
+    struct ServerError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    /** Executes request command arguments and returns the exit code. */
+    using ServeRequestF = std::function<int(const std::vector<std::string>& args)>;
+
+#ifndef LIBIM_OS_WINDOWS
+    namespace detail {
+        constexpr std::size_t kMaxServeRequestSize = 1024 * 1024;
+
+        inline int gServeSignalPipe[2] = { -1, -1 };
+
+        inline void serveSignalHandler(int sig)
+        {
+            const int err = errno;
+            const char c = static_cast<char>(sig);
+            [[maybe_unused]] auto n = ::write(gServeSignalPipe[1], &c, 1);
+            errno = err;
+        }
+
+        inline void setSignalHandler(int sig, void(*handler)(int))
+        {
+            struct sigaction sa {};
+            sa.sa_handler = handler;
+            sa.sa_flags   = SA_RESTART;
+            sigemptyset(&sa.sa_mask);
+            sigaction(sig, &sa, nullptr);
+        }
+
+        [[nodiscard]] inline sockaddr_un makeSocketAddress(const fs::path& socketPath)
+        {
+            sockaddr_un addr {};
+            const auto path = socketPath.string();
+            if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+                throw ServerError(libim::utils::format("Invalid socket path '%'", path));
+            }
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            return addr;
+        }
+
+        [[nodiscard]] inline bool isSocketInUse(const sockaddr_un& addr)
+        {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1) {
+                return false;
+            }
+            const bool inUse = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+            ::close(fd);
+            return inUse;
+        }
+
+        [[nodiscard]] inline int connectSocket(const fs::path& socketPath)
+        {
+            const auto addr = makeSocketAddress(socketPath);
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1) {
+                throw ServerError(libim::utils::format("Failed to create socket: %", std::strerror(errno)));
+            }
+
+            if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1)
+            {
+                const int err = errno;
+                ::close(fd);
+                throw ServerError(libim::utils::format("Failed to connect to server at '%': %", socketPath.string(), std::strerror(err)));
+            }
+            return fd;
+        }
+
+        inline bool writeAll(int fd, std::string_view data)
+        {
+            while (!data.empty())
+            {
+                auto n = ::write(fd, data.data(), data.size());
+                if (n == -1)
+                {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                data.remove_prefix(static_cast<std::size_t>(n));
+            }
+            return true;
+        }
+
+        /** Reads request from fd and returns request working dir followed by command arguments. */
+        [[nodiscard]] inline std::vector<std::string> readServeRequest(int fd)
+        {
+            std::vector<std::string> req(1);
+            std::size_t size = 0;
+            char buf[4096];
+            while (true)
+            {
+                auto n = ::read(fd, buf, sizeof(buf));
+                if (n == -1 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    throw ServerError("Incomplete request");
+                }
+
+                size += static_cast<std::size_t>(n);
+                if (size > kMaxServeRequestSize) {
+                    throw ServerError("Request too large");
+                }
+
+                for (const char c : std::string_view(buf, static_cast<std::size_t>(n)))
+                {
+                    if (c != '\0') {
+                        req.back().push_back(c);
+                    }
+                    else if (!req.back().empty()) {
+                        req.emplace_back();
+                    }
+                    else
+                    {
+                        req.pop_back(); // terminating empty argument
+                        if (req.empty()) {
+                            throw ServerError("Request is missing working directory");
+                        }
+                        return req;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Executes request in forked child process.
+         * Command output is redirected to the client connection.
+         */
+        [[nodiscard]] inline int execServeRequest(int conn, const ServeRequestF& execRequest)
+        {
+            int devNull = ::open("/dev/null", O_RDONLY);
+            if (devNull != -1)
+            {
+                ::dup2(devNull, STDIN_FILENO);
+                ::close(devNull);
+            }
+            ::dup2(conn, STDOUT_FILENO);
+            ::dup2(conn, STDERR_FILENO);
+
+            int code = 1;
+            try
+            {
+                auto req = readServeRequest(conn);
+                ::close(conn);
+
+                fs::current_path(req.at(0));
+                req.erase(req.begin());
+                code = execRequest(req);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Failed to execute request: " << e.what() << std::endl;
+            }
+
+            libim::flushLog();
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+            return code;
+        }
+    }
+
+    /**
+     * Runs server listening for requests on Unix socket.
+     * The server runs until SIGINT or SIGTERM is received,
+     * after that it waits for all running requests to finish and removes the socket file.
+     *
+     * @note The calling process must be single-threaded, as each request is executed in forked process.
+     *
+     * @param socketPath  - file path of Unix socket. Stale socket file is replaced.
+     * @param maxJobs     - max number of concurrently executed requests.
+     * @param execRequest - function executing request in child process.
+     * @throw ServerError if server couldn't be started.
+     */
+    inline void serve(const fs::path& socketPath, std::size_t maxJobs, const ServeRequestF& execRequest)
+    {
+        using namespace detail;
+        using libim::utils::format;
+        maxJobs = std::max<std::size_t>(maxJobs, 1);
+
+        const auto addr = makeSocketAddress(socketPath);
+        std::error_code ec;
+        if (fs::is_socket(socketPath, ec))
+        {
+            if (isSocketInUse(addr)) {
+                throw ServerError(format("Socket '%' is used by another server", socketPath.string()));
+            }
+            fs::remove(socketPath, ec); // stale socket
+        }
+
+        int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd == -1) {
+            throw ServerError(format("Failed to create socket: %", std::strerror(errno)));
+        }
+        ::fcntl(listenFd, F_SETFD, FD_CLOEXEC);
+
+        if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1 ||
+            ::listen(listenFd, SOMAXCONN) == -1)
+        {
+            const int err = errno;
+            ::close(listenFd);
+            throw ServerError(format("Failed to listen on socket '%': %", socketPath.string(), std::strerror(err)));
+        }
+
+        if (::pipe(gServeSignalPipe) == -1)
+        {
+            const int err = errno;
+            ::close(listenFd);
+            fs::remove(socketPath, ec);
+            throw ServerError(format("Failed to create signal pipe: %", std::strerror(err)));
+        }
+        for (int fd : gServeSignalPipe)
+        {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+
+        setSignalHandler(SIGCHLD, serveSignalHandler);
+        setSignalHandler(SIGINT , serveSignalHandler);
+        setSignalHandler(SIGTERM, serveSignalHandler);
+        setSignalHandler(SIGPIPE, SIG_IGN); // client closed connection
+
+        std::map<pid_t, int> jobs; // child process -> client connection
+        const auto finishJob = [&](pid_t pid, int status)
+        {
+            auto it = jobs.find(pid);
+            if (it == jobs.end()) {
+                return;
+            }
+
+            const int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            LOG_INFO("Request % finished with exit code %", pid, code);
+
+            std::string resp(1, '\0');
+            resp += std::to_string(code);
+            writeAll(it->second, resp);
+            ::close(it->second);
+            jobs.erase(it);
+        };
+
+        bool stop = false;
+        while (!stop || !jobs.empty())
+        {
+            pollfd fds[2] = {
+                { gServeSignalPipe[0], POLLIN, 0 },
+                { listenFd, static_cast<short>(!stop && jobs.size() < maxJobs ? POLLIN : 0), 0 }
+            };
+
+            if (::poll(fds, 2, -1) == -1)
+            {
+                if (errno == EINTR) continue;
+                LOG_ERROR("Server poll failed: %", std::strerror(errno));
+                stop = true;
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                char sigs[64];
+                ssize_t n;
+                while ((n = ::read(gServeSignalPipe[0], sigs, sizeof(sigs))) > 0)
+                {
+                    for (ssize_t i = 0; i < n; i++) {
+                        stop |= sigs[i] == SIGINT || sigs[i] == SIGTERM;
+                    }
+                }
+            }
+
+            int status = 0;
+            pid_t pid;
+            while ((pid = ::waitpid(-1, &status, WNOHANG)) > 0) {
+                finishJob(pid, status);
+            }
+
+            if (stop || !(fds[1].revents & POLLIN)) {
+                continue;
+            }
+
+            int conn = ::accept(listenFd, nullptr, nullptr);
+            if (conn == -1) {
+                continue;
+            }
+            ::fcntl(conn, F_SETFD, FD_CLOEXEC);
+
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+
+            pid = ::fork();
+            if (pid == 0)
+            {
+                ::close(listenFd);
+                ::close(gServeSignalPipe[0]);
+                ::close(gServeSignalPipe[1]);
+                for (const auto& [jpid, jconn] : jobs) {
+                    ::close(jconn); // client gets EOF only when all copies of connection are closed
+                }
+                for (int sig : { SIGCHLD, SIGINT, SIGTERM, SIGPIPE }) {
+                    setSignalHandler(sig, SIG_DFL);
+                }
+
+                const int code = execServeRequest(conn, execRequest);
+                ::_exit(code);
+            }
+            else if (pid == -1)
+            {
+                LOG_ERROR("Failed to fork request process: %", std::strerror(errno));
+                std::string resp = "Server failed to start request\n";
+                resp.push_back('\0');
+                resp += "1";
+                writeAll(conn, resp);
+                ::close(conn);
+            }
+            else
+            {
+                LOG_INFO("Request % started", pid);
+                jobs.emplace(pid, conn);
+            }
+        }
+
+        ::close(listenFd);
+        ::close(gServeSignalPipe[0]);
+        ::close(gServeSignalPipe[1]);
+        for (int sig : { SIGCHLD, SIGINT, SIGTERM, SIGPIPE }) {
+            setSignalHandler(sig, SIG_DFL);
+        }
+        fs::remove(socketPath, ec);
+    }
+
+    /**
+     * Sends request to cndtool server and writes command output to stdout.
+     * @param socketPath - file path of server Unix socket.
+     * @param args       - command arguments, without program path.
+     * @return Exit code of the command.
+     * @throw ServerError if request couldn't be sent or connection was closed before the command has finished.
+     */
+    [[nodiscard]] inline int sendServeRequest(const fs::path& socketPath, const std::vector<std::string>& args)
+    {
+        using namespace detail;
+
+        std::string req = fs::current_path().string();
+        req.push_back('\0');
+        for (const auto& arg : args)
+        {
+            if (arg.empty()) {
+                throw ServerError("Empty argument can't be sent to the server");
+            }
+            req += arg;
+            req.push_back('\0');
+        }
+        req.push_back('\0');
+
+        int fd = connectSocket(socketPath);
+        if (!writeAll(fd, req))
+        {
+            const int err = errno;
+            ::close(fd);
+            throw ServerError(libim::utils::format("Failed to send request: %", std::strerror(err)));
+        }
+
+        std::string status;
+        bool hasStatus = false;
+        char buf[64 * 1024];
+        while (true)
+        {
+            auto n = ::read(fd, buf, sizeof(buf));
+            if (n == -1 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+
+            std::string_view data(buf, static_cast<std::size_t>(n));
+            if (!hasStatus)
+            {
+                const auto pos = data.find('\0');
+                std::cout.write(data.data(), static_cast<std::streamsize>(std::min(pos, data.size())));
+                if (pos == std::string_view::npos) {
+                    continue;
+                }
+                hasStatus = true;
+                data.remove_prefix(pos + 1);
+            }
+            status += data;
+        }
+        ::close(fd);
+        std::cout.flush();
+
+        if (!hasStatus || status.empty()) {
+            throw ServerError("Connection to server was closed before the request has finished");
+        }
+        return std::stoi(status);
+    }
+#endif // !LIBIM_OS_WINDOWS
+}
+#endif // CNDTOOL_SERVE_H
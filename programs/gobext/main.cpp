@@ -4,25 +4,39 @@
 
 #include <libim/io/vfstream.h>
 #include <libim/common.h>
+#include <libim/content/asset/world/impl/serialization/cnd/cndview.h>
 #include <libim/io/filestream.h>
+#include <libim/io/gobdelta.h>
+#include <libim/io/manifest.h>
 #include <libim/log/log.h>
+#include <libim/trace/trace.h>
+#include <libim/utils/hash.h>
 #include <cmdutils/cmdutils.h>
 #include <cmdutils/options.h>
+#include <cmdutils/trace.h>
 #include "config.h"
 
 #define SETW(n, f)  std::right << std::setfill(f) << std::setw(n)
 #define SET_FINFO_LW(n) SETW(10 + n, '.')
 
+static constexpr auto CMD_DELTA           ("delta");
+static constexpr auto CMD_LIST            ("list");
+static constexpr auto CMD_VERIFY          ("verify");
+
+static constexpr auto OPT_HASH            ("--hash");
+static constexpr auto OPT_MANIFEST        ("--manifest");
 static constexpr auto OPT_OTPUT_DIR       ("--output-dir");
 static constexpr auto OPT_OTPUT_DIR_SHORT ("-o");
 static constexpr auto OPT_VERBOSE         ("--verbose");
 static constexpr auto OPT_VERBOSE_SHORT   ("-v");
 static constexpr auto OPT_HELP            ("--help");
 static constexpr auto OPT_HELP_SHORT      ("-h");
+static constexpr auto OPT_TRACE           ("--trace");
 
 using namespace cmdutils;
 using namespace gobext;
 using namespace libim;
+using namespace libim::content::asset;
 
 namespace fs = std::filesystem;
 
@@ -35,6 +49,151 @@ void printHelp()
     std::cout << OPT_HELP_SHORT        << SETW(18, ' ') << OPT_HELP        << SETW(31, ' ') << "Show this message\n";
     std::cout << OPT_OTPUT_DIR_SHORT   << SETW(24, ' ') << OPT_OTPUT_DIR   << SETW(34, ' ') << "Output folder <output dir>\n";
     std::cout << OPT_VERBOSE_SHORT     << SETW(21, ' ') << OPT_VERBOSE     << SETW(25, ' ') << "Verbose output\n";
+    std::cout << "  "                  << SETW(19, ' ') << OPT_TRACE       << SETW(43, ' ') << "Write Chrome trace JSON <file>\n";
+
+    std::cout << "\nLists files of GOB file or sections of CND file.\n";
+    std::cout << "  Usage: gobext list <gob|cnd file> [--hash] [--manifest=<file>]" << std::endl << std::endl;
+    std::cout << "  "                  << SETW(18, ' ') << OPT_HASH        << SETW(45, ' ') << "Print content hash of each file\n";
+    std::cout << "  "                  << SETW(22, ' ') << OPT_MANIFEST    << SETW(39, ' ') << "Write content manifest <file>\n";
+
+    std::cout << "\nVerifies content of GOB or CND file against content manifest.\n";
+    std::cout << "  Usage: gobext verify <gob|cnd file> --manifest=<file>" << std::endl;
+
+    std::cout << "\nWrites delta GOB file with files added or modified in new GOB file or folder compared to base GOB file.\n";
+    std::cout << "Delta GOB file should be loaded before base GOB file.\n";
+    std::cout << "  Usage: gobext delta <base gob file> <new gob file|folder> <output delta gob file>" << std::endl;
+}
+
+/**
+ * Returns content manifest of GOB or CND file.
+ * If hash is false, entries have only size set.
+ */
+ContentManifest getContentManifest(const fs::path& file, const bool hash)
+{
+    if (fileExtMatch(file, ".cnd"))
+    {
+        CndView cnd(file);
+        if (hash) {
+            return cnd.contentManifest();
+        }
+
+        std::vector<ContentHash> entries;
+        for (std::size_t i = 0; i < kNumCndSections; i++) {
+            entries.push_back({ std::string(kCndSectionNames.at(i)), cnd.layout().at(i).offset, cnd.layout().at(i).size, 0 });
+        }
+        return ContentManifest(std::move(entries));
+    }
+
+    if (hash) {
+        return gobContentManifest(file);
+    }
+
+    std::vector<ContentHash> entries;
+    for (auto& e : gobReadDirectory(InputFileStream(file))) {
+        entries.push_back({ std::move(e.filePath), e.offset, e.size, 0 });
+    }
+    return ContentManifest(std::move(entries));
+}
+
+int execCmdList(const fs::path& file, const CmdArgs& opt)
+{
+    const bool hash  = opt.hasArg(OPT_HASH) || opt.hasArg(OPT_MANIFEST);
+    const auto manifest = getContentManifest(file, hash);
+    for (const auto& e : manifest.entries())
+    {
+        if (hash) {
+            std::cout << utils::hashToString(e.hash) << " ";
+        }
+        std::cout << SETW(10, ' ') << e.size << " " << e.name << std::endl;
+    }
+    std::cout << "--------------------------\nTotal: " << manifest.entries().size() << std::endl;
+
+    if (opt.hasArg(OPT_MANIFEST))
+    {
+        const fs::path manifestFile = opt.arg(OPT_MANIFEST);
+        manifest.save(manifestFile);
+        std::cout << "Content manifest written to " << manifestFile << std::endl;
+    }
+    return 0;
+}
+
+int execCmdDelta(const fs::path& baseGob, const fs::path& newContent, const fs::path& outFile)
+{
+    // Inputs are read while delta is written, so output file can't be any of them
+    std::error_code ec;
+    if (fs::exists(outFile, ec) && (fs::equivalent(outFile, baseGob, ec) || fs::equivalent(outFile, newContent, ec)))
+    {
+        printError("Output delta GOB file % can't be the same as input file!", outFile);
+        return 1;
+    }
+
+    // Delta is written to temporary file first, so failed run doesn't leave truncated output file
+    auto tmpFile = outFile;
+    tmpFile += ".tmp";
+
+    GobDelta delta;
+    try
+    {
+        OutputFileStream ofs(tmpFile, /*truncate=*/true);
+        delta = gobWriteDelta(baseGob, newContent, ofs);
+    }
+    catch (...)
+    {
+        deleteFile(tmpFile);
+        throw;
+    }
+
+    if (!renameFile(tmpFile, outFile))
+    {
+        deleteFile(tmpFile);
+        throw FileStreamError(utils::format("Failed to replace file % with %", outFile, tmpFile));
+    }
+
+    for (const auto& name : delta.diff.added) {
+        std::cout << "Added:    " << name << std::endl;
+    }
+    for (const auto& name : delta.diff.modified) {
+        std::cout << "Modified: " << name << std::endl;
+    }
+    for (const auto& name : delta.diff.removed) {
+        std::cout << "Warning: File '" << name << "' was removed, but can't be removed by delta GOB file" << std::endl;
+    }
+
+    std::cout << "--------------------------\nTotal files written: " << delta.numFiles
+              << " (" << delta.dataSize << " bytes) to " << outFile << std::endl;
+    return 0;
+}
+
+int execCmdVerify(const fs::path& file, const CmdArgs& opt)
+{
+    if (!opt.hasArg(OPT_MANIFEST) || opt.arg(OPT_MANIFEST).empty())
+    {
+        printError("Content manifest file required, e.g.: %=<file>", OPT_MANIFEST);
+        return 1;
+    }
+
+    const auto prev = ContentManifest::load(opt.arg(OPT_MANIFEST));
+    const auto diff = getContentManifest(file, /*hash=*/true).diff(prev);
+    for (const auto& name : diff.added) {
+        std::cout << "Added:    " << name << std::endl;
+    }
+    for (const auto& name : diff.removed) {
+        std::cout << "Removed:  " << name << std::endl;
+    }
+    for (const auto& name : diff.modified) {
+        std::cout << "Modified: " << name << std::endl;
+    }
+
+    if (diff.empty())
+    {
+        std::cout << "OK: Content matches the manifest" << std::endl;
+        return 0;
+    }
+
+    std::cout << "--------------------------\nAdded: " << diff.added.size()
+              << ", removed: " << diff.removed.size()
+              << ", modified: " << diff.modified.size() << std::endl;
+    return 1;
 }
 
 bool extractGob(const VfContainer c, const fs::path& outDir, const bool verbose)
@@ -44,6 +203,7 @@ bool extractGob(const VfContainer c, const fs::path& outDir, const bool verbose)
         /* Save entries to files */
         for(const auto& [filePath, file] : c)
         {
+            LIBIM_TRACE_SCOPE_DETAIL("gobext", "extractFile", filePath);
             std::cout << "Extracting file: " << filePath << std::endl;
 
             /* Set entry file path */
@@ -86,13 +246,68 @@ int main(int argc, const char *argv[])
         return 1;
     }
 
-    fs::path inputFile = opt.positionalArgs().at(0);
+    std::string_view cmd;
+    auto posArgs = opt.positionalArgs();
+    for (auto c : { CMD_DELTA, CMD_LIST, CMD_VERIFY })
+    {
+        if (posArgs.size() > 1 && posArgs.at(0) == c)
+        {
+            cmd = c;
+            posArgs.erase(posArgs.begin());
+            break;
+        }
+    }
+
+    if (cmd == CMD_DELTA)
+    {
+        if (posArgs.size() != 3)
+        {
+            printError("Command % requires base GOB file, new GOB file or folder and output delta GOB file", CMD_DELTA);
+            return 1;
+        }
+        if (!fileExists(posArgs.at(0)))
+        {
+            printError("File % does not exists!", posArgs.at(0));
+            return 1;
+        }
+        if (!fs::exists(posArgs.at(1)))
+        {
+            printError("File or folder % does not exists!", posArgs.at(1));
+            return 1;
+        }
+
+        TraceSession trace(opt, "gobext");
+        try {
+            return execCmdDelta(posArgs.at(0), posArgs.at(1), posArgs.at(2));
+        }
+        catch (const std::exception& e)
+        {
+            printError("Failed to write delta GOB file %!\n  Error: %", posArgs.at(2), e.what());
+            return 1;
+        }
+    }
+
+    fs::path inputFile = posArgs.at(0);
     if(!fileExists(inputFile))
     {
         printError("File % does not exists!", inputFile);
         return 1;
     }
 
+    if (!cmd.empty())
+    {
+        TraceSession trace(opt, "gobext");
+        try
+        {
+            return cmd == CMD_LIST ? execCmdList(inputFile, opt) : execCmdVerify(inputFile, opt);
+        }
+        catch (const std::exception& e)
+        {
+            printError("Failed to read file %!\n  Error: %", inputFile, e.what());
+            return 1;
+        }
+    }
+
     fs::path outdir;
     if (opt.hasArg(OPT_OTPUT_DIR_SHORT)) {
         outdir = opt.arg(OPT_OTPUT_DIR_SHORT);
@@ -109,6 +324,8 @@ int main(int argc, const char *argv[])
         bVerboseOutput = true;
     }
 
+    TraceSession trace(opt, "gobext");
+
     /* Extract files from gob file */
     int result = 0;
     try
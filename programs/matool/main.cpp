@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <cmdutils/cmdutils.h>
+#include <cmdutils/trace.h>
 
 #include <libim/common.h>
 #include <libim/content/asset/material/material.h>
@@ -41,6 +42,8 @@ constexpr static auto scmdBatch  = "batch"sv;
 
 constexpr static auto optExtractAsBmp      = "--bmp"sv;
 constexpr static auto optExtractAsBmpShort = "-b"sv;
+constexpr static auto optDedupLink         = "--dedup-link"sv;
+constexpr static auto optDedupManifest     = "--dedup-manifest"sv;
 constexpr static auto optEncoding          = "--encoding"sv;
 constexpr static auto optEncodingShort     = "-e"sv;
 constexpr static auto optMaxTex            = "--max-tex"sv;
@@ -49,6 +52,7 @@ constexpr static auto optNoSRGB            = "--no-srgb"sv;
 constexpr static auto optOutput            = "--output"sv;
 constexpr static auto optOutputDir         = "--output-dir"sv;
 constexpr static auto optOutputShort       = "-o"sv;
+constexpr static auto optPngLevel          = "--png-level"sv;
 constexpr static auto optSRGB              = "--srgb"sv;
 constexpr static auto optForce8bpc         = "--force-8bpc"sv;
 constexpr static auto optVerbose           = "--verbose"sv;
@@ -188,6 +192,12 @@ void printHelp(std::string_view cmd = ""sv, std::string_view subcmd = ""sv)
         printOption( ""             , ""                  , "By default, all images are extracted."                               );
         printOption( optExtractLod  , ""                  , "Extract also mipmap LOD images from MAT file."                       );
         printOption( ""             , ""                  , "By default, only top image at LOD 0 is extracted from each texture." );
+        printOption( optPngLevel    , ""                  , "PNG compression level 0-9, e.g.: --png-level=1."                     );
+        printOption( ""             , ""                  , "Lower level is faster, 0 stores images uncompressed."               );
+        printOption( optDedupLink   , ""                  , "Hard link extracted images with duplicate content."                  );
+        printOption( ""             , ""                  , "By default duplicates are encoded once and copied."                  );
+        printOption( optDedupManifest, ""                 , "Manifest file of extracted images."                                  );
+        printOption( ""             , ""                  , "Images listed in existing manifest are not extracted again."         );
         printOption( optOutputDir   , optOutputShort      , "Output folder"                                                       );
         printOption( optVerbose     , optVerboseShort     , "Verbose printout to the console"                                     );
     }
@@ -230,6 +240,9 @@ void printHelp(std::string_view cmd = ""sv, std::string_view subcmd = ""sv)
         printCommand( cmdInfo   , "Print to the console information about MAT file" );
         printCommand( cmdModify , "Modify existing MAT file"                        );
         printCommand( cmdHelp   , "Show this message"                               );
+        std::cout << std::endl;
+        printOptionHeader("Global option");
+        printTraceOption();
     }
 }
 
@@ -578,6 +591,26 @@ int execCmdExtract(const MatoolArgs& args)
             return 1;
         }
 
+        auto pngOptions = PngWriteOptions{};
+        if (args.hasArg(optPngLevel))
+        {
+            const auto level = args.uintArg(optPngLevel);
+            if (level > 9)
+            {
+                printError("Option '%' must be in range 0-9!", optPngLevel);
+                return 1;
+            }
+            pngOptions = PngWriteOptions::withLevel(static_cast<int>(level));
+        }
+        pngOptions.maxThreads = 0; // images are written one by one, large images are compressed on all hardware threads
+
+        /* Images with the same content are extracted only once and copied or hard linked */
+        FileDedup dedup(args.hasArg(optDedupLink) ? FileDedup::Mode::Hardlink : FileDedup::Mode::Copy);
+        const fs::path dedupManifest = args.hasArg(optDedupManifest) ? fs::path(args.arg(optDedupManifest)) : fs::path();
+        if (!dedupManifest.empty()) {
+            dedup.loadManifest(dedupManifest);
+        }
+
         /* Extract images from material files */
         makePath(outDir);
         if (!bVerbose) std::cout << "Extracting... " << std::flush;
@@ -593,11 +626,18 @@ int execCmdExtract(const MatoolArgs& args)
                 printProgress("Extracting... ", idx + 1, matFiles.size());
             }
 
-            matExtractImages(mat, outDir, numImgs, bExtractLod, bExtractAsBmp);
+            matExtractImages(mat, outDir, numImgs, bExtractLod, bExtractAsBmp, pngOptions, &dedup);
             if (bVerbose) std::cout << kSuccess << std::endl;
         }
 
         if (!bVerbose) std::cout << "\rExtracting... "<< kSuccess << std::endl;
+        if (dedup.numDeduplicated() > 0) {
+            std::cout << "Skipped encoding of " << dedup.numDeduplicated() << " image(s) with duplicate content." << std::endl;
+        }
+
+        if (!dedupManifest.empty()) {
+            dedup.saveManifest(dedupManifest);
+        }
         return 0;
     }
     catch (const std::exception& e)
@@ -749,6 +789,7 @@ int main(int argc, const char* argv[])
             return 1;
         }
 
+        TraceSession trace(args, "matool");
         return execCmd(args.cmd(), args);
     }
     catch (const std::exception& e)
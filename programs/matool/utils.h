@@ -9,13 +9,16 @@
 #include <string_view>
 
 #include <cmdutils/cmdutils.h>
+#include <cmdutils/file_dedup.h>
 
 #include <libim/content/asset/material/colorformat.h>
 #include <libim/content/asset/material/material.h>
 #include <libim/content/asset/material/texture.h>
 #include <libim/content/asset/material/texture_view.h>
+#include <libim/content/asset/material/texutils.h>
 #include <libim/io/filestream.h>
 #include <libim/math/math.h>
+#include <libim/utils/hash.h>
 #include <libim/utils/utils.h>
 
 #define MATOOL_SET_DOT_LW(n) CMDUTILS_SETW(32 + n, '.')
@@ -180,6 +183,26 @@ namespace matool {
         std::cout << "  ===================================================\n\n\n";
     }
 
+    /**
+     * Returns content key of image file extracted from texture.
+     * The key is hash of texture pixel data, size and color format, image file extension and PNG encoder options.
+     */
+    [[nodiscard]] inline uint64_t imageContentKey(const libim::content::asset::TextureView& tex, std::string_view ext, const libim::content::asset::PngWriteOptions& pngOptions)
+    {
+        libim::utils::Hasher64 h;
+        h.update(ext);
+        h.updateValue(tex.width());
+        h.updateValue(tex.height());
+        h.updateValue(tex.format());
+        if (ext == kExtPng)
+        {
+            h.updateValue(pngOptions.compressionLevel);
+            h.updateValue(pngOptions.filter);
+        }
+        h.update(tex.data(), tex.size());
+        return h.digest();
+    }
+
     /**
      * Extract images from Material to file.
      *
@@ -188,13 +211,17 @@ namespace matool {
      * @param optMaxCel    - (Optional) max number of images to extract from Material object.
      * @param extractLod   - extract also LOD images of each Texture.
      * @param extractAsBmp - extract images in BMP file format. Default is PNG.
+     * @param pngOptions   - PNG encoder options.
+     * @param dedup        - (Optional) registry of already extracted images. Image with the same content is copied instead of encoded again.
      */
     static void
     matExtractImages(const libim::content::asset::Material& mat,
         const std::filesystem::path& outDir,
         const std::optional<uint64_t> optMaxCel = std::nullopt,
         const bool extractLod   = false,
-        const bool extractAsBmp = false)
+        const bool extractAsBmp = false,
+        const libim::content::asset::PngWriteOptions& pngOptions = {},
+        cmdutils::FileDedup* dedup = nullptr)
     {
         using namespace libim;
         const auto maxCelCount = min<std::size_t>(mat.count(), optMaxCel.value_or(mat.count()));
@@ -209,13 +236,24 @@ namespace matool {
                 if (maxCelCount > 1) appendSeqSuffix(fileName, celNum);
                 if (mipLevels > 1 && lod > 0)  appendLodSeqSuffix(fileName, lod);
 
-                const auto outPath = (outDir / fileName).replace_extension(extractAsBmp ? kExtBmp : kExtPng);
-                OutputFileStream ofs(outPath, /*truncate=*/true);
-                if (extractAsBmp) {
-                    bmpWrite(ofs, tex.mipmap(lod));
+                const auto ext     = extractAsBmp ? kExtBmp : kExtPng;
+                const auto outPath = (outDir / fileName).replace_extension(ext);
+                const auto img     = tex.mipmap(lod);
+                auto writeImage = [&](const std::filesystem::path& path) {
+                    OutputFileStream ofs(path, /*truncate=*/true);
+                    if (extractAsBmp) {
+                        bmpWrite(ofs, img);
+                    }
+                    else {
+                        pngWrite(ofs, img, pngOptions);
+                    }
+                };
+
+                if (dedup) {
+                    dedup->produce(imageContentKey(img, ext, pngOptions), outPath, writeImage);
                 }
                 else {
-                    pngWrite(ofs, tex.mipmap(lod));
+                    writeImage(outPath);
                 }
             }
         }
@@ -0,0 +1,58 @@
+#ifndef LIBIM_BENCH_H
+#define LIBIM_BENCH_H
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace libim::bench {
+
+    /** Single micro-benchmark case. */
+    struct Benchmark
+    {
+        std::string name;
+        std::size_t bytesPerIteration = 0; // Number of bytes processed by one call to run. 0 = don't report throughput.
+        std::function<void()> run;
+    };
+
+    /** Options which benchmark suites can use to add cases for real game files. */
+    struct SuiteOptions
+    {
+        std::filesystem::path cndFile; // optional path to CND file
+        std::filesystem::path gobFile; // optional path to GOB file
+    };
+
+    /**
+     * Registers new benchmark case.
+     * Any setup work should be done before calling this function
+     * so only the work in func is measured.
+     *
+     * @param name  - unique benchmark name, e.g.: "cnd/georesource/parse".
+     * @param bytes - number of bytes processed by one call to func. 0 = don't report throughput.
+     * @param func  - benchmark function.
+     */
+    void addBenchmark(std::string name, std::size_t bytes, std::function<void()> func);
+
+    /** Benchmark suites */
+    void registerWorldBenchmarks(const SuiteOptions& opt);    // CND/NDY world sections, text tokenizer
+    void registerMaterialBenchmarks(const SuiteOptions& opt); // pixel data conversion, scaling, mipmaps
+    void registerIoBenchmarks(const SuiteOptions& opt);       // GOB, sound decoding, memory streams, IndexMap
+
+    /**
+     * Prevents compiler from optimizing away value computed in benchmark.
+     * @param value - value to keep.
+     */
+    template<typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+}
+#endif // LIBIM_BENCH_H
@@ -0,0 +1,343 @@
+#include "bench.h"
+
+#include <libim/content/audio/impl/serialization/indywv.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/filestream.h>
+#include <libim/io/manifest.h>
+#include <libim/io/memorystream.h>
+#include <libim/io/vfs.h>
+#include <libim/io/vfsindex.h>
+#include <libim/io/vfstream.h>
+#include <libim/types/atom.h>
+#include <libim/types/indexmap.h>
+#include <libim/types/sharedref.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace libim;
+using namespace libim::bench;
+using namespace libim::content::audio;
+
+/**
+ * Builds GOB file in memory with numFiles files of fileSize bytes.
+ * Layout: header, file data, directory (num entries + entries).
+ */
+static ByteArray makeGob(std::size_t numFiles, std::size_t fileSize)
+{
+    constexpr std::size_t kHeaderSize    = 12;
+    constexpr std::size_t kEntryPathSize = 128;
+
+    ByteArray gob;
+    gob.reserve(kHeaderSize + numFiles * (fileSize + 8 + kEntryPathSize) + 4);
+    OutputBinaryStream<ByteArray> os(gob);
+    os.write<uint32_t>(0x20424F47); // "GOB "
+    os.write<uint32_t>(0x14);
+    os.write<uint32_t>(safe_cast<uint32_t>(kHeaderSize + numFiles * fileSize));
+
+    ByteArray file(fileSize);
+    for (std::size_t i = 0; i < numFiles; i++)
+    {
+        std::fill(file.begin(), file.end(), static_cast<byte_t>(i));
+        os.write(file);
+    }
+
+    os.write<uint32_t>(safe_cast<uint32_t>(numFiles));
+    for (std::size_t i = 0; i < numFiles; i++)
+    {
+        os.write<uint32_t>(safe_cast<uint32_t>(kHeaderSize + i * fileSize));
+        os.write<uint32_t>(safe_cast<uint32_t>(fileSize));
+
+        std::array<char, kEntryPathSize> path{};
+        const auto name = "mat\\file_" + std::to_string(i) + ".mat";
+        std::memcpy(path.data(), name.data(), name.size());
+        os.write(reinterpret_cast<const byte_t*>(path.data()), path.size());
+    }
+    return gob;
+}
+
+static void extractGob(const VfContainer& c)
+{
+    ByteArray buffer;
+    for (const auto& [filePath, file] : c)
+    {
+        buffer.clear();
+        buffer.reserve(file->size());
+        OutputBinaryStream<ByteArray> os(buffer);
+        os.write(file);
+        doNotOptimize(buffer);
+    }
+}
+
+static void registerGobBenchmarks(const SuiteOptions& opt)
+{
+    auto gob = std::make_shared<ByteArray>(makeGob(1024, 16 * 1024));
+
+    addBenchmark("gob/load", 0, [gob] {
+        auto c = gobLoad(makeSharedRef<InputBinaryStream<ByteArray>>(*gob));
+        doNotOptimize(c);
+    });
+
+    addBenchmark("gob/load_extract", gob->size(), [gob] {
+        auto c = gobLoad(makeSharedRef<InputBinaryStream<ByteArray>>(*gob));
+        extractGob(c);
+    });
+
+    if (!opt.gobFile.empty())
+    {
+        auto gobFile = opt.gobFile;
+        const auto size = InputFileStream(gobFile).size();
+        addBenchmark("gob/file/load_extract", size, [gobFile] {
+            auto c = gobLoad(gobFile);
+            extractGob(c);
+        });
+    }
+}
+
+/**
+ * Mounts GOB file by loading GOB directory and by mapping VFS index, and finds one file.
+ * Index file is built before the benchmark.
+ */
+static void addVfsMountBenchmarks(const std::string& name, const std::filesystem::path& gobFile, const std::string& filePath)
+{
+    const auto indexFile = std::filesystem::temp_directory_path() / ("libim_bench_" + gobFile.stem().string() + ".idx");
+    VfsIndex::build({}, { gobFile }).save(indexFile);
+
+    addBenchmark(name + "/mount_gob", 0, [gobFile, filePath] {
+        VirtualFileSystem vfs;
+        vfs.loadGobContainer(gobFile);
+        doNotOptimize(vfs.getFile(filePath));
+    });
+
+    addBenchmark(name + "/mount_index", 0, [gobFile, filePath, indexFile] {
+        VirtualFileSystem vfs;
+        vfs.mountIndex(indexFile, {}, { gobFile });
+        doNotOptimize(vfs.getFile(filePath));
+    });
+}
+
+static void registerVfsBenchmarks(const SuiteOptions& opt)
+{
+    const auto gobFile = std::filesystem::temp_directory_path() / "libim_bench_vfs.gob";
+    {
+        const auto gob = makeGob(16384, 64);
+        OutputFileStream ofs(gobFile, /*truncate=*/true);
+        ofs.write(gob);
+    }
+    addVfsMountBenchmarks("vfs", gobFile, "mat\\file_100.mat");
+
+    if (!opt.gobFile.empty())
+    {
+        InputFileStream gob(opt.gobFile);
+        const auto dir = gobReadDirectory(gob);
+        if (!dir.empty()) {
+            addVfsMountBenchmarks("vfs/file", opt.gobFile, dir.back().filePath);
+        }
+    }
+}
+
+static void registerManifestBenchmarks(const SuiteOptions& opt)
+{
+    const auto gobFile = std::filesystem::temp_directory_path() / "libim_bench_manifest.gob";
+    constexpr std::size_t kNumFiles = 1024;
+    constexpr std::size_t kFileSize = 64 * 1024;
+    {
+        const auto gob = makeGob(kNumFiles, kFileSize);
+        OutputFileStream ofs(gobFile, /*truncate=*/true);
+        ofs.write(gob);
+    }
+
+    addBenchmark("manifest/gob_1thread", kNumFiles * kFileSize, [gobFile] {
+        auto m = gobContentManifest(gobFile, /*maxThreads=*/1);
+        doNotOptimize(m);
+    });
+
+    addBenchmark("manifest/gob", kNumFiles * kFileSize, [gobFile] {
+        auto m = gobContentManifest(gobFile);
+        doNotOptimize(m);
+    });
+
+    if (!opt.gobFile.empty())
+    {
+        const auto size = std::filesystem::file_size(opt.gobFile);
+        addBenchmark("manifest/gob_file", size, [file = opt.gobFile] {
+            auto m = gobContentManifest(file);
+            doNotOptimize(m);
+        });
+    }
+}
+
+static void registerSoundBenchmarks()
+{
+    constexpr std::size_t kNumChannels = 2;
+    constexpr std::size_t kSampleRate  = 22050;
+    constexpr std::size_t kNumFrames   = kSampleRate * 10; // 10 sec
+
+    ByteArray pcm(kNumFrames * kNumChannels * sizeof(int16_t));
+    for (std::size_t i = 0; i < kNumFrames; i++)
+    {
+        const double t = double(i) / double(kSampleRate);
+        for (std::size_t c = 0; c < kNumChannels; c++)
+        {
+            auto s = static_cast<int16_t>(12000.0 * std::sin(2.0 * 3.14159265 * (220.0 + 110.0 * double(c)) * t));
+            const auto pos = (i * kNumChannels + c) * sizeof(int16_t);
+            pcm[pos]     = static_cast<byte_t>(s & 0xFF);
+            pcm[pos + 1] = static_cast<byte_t>((s >> 8) & 0xFF);
+        }
+    }
+
+    auto wvsm = std::make_shared<ByteArray>(IndyVW::deflate(pcm, kNumChannels, 16));
+    auto out  = std::make_shared<ByteArray>(IndyVW::inflatedSize(*wvsm));
+
+    addBenchmark("audio/indywv/inflate", out->size(), [wvsm, out] {
+        auto n = IndyVW::inflate(*wvsm, *out);
+        doNotOptimize(n);
+    });
+
+    addBenchmark("audio/indywv/inflate_alloc", out->size(), [wvsm] {
+        auto res = IndyVW::inflate(ByteView(*wvsm));
+        doNotOptimize(res);
+    });
+
+    auto pcmPtr = std::make_shared<ByteArray>(std::move(pcm));
+    addBenchmark("audio/indywv/deflate_1thread", pcmPtr->size(), [pcmPtr] {
+        auto res = IndyVW::deflate(*pcmPtr, kNumChannels, 16, /*maxThreads=*/1);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("audio/indywv/deflate", pcmPtr->size(), [pcmPtr] {
+        auto res = IndyVW::deflate(*pcmPtr, kNumChannels, 16);
+        doNotOptimize(res);
+    });
+}
+
+static void registerStreamBenchmarks()
+{
+    constexpr std::size_t kDataSize = 4 * 1024 * 1024;
+    constexpr auto kNumWrites = kDataSize / sizeof(uint32_t);
+
+    addBenchmark("io/binarystream/write_small", kDataSize, [] {
+        ByteArray buffer;
+        OutputBinaryStream<ByteArray> os(buffer);
+        for (std::size_t i = 0; i < kNumWrites; i++) {
+            os.write(static_cast<uint32_t>(i));
+        }
+        doNotOptimize(buffer);
+    });
+
+    addBenchmark("io/memorystream/write_small", kDataSize, [] {
+        MemoryOutputStream os;
+        for (std::size_t i = 0; i < kNumWrites; i++) {
+            os.write(static_cast<uint32_t>(i));
+        }
+        auto buffer = os.release();
+        doNotOptimize(buffer);
+    });
+
+    addBenchmark("io/memorystream/write_small_chunked", kDataSize, [] {
+        MemoryOutputStream os(MemoryOutputStream::Storage::Chunked);
+        for (std::size_t i = 0; i < kNumWrites; i++) {
+            os.write(static_cast<uint32_t>(i));
+        }
+        doNotOptimize(os);
+    });
+
+    addBenchmark("io/memorystream/reserve_commit", kDataSize, [] {
+        MemoryOutputStream os;
+        for (std::size_t i = 0; i < kNumWrites; i += 1024)
+        {
+            auto span = os.reserveSpan(1024 * sizeof(uint32_t));
+            for (std::size_t j = 0; j < 1024; j++) {
+                const auto v = static_cast<uint32_t>(i + j);
+                std::memcpy(span.data() + j * sizeof(uint32_t), &v, sizeof(v));
+            }
+            os.commit(span.size());
+        }
+        auto buffer = os.release();
+        doNotOptimize(buffer);
+    });
+}
+
+static void registerIndexMapBenchmarks()
+{
+    constexpr std::size_t kNumKeys = 4096;
+
+    auto keys = std::make_shared<std::vector<std::string>>();
+    keys->reserve(kNumKeys);
+    for (std::size_t i = 0; i < kNumKeys; i++) {
+        keys->push_back("resource_name_" + std::to_string(i) + ".mat");
+    }
+
+    addBenchmark("types/indexmap/pushBack", 0, [keys] {
+        Table<std::size_t> map;
+        for (std::size_t i = 0; i < keys->size(); i++) {
+            map.pushBack((*keys)[i], i);
+        }
+        doNotOptimize(map);
+    });
+
+    auto map = std::make_shared<Table<std::size_t>>();
+    for (std::size_t i = 0; i < keys->size(); i++) {
+        map->pushBack((*keys)[i], i);
+    }
+
+    addBenchmark("types/indexmap/find", 0, [keys, map] {
+        std::size_t sum = 0;
+        for (const auto& k : *keys) {
+            sum += *map->find(k);
+        }
+        doNotOptimize(sum);
+    });
+
+    addBenchmark("types/indexmap/iterate", 0, [map] {
+        std::size_t sum = 0;
+        for (const auto& v : *map) {
+            sum += v;
+        }
+        doNotOptimize(sum);
+    });
+
+    auto umap = std::make_shared<UniqueTable<std::size_t>>();
+    for (std::size_t i = 0; i < keys->size(); i++) {
+        umap->pushBack((*keys)[i], i);
+    }
+
+    addBenchmark("types/indexmap/find_case_insensitive", 0, [keys, umap] {
+        std::size_t sum = 0;
+        for (const auto& k : *keys) {
+            sum += *umap->find(k);
+        }
+        doNotOptimize(sum);
+    });
+
+    auto atoms = std::make_shared<AtomSet>();
+    for (const auto& k : *keys) {
+        atoms->insert(Atom(k));
+    }
+
+    addBenchmark("types/atom/find", 0, [keys, atoms] {
+        std::size_t n = 0;
+        for (const auto& k : *keys)
+        {
+            auto a = Atom::find(k);
+            n += a && atoms->contains(*a);
+        }
+        doNotOptimize(n);
+    });
+}
+
+void libim::bench::registerIoBenchmarks(const SuiteOptions& opt)
+{
+    registerGobBenchmarks(opt);
+    registerVfsBenchmarks(opt);
+    registerManifestBenchmarks(opt);
+    registerSoundBenchmarks();
+    registerStreamBenchmarks();
+    registerIndexMapBenchmarks();
+}
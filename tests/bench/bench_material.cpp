@@ -0,0 +1,64 @@
+#include "bench.h"
+
+#include <libim/content/asset/material/colorformat.h>
+#include <libim/content/asset/material/texture.h>
+#include <libim/content/asset/material/texutils.h>
+
+#include <memory>
+
+using namespace libim;
+using namespace libim::bench;
+using namespace libim::content::asset;
+
+static PixdataPtr makeTestPixdata(uint32_t width, uint32_t height, const ColorFormat& cf)
+{
+    auto pixdata = makePixdataPtr(calcPixdataSize(width, height, cf));
+    uint32_t seed = 0x12345678;
+    for (auto& b : *pixdata)
+    {
+        seed = seed * 1664525 + 1013904223; // LCG
+        b = static_cast<byte_t>(seed >> 24);
+    }
+    return pixdata;
+}
+
+void libim::bench::registerMaterialBenchmarks(const SuiteOptions& /*opt*/)
+{
+    constexpr uint32_t kSize = 512;
+
+    auto rgba32 = makeTestPixdata(kSize, kSize, RGBA32);
+    auto rgb565 = makeTestPixdata(kSize, kSize, RGB565);
+
+    addBenchmark("material/convertPixdata/rgba32_to_rgb565", rgba32->size(), [rgba32] {
+        auto res = convertPixdata(rgba32->cbegin(), rgba32->cend(), kSize, kSize, RGBA32, RGB565);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("material/convertPixdata/rgb565_to_rgba32", rgb565->size(), [rgb565] {
+        auto res = convertPixdata(rgb565->cbegin(), rgb565->cend(), kSize, kSize, RGB565, RGBA32);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("material/boxFilterScale/rgba32_srgb", rgba32->size(), [rgba32] {
+        Pixdata dest(calcPixdataSize(kSize / 2, kSize / 2, RGBA32));
+        boxFilterScale(rgba32->cbegin(), kSize, kSize, dest.begin(), kSize / 2, kSize / 2, RGBA32, /*sRGB=*/true);
+        doNotOptimize(dest);
+    });
+
+    addBenchmark("material/boxFilterScale/rgb565_linear", rgb565->size(), [rgb565] {
+        Pixdata dest(calcPixdataSize(kSize / 2, kSize / 2, RGB565));
+        boxFilterScale(rgb565->cbegin(), kSize, kSize, dest.begin(), kSize / 2, kSize / 2, RGB565, /*sRGB=*/false);
+        doNotOptimize(dest);
+    });
+
+    auto tex = std::make_shared<Texture>(kSize, kSize, 1, RGBA32, rgba32);
+    addBenchmark("material/makeMipmap/rgba32", rgba32->size(), [tex] {
+        auto res = tex->makeMipmap(std::nullopt);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("material/makeMipmap/rgba32_to_rgb565", rgba32->size(), [tex] {
+        auto res = tex->makeMipmap(std::nullopt, RGB565);
+        doNotOptimize(res);
+    });
+}
@@ -0,0 +1,356 @@
+#include "bench.h"
+
+#include <libim/content/asset/world/impl/serialization/cnd/cnd.h>
+#include <libim/content/asset/world/impl/serialization/cnd/cndview.h>
+#include <libim/content/asset/world/impl/serialization/ndy/ndy.h>
+#include <libim/content/asset/world/geooptimizer.h>
+#include <libim/content/asset/world/lightbaker.h>
+#include <libim/content/asset/material/material.h>
+#include <libim/content/asset/material/texutils.h>
+#include <libim/content/text/text_resource_reader.h>
+#include <libim/content/text/text_resource_writer.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/filestream.h>
+#include <libim/io/memorystream.h>
+#include <libim/text/tokenizer.h>
+#include <libim/utils/arena.h>
+
+#include <memory>
+#include <string>
+
+using namespace libim;
+using namespace libim::bench;
+using namespace libim::content::asset;
+using namespace libim::content::text;
+using namespace libim::text;
+
+/**
+ * Makes flat grid world geometry of size x size quads.
+ * Every 16th surface is an adjoin surface.
+ */
+static Georesource makeGridGeoresource(std::size_t size, std::size_t numMaterials)
+{
+    Georesource geo;
+    const auto numVerts = (size + 1) * (size + 1);
+    geo.vertices.reserve(numVerts);
+    geo.texVertices.reserve(numVerts);
+    for (std::size_t y = 0; y <= size; y++)
+    {
+        for (std::size_t x = 0; x <= size; x++)
+        {
+            geo.vertices.emplace_back(float(x) * 0.1f, float(y) * 0.1f, float((x * 7 + y * 13) % 5) * 0.01f);
+            geo.texVertices.emplace_back(float(x) * 16.0f, float(y) * 16.0f);
+        }
+    }
+
+    geo.surfaces.reserve(size * size);
+    for (std::size_t y = 0; y < size; y++)
+    {
+        for (std::size_t x = 0; x < size; x++)
+        {
+            Surface s;
+            s.id         = geo.surfaces.size();
+            s.matIdx     = s.id % numMaterials;
+            s.surflags   = Surface::Floor | Surface::Collision;
+            s.flags      = Face::FogEnabled;
+            s.geoMode    = GeoMode::Textured;
+            s.lightMode  = LightMode::Gouraud;
+            s.extraLight = LinearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
+            s.normal     = Vector3f(0.0f, 0.0f, 1.0f);
+
+            const auto v0 = y * (size + 1) + x;
+            for (auto vi : { v0, v0 + 1, v0 + size + 2, v0 + size + 1 })
+            {
+                s.vertices.push_back({ vi, vi });
+                s.vecIntensities.push_back(LinearColor({ 0.5f, 0.5f, 0.5f, 1.0f }));
+            }
+
+            if (s.id % 16 == 0)
+            {
+                SurfaceAdjoin a;
+                a.flags      = SurfaceAdjoin::Visible | SurfaceAdjoin::AllowMovement | SurfaceAdjoin::AllowSound;
+                a.mirrorIdx  = geo.adjoins.size() ^ 1; // pair adjoins
+                a.surfaceIdx = s.id;
+                a.sectorIdx  = 0;
+                a.distance   = 0.0f;
+                s.adjoinIdx  = geo.adjoins.size();
+                geo.adjoins.push_back(a);
+            }
+            geo.surfaces.push_back(std::move(s));
+        }
+    }
+
+    if (geo.adjoins.size() % 2 != 0) { // make sure last adjoin has mirror
+        geo.adjoins.back().mirrorIdx = geo.adjoins.size() - 2;
+    }
+    return geo;
+}
+
+/** Makes materials with numCels RGB565 cel textures of size x size with all mipmap levels. */
+static Table<Material> makeMaterials(std::size_t count, uint32_t size, std::size_t numCels)
+{
+    Table<Material> materials;
+    const auto mipLevels = calcMaxMipmapLevels(size, size);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::vector<Texture> cels;
+        for (std::size_t c = 0; c < numCels; c++)
+        {
+            auto pixdata = makePixdataPtr(calcMipmapSize(size, size, mipLevels, RGB565));
+            for (std::size_t p = 0; p < pixdata->size(); p++) {
+                (*pixdata)[p] = static_cast<byte_t>((p * 31 + i * 7 + c) & 0xFF);
+            }
+            cels.emplace_back(size, size, mipLevels, RGB565, std::move(pixdata));
+        }
+
+        const auto name = "mat_" + std::to_string(i) + ".mat";
+        Material mat(name);
+        mat.setCells(std::move(cels));
+        materials.pushBack(name, std::move(mat));
+    }
+    return materials;
+}
+
+/**
+ * Writes to memory buffer via write func.
+ */
+template<typename WriteFunc>
+static ByteArray writeToBuffer(std::size_t capacity, WriteFunc&& write)
+{
+    MemoryOutputStream os;
+    os.reserve(capacity);
+    write(os);
+    auto buffer = os.release();
+    buffer.shrink_to_fit();
+    return buffer;
+}
+
+static void registerGeoresourceBenchmarks()
+{
+    auto geo = std::make_shared<Georesource>(makeGridGeoresource(128, 32));
+
+    CndHeader header{};
+    header.numVertices    = safe_cast<uint32_t>(geo->vertices.size());
+    header.numTexVertices = safe_cast<uint32_t>(geo->texVertices.size());
+    header.numAdjoins     = safe_cast<uint32_t>(geo->adjoins.size());
+    header.numSurfaces    = safe_cast<uint32_t>(geo->surfaces.size());
+
+    /* CND */
+    auto cndData = std::make_shared<ByteArray>(writeToBuffer(64 * 1024 * 1024, [&](OutputStream& os) {
+        CND::writeSection_Georesource(os, *geo);
+    }));
+
+    addBenchmark("cnd/georesource/write", cndData->size(), [geo, size = cndData->size()] {
+        ByteArray buffer;
+        buffer.reserve(size);
+        OutputBinaryStream<ByteArray> os(buffer);
+        CND::writeSection_Georesource(os, *geo);
+        doNotOptimize(buffer);
+    });
+
+    addBenchmark("cnd/georesource/parse", cndData->size(), [cndData, header] {
+        InputBinaryStream<ByteArray> is(*cndData);
+        auto res = CND::parseSection_Georesource(is, header);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("cnd/georesource/parse_arena", cndData->size(), [cndData, header] {
+        utils::Arena arena;
+        InputBinaryStream<ByteArray> is(*cndData);
+        auto res = CND::parseSection_Georesource(is, header, &arena);
+        doNotOptimize(res);
+    });
+
+    /* NDY */
+    auto ndyData = std::make_shared<ByteArray>(writeToBuffer(64 * 1024 * 1024, [&](OutputStream& os) {
+        TextResourceWriter rw(os);
+        NDY::writeSection_Georesource(rw, *geo);
+    }));
+
+    addBenchmark("ndy/georesource/write", ndyData->size(), [geo, size = ndyData->size()] {
+        ByteArray buffer;
+        buffer.reserve(size);
+        OutputBinaryStream<ByteArray> os(buffer);
+        TextResourceWriter rw(os);
+        NDY::writeSection_Georesource(rw, *geo);
+        doNotOptimize(buffer);
+    });
+
+    addBenchmark("ndy/georesource/parse", ndyData->size(), [ndyData] {
+        InputBinaryStream<ByteArray> is(*ndyData);
+        TextResourceReader rr(is);
+        rr.assertSection(NDY::kSectionGeoresource);
+        auto res = NDY::parseSection_Georesource(rr);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("ndy/georesource/parse_arena", ndyData->size(), [ndyData] {
+        utils::Arena arena;
+        InputBinaryStream<ByteArray> is(*ndyData);
+        TextResourceReader rr(is);
+        rr.setMemoryResource(&arena);
+        rr.assertSection(NDY::kSectionGeoresource);
+        auto res = NDY::parseSection_Georesource(rr);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("text/tokenizer/ndy", ndyData->size(), [ndyData] {
+        InputBinaryStream<ByteArray> is(*ndyData);
+        Tokenizer tok(is);
+        Token t;
+        std::size_t numTokens = 0;
+        while (tok.getNextToken(t) && t.type() != Token::EndOfFile) {
+            numTokens++;
+        }
+        doNotOptimize(numTokens);
+    });
+}
+
+static void registerGeoOptimizerBenchmarks()
+{
+    // Each surface references its own copy of vertices, e.g. geometry exported from external editor
+    auto geo = std::make_shared<Georesource>(makeGridGeoresource(128, 32));
+    std::vector<Vector3f> verts;
+    std::vector<Vector2f> uvs;
+    for (auto& s : geo->surfaces)
+    {
+        for (auto& v : s.vertices)
+        {
+            verts.push_back(geo->vertices.at(v.vertIdx));
+            uvs.push_back(geo->texVertices.at(*v.uvIdx));
+            v.vertIdx = verts.size() - 1;
+            v.uvIdx   = uvs.size() - 1;
+        }
+    }
+    geo->vertices    = std::move(verts);
+    geo->texVertices = std::move(uvs);
+
+    // Includes copying of georesource
+    addBenchmark("world/geo/optimize", 0, [geo] {
+        auto g = *geo;
+        auto stats = optimizeGeometry(g, {});
+        doNotOptimize(stats);
+    });
+}
+
+static void registerLightBakerBenchmarks()
+{
+    // Grid of 16x16 sectors, each sector has 8x8 surfaces and point light above its center
+    constexpr std::size_t gridSize   = 128;
+    constexpr std::size_t sectorSize = 8;
+    auto geo     = std::make_shared<Georesource>(makeGridGeoresource(gridSize, 32));
+    auto sectors = std::make_shared<std::vector<Sector>>();
+    for (std::size_t i = 0; i < geo->surfaces.size(); i += sectorSize * sectorSize)
+    {
+        const float x = float((i / sectorSize) % (gridSize / sectorSize)) * sectorSize * 0.1f;
+        const float y = float(i / (gridSize * sectorSize)) * sectorSize * 0.1f;
+
+        Sector s;
+        s.id                  = sectors->size();
+        s.ambientLight        = LinearColor({ 0.1f, 0.1f, 0.1f, 1.0f });
+        s.avgLight.position   = Vector3f(x + 0.4f, y + 0.4f, 0.3f);
+        s.avgLight.color      = LinearColor({ 0.8f, 0.6f, 0.4f, 1.0f });
+        s.avgLight.falloffMin = 0.4f;
+        s.avgLight.falloffMax = 0.8f;
+        s.surfaces.firstIdx   = i;
+        s.surfaces.count      = sectorSize * sectorSize;
+        sectors->push_back(std::move(s));
+    }
+
+    // Includes copying of georesource
+    addBenchmark("world/light/bake", 0, [geo, sectors] {
+        auto g = *geo;
+        auto stats = bakeVertexLight(g, *sectors, {});
+        doNotOptimize(stats);
+    });
+}
+
+static void registerMaterialSectionBenchmarks()
+{
+    auto materials = std::make_shared<Table<Material>>(makeMaterials(32, 64, 2));
+
+    CndHeader header{};
+    header.numMaterials = safe_cast<uint32_t>(materials->size());
+
+    auto cndData = std::make_shared<ByteArray>(writeToBuffer(64 * 1024 * 1024, [&](OutputStream& os) {
+        CND::writeSection_Materials(os, *materials);
+    }));
+
+    addBenchmark("cnd/materials/write", cndData->size(), [materials, size = cndData->size()] {
+        ByteArray buffer;
+        buffer.reserve(size);
+        OutputBinaryStream<ByteArray> os(buffer);
+        CND::writeSection_Materials(os, *materials);
+        doNotOptimize(buffer);
+    });
+
+    addBenchmark("cnd/materials/parse", cndData->size(), [cndData, header] {
+        InputBinaryStream<ByteArray> is(*cndData);
+        auto res = CND::parseSection_Materials(is, header);
+        doNotOptimize(res);
+    });
+}
+
+static void registerCndFileBenchmarks(const std::filesystem::path& cndFile)
+{
+    auto data = std::make_shared<ByteArray>([&] {
+        InputFileStream ifs(cndFile);
+        return ifs.read<ByteArray>(ifs.size());
+    }());
+
+    addBenchmark("cnd/file/materials", 0, [data] {
+        InputBinaryStream<ByteArray> is(*data);
+        auto res = CND::readMaterials(is);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("cnd/file/georesource", 0, [data] {
+        InputBinaryStream<ByteArray> is(*data);
+        auto res = CND::readGeoresource(is);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("cnd/file/sectors", 0, [data] {
+        InputBinaryStream<ByteArray> is(*data);
+        auto res = CND::readSectors(is);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("cnd/file/keyframes", 0, [data] {
+        InputBinaryStream<ByteArray> is(*data);
+        auto res = CND::readKeyframes(is);
+        doNotOptimize(res);
+    });
+
+    addBenchmark("cnd/file/things", 0, [data] {
+        InputBinaryStream<ByteArray> is(*data);
+        auto templates = CND::readTemplates(is);
+        auto things    = CND::readThings(is, templates);
+        doNotOptimize(things);
+    });
+
+    addBenchmark("cnd/file/view", data->size(), [data] {
+        CndView view(*data);
+        doNotOptimize(view);
+    });
+
+    addBenchmark("cnd/file/view_surface_verts", 0, [data] {
+        CndView view(*data);
+        std::size_t numVerts = 0;
+        for (const auto& s : view.surfaces()) {
+            numVerts += s.numVerts;
+        }
+        doNotOptimize(numVerts);
+    });
+}
+
+void libim::bench::registerWorldBenchmarks(const SuiteOptions& opt)
+{
+    registerGeoresourceBenchmarks();
+    registerGeoOptimizerBenchmarks();
+    registerLightBakerBenchmarks();
+    registerMaterialSectionBenchmarks();
+    if (!opt.cndFile.empty()) {
+        registerCndFileBenchmarks(opt.cndFile);
+    }
+}
@@ -0,0 +1,360 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cmdutils/cmdutils.h>
+#include <cmdutils/options.h>
+#include <libim/platform.h>
+
+#ifdef LIBIM_OS_WINDOWS
+# include <malloc.h>
+#endif
+
+using namespace cmdutils;
+using namespace libim;
+using namespace libim::bench;
+using namespace std::string_view_literals;
+namespace fs = std::filesystem;
+
+constexpr static auto optCnd     = "--cnd"sv;
+constexpr static auto optFilter  = "--filter"sv;
+constexpr static auto optGob     = "--gob"sv;
+constexpr static auto optHelp    = "--help"sv;
+constexpr static auto optJson    = "--json"sv;
+constexpr static auto optList    = "--list"sv;
+constexpr static auto optMinTime = "--min-time"sv;
+
+constexpr static std::size_t kDefaultMinTimeMs = 500;
+
+
+/* Global allocation counters.
+   All allocations made through global operator new are counted,
+   including the allocations made by worker threads. */
+static std::atomic_size_t gNumAllocs  = 0;
+static std::atomic_size_t gAllocBytes = 0;
+
+void* operator new(std::size_t size)
+{
+    gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/* Aligned allocations, e.g. made by std::pmr::new_delete_resource */
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+
+    const auto align = static_cast<std::size_t>(alignment);
+    size = (std::max<std::size_t>(size, 1) + align - 1) / align * align; // aligned_alloc requires size to be multiple of alignment
+#ifdef LIBIM_OS_WINDOWS
+    void* p = _aligned_malloc(size, align);
+#else
+    void* p = std::aligned_alloc(align, size);
+#endif
+    if (p) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+#ifdef LIBIM_OS_WINDOWS
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    ::operator delete(p, alignment);
+}
+
+
+struct BenchResult
+{
+    std::string name;
+    std::size_t iterations = 0;
+    double nsPerIteration  = 0.0;
+    double mbPerSecond     = 0.0; // 0 = not measured
+    double allocsPerIteration     = 0.0;
+    double allocBytesPerIteration = 0.0;
+};
+
+static std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> list;
+    return list;
+}
+
+void libim::bench::addBenchmark(std::string name, std::size_t bytes, std::function<void()> func)
+{
+    benchmarks().push_back({ std::move(name), bytes, std::move(func) });
+}
+
+void printHelp()
+{
+    std::cout << "Runs libim micro-benchmarks.\n\n";
+    std::cout << "  Usage: libim_bench [options]\n\n";
+
+    printOptionHeader();
+    printOption(optCnd    , "", "Also benchmark reading sections of <file> CND file.");
+    printOption(optGob    , "", "Also benchmark loading and extracting <file> GOB file.");
+    printOption(optFilter , "", "Run only benchmarks whose name contains <text>.");
+    printOption(optHelp   , "", "Show this message.");
+    printOption(optJson   , "", "Write results as JSON to <file>. Use - for stdout.");
+    printOption(optList   , "", "List benchmark names and exit.");
+    printOption(optMinTime, "", "Min. measuring time per benchmark in milliseconds. Default 500.");
+}
+
+BenchResult runBenchmark(const Benchmark& b, std::chrono::nanoseconds minTime)
+{
+    using clock = std::chrono::steady_clock;
+
+    b.run(); // warm up caches and lazy static initialization
+
+    const auto numAllocs  = gNumAllocs.load();
+    const auto allocBytes = gAllocBytes.load();
+
+    std::size_t iterations = 0;
+    std::size_t batch      = 1;
+    clock::duration elapsed{};
+    while (true)
+    {
+        const auto start = clock::now();
+        for (std::size_t i = 0; i < batch; i++) {
+            b.run();
+        }
+        elapsed    += clock::now() - start;
+        iterations += batch;
+        if (elapsed >= minTime) {
+            break;
+        }
+
+        // Double batch size but don't overshoot min. time by too much
+        const auto nsPerIter = std::max<double>(1.0, double(std::chrono::nanoseconds(elapsed).count()) / double(iterations));
+        const auto remaining = double(std::chrono::nanoseconds(minTime - elapsed).count());
+        batch = std::clamp<std::size_t>(static_cast<std::size_t>(remaining / nsPerIter) + 1, 1, batch * 2);
+    }
+
+    BenchResult r;
+    r.name           = b.name;
+    r.iterations     = iterations;
+    r.nsPerIteration = double(std::chrono::nanoseconds(elapsed).count()) / double(iterations);
+    if (b.bytesPerIteration > 0) {
+        r.mbPerSecond = (double(b.bytesPerIteration) / (1024.0 * 1024.0)) / (r.nsPerIteration / 1e9);
+    }
+    r.allocsPerIteration     = double(gNumAllocs.load() - numAllocs)   / double(iterations);
+    r.allocBytesPerIteration = double(gAllocBytes.load() - allocBytes) / double(iterations);
+    return r;
+}
+
+void printTableHeader()
+{
+    std::cout << std::left  << std::setw(40) << "Benchmark"
+              << std::right << std::setw(10) << "Iters"
+              << std::setw(14) << "Time/iter"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "Allocs/iter"
+              << std::setw(16) << "Alloc B/iter" << "\n";
+    std::cout << std::string(106, '-') << std::endl;
+}
+
+void printResult(const BenchResult& r)
+{
+    auto fmtTime = [](double ns) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        if (ns >= 1e6) {
+            ss << ns / 1e6 << " ms";
+        }
+        else if (ns >= 1e3) {
+            ss << ns / 1e3 << " us";
+        }
+        else {
+            ss << ns << " ns";
+        }
+        return ss.str();
+    };
+
+    std::cout << std::left  << std::setw(40) << r.name
+              << std::right << std::setw(10) << r.iterations
+              << std::setw(14) << fmtTime(r.nsPerIteration)
+              << std::fixed << std::setprecision(2);
+    if (r.mbPerSecond > 0.0) {
+        std::cout << std::setw(12) << r.mbPerSecond;
+    }
+    else {
+        std::cout << std::setw(12) << "-";
+    }
+    std::cout << std::setw(14) << r.allocsPerIteration
+              << std::setw(16) << std::setprecision(0) << r.allocBytesPerIteration
+              << std::endl;
+}
+
+std::string jsonEscape(std::string_view str)
+{
+    std::string out;
+    out.reserve(str.size());
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+void writeJson(std::ostream& os, const std::vector<BenchResult>& results)
+{
+    os << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const auto& r = results[i];
+        os << "    {"
+           << "\"name\": \"" << jsonEscape(r.name) << "\", "
+           << "\"iterations\": " << r.iterations << ", "
+           << std::fixed << std::setprecision(3)
+           << "\"ns_per_iter\": " << r.nsPerIteration << ", "
+           << "\"mb_per_s\": " << r.mbPerSecond << ", "
+           << "\"allocs_per_iter\": " << r.allocsPerIteration << ", "
+           << "\"alloc_bytes_per_iter\": " << r.allocBytesPerIteration
+           << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    try
+    {
+        CmdArgs args(static_cast<std::size_t>(argc), argv);
+        if (args.hasArg(optHelp))
+        {
+            printHelp();
+            return 0;
+        }
+
+        SuiteOptions opt;
+        opt.cndFile = args.arg(optCnd);
+        opt.gobFile = args.arg(optGob);
+
+        registerWorldBenchmarks(opt);
+        registerMaterialBenchmarks(opt);
+        registerIoBenchmarks(opt);
+
+        const auto filter = args.arg(optFilter);
+        std::vector<const Benchmark*> selected;
+        for (const auto& b : benchmarks())
+        {
+            if (filter.empty() || b.name.find(filter) != std::string::npos) {
+                selected.push_back(&b);
+            }
+        }
+
+        if (args.hasArg(optList))
+        {
+            for (const auto* b : selected) {
+                std::cout << b->name << "\n";
+            }
+            return 0;
+        }
+
+        const auto minTime  = std::chrono::milliseconds(args.uintArg(optMinTime, kDefaultMinTimeMs));
+        const auto jsonPath = args.arg(optJson);
+        const bool jsonToStdout = jsonPath == "-";
+
+        std::vector<BenchResult> results;
+        results.reserve(selected.size());
+        if (!jsonToStdout) {
+            printTableHeader();
+        }
+
+        for (const auto* b : selected)
+        {
+            results.push_back(runBenchmark(*b, minTime));
+            if (!jsonToStdout) {
+                printResult(results.back());
+            }
+        }
+
+        if (jsonToStdout) {
+            writeJson(std::cout, results);
+        }
+        else if (!jsonPath.empty())
+        {
+            std::ofstream ofs(jsonPath);
+            if (!ofs) {
+                throw std::runtime_error("Failed to open file for writing: " + jsonPath);
+            }
+            writeJson(ofs, results);
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        printError("%", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,228 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <cmdutils/cmdutils.h>
+#include <cmdutils/options.h>
+
+#include <libim/content/asset/animation/animation.h>
+#include <libim/content/asset/material/material.h>
+#include <libim/content/asset/material/texutils.h>
+#include <libim/content/asset/world/worldgen.h>
+#include <libim/content/text/text_resource_writer.h>
+#include <libim/io/binarystream.h>
+#include <libim/io/filestream.h>
+#include <libim/io/vfstream.h>
+#include <libim/utils/utils.h>
+
+using namespace cmdutils;
+using namespace libim;
+using namespace libim::content::asset;
+using namespace libim::content::text;
+using namespace std::string_view_literals;
+namespace fs = std::filesystem;
+
+constexpr static auto optAnimations     = "--animations"sv;
+constexpr static auto optAssets         = "--assets"sv;
+constexpr static auto optCels           = "--cels"sv;
+constexpr static auto optCompressSounds = "--compress-sounds"sv;
+constexpr static auto optDivisions      = "--divisions"sv;
+constexpr static auto optFrames         = "--frames"sv;
+constexpr static auto optGob            = "--gob"sv;
+constexpr static auto optGobMaterials   = "--gob-materials"sv;
+constexpr static auto optGrid           = "--grid"sv;
+constexpr static auto optHelp           = "--help"sv;
+constexpr static auto optMaterials      = "--materials"sv;
+constexpr static auto optMaterialSize   = "--material-size"sv;
+constexpr static auto optName           = "--name"sv;
+constexpr static auto optNdy            = "--ndy"sv;
+constexpr static auto optNodes          = "--nodes"sv;
+constexpr static auto optSeed           = "--seed"sv;
+constexpr static auto optSoundLength    = "--sound-length"sv;
+constexpr static auto optSounds         = "--sounds"sv;
+constexpr static auto optTemplates      = "--templates"sv;
+constexpr static auto optThings         = "--things"sv;
+
+
+void printHelp()
+{
+    std::cout << "Generates synthetic world and assets for testing and benchmarking.\n\n";
+    std::cout << "  Usage: worldgen <output dir> [options]\n\n";
+
+    WorldGenParams d;
+    printOptionHeader();
+    printOption(optName          , "", utils::format("World name. Default %.", d.name));
+    printOption(optSeed          , "", utils::format("Random seed. Default %.", d.seed));
+    printOption(optGrid          , "", utils::format("Number of sectors along one world side. Default %.", d.gridSize));
+    printOption(optDivisions     , "", utils::format("Number of floor surfaces along one sector side. Default %.", d.floorDivisions));
+    printOption(optMaterials     , "", utils::format("Number of materials. Default %.", d.numMaterials));
+    printOption(optMaterialSize  , "", utils::format("Material texture size, power of 2. Default %.", d.materialSize));
+    printOption(optCels          , "", utils::format("Number of material cels. Default %.", d.numMaterialCels));
+    printOption(optAnimations    , "", utils::format("Number of keyframes. Default %.", d.numAnimations));
+    printOption(optFrames        , "", utils::format("Number of keyframe frames. Default %.", d.numAnimationFrames));
+    printOption(optNodes         , "", utils::format("Number of keyframe nodes. Default %.", d.numAnimationNodes));
+    printOption(optSounds        , "", utils::format("Number of sounds. Default %.", d.numSounds));
+    printOption(optSoundLength   , "", utils::format("Sound length in milliseconds. Default %.", d.soundDuration));
+    printOption(optCompressSounds, "", "Compress sounds in CND file.");
+    printOption(optTemplates     , "", utils::format("Number of thing templates. Default %.", d.numTemplates));
+    printOption(optThings        , "", utils::format("Number of things. Default %.", d.numThings));
+    printOption(optNdy           , "", "Also write NDY file.");
+    printOption(optAssets        , "", "Also write MAT, KEY and WAV files.");
+    printOption(optGob           , "", "Pack all written files to <name>.gob.");
+    printOption(optGobMaterials  , "", "Number of MAT files to pack to GOB. Default --materials.");
+    printOption(optHelp          , "", "Show this message.");
+}
+
+template<typename WriteFunc>
+ByteArray writeToBuffer(std::size_t capacity, WriteFunc&& write)
+{
+    ByteArray buffer;
+    buffer.reserve(capacity);
+    OutputBinaryStream<ByteArray> os(buffer);
+    write(os);
+    return buffer;
+}
+
+void writeFile(const fs::path& filePath, ByteView data)
+{
+    makePath(filePath);
+    OutputFileStream ofs(filePath, /*truncate=*/true);
+    ofs.write(data.data(), data.size());
+}
+
+int main(int argc, const char* argv[])
+{
+    try
+    {
+        CmdArgs args(static_cast<std::size_t>(argc), argv);
+        if (args.hasArg(optHelp) || args.positionalArgs().empty())
+        {
+            printHelp();
+            return args.hasArg(optHelp) ? 0 : 1;
+        }
+
+        const fs::path outDir = args.positionalArgs().at(0);
+
+        WorldGenParams p;
+        if (args.hasArg(optName)) {
+            p.name = args.arg(optName);
+        }
+        p.seed               = static_cast<uint32_t>(args.uintArg(optSeed, p.seed));
+        p.gridSize           = args.uintArg(optGrid, p.gridSize);
+        p.floorDivisions     = args.uintArg(optDivisions, p.floorDivisions);
+        p.numMaterials       = args.uintArg(optMaterials, p.numMaterials);
+        p.materialSize       = static_cast<uint32_t>(args.uintArg(optMaterialSize, p.materialSize));
+        p.numMaterialCels    = args.uintArg(optCels, p.numMaterialCels);
+        p.numAnimations      = args.uintArg(optAnimations, p.numAnimations);
+        p.numAnimationFrames = args.uintArg(optFrames, p.numAnimationFrames);
+        p.numAnimationNodes  = args.uintArg(optNodes, p.numAnimationNodes);
+        p.numSounds          = args.uintArg(optSounds, p.numSounds);
+        p.soundDuration      = args.uintArg(optSoundLength, p.soundDuration);
+        p.compressSounds     = args.hasArg(optCompressSounds);
+        p.numTemplates       = args.uintArg(optTemplates, p.numTemplates);
+        p.numThings          = args.uintArg(optThings, p.numThings);
+
+        const bool writeNdy    = args.hasArg(optNdy);
+        const bool writeAssets = args.hasArg(optAssets);
+        const bool writeGob    = args.hasArg(optGob);
+        const auto numGobMats  = args.uintArg(optGobMaterials, p.numMaterials);
+
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        auto world = generateWorld(p);
+        std::cout << "Generated world '" << p.name << "' in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count() << " ms: "
+                  << world.sectors.size() << " sectors, "
+                  << world.georesource.surfaces.size() << " surfaces, "
+                  << world.georesource.vertices.size() << " vertices, "
+                  << world.georesource.adjoins.size() << " adjoins, "
+                  << world.things.size() << " things" << std::endl;
+
+        const auto cndPath = outDir / "ndy" / (p.name + ".cnd");
+        const auto ndyPath = outDir / "ndy" / (p.name + ".ndy");
+        makePath(cndPath);
+
+        start = clock::now();
+        {
+            OutputFileStream ofs(cndPath, /*truncate=*/true);
+            writeWorldCnd(ofs, world);
+        }
+        std::cout << "Wrote " << cndPath << " (" << fs::file_size(cndPath) << " bytes) in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count() << " ms" << std::endl;
+
+        if (writeNdy)
+        {
+            start = clock::now();
+            {
+                OutputFileStream ofs(ndyPath, /*truncate=*/true);
+                writeWorldNdy(ofs, world);
+            }
+            std::cout << "Wrote " << ndyPath << " (" << fs::file_size(ndyPath) << " bytes) in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count() << " ms" << std::endl;
+        }
+
+        // Asset files are generated one by one so big GOB files don't have to fit in memory
+        const auto forEachAsset = [&](auto&& func)
+        {
+            const auto matBufSize = calcMipmapSize(p.materialSize, p.materialSize, 4, RGB565) * std::max<std::size_t>(1, p.numMaterialCels) + 4096;
+            for (std::size_t i = 0; i < (writeGob ? numGobMats : p.numMaterials); i++)
+            {
+                auto mat = generateMaterial(p, i);
+                func("mat/" + mat.name(), writeToBuffer(matBufSize, [&](OutputStream& os) {
+                    matWrite(mat, os);
+                }));
+            }
+
+            for (const auto& anim : world.animations)
+            {
+                func("3do/key/" + anim.name(), writeToBuffer(1024 * 1024, [&](OutputStream& os) {
+                    keyWrite(anim, TextResourceWriter(os));
+                }));
+            }
+
+            for (std::size_t i = 0; i < p.numSounds; i++) {
+                func(utils::format("sound/%_%.wav", p.name, i), generateSoundWav(p, i));
+            }
+        };
+
+        if (writeAssets)
+        {
+            std::size_t numFiles = 0;
+            forEachAsset([&](const std::string& filePath, const ByteArray& data) {
+                writeFile(outDir / filePath, data);
+                numFiles++;
+            });
+            std::cout << "Wrote " << numFiles << " asset files" << std::endl;
+        }
+
+        if (writeGob)
+        {
+            start = clock::now();
+            const auto gobPath = outDir / (p.name + ".gob");
+            OutputFileStream ofs(gobPath, /*truncate=*/true);
+            GobWriter gob(ofs);
+            gob.add("ndy/" + p.name + ".cnd", InputFileStream(cndPath));
+            if (writeNdy) {
+                gob.add("ndy/" + p.name + ".ndy", InputFileStream(ndyPath));
+            }
+
+            forEachAsset([&](const std::string& filePath, const ByteArray& data) {
+                gob.add(filePath, data);
+            });
+            gob.finish();
+            ofs.close();
+
+            std::cout << "Wrote " << gobPath << " (" << gob.size() << " files, " << fs::file_size(gobPath) << " bytes) in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count() << " ms" << std::endl;
+        }
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        printError("%", e.what());
+        return 1;
+    }
+}